@@ -0,0 +1,164 @@
+/***********************************************************************************************************
+ * @file AliasingPlanner.cpp
+ *
+ * @brief Implements functions of the AliasingPlanner class found in AliasingPlanner.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "AliasingPlanner.h"
+
+#include <algorithm>
+
+
+namespace {
+	bool overlaps(std::uint32_t firstA, std::uint32_t lastA, std::uint32_t firstB, std::uint32_t lastB) {
+		return(firstA <= lastB && firstB <= lastA);
+	}
+
+	std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment) {
+		if (alignment <= 1) return value;
+		return((value + alignment - 1) / alignment * alignment);
+	}
+}
+
+
+/** Constructor for the AliasingPlanner class.
+ *
+ * @param[in] pMaxHeapSize: Largest heap the planner may lay out, or 0 to put everything into one heap.
+ */
+SyrenEngine::AliasingPlanner::AliasingPlanner(std::uint64_t pMaxHeapSize) : mMaxHeapSize(pMaxHeapSize) {}
+
+/** Places every request into a heap.
+ *
+ * @param[in] requests: Sizes, alignments and lifetimes of the resources.
+ * @param[out] placements: Heap, offset and aliased request of each resource, in request order.
+ *
+ * @retval FunctionResult indicating whether every request could be placed.
+ */
+SyrenEngine::FunctionResult SyrenEngine::AliasingPlanner::plan(const std::vector<AliasingRequest>& requests, std::vector<AliasingPlacement>& placements) {
+	placements.assign(requests.size(), AliasingPlacement());
+	mHeapSizes.clear();
+	mPlaced.clear();
+	mRequestedSize = 0;
+
+	mOrder.resize(requests.size());
+	for (std::uint32_t i = 0; i < requests.size(); ++i) {
+		if (requests[i].firstUse > requests[i].lastUse)
+			return(FunctionResult(false, RESULT::FAIL, "Aliasing request ends before it begins."));
+		if (mMaxHeapSize != 0 && requests[i].size > mMaxHeapSize)
+			return(FunctionResult(false, RESULT::FAIL, "Aliasing request is larger than the maximum heap size."));
+
+		mOrder[i] = i;
+		mRequestedSize += requests[i].size;
+	}
+
+	std::sort(mOrder.begin(), mOrder.end(), [&requests](std::uint32_t a, std::uint32_t b) {
+		if (requests[a].size != requests[b].size) return(requests[a].size > requests[b].size);
+		if (requests[a].firstUse != requests[b].firstUse) return(requests[a].firstUse < requests[b].firstUse);
+		return(a < b);
+	});
+
+	for (std::uint32_t index : mOrder) {
+		std::uint32_t heap = 0;
+		std::uint64_t offset = 0;
+
+		while (heap < mHeapSizes.size() && !fit(requests, placements, index, heap, offset))
+			++heap;
+
+		if (heap == mHeapSizes.size()) {
+			mHeapSizes.push_back(0);
+			offset = 0;
+		}
+
+		placements[index].heap = heap;
+		placements[index].offset = offset;
+		mHeapSizes[heap] = std::max(mHeapSizes[heap], offset + requests[index].size);
+		mPlaced.push_back(index);
+	}
+
+	findAliases(requests, placements);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Planned the transient resource heaps."));
+}
+
+/** Sums the sizes of the planned heaps. */
+std::uint64_t SyrenEngine::AliasingPlanner::plannedSize() const {
+	std::uint64_t size = 0;
+	for (std::uint64_t heapSize : mHeapSizes)
+		size += heapSize;
+	return size;
+}
+
+/** Finds the lowest offset of a heap at which a request fits next to the requests alive at the same time.
+ *
+ * @param[in] requests: All requests being planned.
+ * @param[in] placements: Placements made so far.
+ * @param[in] index: Request to place.
+ * @param[in] heap: Heap to search.
+ * @param[out] offset: Offset of the request within the heap.
+ *
+ * @retval True if the request fits into the heap.
+ */
+bool SyrenEngine::AliasingPlanner::fit(const std::vector<AliasingRequest>& requests, const std::vector<AliasingPlacement>& placements, std::uint32_t index, std::uint32_t heap, std::uint64_t& offset) {
+	const AliasingRequest& request = requests[index];
+
+	mBusy.clear();
+	for (std::uint32_t placed : mPlaced) {
+		if (placements[placed].heap != heap) continue;
+		if (!overlaps(request.firstUse, request.lastUse, requests[placed].firstUse, requests[placed].lastUse)) continue;
+		mBusy.push_back({ placements[placed].offset, placements[placed].offset + requests[placed].size });
+	}
+
+	std::sort(mBusy.begin(), mBusy.end(), [](const Interval& a, const Interval& b) { return(a.begin < b.begin); });
+
+	std::uint64_t candidate = 0;
+	for (const Interval& busy : mBusy) {
+		if (alignUp(candidate, request.alignment) + request.size <= busy.begin) break;
+		candidate = std::max(candidate, busy.end);
+	}
+
+	offset = alignUp(candidate, request.alignment);
+	return(mMaxHeapSize == 0 || offset + request.size <= mMaxHeapSize);
+}
+
+/** Works out which earlier request each placement takes its memory over from.
+ *
+ * @details
+ * If the latest earlier user of the memory covers the whole placement, the memory is handed over from
+ * that request alone. Otherwise the placement overlaps several earlier requests and is reported as
+ * AliasingMany.
+ */
+void SyrenEngine::AliasingPlanner::findAliases(const std::vector<AliasingRequest>& requests, std::vector<AliasingPlacement>& placements) const {
+	for (std::uint32_t i = 0; i < requests.size(); ++i) {
+		const std::uint64_t begin = placements[i].offset;
+		const std::uint64_t end = begin + requests[i].size;
+
+		std::uint32_t latest = AliasingNone;
+		std::uint32_t candidates = 0;
+
+		for (std::uint32_t j = 0; j < requests.size(); ++j) {
+			if (j == i || placements[j].heap != placements[i].heap) continue;
+			if (requests[j].lastUse >= requests[i].firstUse) continue;
+
+			const std::uint64_t otherBegin = placements[j].offset;
+			const std::uint64_t otherEnd = otherBegin + requests[j].size;
+			if (otherEnd <= begin || end <= otherBegin) continue;
+
+			++candidates;
+			if (latest == AliasingNone || requests[j].lastUse > requests[latest].lastUse) latest = j;
+		}
+
+		if (candidates > 1) {
+			const std::uint64_t latestBegin = placements[latest].offset;
+			const std::uint64_t latestEnd = latestBegin + requests[latest].size;
+			if (latestBegin > begin || latestEnd < end) latest = AliasingMany;
+		}
+
+		placements[i].aliases = latest;
+	}
+}
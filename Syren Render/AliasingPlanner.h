@@ -0,0 +1,80 @@
+/***********************************************************************************************************
+ * @file AliasingPlanner.h
+ *
+ * @brief Declares the planner that packs transient resources with disjoint lifetimes into shared heaps
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Every request is an allocation size and alignment together with the first and last step that uses
+ * it. Requests whose lifetimes do not overlap may share memory. The planner places the largest
+ * requests first, each at the lowest aligned offset that does not collide with a placed request that
+ * is alive at the same time, and opens another heap only when a maximum heap size is set and reached.
+ *
+ * For every placement it reports which earlier request last used the memory, so the caller can issue
+ * the aliasing barrier that hands the memory over. The planner knows nothing about graphics APIs.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common.h"
+
+
+namespace SyrenEngine {
+	static const std::uint32_t AliasingNone = 0xFFFFFFFFu; /*!< The memory was not used earlier in the frame */
+	static const std::uint32_t AliasingMany = 0xFFFFFFFEu; /*!< The memory was used by several earlier requests */
+
+	struct AliasingRequest {
+		std::uint64_t size;
+		std::uint64_t alignment;
+		std::uint32_t firstUse;
+		std::uint32_t lastUse;
+	};
+
+	struct AliasingPlacement {
+		std::uint32_t heap = 0;
+		std::uint64_t offset = 0;
+		std::uint32_t aliases = AliasingNone; /*!< Request that last used the memory, AliasingNone or AliasingMany */
+	};
+
+	class AliasingPlanner {
+	private:
+		struct Interval {
+			std::uint64_t begin;
+			std::uint64_t end;
+		};
+
+		std::uint64_t mMaxHeapSize;
+		std::vector<std::uint64_t> mHeapSizes;
+
+		std::vector<std::uint32_t> mOrder;  /*!< Requests in placement order */
+		std::vector<std::uint32_t> mPlaced; /*!< Requests placed so far */
+		std::vector<Interval> mBusy;        /*!< Memory of a heap taken by requests alive at the same time */
+
+		std::uint64_t mRequestedSize = 0;
+
+	public:
+		explicit AliasingPlanner(std::uint64_t pMaxHeapSize = 0);
+
+		FunctionResult plan(const std::vector<AliasingRequest>& requests, std::vector<AliasingPlacement>& placements);
+
+		const std::vector<std::uint64_t>& heapSizes() const { return mHeapSizes; }
+		std::uint64_t requestedSize() const { return mRequestedSize; }
+		std::uint64_t plannedSize() const;
+	private:
+		AliasingPlanner(const AliasingPlanner& rhs) = delete;
+		AliasingPlanner& operator=(const AliasingPlanner& rhs) = delete;
+
+		bool fit(const std::vector<AliasingRequest>& requests, const std::vector<AliasingPlacement>& placements, std::uint32_t index, std::uint32_t heap, std::uint64_t& offset);
+		void findAliases(const std::vector<AliasingRequest>& requests, std::vector<AliasingPlacement>& placements) const;
+	};
+}
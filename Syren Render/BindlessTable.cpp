@@ -0,0 +1,85 @@
+/***********************************************************************************************************
+ * @file BindlessTable.cpp
+ *
+ * @brief Implements functions of the BindlessTable class found in BindlessTable.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "BindlessTable.h"
+
+
+/** Constructor for the BindlessTable class. */
+SyrenEngine::BindlessTable::BindlessTable() : mLiveCount(0) {}
+
+/** Sizes the table and binds it to the timeline that frames reading it are signalled on.
+ *
+ * @param[in] pTimeline: Timeline of the queue that reads the table.
+ * @param[in] pCapacity: Number of slots, at most MaxBindlessCount.
+ */
+SyrenEngine::FunctionResult SyrenEngine::BindlessTable::initialise(Timeline* pTimeline, std::uint32_t pCapacity) {
+	if (pTimeline == nullptr) return(FunctionResult(false, RESULT::FAIL, "Bindless table requires a timeline."));
+	if (pCapacity == 0 || pCapacity > MaxBindlessCount) return(FunctionResult(false, RESULT::FAIL, "Bindless table capacity is out of range."));
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mCapacity = pCapacity;
+	mSlots = std::make_unique<std::atomic<std::uint32_t>[]>(pCapacity);
+	for (std::uint32_t i = 0; i < pCapacity; ++i)
+		mSlots[i].store(1, std::memory_order_relaxed);
+
+	mNextUnused = 0;
+	mLiveCount.store(0, std::memory_order_relaxed);
+	mRetired = std::make_unique<FenceRecycler<std::uint32_t> >(pTimeline);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the bindless table."));
+}
+
+/** Takes a slot, preferring the oldest freed slot that no frame can reference any more.
+ *
+ * @param[out] handle: Handle of the slot.
+ *
+ * @retval FunctionResult indicating whether a slot was free.
+ */
+SyrenEngine::FunctionResult SyrenEngine::BindlessTable::allocate(BindlessHandle& handle) {
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	std::uint32_t slot;
+	if (!mRetired || !mRetired->acquire(slot)) {
+		if (mNextUnused == mCapacity) return(FunctionResult(false, RESULT::FAIL, "The bindless table is full."));
+		slot = mNextUnused++;
+	}
+
+	const std::uint32_t generation = mSlots[slot].load(std::memory_order_relaxed);
+	mSlots[slot].store(generation | LiveBit, std::memory_order_release);
+	mLiveCount.fetch_add(1, std::memory_order_relaxed);
+
+	handle = (generation << BindlessIndexBits) | slot;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Bindless slot allocated."));
+}
+
+/** Invalidates a handle and hands its slot back once a timeline value has completed.
+ *
+ * @param[in] handle: Handle to free, reset to InvalidBindlessHandle.
+ * @param[in] fenceValue: Value after which no submitted work reads the slot.
+ *
+ * @retval FunctionResult with RESULT::FAIL if the handle is stale.
+ */
+SyrenEngine::FunctionResult SyrenEngine::BindlessTable::free(BindlessHandle& handle, std::uint64_t fenceValue) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!isValid(handle)) return(FunctionResult(false, RESULT::FAIL, "Freeing a stale bindless handle."));
+
+	const std::uint32_t slot = index(handle);
+	std::uint32_t next = (generation(handle) + 1) & GenerationMask;
+	if (next == 0) next = 1;
+
+	mSlots[slot].store(next, std::memory_order_release);
+	mLiveCount.fetch_sub(1, std::memory_order_relaxed);
+	mRetired->retire(slot, fenceValue);
+
+	handle = InvalidBindlessHandle;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Bindless slot freed."));
+}
@@ -0,0 +1,84 @@
+/***********************************************************************************************************
+ * @file BindlessTable.h
+ *
+ * @brief Declares the table of stable, generation checked indices that shaders use to reach any resource
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Every texture and buffer registered with the table gets a slot that keeps its index for the whole
+ * life of the resource. Shaders receive the index in their constants and read the descriptor from one
+ * large table bound once per frame, so draws no longer bind descriptor tables of their own.
+ *
+ * A handle packs the slot index into its low BindlessIndexBits bits and the generation of the slot into
+ * the rest. Freeing a slot advances its generation, so handles kept past the free are detected as stale
+ * instead of silently reaching whatever resource takes the slot next. Freed slots are only reused once
+ * the timeline value passed to free() has completed, since frames in flight may still index them.
+ *
+ * Registration and removal may happen on any thread; validating a handle takes no lock.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "common.h"
+#include "FenceRecycler.h"
+#include "Timeline.h"
+
+
+namespace SyrenEngine {
+	typedef std::uint32_t BindlessHandle;
+
+	static const BindlessHandle InvalidBindlessHandle = 0;
+	static const std::uint32_t BindlessIndexBits = 20;
+	static const std::uint32_t BindlessIndexMask = (1u << BindlessIndexBits) - 1;
+	static const std::uint32_t MaxBindlessCount = 1u << BindlessIndexBits;
+
+	class BindlessTable {
+	private:
+		static const std::uint32_t GenerationMask = 0xFFFFFFFFu >> BindlessIndexBits;
+		static const std::uint32_t LiveBit = 0x80000000u;
+
+		std::uint32_t mCapacity = 0;
+		std::unique_ptr<std::atomic<std::uint32_t>[]> mSlots; /*!< Generation of each slot, with LiveBit set while it is in use */
+		std::uint32_t mNextUnused = 0;
+		std::atomic<std::uint32_t> mLiveCount;
+
+		std::unique_ptr<FenceRecycler<std::uint32_t> > mRetired;
+		std::mutex mMutex;
+	public:
+		BindlessTable();
+
+		FunctionResult initialise(Timeline* pTimeline, std::uint32_t pCapacity);
+
+		FunctionResult allocate(BindlessHandle& handle);
+		FunctionResult free(BindlessHandle& handle, std::uint64_t fenceValue);
+
+		/** Checks that a handle refers to a live slot and has not outlived it. */
+		bool isValid(BindlessHandle handle) const {
+			const std::uint32_t slot = index(handle);
+			if (handle == InvalidBindlessHandle || slot >= mCapacity) return false;
+			return(mSlots[slot].load(std::memory_order_acquire) == (generation(handle) | LiveBit));
+		}
+
+		std::uint32_t capacity() const { return mCapacity; }
+		std::uint32_t liveCount() const { return mLiveCount.load(std::memory_order_relaxed); }
+
+		/** Index of the handle's descriptor within the table, as passed to shaders. */
+		static std::uint32_t index(BindlessHandle handle) { return handle & BindlessIndexMask; }
+		static std::uint32_t generation(BindlessHandle handle) { return handle >> BindlessIndexBits; }
+	private:
+		BindlessTable(const BindlessTable& rhs) = delete;
+		BindlessTable& operator=(const BindlessTable& rhs) = delete;
+	};
+}
@@ -0,0 +1,239 @@
+/***********************************************************************************************************
+ * @file CommandStream.cpp
+ *
+ * @brief Implements functions of the CommandStream class found in CommandStream.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "CommandStream.h"
+
+
+namespace {
+	/** Padded packet size of every command type, indexed by CommandType. */
+	const std::size_t CommandSizes[] = {
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::ClearRenderTargetCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::ClearDepthStencilCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::SetViewportCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::SetScissorCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::SetRenderTargetsCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::SetPipelineCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::SetVertexBufferCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::SetIndexBufferCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::DrawCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::DrawIndexedCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::DispatchCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::BarrierCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::CopyBufferCommand)),
+		SyrenEngine::CommandStream::paddedSize(sizeof(SyrenEngine::CopyTextureCommand))
+	};
+	static_assert(sizeof(CommandSizes) / sizeof(CommandSizes[0]) == static_cast<std::size_t>(SyrenEngine::CommandType::COUNT), "Every command type needs a size entry.");
+}
+
+
+void SyrenEngine::CommandStream::clearRenderTarget(ResourceId target, const float color[4]) {
+	ClearRenderTargetCommand& command = push<ClearRenderTargetCommand>();
+	command.target = target;
+	std::memcpy(command.color, color, sizeof(command.color));
+}
+
+void SyrenEngine::CommandStream::clearDepthStencil(ResourceId target, float depth, std::uint8_t stencil, bool clearDepth, bool clearStencil) {
+	ClearDepthStencilCommand& command = push<ClearDepthStencilCommand>();
+	command.target = target;
+	command.depth = depth;
+	command.stencil = stencil;
+	command.clearDepth = clearDepth ? 1 : 0;
+	command.clearStencil = clearStencil ? 1 : 0;
+}
+
+void SyrenEngine::CommandStream::setViewport(float x, float y, float width, float height, float minDepth, float maxDepth) {
+	SetViewportCommand& command = push<SetViewportCommand>();
+	command.x = x;
+	command.y = y;
+	command.width = width;
+	command.height = height;
+	command.minDepth = minDepth;
+	command.maxDepth = maxDepth;
+}
+
+void SyrenEngine::CommandStream::setScissor(std::int32_t left, std::int32_t top, std::int32_t right, std::int32_t bottom) {
+	SetScissorCommand& command = push<SetScissorCommand>();
+	command.left = left;
+	command.top = top;
+	command.right = right;
+	command.bottom = bottom;
+}
+
+void SyrenEngine::CommandStream::setRenderTargets(std::uint32_t count, const ResourceId* colors, ResourceId depthStencil) {
+	SetRenderTargetsCommand& command = push<SetRenderTargetsCommand>();
+	command.count = count < MaxCommandRenderTargets ? count : MaxCommandRenderTargets;
+	for (std::uint32_t i = 0; i < command.count; ++i)
+		command.colors[i] = colors[i];
+	command.depthStencil = depthStencil;
+}
+
+void SyrenEngine::CommandStream::setPipeline(PipelineId pipeline) {
+	push<SetPipelineCommand>().pipeline = pipeline;
+}
+
+void SyrenEngine::CommandStream::setVertexBuffer(std::uint32_t slot, ResourceId buffer, std::uint32_t offset, std::uint32_t size, std::uint32_t stride) {
+	SetVertexBufferCommand& command = push<SetVertexBufferCommand>();
+	command.slot = slot;
+	command.buffer = buffer;
+	command.offset = offset;
+	command.size = size;
+	command.stride = stride;
+}
+
+void SyrenEngine::CommandStream::setIndexBuffer(ResourceId buffer, std::uint32_t offset, std::uint32_t size, std::uint32_t indexSize) {
+	SetIndexBufferCommand& command = push<SetIndexBufferCommand>();
+	command.buffer = buffer;
+	command.offset = offset;
+	command.size = size;
+	command.indexSize = indexSize;
+}
+
+void SyrenEngine::CommandStream::draw(std::uint32_t vertexCount, std::uint32_t instanceCount, std::uint32_t firstVertex, std::uint32_t firstInstance) {
+	DrawCommand& command = push<DrawCommand>();
+	command.vertexCount = vertexCount;
+	command.instanceCount = instanceCount;
+	command.firstVertex = firstVertex;
+	command.firstInstance = firstInstance;
+}
+
+void SyrenEngine::CommandStream::drawIndexed(std::uint32_t indexCount, std::uint32_t instanceCount, std::uint32_t firstIndex, std::int32_t baseVertex, std::uint32_t firstInstance) {
+	DrawIndexedCommand& command = push<DrawIndexedCommand>();
+	command.indexCount = indexCount;
+	command.instanceCount = instanceCount;
+	command.firstIndex = firstIndex;
+	command.baseVertex = baseVertex;
+	command.firstInstance = firstInstance;
+}
+
+void SyrenEngine::CommandStream::dispatch(std::uint32_t groupsX, std::uint32_t groupsY, std::uint32_t groupsZ) {
+	DispatchCommand& command = push<DispatchCommand>();
+	command.groupsX = groupsX;
+	command.groupsY = groupsY;
+	command.groupsZ = groupsZ;
+}
+
+void SyrenEngine::CommandStream::barrier(ResourceId resource, ResourceState before, ResourceState after) {
+	BarrierCommand& command = push<BarrierCommand>();
+	command.resource = resource;
+	command.before = before;
+	command.after = after;
+}
+
+void SyrenEngine::CommandStream::copyBuffer(ResourceId destination, std::uint64_t destinationOffset, ResourceId source, std::uint64_t sourceOffset, std::uint64_t size) {
+	CopyBufferCommand& command = push<CopyBufferCommand>();
+	command.destination = destination;
+	command.destinationOffset = destinationOffset;
+	command.source = source;
+	command.sourceOffset = sourceOffset;
+	command.size = size;
+}
+
+void SyrenEngine::CommandStream::copyTexture(ResourceId destination, ResourceId source) {
+	CopyTextureCommand& command = push<CopyTextureCommand>();
+	command.destination = destination;
+	command.source = source;
+}
+
+/** Appends the packets of another stream.
+ *
+ * @details
+ * Packets are position independent, so this is a single copy. Used to merge the streams recorded by
+ * several threads into one frame.
+ *
+ * @param[in] stream: Stream to append.
+ */
+void SyrenEngine::CommandStream::append(const CommandStream& stream) {
+	mData.insert(mData.end(), stream.mData.begin(), stream.mData.end());
+	mCommandCount += stream.mCommandCount;
+}
+
+/** Replaces the stream with serialised packet data.
+ *
+ * @details
+ * Walks the packets and rejects data that does not consist of whole, known packets, or whose packets
+ * hold counts, slots, index sizes, flags or resource states outside the range recording produces. A
+ * loaded stream therefore only differs from a recorded one in the resources and sizes it names, which
+ * the executors check against what actually exists.
+ *
+ * @param[in] data: Packet data previously obtained through data() and size().
+ * @param[in] size: Size of the packet data in bytes.
+ *
+ * @retval FunctionResult indicating whether the data is a valid command stream.
+ */
+SyrenEngine::FunctionResult SyrenEngine::CommandStream::load(const void* data, std::size_t size) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	std::uint32_t count = 0;
+	std::size_t offset = 0;
+
+	while (offset < size) {
+		if (size - offset < sizeof(CommandHeader)) return(FunctionResult(false, RESULT::FAIL, "Truncated command header in command stream."));
+
+		CommandHeader header;
+		std::memcpy(&header, bytes + offset, sizeof(header));
+
+		if (header.type >= CommandType::COUNT) return(FunctionResult(false, RESULT::FAIL, "Unknown command type in command stream."));
+		if (header.size != CommandSizes[static_cast<std::size_t>(header.type)] || header.size > size - offset)
+			return(FunctionResult(false, RESULT::FAIL, "Invalid command size in command stream."));
+
+		const unsigned char* packet = bytes + offset;
+		switch (header.type) {
+		case CommandType::CLEAR_DEPTH_STENCIL: {
+			ClearDepthStencilCommand command;
+			std::memcpy(&command, packet, sizeof(command));
+			if (command.clearDepth > 1 || command.clearStencil > 1) return(FunctionResult(false, RESULT::FAIL, "Invalid clear flags in command stream."));
+			break;
+		}
+		case CommandType::SET_RENDER_TARGETS: {
+			SetRenderTargetsCommand command;
+			std::memcpy(&command, packet, sizeof(command));
+			if (command.count > MaxCommandRenderTargets) return(FunctionResult(false, RESULT::FAIL, "Too many render targets in command stream."));
+			break;
+		}
+		case CommandType::SET_VERTEX_BUFFER: {
+			SetVertexBufferCommand command;
+			std::memcpy(&command, packet, sizeof(command));
+			if (command.slot >= MaxCommandVertexBuffers) return(FunctionResult(false, RESULT::FAIL, "Invalid vertex buffer slot in command stream."));
+			break;
+		}
+		case CommandType::SET_INDEX_BUFFER: {
+			SetIndexBufferCommand command;
+			std::memcpy(&command, packet, sizeof(command));
+			if (command.indexSize != 2 && command.indexSize != 4) return(FunctionResult(false, RESULT::FAIL, "Invalid index size in command stream."));
+			break;
+		}
+		case CommandType::BARRIER: {
+			BarrierCommand command;
+			std::memcpy(&command, packet, sizeof(command));
+			if (command.before > ResourceState::INDIRECT_ARGUMENT || command.after > ResourceState::INDIRECT_ARGUMENT)
+				return(FunctionResult(false, RESULT::FAIL, "Invalid resource state in command stream."));
+			break;
+		}
+		default:
+			break;
+		}
+
+		offset += header.size;
+		++count;
+	}
+
+	mData.assign(bytes, bytes + size);
+	mCommandCount = count;
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Command stream loaded."));
+}
+
+/** Empties the stream while keeping its memory for the next recording. */
+void SyrenEngine::CommandStream::reset() {
+	mData.clear();
+	mCommandCount = 0;
+}
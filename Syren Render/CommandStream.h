@@ -0,0 +1,266 @@
+/***********************************************************************************************************
+ * @file CommandStream.h
+ *
+ * @brief Declares the backend-neutral recorded command stream
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Client threads record draw, dispatch, state, barrier and copy packets into their own CommandStream.
+ * A stream is a single linear block of POD packets, each starting with a CommandHeader and padded to
+ * CommandAlignment bytes. Recording is a bounds check and a copy, and a stream can be appended to
+ * another stream, written to disk and loaded back without any fix-ups. Backends replay a stream with
+ * replayCommandStream(), which walks the packets in one loop and dispatches on the packet type.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "common.h"
+
+
+namespace SyrenEngine {
+	typedef std::uint32_t ResourceId;
+	typedef std::uint32_t PipelineId;
+
+	static const ResourceId NullResource = 0;
+	static const ResourceId BackBufferResource = 0xFFFFFFFFu;   /*!< Current back buffer or offscreen colour target */
+	static const ResourceId DepthStencilResource = 0xFFFFFFFEu; /*!< Depth stencil buffer of the frame */
+	static const ResourceId UploadRingResource = 0xFFFFFFFDu;   /*!< Upload ring of the frame, addressed by allocation offset */
+
+	static const std::size_t CommandAlignment = 8;
+	static const std::uint32_t MaxCommandRenderTargets = 8;
+	static const std::uint32_t MaxCommandVertexBuffers = 16; /*!< Vertex buffer slots every backend supports */
+
+	enum class CommandType : std::uint16_t {
+		CLEAR_RENDER_TARGET, CLEAR_DEPTH_STENCIL, SET_VIEWPORT, SET_SCISSOR, SET_RENDER_TARGETS,
+		SET_PIPELINE, SET_VERTEX_BUFFER, SET_INDEX_BUFFER, DRAW, DRAW_INDEXED, DISPATCH, BARRIER,
+		COPY_BUFFER, COPY_TEXTURE, COUNT
+	};
+
+	struct CommandHeader {
+		CommandType type;
+		std::uint16_t size; /*!< Size of the whole packet including the header and padding */
+	};
+
+	struct ClearRenderTargetCommand {
+		static const CommandType Type = CommandType::CLEAR_RENDER_TARGET;
+		CommandHeader header;
+		ResourceId target;
+		float color[4];
+	};
+
+	struct ClearDepthStencilCommand {
+		static const CommandType Type = CommandType::CLEAR_DEPTH_STENCIL;
+		CommandHeader header;
+		ResourceId target;
+		float depth;
+		std::uint8_t stencil;
+		std::uint8_t clearDepth;
+		std::uint8_t clearStencil;
+	};
+
+	struct SetViewportCommand {
+		static const CommandType Type = CommandType::SET_VIEWPORT;
+		CommandHeader header;
+		float x, y, width, height, minDepth, maxDepth;
+	};
+
+	struct SetScissorCommand {
+		static const CommandType Type = CommandType::SET_SCISSOR;
+		CommandHeader header;
+		std::int32_t left, top, right, bottom;
+	};
+
+	struct SetRenderTargetsCommand {
+		static const CommandType Type = CommandType::SET_RENDER_TARGETS;
+		CommandHeader header;
+		std::uint32_t count;
+		ResourceId colors[MaxCommandRenderTargets];
+		ResourceId depthStencil;
+	};
+
+	struct SetPipelineCommand {
+		static const CommandType Type = CommandType::SET_PIPELINE;
+		CommandHeader header;
+		PipelineId pipeline;
+	};
+
+	struct SetVertexBufferCommand {
+		static const CommandType Type = CommandType::SET_VERTEX_BUFFER;
+		CommandHeader header;
+		std::uint32_t slot;
+		ResourceId buffer;
+		std::uint32_t offset;
+		std::uint32_t size;
+		std::uint32_t stride;
+	};
+
+	struct SetIndexBufferCommand {
+		static const CommandType Type = CommandType::SET_INDEX_BUFFER;
+		CommandHeader header;
+		ResourceId buffer;
+		std::uint32_t offset;
+		std::uint32_t size;
+		std::uint32_t indexSize; /*!< 2 or 4 bytes */
+	};
+
+	struct DrawCommand {
+		static const CommandType Type = CommandType::DRAW;
+		CommandHeader header;
+		std::uint32_t vertexCount;
+		std::uint32_t instanceCount;
+		std::uint32_t firstVertex;
+		std::uint32_t firstInstance;
+	};
+
+	struct DrawIndexedCommand {
+		static const CommandType Type = CommandType::DRAW_INDEXED;
+		CommandHeader header;
+		std::uint32_t indexCount;
+		std::uint32_t instanceCount;
+		std::uint32_t firstIndex;
+		std::int32_t baseVertex;
+		std::uint32_t firstInstance;
+	};
+
+	struct DispatchCommand {
+		static const CommandType Type = CommandType::DISPATCH;
+		CommandHeader header;
+		std::uint32_t groupsX, groupsY, groupsZ;
+	};
+
+	struct BarrierCommand {
+		static const CommandType Type = CommandType::BARRIER;
+		CommandHeader header;
+		ResourceId resource;
+		ResourceState before;
+		ResourceState after;
+	};
+
+	struct CopyBufferCommand {
+		static const CommandType Type = CommandType::COPY_BUFFER;
+		CommandHeader header;
+		ResourceId destination;
+		ResourceId source;
+		std::uint64_t destinationOffset;
+		std::uint64_t sourceOffset;
+		std::uint64_t size;
+	};
+
+	struct CopyTextureCommand {
+		static const CommandType Type = CommandType::COPY_TEXTURE;
+		CommandHeader header;
+		ResourceId destination;
+		ResourceId source;
+	};
+
+	class CommandStream {
+	private:
+		std::vector<unsigned char> mData;
+		std::uint32_t mCommandCount = 0;
+
+	public:
+		CommandStream() = default;
+		explicit CommandStream(std::size_t reserveBytes) { mData.reserve(reserveBytes); }
+
+		/** Appends a zero initialised packet to the stream and returns it for filling in.
+		 *
+		 * @details
+		 * The reference stays valid until the next packet is recorded.
+		 */
+		template<typename Command>
+		Command& push() {
+			static_assert(std::is_trivially_copyable<Command>::value, "Command packets must be POD.");
+			static_assert(offsetof(Command, header) == 0, "Command packets must start with their header.");
+
+			const std::size_t size = paddedSize(sizeof(Command));
+			const std::size_t offset = mData.size();
+			mData.resize(offset + size);
+
+			Command* command = reinterpret_cast<Command*>(mData.data() + offset);
+			command->header.type = Command::Type;
+			command->header.size = static_cast<std::uint16_t>(size);
+			++mCommandCount;
+
+			return *command;
+		}
+
+		void clearRenderTarget(ResourceId target, const float color[4]);
+		void clearDepthStencil(ResourceId target, float depth, std::uint8_t stencil, bool clearDepth = true, bool clearStencil = true);
+		void setViewport(float x, float y, float width, float height, float minDepth = 0.0f, float maxDepth = 1.0f);
+		void setScissor(std::int32_t left, std::int32_t top, std::int32_t right, std::int32_t bottom);
+		void setRenderTargets(std::uint32_t count, const ResourceId* colors, ResourceId depthStencil);
+		void setPipeline(PipelineId pipeline);
+		void setVertexBuffer(std::uint32_t slot, ResourceId buffer, std::uint32_t offset, std::uint32_t size, std::uint32_t stride);
+		void setIndexBuffer(ResourceId buffer, std::uint32_t offset, std::uint32_t size, std::uint32_t indexSize);
+		void draw(std::uint32_t vertexCount, std::uint32_t instanceCount = 1, std::uint32_t firstVertex = 0, std::uint32_t firstInstance = 0);
+		void drawIndexed(std::uint32_t indexCount, std::uint32_t instanceCount = 1, std::uint32_t firstIndex = 0, std::int32_t baseVertex = 0, std::uint32_t firstInstance = 0);
+		void dispatch(std::uint32_t groupsX, std::uint32_t groupsY, std::uint32_t groupsZ);
+		void barrier(ResourceId resource, ResourceState before, ResourceState after);
+		void copyBuffer(ResourceId destination, std::uint64_t destinationOffset, ResourceId source, std::uint64_t sourceOffset, std::uint64_t size);
+		void copyTexture(ResourceId destination, ResourceId source);
+
+		void append(const CommandStream& stream);
+		FunctionResult load(const void* data, std::size_t size);
+		void reset();
+
+		const unsigned char* data() const { return mData.data(); }
+		std::size_t size() const { return mData.size(); }
+		std::uint32_t commandCount() const { return mCommandCount; }
+		bool empty() const { return mData.empty(); }
+
+		static constexpr std::size_t paddedSize(std::size_t size) {
+			return((size + CommandAlignment - 1) & ~(CommandAlignment - 1));
+		}
+	};
+
+	/** Replays a command stream through a backend executor.
+	 *
+	 * @details
+	 * The executor provides an execute() overload for every packet type. Dispatch is resolved at
+	 * compile time, so replay is a single loop over the linear packet memory.
+	 *
+	 * @param[in] stream: Stream to replay.
+	 * @param[in] executor: Backend object translating packets into API calls.
+	 */
+	template<typename Executor>
+	void replayCommandStream(const CommandStream& stream, Executor& executor) {
+		const unsigned char* cursor = stream.data();
+		const unsigned char* end = cursor + stream.size();
+
+		while (cursor < end) {
+			const CommandHeader* header = reinterpret_cast<const CommandHeader*>(cursor);
+
+			switch (header->type) {
+			case CommandType::CLEAR_RENDER_TARGET: executor.execute(*reinterpret_cast<const ClearRenderTargetCommand*>(cursor)); break;
+			case CommandType::CLEAR_DEPTH_STENCIL: executor.execute(*reinterpret_cast<const ClearDepthStencilCommand*>(cursor)); break;
+			case CommandType::SET_VIEWPORT: executor.execute(*reinterpret_cast<const SetViewportCommand*>(cursor)); break;
+			case CommandType::SET_SCISSOR: executor.execute(*reinterpret_cast<const SetScissorCommand*>(cursor)); break;
+			case CommandType::SET_RENDER_TARGETS: executor.execute(*reinterpret_cast<const SetRenderTargetsCommand*>(cursor)); break;
+			case CommandType::SET_PIPELINE: executor.execute(*reinterpret_cast<const SetPipelineCommand*>(cursor)); break;
+			case CommandType::SET_VERTEX_BUFFER: executor.execute(*reinterpret_cast<const SetVertexBufferCommand*>(cursor)); break;
+			case CommandType::SET_INDEX_BUFFER: executor.execute(*reinterpret_cast<const SetIndexBufferCommand*>(cursor)); break;
+			case CommandType::DRAW: executor.execute(*reinterpret_cast<const DrawCommand*>(cursor)); break;
+			case CommandType::DRAW_INDEXED: executor.execute(*reinterpret_cast<const DrawIndexedCommand*>(cursor)); break;
+			case CommandType::DISPATCH: executor.execute(*reinterpret_cast<const DispatchCommand*>(cursor)); break;
+			case CommandType::BARRIER: executor.execute(*reinterpret_cast<const BarrierCommand*>(cursor)); break;
+			case CommandType::COPY_BUFFER: executor.execute(*reinterpret_cast<const CopyBufferCommand*>(cursor)); break;
+			case CommandType::COPY_TEXTURE: executor.execute(*reinterpret_cast<const CopyTextureCommand*>(cursor)); break;
+			default: break;
+			}
+
+			cursor += header->size;
+		}
+	}
+}
@@ -0,0 +1,133 @@
+/***********************************************************************************************************
+ * @file CpuCopyBackend.cpp
+ *
+ * @brief Implements functions of the CpuCopyBackend class found in CpuCopyBackend.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "CpuCopyBackend.h"
+
+#include <cstring>
+#include <utility>
+
+
+/** Constructor for the CpuCopyBackend class.
+ *
+ * @param[in] pStagingSize: Size of the staging memory.
+ */
+SyrenEngine::CpuCopyBackend::CpuCopyBackend(std::uint64_t pStagingSize) : mStaging(static_cast<std::size_t>(pStagingSize)), mQueue(std::make_unique<WorkerPool>(1)) {}
+
+/** Destructor for the CpuCopyBackend class.
+ *
+ * @details
+ * Joins the worker thread, which runs every batch that was submitted before returning.
+ */
+SyrenEngine::CpuCopyBackend::~CpuCopyBackend() {
+	mQueue.reset();
+}
+
+SyrenEngine::Timeline* SyrenEngine::CpuCopyBackend::timeline() {
+	return &mTimeline;
+}
+
+void* SyrenEngine::CpuCopyBackend::stagingMemory() {
+	return mStaging.data();
+}
+
+std::uint64_t SyrenEngine::CpuCopyBackend::stagingSize() const {
+	return mStaging.size();
+}
+
+/** Adds up the padded subresources of a texture upload, each placed at a TextureStagingAlignment boundary. */
+std::uint64_t SyrenEngine::CpuCopyBackend::textureStagingSize(const TextureUpload& upload) {
+	const CpuCopyTexture* texture = static_cast<const CpuCopyTexture*>(upload.destination);
+
+	std::uint64_t size = 0;
+	for (std::uint32_t i = 0; i < upload.subresourceCount; ++i) {
+		const CpuCopySubresource& subresource = texture->subresources[upload.firstSubresource + i];
+		size = (size + TextureStagingAlignment - 1) & ~(TextureStagingAlignment - 1);
+		size += stagedRowPitch(subresource) * subresource.rowCount * subresource.depth;
+	}
+	return size;
+}
+
+SyrenEngine::FunctionResult SyrenEngine::CpuCopyBackend::copyBuffer(const BufferUpload& upload, const UploadAllocation& staging) {
+	mRecorded.push_back(Copy{ upload.destination, upload.destinationOffset, staging.offset, upload.size, 0, 0 });
+	return(FunctionResult(true, RESULT::SSUCCESS, "Buffer copy recorded."));
+}
+
+/** Writes the rows of every subresource into the staging memory at their padded pitch and records the copy. */
+SyrenEngine::FunctionResult SyrenEngine::CpuCopyBackend::copyTexture(const TextureUpload& upload, const UploadAllocation& staging) {
+	const CpuCopyTexture* texture = static_cast<const CpuCopyTexture*>(upload.destination);
+	if (upload.firstSubresource + upload.subresourceCount > texture->subresourceCount)
+		return(FunctionResult(false, RESULT::FAIL, "Texture upload is out of the destination's subresource range."));
+
+	std::uint64_t offset = 0;
+	for (std::uint32_t i = 0; i < upload.subresourceCount; ++i) {
+		const CpuCopySubresource& subresource = texture->subresources[upload.firstSubresource + i];
+		const TextureSubresourceData& source = upload.subresources[i];
+		const std::uint64_t rowPitch = stagedRowPitch(subresource);
+
+		offset = (offset + TextureStagingAlignment - 1) & ~(TextureStagingAlignment - 1);
+		for (std::uint32_t z = 0; z < subresource.depth; ++z) {
+			const unsigned char* slice = static_cast<const unsigned char*>(source.data) + source.slicePitch * z;
+			for (std::uint32_t y = 0; y < subresource.rowCount; ++y) {
+				std::memcpy(staging.cpuAddress + offset, slice + source.rowPitch * y, static_cast<std::size_t>(subresource.rowSize));
+				offset += rowPitch;
+			}
+		}
+	}
+
+	mRecorded.push_back(Copy{ upload.destination, 0, staging.offset, staging.size, upload.firstSubresource, upload.subresourceCount });
+	return(FunctionResult(true, RESULT::SSUCCESS, "Texture copy recorded."));
+}
+
+/** Hands the recorded copies to the worker thread and reserves the value it completes afterwards. */
+SyrenEngine::FunctionResult SyrenEngine::CpuCopyBackend::submit(std::uint64_t& fenceValue) {
+	fenceValue = mTimeline.reserve();
+
+	mQueue->enqueue([this, copies = std::move(mRecorded), fenceValue]() {
+		execute(copies);
+		mTimeline.complete(fenceValue);
+	});
+	mRecorded.clear();
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Copy batch submitted."));
+}
+
+/** Performs a batch of copies from the staging memory into their destinations. */
+void SyrenEngine::CpuCopyBackend::execute(const std::vector<Copy>& copies) {
+	for (const Copy& copy : copies) {
+		const unsigned char* staged = mStaging.data() + copy.stagingOffset;
+
+		if (copy.subresourceCount == 0) {
+			std::memcpy(static_cast<unsigned char*>(copy.destination) + copy.destinationOffset, staged, static_cast<std::size_t>(copy.size));
+			continue;
+		}
+
+		const CpuCopyTexture* texture = static_cast<const CpuCopyTexture*>(copy.destination);
+		std::uint64_t offset = 0;
+		for (std::uint32_t i = 0; i < copy.subresourceCount; ++i) {
+			const CpuCopySubresource& subresource = texture->subresources[copy.firstSubresource + i];
+			const std::uint64_t rowPitch = stagedRowPitch(subresource);
+
+			offset = (offset + TextureStagingAlignment - 1) & ~(TextureStagingAlignment - 1);
+			unsigned char* destination = subresource.data;
+			for (std::uint32_t row = 0; row < subresource.rowCount * subresource.depth; ++row) {
+				std::memcpy(destination, staged + offset, static_cast<std::size_t>(subresource.rowSize));
+				destination += subresource.rowSize;
+				offset += rowPitch;
+			}
+		}
+	}
+}
+
+std::uint64_t SyrenEngine::CpuCopyBackend::stagedRowPitch(const CpuCopySubresource& subresource) {
+	return((subresource.rowSize + TextureStagingRowAlignment - 1) & ~(TextureStagingRowAlignment - 1));
+}
@@ -0,0 +1,86 @@
+/***********************************************************************************************************
+ * @file CpuCopyBackend.h
+ *
+ * @brief Declares a copy backend that performs uploads into plain memory on a worker thread
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The backend behaves like a copy queue: submitted batches are executed in order on a single worker
+ * thread while the caller keeps recording, and each batch completes a CpuTimeline value. Textures are
+ * staged with the same 256 byte row pitch and 512 byte placement alignment as D3D12 footprints, so the
+ * UploadBatcher sees the staging sizes and ring pressure it would see on a GPU. It backs uploads for
+ * the software rasteriser and lets the batching logic run without a device.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "CpuTimeline.h"
+#include "UploadBatcher.h"
+#include "WorkerPool.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	static const std::uint64_t TextureStagingRowAlignment = 256; /*!< Row pitch alignment of staged texture data */
+
+	/** One subresource of a CpuCopyTexture, rows tightly packed. */
+	struct CpuCopySubresource {
+		unsigned char* data = nullptr;
+		std::uint64_t rowSize = 0;
+		std::uint32_t rowCount = 0;
+		std::uint32_t depth = 1;
+	};
+
+	/** Destination of a texture upload on the CPU copy backend. */
+	struct CpuCopyTexture {
+		CpuCopySubresource* subresources = nullptr;
+		std::uint32_t subresourceCount = 0;
+	};
+
+	class CpuCopyBackend : public CopyBackend {
+	private:
+		/** A recorded copy; buffer destinations are plain memory, texture destinations CpuCopyTextures. */
+		struct Copy {
+			void* destination;
+			std::uint64_t destinationOffset;
+			std::uint64_t stagingOffset;
+			std::uint64_t size;
+			std::uint32_t firstSubresource;
+			std::uint32_t subresourceCount; /*!< 0 for buffer copies */
+		};
+
+		CpuTimeline mTimeline;
+		std::vector<unsigned char> mStaging;
+		std::vector<Copy> mRecorded;
+		std::unique_ptr<WorkerPool> mQueue; /*!< One thread, so batches complete in submission order */
+	public:
+		explicit CpuCopyBackend(std::uint64_t pStagingSize = DefaultUploadRingSize);
+		~CpuCopyBackend();
+
+		virtual Timeline* timeline();
+		virtual void* stagingMemory();
+		virtual std::uint64_t stagingSize() const;
+		virtual std::uint64_t textureStagingSize(const TextureUpload& upload);
+		virtual FunctionResult copyBuffer(const BufferUpload& upload, const UploadAllocation& staging);
+		virtual FunctionResult copyTexture(const TextureUpload& upload, const UploadAllocation& staging);
+		virtual FunctionResult submit(std::uint64_t& fenceValue);
+	private:
+		CpuCopyBackend() = delete;
+		CpuCopyBackend(const CpuCopyBackend& rhs) = delete;
+		CpuCopyBackend& operator=(const CpuCopyBackend& rhs) = delete;
+
+		void execute(const std::vector<Copy>& copies);
+		static std::uint64_t stagedRowPitch(const CpuCopySubresource& subresource);
+	};
+}
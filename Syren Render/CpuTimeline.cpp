@@ -0,0 +1,82 @@
+/***********************************************************************************************************
+ * @file CpuTimeline.cpp
+ *
+ * @brief Implements functions of the CpuTimeline class found in CpuTimeline.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "CpuTimeline.h"
+
+
+/** Constructor for the CpuTimeline class. */
+SyrenEngine::CpuTimeline::CpuTimeline() : mLastSignaledValue(0), mCompletedValue(0) {}
+
+/** Reserves the next value and completes it immediately.
+ *
+ * @details
+ * Work on the calling thread has already finished by the time it signals, so there is nothing left
+ * to wait for.
+ *
+ * @param[out] value: The value that was reached.
+ */
+SyrenEngine::FunctionResult SyrenEngine::CpuTimeline::signal(std::uint64_t& value) {
+	value = reserve();
+	complete(value);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Signalled the timeline."));
+}
+
+/** Blocks until the timeline reaches the given value.
+ *
+ * @param[in] value: Value to wait for.
+ */
+SyrenEngine::FunctionResult SyrenEngine::CpuTimeline::waitForValue(std::uint64_t value) {
+	if (value > mLastSignaledValue.load(std::memory_order_acquire))
+		return(FunctionResult(false, RESULT::FAIL, "Cannot wait for a timeline value that has not been signalled."));
+
+	std::uint64_t current = mCompletedValue.load(std::memory_order_acquire);
+	while (current < value) {
+		mCompletedValue.wait(current, std::memory_order_acquire);
+		current = mCompletedValue.load(std::memory_order_acquire);
+	}
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Timeline value reached."));
+}
+
+std::uint64_t SyrenEngine::CpuTimeline::completedValue() {
+	return mCompletedValue.load(std::memory_order_acquire);
+}
+
+bool SyrenEngine::CpuTimeline::isComplete(std::uint64_t value) {
+	return(value <= mCompletedValue.load(std::memory_order_acquire));
+}
+
+std::uint64_t SyrenEngine::CpuTimeline::lastSignaledValue() const {
+	return mLastSignaledValue.load(std::memory_order_acquire);
+}
+
+/** Hands out the next timeline value without completing it.
+ *
+ * @details
+ * Used when the work behind the value is performed asynchronously, e.g. by a worker thread that
+ * calls complete() once it is done.
+ */
+std::uint64_t SyrenEngine::CpuTimeline::reserve() {
+	return(mLastSignaledValue.fetch_add(1, std::memory_order_acq_rel) + 1);
+}
+
+/** Marks a value, and therefore every value before it, as complete and wakes all waiters.
+ *
+ * @param[in] value: Value that has been reached.
+ */
+void SyrenEngine::CpuTimeline::complete(std::uint64_t value) {
+	std::uint64_t current = mCompletedValue.load(std::memory_order_relaxed);
+	while (current < value && !mCompletedValue.compare_exchange_weak(current, value, std::memory_order_release, std::memory_order_relaxed));
+
+	mCompletedValue.notify_all();
+}
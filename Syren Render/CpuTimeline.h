@@ -0,0 +1,49 @@
+/***********************************************************************************************************
+ * @file CpuTimeline.h
+ *
+ * @brief Implements the Timeline interface for work that completes on CPU threads
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The completed value is a single atomic counter. Waiters block through std::atomic::wait, which maps
+ * onto a futex on Linux and WaitOnAddress on Windows, so no wait object is ever created or destroyed.
+ * Backends without a GPU complete values from their worker threads, and the same class stands in for
+ * a GPU fence wherever the synchronisation logic has to run without a device.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "Timeline.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	class CpuTimeline : public Timeline {
+	private:
+		std::atomic<std::uint64_t> mLastSignaledValue;
+		std::atomic<std::uint64_t> mCompletedValue;
+	public:
+		CpuTimeline();
+
+		virtual FunctionResult signal(std::uint64_t& value);
+		virtual FunctionResult waitForValue(std::uint64_t value);
+		virtual std::uint64_t completedValue();
+		virtual bool isComplete(std::uint64_t value);
+		virtual std::uint64_t lastSignaledValue() const;
+
+		std::uint64_t reserve();
+		void complete(std::uint64_t value);
+	private:
+		CpuTimeline(const CpuTimeline& rhs) = delete;
+		CpuTimeline& operator=(const CpuTimeline& rhs) = delete;
+	};
+}
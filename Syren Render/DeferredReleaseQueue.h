@@ -0,0 +1,212 @@
+/***********************************************************************************************************
+ * @file DeferredReleaseQueue.h
+ *
+ * @brief Declares a lock-free queue that destroys objects once the GPU can no longer use them
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Objects that may still be referenced by submitted or recording work are retired together with the
+ * timeline value of the last submission that can use them, instead of waiting for the queue to drain.
+ * Any thread may retire objects; retiring pushes a node onto an atomic list with a single compare and
+ * swap. One consumer thread, normally the render thread once per frame, detaches the whole list, polls
+ * the timeline once and releases every object whose value has completed in one go.
+ *
+ * Producers may stamp values out of order, so the consumer keeps the objects that are not yet complete
+ * in a private list and checks all of them on every collect. The list only ever holds the objects of
+ * the frames in flight, which keeps the walk short.
+ *
+ * Nodes come from a pool that only grows, in blocks twice the size of the one before, and released
+ * nodes go back onto a free list rather than to the heap. Once the pool holds as many nodes as the
+ * frames in flight retire, retiring and collecting no longer allocate. The free list is popped by any
+ * producer, so its head carries a tag that every change advances, which stops a producer whose node
+ * was taken and returned meanwhile from swapping in a stale successor.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include "Timeline.h"
+
+
+namespace SyrenEngine {
+	template<typename T>
+	class DeferredReleaseQueue {
+	private:
+		static const std::uint32_t InvalidNode = 0xFFFFFFFFu;
+		static const std::uint32_t FirstBlockSize = 64;
+		static const std::uint32_t MaxBlocks = 25; /*!< Keeps every node index below InvalidNode */
+
+		struct Node {
+			std::uint64_t fenceValue = 0;
+			std::optional<T> object;
+			Node* next = nullptr;
+			std::uint32_t index = InvalidNode;
+			std::atomic<std::uint32_t> nextFree { InvalidNode };
+		};
+
+		Timeline* mTimeline;
+		std::atomic<Node*> mIncoming;       /*!< Objects retired since the last collect, newest first */
+		std::atomic<std::size_t> mSize;
+		Node* mPending = nullptr;           /*!< Objects the consumer is still waiting on */
+
+		std::atomic<std::uint64_t> mFree;   /*!< Index of the first free node in the low half, tag in the high half */
+		std::atomic<Node*> mBlocks[MaxBlocks] = {};
+		std::uint32_t mBlockCount = 0;
+		std::mutex mGrowMutex;
+
+	public:
+		explicit DeferredReleaseQueue(Timeline* pTimeline = nullptr) : mTimeline(pTimeline), mIncoming(nullptr), mSize(0), mFree(InvalidNode) {};
+		~DeferredReleaseQueue() {
+			for (std::uint32_t block = 0; block < mBlockCount; ++block)
+				delete[] mBlocks[block].load(std::memory_order_relaxed);
+		}
+
+		/** Sets the timeline retired values refer to. Must be called before anything is retired. */
+		void initialise(Timeline* pTimeline) { mTimeline = pTimeline; }
+
+		/** Hands an object over for release. May be called from any thread.
+		 *
+		 * @param[in] object: Object to release.
+		 * @param[in] fenceValue: Timeline value of the last submission that can use the object.
+		 */
+		void retire(T object, std::uint64_t fenceValue) {
+			Node* node = takeNode();
+			node->fenceValue = fenceValue;
+			node->object.emplace(std::move(object));
+			node->next = mIncoming.load(std::memory_order_relaxed);
+			while (!mIncoming.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+			mSize.fetch_add(1, std::memory_order_relaxed);
+		}
+		/** Releases every object whose timeline value has completed. Only one thread may collect.
+		 *
+		 * @param[in] release: Called with each released object before it is destroyed.
+		 *
+		 * @retval Number of objects released.
+		 */
+		template<typename Release>
+		std::size_t collect(Release&& release) {
+			adopt();
+			if (!mPending) return 0;
+
+			const std::uint64_t completed = mTimeline->completedValue();
+			return(releaseWhere(release, [completed](std::uint64_t fenceValue) { return(fenceValue <= completed); }));
+		}
+
+		/** Releases every object regardless of its value. The caller must have waited for the GPU. */
+		template<typename Release>
+		std::size_t drain(Release&& release) {
+			adopt();
+			return(releaseWhere(release, [](std::uint64_t) { return true; }));
+		}
+
+		std::size_t size() const { return mSize.load(std::memory_order_relaxed); }
+	private:
+		DeferredReleaseQueue(const DeferredReleaseQueue& rhs) = delete;
+		DeferredReleaseQueue& operator=(const DeferredReleaseQueue& rhs) = delete;
+
+		/** Moves the objects retired since the last call onto the private list. */
+		void adopt() {
+			Node* incoming = mIncoming.exchange(nullptr, std::memory_order_acquire);
+			while (incoming) {
+				Node* next = incoming->next;
+				incoming->next = mPending;
+				mPending = incoming;
+				incoming = next;
+			}
+		}
+
+		template<typename Release, typename Predicate>
+		std::size_t releaseWhere(Release& release, Predicate isReleasable) {
+			std::size_t count = 0;
+			Node* firstReleased = nullptr;
+			Node* lastReleased = nullptr;
+			Node** link = &mPending;
+			while (*link) {
+				Node* node = *link;
+				if (!isReleasable(node->fenceValue)) {
+					link = &node->next;
+					continue;
+				}
+
+				*link = node->next;
+				release(*node->object);
+				node->object.reset();
+
+				node->nextFree.store(firstReleased ? firstReleased->index : InvalidNode, std::memory_order_relaxed);
+				if (!lastReleased) lastReleased = node;
+				firstReleased = node;
+				++count;
+			}
+
+			if (firstReleased) pushFree(firstReleased, lastReleased);
+			mSize.fetch_sub(count, std::memory_order_relaxed);
+			return count;
+		}
+
+		static std::uint32_t headIndex(std::uint64_t head) { return static_cast<std::uint32_t>(head); }
+		static std::uint64_t nextHead(std::uint64_t head, std::uint32_t index) { return(((head >> 32) + 1) << 32 | index); }
+
+		Node* nodeAt(std::uint32_t index) const {
+			const std::uint32_t block = static_cast<std::uint32_t>(std::bit_width(index / FirstBlockSize + 1)) - 1;
+			const std::uint32_t blockStart = FirstBlockSize * ((1u << block) - 1);
+			return(mBlocks[block].load(std::memory_order_acquire) + (index - blockStart));
+		}
+
+		/** Pops a free node, or returns nullptr if there is none. */
+		Node* popFree() {
+			std::uint64_t head = mFree.load(std::memory_order_acquire);
+			while (headIndex(head) != InvalidNode) {
+				Node* node = nodeAt(headIndex(head));
+				const std::uint64_t next = nextHead(head, node->nextFree.load(std::memory_order_relaxed));
+				if (mFree.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) return node;
+			}
+			return nullptr;
+		}
+
+		/** Pushes a chain of nodes, already linked through nextFree, onto the free list. */
+		void pushFree(Node* first, Node* last) {
+			std::uint64_t head = mFree.load(std::memory_order_relaxed);
+			do {
+				last->nextFree.store(headIndex(head), std::memory_order_relaxed);
+			} while (!mFree.compare_exchange_weak(head, nextHead(head, first->index), std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		/** Takes a free node, adding a block to the pool if every node is in use. */
+		Node* takeNode() {
+			if (Node* node = popFree()) return node;
+
+			std::lock_guard<std::mutex> lock(mGrowMutex);
+			// Another producer may have grown the pool while this one waited
+			if (Node* node = popFree()) return node;
+			if (mBlockCount == MaxBlocks) throw std::bad_alloc();
+
+			const std::uint32_t blockSize = FirstBlockSize << mBlockCount;
+			const std::uint32_t blockStart = FirstBlockSize * ((1u << mBlockCount) - 1);
+			Node* block = new Node[blockSize];
+			for (std::uint32_t i = 0; i < blockSize; ++i) {
+				block[i].index = blockStart + i;
+				block[i].nextFree.store(blockStart + i + 1, std::memory_order_relaxed);
+			}
+			mBlocks[mBlockCount].store(block, std::memory_order_release);
+			++mBlockCount;
+
+			// The first node goes to the caller, the rest become free
+			pushFree(&block[1], &block[blockSize - 1]);
+			return &block[0];
+		}
+	};
+}
@@ -0,0 +1,104 @@
+/***********************************************************************************************************
+ * @file DescriptorAllocator.cpp
+ *
+ * @brief Implements functions of the DescriptorFreeList and DescriptorRing classes found in DescriptorAllocator.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "DescriptorAllocator.h"
+
+
+/** Constructor for the DescriptorFreeList class. */
+SyrenEngine::DescriptorFreeList::DescriptorFreeList() : mHead(InvalidDescriptor), mAllocatedCount(0) {}
+
+/** Makes every index free. No other thread may use the list while it is initialised.
+ *
+ * @param[in] capacity: Number of descriptors in the heap.
+ */
+void SyrenEngine::DescriptorFreeList::initialise(std::uint32_t capacity) {
+	mNext = std::make_unique<std::atomic<DescriptorIndex>[]>(capacity);
+	for (std::uint32_t i = 0; i < capacity; ++i)
+		mNext[i].store(i + 1 < capacity ? i + 1 : InvalidDescriptor, std::memory_order_relaxed);
+
+	mCapacity = capacity;
+	mAllocatedCount.store(0, std::memory_order_relaxed);
+	mHead.store(capacity > 0 ? 0 : InvalidDescriptor, std::memory_order_release);
+}
+
+/** Pops a free index.
+ *
+ * @param[out] index: The index handed out.
+ *
+ * @retval False if the heap is full.
+ */
+bool SyrenEngine::DescriptorFreeList::allocate(DescriptorIndex& index) {
+	std::uint64_t head = mHead.load(std::memory_order_acquire);
+	for (;;) {
+		const DescriptorIndex first = static_cast<DescriptorIndex>(head);
+		if (first == InvalidDescriptor) return false;
+
+		const std::uint64_t tag = (head >> 32) + 1;
+		const std::uint64_t next = (tag << 32) | mNext[first].load(std::memory_order_relaxed);
+		if (mHead.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+			index = first;
+			break;
+		}
+	}
+
+	mAllocatedCount.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+/** Pushes an index back onto the free list and invalidates the caller's copy. */
+void SyrenEngine::DescriptorFreeList::free(DescriptorIndex& index) {
+	if (index == InvalidDescriptor) return;
+
+	std::uint64_t head = mHead.load(std::memory_order_relaxed);
+	for (;;) {
+		mNext[index].store(static_cast<DescriptorIndex>(head), std::memory_order_relaxed);
+
+		const std::uint64_t tag = (head >> 32) + 1;
+		if (mHead.compare_exchange_weak(head, (tag << 32) | index, std::memory_order_release, std::memory_order_relaxed)) break;
+	}
+
+	mAllocatedCount.fetch_sub(1, std::memory_order_relaxed);
+	index = InvalidDescriptor;
+}
+
+/** Constructor for the DescriptorRing class. */
+SyrenEngine::DescriptorRing::DescriptorRing() : mCursor(0) {}
+
+/** Splits the heap into one segment per frame in flight.
+ *
+ * @param[in] capacity: Number of descriptors in the heap.
+ * @param[in] frameCount: Number of frames that may be in flight at once.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DescriptorRing::initialise(std::uint32_t capacity, std::size_t frameCount) {
+	if (frameCount == 0 || capacity < frameCount) return(FunctionResult(false, RESULT::FAIL, "Descriptor ring requires at least one descriptor per frame."));
+
+	mCapacity = capacity;
+	mSegmentSize = static_cast<std::uint32_t>(capacity / frameCount);
+	mSegmentStart = 0;
+	mCursor.store(0, std::memory_order_relaxed);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the descriptor ring."));
+}
+
+/** Recycles the segment of a frame slot. Called on the render thread once the slot has been acquired.
+ *
+ * @param[in] frameIndex: Index of the frame slot being recorded.
+ */
+void SyrenEngine::DescriptorRing::beginFrame(std::size_t frameIndex) {
+	mSegmentStart = static_cast<std::uint32_t>(frameIndex) * mSegmentSize;
+	mCursor.store(0, std::memory_order_relaxed);
+}
+
+std::uint32_t SyrenEngine::DescriptorRing::usedCount() const {
+	const std::uint32_t used = mCursor.load(std::memory_order_relaxed);
+	return(used < mSegmentSize ? used : mSegmentSize);
+}
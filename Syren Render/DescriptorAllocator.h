@@ -0,0 +1,99 @@
+/***********************************************************************************************************
+ * @file DescriptorAllocator.h
+ *
+ * @brief Declares the API independent index allocators behind the descriptor heaps
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Descriptor heaps are created once with a fixed size and then only handed out by index.
+ *
+ * A DescriptorFreeList manages a CPU-only staging heap, where views are created and live for as long
+ * as their resource. Free indices form a lock-free stack threaded through a next array; the head
+ * carries a tag that changes with every update, so a thread that was preempted between reading the
+ * head and swapping it cannot resurrect a stale link.
+ *
+ * A DescriptorRing manages a shader visible heap, which is split into one segment per frame in flight.
+ * Descriptor tables are copied into the segment of the frame being recorded with a single atomic add
+ * and the whole segment is recycled when the frame slot comes round again, by which time the frame
+ * ring has already waited for the GPU to finish with it.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "common.h"
+
+
+namespace SyrenEngine {
+	typedef std::uint32_t DescriptorIndex;
+
+	static const DescriptorIndex InvalidDescriptor = 0xFFFFFFFFu;
+
+	class DescriptorFreeList {
+	private:
+		std::unique_ptr<std::atomic<DescriptorIndex>[]> mNext;
+		std::atomic<std::uint64_t> mHead; /*!< Update tag in the high half, first free index in the low half */
+		std::atomic<std::uint32_t> mAllocatedCount;
+		std::uint32_t mCapacity = 0;
+
+	public:
+		DescriptorFreeList();
+
+		void initialise(std::uint32_t capacity);
+
+		bool allocate(DescriptorIndex& index);
+		void free(DescriptorIndex& index);
+
+		std::uint32_t capacity() const { return mCapacity; }
+		std::uint32_t allocatedCount() const { return mAllocatedCount.load(std::memory_order_relaxed); }
+	private:
+		DescriptorFreeList(const DescriptorFreeList& rhs) = delete;
+		DescriptorFreeList& operator=(const DescriptorFreeList& rhs) = delete;
+	};
+
+	class DescriptorRing {
+	private:
+		std::uint32_t mCapacity = 0;
+		std::uint32_t mSegmentSize = 0;
+		std::uint32_t mSegmentStart = 0;
+		std::atomic<std::uint32_t> mCursor; /*!< Descriptors taken from the current segment */
+
+	public:
+		DescriptorRing();
+
+		FunctionResult initialise(std::uint32_t capacity, std::size_t frameCount);
+		void beginFrame(std::size_t frameIndex);
+
+		/** Takes a contiguous range from the segment of the current frame.
+		 *
+		 * @param[in] count: Number of descriptors in the range.
+		 * @param[out] first: Index of the first descriptor of the range.
+		 *
+		 * @retval False if the segment is exhausted.
+		 */
+		bool allocate(std::uint32_t count, DescriptorIndex& first) {
+			const std::uint32_t offset = mCursor.fetch_add(count, std::memory_order_relaxed);
+			if (offset > mSegmentSize || count > mSegmentSize - offset) return false;
+
+			first = mSegmentStart + offset;
+			return true;
+		}
+
+		std::uint32_t capacity() const { return mCapacity; }
+		std::uint32_t segmentSize() const { return mSegmentSize; }
+		std::uint32_t usedCount() const;
+	private:
+		DescriptorRing(const DescriptorRing& rhs) = delete;
+		DescriptorRing& operator=(const DescriptorRing& rhs) = delete;
+	};
+}
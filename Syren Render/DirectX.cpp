@@ -22,6 +22,10 @@
 #include "pch.h"
 #include "DirectX.h"
 
+#include <filesystem>
+
+#include "ScopeGuard.h"
+
 
  /***********************************************************************************************************
   * DirectX entry and exit member functions
@@ -33,13 +37,22 @@
  * @details
  * Initializes member variables. This prepares the DirectX object for further configuration and
  * initialisation.
+ *
+ * @param[in] phMainWnd: Window the swap chain presents to, or nullptr to render headless.
+ * @param[in] pConfig: Graphics configuration providing the swap chain depth, frame latency and frame size.
  */
-SyrenEngine::DirectX::DirectX(HWND phMainWnd) {
+SyrenEngine::DirectX::DirectX(HWND phMainWnd, const GraphicsConfig& pConfig) {
 	mhMainWnd = phMainWnd;
+	mHeadless = pConfig.Headless || phMainWnd == nullptr;
+	mPacing = resolveFramePacing(pConfig);
+	mClientWidth = pConfig.Width > 0 ? pConfig.Width : mClientWidth;
+	mClientHeight = pConfig.Height > 0 ? pConfig.Height : mClientHeight;
+	mPipelineCachePath = pConfig.PipelineCachePath;
+	mShaderArchivePath = pConfig.ShaderArchivePath;
 
 	mFactory = nullptr;
 	md3dDevice = nullptr;
-	mFence = nullptr;
+	mTimeline = nullptr;
 
 	mRtvDescriptorSize = 0;
 	mDsvDescriptorSize = 0;
@@ -48,6 +61,8 @@ SyrenEngine::DirectX::DirectX(HWND phMainWnd) {
 	md3dDriverType = D3D_DRIVER_TYPE_HARDWARE;
 	mBackBufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
 	mDepthStencilFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+
+	mGraph.setAliasingPlanner(&mAliasingPlanner);
 }
 
 /** Destructor for the DirectX class.
@@ -56,9 +71,30 @@ SyrenEngine::DirectX::DirectX(HWND phMainWnd) {
  * Releases the DirectX COM objects if they have been created.
  */
 SyrenEngine::DirectX::~DirectX() {
-	if (md3dDevice != nullptr) {
+	if (md3dDevice != nullptr && mTimeline != nullptr) {
 		flushCommandQueue();
 	}
+
+	// Compile jobs hold on to the cache, and the pipelines they produced may only go once the GPU is idle
+	mPipelines.shutdown();
+	mWorkers.reset();
+	if (mPipelineCache) savePipelineCache();
+	if (mRootSignatures) mRootSignatures->shutdown();
+
+	if (mHeapAllocator) {
+		for (std::size_t i = 0; i < mReadback.slotCount(); ++i)
+			mHeapAllocator->release(mReadback.slot(i).staging.buffer);
+
+		mTransients.clear();
+		mDepthStencilBuffer.Reset();
+		mHeapAllocator->free(mTransientBlock);
+		releaseOffscreenTargets();
+
+		if (mUploadBuffer.resource) mUploadBuffer.resource->Unmap(0, nullptr);
+		mHeapAllocator->release(mUploadBuffer);
+
+		collectReleases(true);
+	}
 	
 	if (mFactory) {
 		mFactory->Release();
@@ -132,17 +168,16 @@ SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseD3D12() {
 /** Initializes the fence for synchronization.
  *
  * @details
- * Creates a fence object that allows for synchronization between the CPU and GPU
- * operations. Returns a result indicating the success or failure of the fence creation.
+ * Creates the timeline that allows for synchronization between the CPU and GPU operations. The
+ * timeline is signalled by the primary command queue, so the command objects must exist first.
+ * Returns a result indicating the success or failure of the fence creation.
  *
  * @retval FunctionResult indicating the success of the fence initialisation.
  */
 SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseFence() {
-	HRESULT hr = md3dDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence));
-
-	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create a fence object."));
-	
-	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created a fence object."));
+	mTimeline = std::make_unique<DirectXTimeline>(md3dDevice.Get(), mCommandQueue.Get());
+	mReleases.initialise(mTimeline.get());
+	return(mTimeline->initialise());
 }
 
 /** Caches the descriptor sizes for various Direct3D 12 object types.
@@ -188,76 +223,444 @@ SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseCommandObjects() {
 	HRESULT hr = md3dDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCommandQueue));
 	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create the primary command queue."));
 
-	hr = md3dDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(mDirectCmdListAlloc.GetAddressOf()));
-	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create a command allocator for the primary command queue."));
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created the primary command queue."));
+}
 
-	hr = md3dDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, 
-		mDirectCmdListAlloc.Get(), /*!< Associated command allocator */
-		nullptr,                   /*!< Initial PipelineStateObject */ 
-		IID_PPV_ARGS(mCommandList.GetAddressOf()));
-	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create the command list for the primary command queue."));
+/** Creates the frame ring and the command pool of the primary command queue.
+ *
+ * @details
+ * Command allocators and lists are drawn from the pool and handed back with the fence value of the
+ * frame that submitted them, so the CPU can record the next frame while the GPU is still executing
+ * the previous ones. The ring only blocks when the CPU laps the oldest frame that is still in flight.
+ *
+ * @retval FunctionResult indicating the success of the frame resource creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseFrameResources() {
+	FunctionResult result = mFrames.initialise(mTimeline.get(), mPacing.framesInFlight);
+	if (!result.is_successfull) return(result);
 
-	mCommandList->Close(); /*!< The command list will be reset the first time it is refered to */
+	unsigned int threadCount = std::thread::hardware_concurrency();
+	if (threadCount == 0) threadCount = 1;
+	for (std::size_t i = 0; i < mFrames.frameCount(); ++i)
+		mFrames.slot(i).resources.threadArenas = std::make_unique<ThreadArenas>(threadCount);
 
-	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created the primary command queue."));
+	result = mReadback.initialise(mTimeline.get(), mPacing.bufferCount);
+	if (!result.is_successfull) return(result);
+
+	mDirectCommandPool = std::make_unique<DirectXCommandPool>(md3dDevice.Get(), D3D12_COMMAND_LIST_TYPE_DIRECT, mTimeline.get());
+	mHeapAllocator = std::make_unique<DirectXHeapAllocator>(md3dDevice.Get());
+
+	result = initialiseUploadRing();
+	if (!result.is_successfull) return(result);
+
+	result = initialiseCopyQueue();
+	if (!result.is_successfull) return(result);
+
+	result = initialiseResidency();
+	if (!result.is_successfull) return(result);
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created the frame resources."));
+}
+
+/** Creates the buffer behind the upload ring and maps it for the lifetime of the backend.
+ *
+ * @details
+ * Upload heaps are write combined, so the buffer is never read from the CPU and an empty read range
+ * is passed to Map.
+ *
+ * @retval FunctionResult indicating the success of the upload ring creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseUploadRing() {
+	FunctionResult result = mHeapAllocator->createResource(HeapClass::UPLOAD_BUFFER, CD3DX12_RESOURCE_DESC::Buffer(DefaultUploadRingSize), D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr, mUploadBuffer);
+	if (!result.is_successfull) return(FunctionResult(false, RESULT::FAIL, "Failed to create the upload ring buffer. " + result.message));
+
+	void* data = nullptr;
+	CD3DX12_RANGE readRange(0, 0);
+	HRESULT hr = mUploadBuffer.resource->Map(0, &readRange, &data);
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to map the upload ring buffer."));
+
+	return(mUploadRing.initialise(mTimeline.get(), data, mUploadBuffer.resource->GetGPUVirtualAddress(), DefaultUploadRingSize, mPacing.framesInFlight));
+}
+
+/** Creates the copy queue that asset uploads are batched onto.
+ *
+ * @retval FunctionResult indicating the success of the copy queue creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseCopyQueue() {
+	mCopyBackend = std::make_unique<DirectXCopyBackend>(md3dDevice.Get(), mHeapAllocator.get());
+
+	FunctionResult result = mCopyBackend->initialise();
+	if (!result.is_successfull) return(result);
+
+	return(mUploader.initialise(mCopyBackend.get()));
+}
+
+/** Creates the residency manager, which reads the budget from the adapter the device was created on.
+ *
+ * @retval FunctionResult indicating the success of the residency manager creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseResidency() {
+	Microsoft::WRL::ComPtr<IDXGIAdapter3> adapter;
+	HRESULT hr = mFactory->EnumAdapterByLuid(md3dDevice->GetAdapterLuid(), IID_PPV_ARGS(&adapter));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to find the adapter of the device."));
+
+	mResidencySource = std::make_unique<DirectXResidencySource>(md3dDevice.Get(), adapter.Get());
+	return(mResidency.initialise(mResidencySource.get(), mTimeline.get()));
+}
+
+/** Loads the pipelines compiled by earlier runs on the same adapter and driver.
+ *
+ * @details
+ * The cache file is mapped rather than read, so startup does not depend on its size. A file written
+ * for another adapter or driver is ignored and replaced when the cache is saved.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if the pipelines are compiled from scratch this run.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::initialisePipelineCache() {
+	mPipelineCache = std::make_unique<DirectXPipelineCache>(md3dDevice.Get());
+	if (mPipelineCachePath.empty()) return(FunctionResult(true, RESULT::WSUCCESS, "The pipeline cache is disabled."));
+
+	Microsoft::WRL::ComPtr<IDXGIAdapter1> adapter;
+	HRESULT hr = mFactory->EnumAdapterByLuid(md3dDevice->GetAdapterLuid(), IID_PPV_ARGS(&adapter));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to find the adapter of the device."));
+
+	return(mPipelineCache->initialise(adapter.Get(), mPipelineCachePath));
+}
+
+/** Maps the shader archive, whose bytecode is then handed to pipeline creation in place.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if there is no archive and shaders are supplied by the caller.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseShaderArchive() {
+	if (mShaderArchivePath.empty() || !std::filesystem::exists(mShaderArchivePath)) return(FunctionResult(true, RESULT::WSUCCESS, "No shader archive to load."));
+	return(mShaderArchive.open(mShaderArchivePath));
+}
+
+/** Prepares the registry that creates each distinct root signature layout once. */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseRootSignatures() {
+	mRootSignatures = std::make_unique<DirectXRootSignatureRegistry>(md3dDevice.Get());
+	return(mRootSignatures->initialise());
+}
+
+/** Starts the workers pipelines are compiled on. Pipelines handed to the scheduler hold one reference. */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::initialisePipelineScheduler() {
+	mWorkers = std::make_unique<WorkerPool>();
+	return(mPipelines.initialise(mWorkers.get(), [](void* pipeline) { static_cast<ID3D12PipelineState*>(pipeline)->Release(); }));
 }
 
+/** Creates the flip model swap chain.
+ *
+ * @details
+ * The buffer count and maximum frame latency come from the graphics configuration. The swap chain
+ * exposes a frame latency waitable object, which the frame pacer blocks on before CPU work for the
+ * next frame begins. Flip model swap chains cannot be multisampled, so MSAA has to be resolved into
+ * the back buffer.
+ *
+ * @param[in] rrNumerator: Refresh rate numerator.
+ * @param[in] rrDenominator: Refresh rate denominator.
+ *
+ * @retval FunctionResult indicating the success of the swap chain creation.
+ */
 SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseSwapChain(const int rrNumerator, const int rrDenominator) {
+	mPresenter.reset();
 	mSwapChain.Reset();
 
-	DXGI_SWAP_CHAIN_DESC sd;
+	DXGI_SWAP_CHAIN_DESC1 sd = {};
 
-	sd.BufferDesc.Width = mClientWidth;
-	sd.BufferDesc.Height = mClientHeight;
-	sd.BufferDesc.RefreshRate.Numerator = rrNumerator;
-	sd.BufferDesc.RefreshRate.Denominator = rrDenominator;
-	sd.BufferDesc.Format = mBackBufferFormat;
-	sd.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-	sd.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+	sd.Width = mClientWidth;
+	sd.Height = mClientHeight;
+	sd.Format = mBackBufferFormat;
+	sd.Scaling = DXGI_SCALING_STRETCH;
 
-	sd.SampleDesc.Count = m4xMsaaState ? 4 : 1;
-	sd.SampleDesc.Quality = m4xMsaaState ? (m4xMsaaQuality - 1) : 0;
+	sd.SampleDesc.Count = 1;
+	sd.SampleDesc.Quality = 0;
 
 	sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-	sd.BufferCount = SwapChainBufferCount;
+	sd.BufferCount = mPacing.bufferCount;
 
-	sd.OutputWindow = mhMainWnd;
-	
-	sd.Windowed = true;
 	sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-	sd.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
+	sd.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
+
+	mSwapChainFlags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH | DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+	sd.Flags = mSwapChainFlags;
+
+	DXGI_SWAP_CHAIN_FULLSCREEN_DESC fsd = {};
+	fsd.RefreshRate.Numerator = rrNumerator;
+	fsd.RefreshRate.Denominator = rrDenominator;
+	fsd.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
+	fsd.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+	fsd.Windowed = true;
 
-	HRESULT hr = mFactory->CreateSwapChain(mCommandQueue.Get(), &sd,mSwapChain.GetAddressOf());
+	Microsoft::WRL::ComPtr<IDXGISwapChain1> swapChain;
+	HRESULT hr = mFactory->CreateSwapChainForHwnd(mCommandQueue.Get(), mhMainWnd, &sd, &fsd, nullptr, swapChain.GetAddressOf());
+	if (SUCCEEDED(hr)) hr = swapChain.As(&mSwapChain);
 	if (FAILED(hr)) {
 		std::string message = "Failed to create the swap chain. \n";
 		message += "Resolution: " + std::to_string(mClientWidth) + "x" + std::to_string(mClientHeight) + "\n";
 		message += "Refresh Rate: " + std::to_string((rrNumerator/ rrDenominator)) + "\n";
+		message += "Buffers: " + std::to_string(mPacing.bufferCount) + "\n";
 		return(FunctionResult(false, RESULT::FAIL, message.data()));
 	}
 
+	FunctionResult result = mPresenter.initialise(mSwapChain.Get(), mPacing.maxFrameLatency);
+	if (!result.is_successfull) return(result);
+
+	result = mPacer.initialise(&mPresenter, mPacing);
+	if (!result.is_successfull) return(result);
+
 	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the swap chain."));
 }
 
-SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseRtvAndDsvDescriptorHeaps() {
-	D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc;
-	rtvHeapDesc.NumDescriptors = SwapChainBufferCount;
-	rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-	rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-	rtvHeapDesc.NodeMask = 0;
-	
-	HRESULT hr = md3dDevice->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(mRtvHeap.GetAddressOf()));
-	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create descriptor heap (RTV)."));
-
-	D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc;
-	dsvHeapDesc.NumDescriptors = 1;
-	dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
-	dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-	dsvHeapDesc.NodeMask = 0;
-	
-	hr = md3dDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(mDsvHeap.GetAddressOf()));
-	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create descriptor heap (DSV)."));
+/** Creates the descriptor heaps and takes the views of the back buffers and the depth stencil buffer.
+ *
+ * @details
+ * Every heap is created here with a fixed size, so allocating descriptors never creates a heap while
+ * rendering. Views are created in the CPU-only staging heaps; the shader visible heaps are rings that
+ * tables are copied into for each frame, behind the bindless region of the CBV/SRV/UAV heap.
+ *
+ * @retval FunctionResult indicating the success of the descriptor heap creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseDescriptorHeaps() {
+	FunctionResult result = mRtvHeap.initialise(md3dDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, StagingRtvDescriptorCount);
+	if (!result.is_successfull) return(result);
+
+	result = mDsvHeap.initialise(md3dDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_DSV, StagingDsvDescriptorCount);
+	if (!result.is_successfull) return(result);
+
+	result = mCbvSrvUavHeap.initialise(md3dDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, StagingCbvSrvUavDescriptorCount);
+	if (!result.is_successfull) return(result);
+
+	result = mSamplerHeap.initialise(md3dDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, StagingSamplerDescriptorCount);
+	if (!result.is_successfull) return(result);
+
+	result = mShaderDescriptors.initialise(md3dDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, ShaderVisibleCbvSrvUavDescriptorCount, mPacing.framesInFlight,
+		BindlessDescriptorCount);
+	if (!result.is_successfull) return(result);
+
+	result = mBindless.initialise(mTimeline.get(), BindlessDescriptorCount);
+	if (!result.is_successfull) return(result);
 
-	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created the render target view and depth stencil view."));
+	result = mShaderSamplers.initialise(md3dDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, ShaderVisibleSamplerDescriptorCount, mPacing.framesInFlight);
+	if (!result.is_successfull) return(result);
+
+	for (int i = 0; i < mPacing.bufferCount; ++i) {
+		if (!mRtvHeap.allocate(mBackBufferViews[i])) return(FunctionResult(false, RESULT::FAIL, "Failed to allocate a back buffer view."));
+	}
+	if (!mDsvHeap.allocate(mDepthStencilView)) return(FunctionResult(false, RESULT::FAIL, "Failed to allocate the depth stencil view."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created the descriptor heaps."));
+}
+
+/** Creates the headless back buffers.
+ *
+ * @details
+ * Headless back buffers are plain render target textures. Between frames they rest in the copy
+ * source state, ready for the copy into the readback ring, where a swap chain buffer would rest in
+ * the present state.
+ *
+ * @retval FunctionResult indicating the success of the render target creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::initialiseOffscreenTargets() {
+	D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(mBackBufferFormat, mClientWidth, mClientHeight, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+
+	D3D12_CLEAR_VALUE optClear;
+	optClear.Format = mBackBufferFormat;
+	std::memcpy(optClear.Color, Colors::LightSteelBlue, sizeof(optClear.Color));
+
+	for (int i = 0; i < mPacing.bufferCount; ++i) {
+		DirectXPlacedResource placed;
+		FunctionResult result = mHeapAllocator->createResource(HeapClass::RENDER_TARGET, desc, D3D12_RESOURCE_STATE_COPY_SOURCE, &optClear, placed);
+		if (!result.is_successfull) return(FunctionResult(false, RESULT::FAIL, "Failed to create an offscreen render target. " + result.message));
+
+		mSwapChainBuffer[i] = placed.resource;
+		mOffscreenAllocations[i] = placed.allocation;
+	}
+
+	mCurrBackBuffer = 0;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created the offscreen render targets."));
+}
+
+/** Hands the headless back buffers to the deferred release queue. */
+void SyrenEngine::DirectX::releaseOffscreenTargets() {
+	for (int i = 0; i < MaxSwapChainBufferCount; ++i) {
+		if (!mOffscreenAllocations[i].valid()) continue;
+
+		DirectXPlacedResource placed = { std::move(mSwapChainBuffer[i]), mOffscreenAllocations[i] };
+		deferRelease(placed);
+		mOffscreenAllocations[i] = HeapAllocation();
+	}
+}
+
+/** Releases the retired resources whose frames have completed.
+ *
+ * @param[in] all: Release everything regardless of the timeline. The GPU must be idle.
+ */
+void SyrenEngine::DirectX::collectReleases(bool all) {
+	auto release = [this](DirectXPlacedResource& placed) { mHeapAllocator->release(placed); };
+
+	if (all) mReleases.drain(release);
+	else mReleases.collect(release);
+}
+
+/** Records a copy of the current back buffer into a readback heap buffer.
+ *
+ * @details
+ * The buffer is reallocated when the size of the copy changes. Rows are laid out with the footprint
+ * the device reports, which pads them to D3D12_TEXTURE_DATA_PITCH_ALIGNMENT.
+ *
+ * @param[in] cmdList: Command list of the frame, with the back buffer in the copy source state.
+ * @param[in] staging: Readback slot claimed for the frame.
+ *
+ * @retval FunctionResult indicating the success of the copy.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::recordReadback(ID3D12GraphicsCommandList* cmdList, DirectXReadback& staging) {
+	D3D12_RESOURCE_DESC desc = CurrentBackBuffer()->GetDesc();
+
+	UINT64 size = 0;
+	md3dDevice->GetCopyableFootprints(&desc, 0, 1, 0, &staging.footprint, nullptr, nullptr, &size);
+
+	if (staging.buffer.resource == nullptr || staging.size != size) {
+		mHeapAllocator->release(staging.buffer);
+
+		FunctionResult result = mHeapAllocator->createResource(HeapClass::READBACK_BUFFER, CD3DX12_RESOURCE_DESC::Buffer(size), D3D12_RESOURCE_STATE_COPY_DEST, nullptr, staging.buffer);
+		if (!result.is_successfull) return(FunctionResult(false, RESULT::FAIL, "Failed to create a readback buffer. " + result.message));
+
+		staging.size = size;
+	}
+
+	CD3DX12_TEXTURE_COPY_LOCATION destination(staging.buffer.resource.Get(), staging.footprint);
+	CD3DX12_TEXTURE_COPY_LOCATION source(CurrentBackBuffer(), 0);
+	cmdList->CopyTextureRegion(&destination, 0, 0, 0, &source, nullptr);
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Recorded the readback copy."));
+}
+
+/** Creates the transient render targets of the compiled frame graph in the shared transient heap.
+ *
+ * @details
+ * The placed resources are kept across frames and only recreated when the layout planned by the
+ * graph changes, e.g. after a resize. The old resources are handed to the deferred release queue, as
+ * earlier frames may still use them. The new ones may be placed over the same memory straight away,
+ * since only work submitted after them on the same queue touches it. A transient is created in the
+ * initial state the graph was given for it, and the state its last use leaves it in is remembered for
+ * the next frame.
+ *
+ * @retval FunctionResult indicating the success of the placement.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::placeTransients() {
+	auto sameDesc = [](const RenderGraphTextureDesc& a, const RenderGraphTextureDesc& b) {
+		return(a.width == b.width && a.height == b.height && a.format == b.format && a.sampleCount == b.sampleCount && a.flags == b.flags && a.size == b.size);
+	};
+
+	std::size_t count = 0;
+	bool changed = false;
+
+	for (RenderGraphResource r = 0; r < mGraph.resourceCount(); ++r) {
+		if (mGraph.isImported(r) || mGraph.heap(r) == RenderGraphNone) continue;
+
+		const RenderGraphTextureDesc& desc = mGraph.resourceDesc(r);
+		changed = changed || count >= mTransients.size()
+			|| mTransients[count].id != mGraph.resourceId(r)
+			|| mTransients[count].offset != mGraph.heapOffset(r)
+			|| !sameDesc(mTransients[count].desc, desc);
+		++count;
+	}
+	changed = changed || count != mTransients.size();
+
+	if (changed) {
+		for (DirectXTransient& transient : mTransients)
+			deferRelease(transient.resource);
+		mTransients.clear();
+		mDepthStencilBuffer.Reset();
+
+		bool multisampled = false;
+		for (RenderGraphResource r = 0; r < mGraph.resourceCount(); ++r)
+			multisampled = multisampled || (!mGraph.isImported(r) && mGraph.resourceDesc(r).sampleCount > 1);
+
+		const std::vector<std::uint64_t>& heapSizes = mAliasingPlanner.heapSizes();
+		if (!heapSizes.empty()) {
+			FunctionResult result = allocateTransientBlock(heapSizes[0], multisampled);
+			if (!result.is_successfull) return(result);
+		}
+
+		for (RenderGraphResource r = 0; r < mGraph.resourceCount(); ++r) {
+			if (mGraph.isImported(r) || mGraph.heap(r) == RenderGraphNone) continue;
+
+			DirectXTransient transient;
+			transient.id = mGraph.resourceId(r);
+			transient.desc = mGraph.resourceDesc(r);
+			transient.offset = mGraph.heapOffset(r);
+
+			D3D12_RESOURCE_DESC desc = toD3D12Desc(transient.desc);
+			const bool depthStencil = (desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) != 0;
+
+			D3D12_CLEAR_VALUE optClear;
+			if (depthStencil) {
+				optClear.Format = mDepthStencilFormat;
+				optClear.DepthStencil.Depth = 1.0f;
+				optClear.DepthStencil.Stencil = 0;
+			}
+			else {
+				optClear.Format = desc.Format;
+				std::memcpy(optClear.Color, Colors::LightSteelBlue, sizeof(optClear.Color));
+			}
+
+			HRESULT hr = md3dDevice->CreatePlacedResource(mHeapAllocator->heap(mTransientBlock), mTransientBlock.offset + transient.offset, &desc, toD3D12State(mGraph.initialState(r)), &optClear,
+				IID_PPV_ARGS(transient.resource.GetAddressOf())
+			);
+			if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to place a transient render target."));
+
+			if (transient.id == DepthStencilResource) {
+				D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc;
+				dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
+				dsvDesc.ViewDimension = transient.desc.sampleCount > 1 ? D3D12_DSV_DIMENSION_TEXTURE2DMS : D3D12_DSV_DIMENSION_TEXTURE2D;
+				dsvDesc.Format = mDepthStencilFormat;
+				dsvDesc.Texture2D.MipSlice = 0;
+				md3dDevice->CreateDepthStencilView(transient.resource.Get(), &dsvDesc, DepthStencilView());
+
+				mDepthStencilBuffer = transient.resource;
+			}
+
+			mTransients.push_back(std::move(transient));
+		}
+	}
+
+	std::size_t index = 0;
+	for (RenderGraphResource r = 0; r < mGraph.resourceCount(); ++r) {
+		if (mGraph.isImported(r) || mGraph.heap(r) == RenderGraphNone) continue;
+		mTransients[index++].state = mGraph.finalState(r);
+	}
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Placed the transient render targets."));
+}
+
+/** Allocates the block of memory the transient render targets are placed in.
+ *
+ * @details
+ * The block comes from the render target pages of the heap allocator, or from the multisampled ones if
+ * any transient is multisampled. It is kept while it is large enough for the planned layout.
+ *
+ * @param[in] size: Size of the layout planned by the aliasing planner.
+ * @param[in] multisampled: Whether the layout contains multisampled render targets.
+ *
+ * @retval FunctionResult indicating the success of the allocation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::allocateTransientBlock(UINT64 size, bool multisampled) {
+	const HeapClass heapClass = multisampled ? HeapClass::MSAA_RENDER_TARGET : HeapClass::RENDER_TARGET;
+	if (mTransientBlock.valid() && mTransientBlock.heapClass == heapClass && mTransientBlock.size >= size)
+		return(FunctionResult(true, RESULT::SSUCCESS, "Reused the transient block."));
+
+	deferRelease(mTransientBlock);
+	return(mHeapAllocator->allocate(heapClass, size, 0, mTransientBlock));
+}
+
+/** Returns the state a transient render target was left in, or COMMON if it has not been placed yet. */
+SyrenEngine::ResourceState SyrenEngine::DirectX::transientState(ResourceId id) const {
+	for (const DirectXTransient& transient : mTransients) {
+		if (transient.id == id) return transient.state;
+	}
+	return ResourceState::COMMON;
 }
 
 /** Retrieves the graphics adapter at a given index position.
@@ -313,38 +716,229 @@ SyrenEngine::FunctionResult SyrenEngine::DirectX::getOutput(int pAdapterIndex, i
 	return(SyrenEngine::FunctionResult(false, RESULT::FAIL, message.data()));
 }
 
+/** Blocks until the GPU has finished all work submitted to the primary command queue.
+ *
+ * @details
+ * Only needed when resources that in-flight frames may reference are about to be destroyed. The
+ * render loop itself synchronises through the frame ring.
+ *
+ * @retval FunctionResult indicating the success of the flush.
+ */
 SyrenEngine::FunctionResult SyrenEngine::DirectX::flushCommandQueue() {
-	mCurrentFence++;
+	std::uint64_t fenceValue = 0;
 
-	HRESULT hr = mCommandQueue->Signal(mFence.Get(), mCurrentFence);
-	if(FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to signal the command queue."));
-	
-	if (mFence->GetCompletedValue() < mCurrentFence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, NULL, false, EVENT_ALL_ACCESS);
-
-		hr = mFence->SetEventOnCompletion(mCurrentFence, eventHandle);
-		if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to fire event on fence completion."));
+	FunctionResult result = mTimeline->signal(fenceValue);
+	if (!result.is_successfull) return(result);
 
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	result = mTimeline->waitForValue(fenceValue);
+	if (!result.is_successfull) return(result);
 	
 	return(SyrenEngine::FunctionResult(true, RESULT::SSUCCESS, "Successfully flushed the command queue."));
 }
 
 D3D12_CPU_DESCRIPTOR_HANDLE SyrenEngine::DirectX::DepthStencilView() const {
-	return mDsvHeap->GetCPUDescriptorHandleForHeapStart();
+	return mDepthStencilView.cpu;
 }
 
 D3D12_CPU_DESCRIPTOR_HANDLE SyrenEngine::DirectX::CurrentBackBufferView() const {
-	return CD3DX12_CPU_DESCRIPTOR_HANDLE(mRtvHeap->GetCPUDescriptorHandleForHeapStart(), mCurrBackBuffer, mRtvDescriptorSize);
+	return mBackBufferViews[mCurrBackBuffer].cpu;
+}
+
+SyrenEngine::DirectXDescriptorHeap& SyrenEngine::DirectX::stagingHeap(D3D12_DESCRIPTOR_HEAP_TYPE type) {
+	switch (type) {
+	case D3D12_DESCRIPTOR_HEAP_TYPE_RTV: return mRtvHeap;
+	case D3D12_DESCRIPTOR_HEAP_TYPE_DSV: return mDsvHeap;
+	case D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER: return mSamplerHeap;
+	default: return mCbvSrvUavHeap;
+	}
 }
 
 ID3D12Resource* SyrenEngine::DirectX::CurrentBackBuffer() const {
 	return mSwapChainBuffer[mCurrBackBuffer].Get();
 }
 
+/** Maps a command stream resource id onto the D3D12 resource it names.
+ *
+ * @param[in] id: Resource id recorded in a command stream.
+ *
+ * @retval The resource, or nullptr if the id does not name a resource of this backend.
+ */
+ID3D12Resource* SyrenEngine::DirectX::resolveResource(ResourceId id) const {
+	if (id == BackBufferResource) return CurrentBackBuffer();
+	if (id == DepthStencilResource) return mDepthStencilBuffer.Get();
+	if (id == UploadRingResource) return mUploadBuffer.resource.Get();
+	return nullptr;
+}
+
+/** Describes a transient render target of the frame graph as a D3D12 texture. */
+D3D12_RESOURCE_DESC SyrenEngine::DirectX::toD3D12Desc(const RenderGraphTextureDesc& desc) const {
+	const UINT quality = desc.sampleCount > 1 ? m4xMsaaQuality - 1 : 0;
+	return CD3DX12_RESOURCE_DESC::Tex2D(static_cast<DXGI_FORMAT>(desc.format), desc.width, desc.height, 1, 1, desc.sampleCount, quality,
+		static_cast<D3D12_RESOURCE_FLAGS>(desc.flags));
+}
+
+/** Translates a backend-neutral resource state into its D3D12 equivalent. */
+D3D12_RESOURCE_STATES SyrenEngine::DirectX::toD3D12State(ResourceState state) {
+	switch (state) {
+	case ResourceState::PRESENT: return D3D12_RESOURCE_STATE_PRESENT;
+	case ResourceState::RENDER_TARGET: return D3D12_RESOURCE_STATE_RENDER_TARGET;
+	case ResourceState::DEPTH_WRITE: return D3D12_RESOURCE_STATE_DEPTH_WRITE;
+	case ResourceState::DEPTH_READ: return D3D12_RESOURCE_STATE_DEPTH_READ;
+	case ResourceState::SHADER_RESOURCE: return D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+	case ResourceState::UNORDERED_ACCESS: return D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+	case ResourceState::COPY_SOURCE: return D3D12_RESOURCE_STATE_COPY_SOURCE;
+	case ResourceState::COPY_DEST: return D3D12_RESOURCE_STATE_COPY_DEST;
+	case ResourceState::VERTEX_BUFFER: return D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
+	case ResourceState::INDEX_BUFFER: return D3D12_RESOURCE_STATE_INDEX_BUFFER;
+	case ResourceState::CONSTANT_BUFFER: return D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
+	case ResourceState::INDIRECT_ARGUMENT: return D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
+	default: return D3D12_RESOURCE_STATE_COMMON;
+	}
+}
+
+/***********************************************************************************************************
+ * DirectX command stream replay
+ *
+ **********************************************************************************************************/
+
+/** Translates command stream packets into calls on a D3D12 command list.
+ *
+ * @details
+ * Packets naming resources or pipelines this backend does not know are skipped.
+ */
+struct SyrenEngine::DirectX::StreamExecutor {
+	const DirectX& api;
+	ID3D12GraphicsCommandList* cmdList;
+
+	void execute(const ClearRenderTargetCommand& command) {
+		if (command.target != BackBufferResource) return;
+		cmdList->ClearRenderTargetView(api.CurrentBackBufferView(), command.color, 0, nullptr);
+	}
+
+	void execute(const ClearDepthStencilCommand& command) {
+		if (command.target != DepthStencilResource) return;
+
+		D3D12_CLEAR_FLAGS flags = static_cast<D3D12_CLEAR_FLAGS>(0);
+		if (command.clearDepth) flags |= D3D12_CLEAR_FLAG_DEPTH;
+		if (command.clearStencil) flags |= D3D12_CLEAR_FLAG_STENCIL;
+		cmdList->ClearDepthStencilView(api.DepthStencilView(), flags, command.depth, command.stencil, 0, nullptr);
+	}
+
+	void execute(const SetViewportCommand& command) {
+		D3D12_VIEWPORT viewport = { command.x, command.y, command.width, command.height, command.minDepth, command.maxDepth };
+		cmdList->RSSetViewports(1, &viewport);
+	}
+
+	void execute(const SetScissorCommand& command) {
+		D3D12_RECT rect = { command.left, command.top, command.right, command.bottom };
+		cmdList->RSSetScissorRects(1, &rect);
+	}
+
+	void execute(const SetRenderTargetsCommand& command) {
+		D3D12_CPU_DESCRIPTOR_HANDLE colors[MaxCommandRenderTargets];
+		UINT count = 0;
+		const std::uint32_t targetCount = command.count < MaxCommandRenderTargets ? command.count : MaxCommandRenderTargets;
+		for (std::uint32_t i = 0; i < targetCount; ++i) {
+			if (command.colors[i] == BackBufferResource) colors[count++] = api.CurrentBackBufferView();
+		}
+
+		D3D12_CPU_DESCRIPTOR_HANDLE depth = api.DepthStencilView();
+		cmdList->OMSetRenderTargets(count, colors, false, command.depthStencil == DepthStencilResource ? &depth : nullptr);
+	}
+
+	void execute(const SetPipelineCommand&) {}
+	void execute(const SetVertexBufferCommand& command) {
+		if (command.buffer != UploadRingResource || command.slot >= MaxCommandVertexBuffers) return;
+
+		D3D12_VERTEX_BUFFER_VIEW view = { api.mUploadRing.gpuAddress(command.offset), command.size, command.stride };
+		cmdList->IASetVertexBuffers(command.slot, 1, &view);
+	}
+
+	void execute(const SetIndexBufferCommand& command) {
+		if (command.buffer != UploadRingResource) return;
+
+		D3D12_INDEX_BUFFER_VIEW view = { api.mUploadRing.gpuAddress(command.offset), command.size, command.indexSize == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT };
+		cmdList->IASetIndexBuffer(&view);
+	}
+
+	void execute(const DrawCommand& command) {
+		cmdList->DrawInstanced(command.vertexCount, command.instanceCount, command.firstVertex, command.firstInstance);
+	}
+
+	void execute(const DrawIndexedCommand& command) {
+		cmdList->DrawIndexedInstanced(command.indexCount, command.instanceCount, command.firstIndex, command.baseVertex, command.firstInstance);
+	}
+
+	void execute(const DispatchCommand& command) {
+		cmdList->Dispatch(command.groupsX, command.groupsY, command.groupsZ);
+	}
+
+	void execute(const BarrierCommand& command) {
+		ID3D12Resource* resource = api.resolveResource(command.resource);
+		if (resource == nullptr) return;
+
+		CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(resource, toD3D12State(command.before), toD3D12State(command.after));
+		cmdList->ResourceBarrier(1, &barrier);
+	}
+
+	void execute(const CopyBufferCommand& command) {
+		ID3D12Resource* destination = api.resolveResource(command.destination);
+		ID3D12Resource* source = api.resolveResource(command.source);
+		if (destination == nullptr || source == nullptr) return;
+
+		cmdList->CopyBufferRegion(destination, command.destinationOffset, source, command.sourceOffset, command.size);
+	}
+
+	void execute(const CopyTextureCommand& command) {
+		ID3D12Resource* destination = api.resolveResource(command.destination);
+		ID3D12Resource* source = api.resolveResource(command.source);
+		if (destination == nullptr || source == nullptr) return;
+
+		cmdList->CopyResource(destination, source);
+	}
+};
+
+/** Translates render graph barrier batches into ResourceBarrier calls. */
+struct SyrenEngine::DirectX::GraphExecutor {
+	const DirectX& api;
+	const RenderGraph& graph;
+	ID3D12GraphicsCommandList* cmdList;
+
+	void barriers(const RenderGraphBarrier* barriers, std::uint32_t count) {
+		D3D12_RESOURCE_BARRIER batch[16];
+		UINT batched = 0;
+
+		for (std::uint32_t i = 0; i < count; ++i) {
+			ID3D12Resource* resource = api.resolveResource(graph.resourceId(barriers[i].resource));
+			if (resource == nullptr) continue;
+
+			switch (barriers[i].type) {
+			case RenderGraphBarrierType::UAV:
+				batch[batched++] = CD3DX12_RESOURCE_BARRIER::UAV(resource);
+				break;
+			case RenderGraphBarrierType::BEGIN_ONLY:
+				batch[batched++] = CD3DX12_RESOURCE_BARRIER::Transition(resource, toD3D12State(barriers[i].before), toD3D12State(barriers[i].after),
+					D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+				break;
+			case RenderGraphBarrierType::END_ONLY:
+				batch[batched++] = CD3DX12_RESOURCE_BARRIER::Transition(resource, toD3D12State(barriers[i].before), toD3D12State(barriers[i].after),
+					D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+				break;
+			default:
+				batch[batched++] = CD3DX12_RESOURCE_BARRIER::Transition(resource, toD3D12State(barriers[i].before), toD3D12State(barriers[i].after));
+				break;
+			}
+
+			if (batched == _countof(batch)) {
+				cmdList->ResourceBarrier(batched, batch);
+				batched = 0;
+			}
+		}
+
+		if (batched > 0) cmdList->ResourceBarrier(batched, batch);
+	}
+};
+
 /***********************************************************************************************************
  * DirectX public member functions
  *
@@ -371,7 +965,7 @@ SyrenEngine::FunctionResult SyrenEngine::DirectX::getAdapters(GraphicsAdapterLis
 		std::wstring LadapterName = desc.Description;
 		std::string adapterName = std::string(LadapterName.begin(), LadapterName.end());
 
-		adapters.push_back(std::make_shared<GraphicsAdapter>(i, adapterName));
+		adapters.emplace_back(i, adapterName);
 		++i;
 	}
 
@@ -403,7 +997,7 @@ SyrenEngine::FunctionResult SyrenEngine::DirectX::getOutputs(int index, Graphics
 		std::wstring LoutputName = desc.DeviceName;
 		std::string outputName = std::string(LoutputName.begin(), LoutputName.end());
 		
-		outputs.push_back(std::make_shared<GraphicsOutput>(i, outputName));
+		outputs.emplace_back(i, outputName);
 		++i;
 	}
 
@@ -440,7 +1034,7 @@ SyrenEngine::FunctionResult SyrenEngine::DirectX::getDisplayModes(int pAdapterIn
 		UINT n = modeList[i].RefreshRate.Numerator;
 		UINT d = modeList[i].RefreshRate.Denominator;
 		
-		pDisplayModes.push_back(std::make_shared<DisplayMode>(i, modeList[i].Width, modeList[i].Height, int(n / d)));
+		pDisplayModes.emplace_back(i, modeList[i].Width, modeList[i].Height, int(n / d));
 	}
 
 	return(SyrenEngine::FunctionResult(true, RESULT::SSUCCESS, "Display modes returned."));
@@ -466,24 +1060,52 @@ SyrenEngine::FunctionResult SyrenEngine::DirectX::initialise() {
 	message += initialised.message + "\n";
 	if (!initialised.is_successfull) return initialised;
 
+	cacheDescriptorSizes();
+
+	initialised = initialiseCommandObjects();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
 	initialised = initialiseFence();
 	message += initialised.message + "\n";
 	if (!initialised.is_successfull) return initialised;
 
-	cacheDescriptorSizes();
+	initialised = initialiseFrameResources();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
 
-	initialised = initialiseCommandObjects();
+	initialised = initialisePipelineCache();
 	message += initialised.message + "\n";
 	if (!initialised.is_successfull) return initialised;
 
-	initialised = initialiseSwapChain(60, 1);
+	initialised = initialiseShaderArchive();
 	message += initialised.message + "\n";
 	if (!initialised.is_successfull) return initialised;
 
-	initialised = initialiseRtvAndDsvDescriptorHeaps();
+	initialised = initialiseRootSignatures();
 	message += initialised.message + "\n";
 	if (!initialised.is_successfull) return initialised;
 
+	initialised = initialisePipelineScheduler();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	if (!mHeadless) {
+		initialised = initialiseSwapChain(60, 1);
+		message += initialised.message + "\n";
+		if (!initialised.is_successfull) return initialised;
+	}
+
+	initialised = initialiseDescriptorHeaps();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	if (mHeadless) {
+		initialised = onResize();
+		message += "Rendering headless. \n";
+		if (!initialised.is_successfull) return initialised;
+	}
+
 	message += "Initialising DirectX was successful.";
 
 	return(SyrenEngine::FunctionResult(true, RESULT::SSUCCESS, message));
@@ -491,74 +1113,57 @@ SyrenEngine::FunctionResult SyrenEngine::DirectX::initialise() {
 
 SyrenEngine::FunctionResult SyrenEngine::DirectX::onResize() {
 	assert(md3dDevice);
-	assert(mSwapChain);
-	assert(mDirectCmdListAlloc);
-
-	FunctionResult result = flushCommandQueue();
-	if (!result.is_successfull) return result;
+	assert(mSwapChain || mHeadless);
+	assert(mDirectCommandPool);
 
-	HRESULT hr = mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr);
-	if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to reset command list."));
+	FunctionResult result(true, RESULT::SSUCCESS, "Resized.");
+	HRESULT hr = S_OK;
 
-	for (int i = 0; i < SwapChainBufferCount; ++i)
-		mSwapChainBuffer[i].Reset();
+	// Frames in flight may still use the old targets, so they are released once those frames complete
+	releaseOffscreenTargets();
+	for (DirectXTransient& transient : mTransients)
+		deferRelease(transient.resource);
+	mTransients.clear();
 	mDepthStencilBuffer.Reset();
 
-	hr = mSwapChain->ResizeBuffers(SwapChainBufferCount, mClientWidth, mClientHeight, mBackBufferFormat, DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH);
-	if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to resize swap chain buffers."));
-
-	mCurrBackBuffer = 0;
+	if (mHeadless) {
+		result = initialiseOffscreenTargets();
+		if (!result.is_successfull) return(result);
+	}
+	else {
+		// DXGI only resizes back buffers that nothing references any more, including submitted frames
+		result = mTimeline->waitForValue(mTimeline->lastSignaledValue());
+		if (!result.is_successfull) return(result);
 
-	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHeapHandle(mRtvHeap->GetCPUDescriptorHandleForHeapStart());
-	for (UINT i = 0; i < SwapChainBufferCount; i++)
-	{
-		hr = mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mSwapChainBuffer[i]));
-		if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to get a buffer from the swap chain."));
-
-		md3dDevice->CreateRenderTargetView(mSwapChainBuffer[i].Get(), nullptr, rtvHeapHandle);
-		rtvHeapHandle.Offset(1, mRtvDescriptorSize);
-	}
-
-	D3D12_RESOURCE_DESC depthStencilDesc;
-	depthStencilDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-	depthStencilDesc.Alignment = 0;
-	depthStencilDesc.Width = mClientWidth;
-	depthStencilDesc.Height = mClientHeight;
-	depthStencilDesc.DepthOrArraySize = 1;
-	depthStencilDesc.MipLevels = 1;
-	depthStencilDesc.Format = DXGI_FORMAT_R24G8_TYPELESS;
-	depthStencilDesc.SampleDesc.Count = m4xMsaaState ? 4 : 1;
-	depthStencilDesc.SampleDesc.Quality = m4xMsaaState ? (m4xMsaaQuality - 1) : 0;
-	depthStencilDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-	depthStencilDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+		for (int i = 0; i < mPacing.bufferCount; ++i)
+			mSwapChainBuffer[i].Reset();
 
-	D3D12_CLEAR_VALUE optClear;
-	optClear.Format = mDepthStencilFormat;
-	optClear.DepthStencil.Depth = 1.0f;
-	optClear.DepthStencil.Stencil = 0;
-	
-	hr = md3dDevice->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT), D3D12_HEAP_FLAG_NONE, &depthStencilDesc, D3D12_RESOURCE_STATE_COMMON, &optClear,
-		IID_PPV_ARGS(mDepthStencilBuffer.GetAddressOf())
-	);
-	if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to create a commited resource."));
+		hr = mSwapChain->ResizeBuffers(mPacing.bufferCount, mClientWidth, mClientHeight, mBackBufferFormat, mSwapChainFlags);
+		if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to resize swap chain buffers."));
 
-	D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc;
-	dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
-	dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
-	dsvDesc.Format = mDepthStencilFormat;
-	dsvDesc.Texture2D.MipSlice = 0;
-	md3dDevice->CreateDepthStencilView(mDepthStencilBuffer.Get(), &dsvDesc, DepthStencilView());
+		mCurrBackBuffer = mSwapChain->GetCurrentBackBufferIndex();
+	}
 
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(mDepthStencilBuffer.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_DEPTH_WRITE));
+	for (int i = 0; i < mPacing.bufferCount; i++)
+	{
+		if (!mHeadless) {
+			hr = mSwapChain->GetBuffer(i, IID_PPV_ARGS(&mSwapChainBuffer[i]));
+			if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to get a buffer from the swap chain."));
+		}
 
-	hr = mCommandList->Close();
-	if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to close the command list."));
+		md3dDevice->CreateRenderTargetView(mSwapChainBuffer[i].Get(), nullptr, mBackBufferViews[i].cpu);
+	}
 
-	ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
-	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+	mDepthStencilDesc.width = mClientWidth;
+	mDepthStencilDesc.height = mClientHeight;
+	mDepthStencilDesc.format = DXGI_FORMAT_R24G8_TYPELESS;
+	mDepthStencilDesc.sampleCount = m4xMsaaState ? 4 : 1;
+	mDepthStencilDesc.flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
 
-	result = flushCommandQueue();
-	if (!result.is_successfull) return(result);
+	D3D12_RESOURCE_DESC depthStencilDesc = toD3D12Desc(mDepthStencilDesc);
+	D3D12_RESOURCE_ALLOCATION_INFO allocation = md3dDevice->GetResourceAllocationInfo(0, 1, &depthStencilDesc);
+	mDepthStencilDesc.size = allocation.SizeInBytes;
+	mDepthStencilDesc.alignment = allocation.Alignment;
 
 	mScreenViewport.TopLeftX = 0;
 	mScreenViewport.TopLeftY = 0;
@@ -571,45 +1176,566 @@ SyrenEngine::FunctionResult SyrenEngine::DirectX::onResize() {
 	return(SyrenEngine::FunctionResult(true, RESULT::SSUCCESS, "Succseeful."));
 }
 
+/** Blocks until the swap chain can accept another frame.
+ *
+ * @details
+ * Should be called by the frame loop before any CPU work for the next frame, so that the work is
+ * based on input sampled as late as the configured frame latency allows.
+ *
+ * @return FunctionResult with RESULT::WSUCCESS if the wait timed out.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::waitForNextFrame() {
+	if (mHeadless) return(SyrenEngine::FunctionResult(true, RESULT::SSUCCESS, "Headless frames are not paced."));
+
+	assert(mSwapChain);
+	return(mPacer.waitForNextFrame());
+}
+
 SyrenEngine::FunctionResult SyrenEngine::DirectX::render() {
 	assert(md3dDevice);
-	assert(mSwapChain);
-	assert(mDirectCmdListAlloc);
-	
-	HRESULT hr = mDirectCmdListAlloc->Reset();	
-	if(FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to reset the command list allocator."));
+	assert(mSwapChain || mHeadless);
+	assert(mTimeline);
+	assert(mDirectCommandPool);
+
+	FrameResources* frame = nullptr;
+	FunctionResult result = mFrames.beginFrame(frame);
+	if (!result.is_successfull) return(result);
 
-	hr = mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr);
-	if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to reset the command list."));
+	mShaderDescriptors.beginFrame(mFrames.currentIndex());
+	mShaderSamplers.beginFrame(mFrames.currentIndex());
+	frame->arena.reset();
+	frame->threadArenas->reset();
+	collectReleases(false);
 
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
+	// Pipelines that failed to compile keep drawing with their fallback, so this is not an error
+	result = mPipelines.pump();
+	if (!result.is_successfull) return(result);
+
+	// Uploads queued since the last frame copy while this frame records and executes
+	result = mUploader.flush();
+	if (!result.is_successfull) return(result);
+
+	DirectXCommandContext context;
+	bool recording = true;
+	bool submitted = false;
+	bool copying = false;
+
+	// Every early return hands the context and the claimed readback slot back. A submitted context is
+	// in use until the next value signalled on the queue, which follows its command list
+	ScopeGuard abandonFrame([&]() {
+		if (copying) mReadback.cancelCopy();
+		if (!submitted) mDirectCommandPool->discard(context, recording);
+		else mDirectCommandPool->retire(context, mTimeline->lastSignaledValue() + 1);
+	});
+
+	result = mDirectCommandPool->acquire(context);
+	if (!result.is_successfull) return(result);
 
-	mCommandList->RSSetViewports(1, &mScreenViewport);
-	mCommandList->RSSetScissorRects(1, &mScissorRect);
+	ID3D12GraphicsCommandList* cmdList = context.list.Get();
+	const ResourceState restingState = mHeadless ? ResourceState::COPY_SOURCE : ResourceState::PRESENT;
 
-	mCommandList->ClearRenderTargetView(CurrentBackBufferView(), Colors::LightSteelBlue, 0, nullptr);
-	mCommandList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
+	std::uint64_t uploadCursor = 0;
 
-	mCommandList->OMSetRenderTargets(1, &CurrentBackBufferView(), true, &DepthStencilView());
+	mGraph.reset();
+	RenderGraphResource backBuffer = mGraph.importResource("BackBuffer", BackBufferResource, restingState, restingState);
+	RenderGraphResource depthStencil = mGraph.createTransient("DepthStencil", DepthStencilResource, mDepthStencilDesc, transientState(DepthStencilResource));
+
+	RenderGraphPass scene = mGraph.addPass("Scene", [this, cmdList, &uploadCursor]() {
+		ID3D12DescriptorHeap* descriptorHeaps[] = { mShaderDescriptors.heap(), mShaderSamplers.heap() };
+		cmdList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
+
+		cmdList->RSSetViewports(1, &mScreenViewport);
+		cmdList->RSSetScissorRects(1, &mScissorRect);
+
+		cmdList->ClearRenderTargetView(CurrentBackBufferView(), Colors::LightSteelBlue, 0, nullptr);
+		cmdList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
+
+		cmdList->OMSetRenderTargets(1, &CurrentBackBufferView(), true, &DepthStencilView());
+
+		std::lock_guard<std::mutex> lock(mStreamMutex);
+		StreamExecutor executor = { *this, cmdList };
+		replayCommandStream(mFrameStream, executor);
+		mFrameStream.reset();
+
+		// Everything the consumed streams uploaded was allocated before they were submitted
+		std::lock_guard<std::mutex> uploadLock(mUploadMutex);
+		uploadCursor = mUploadRing.cursor();
+	});
+	mGraph.write(scene, backBuffer, ResourceState::RENDER_TARGET);
+	mGraph.write(scene, depthStencil, ResourceState::DEPTH_WRITE);
+
+	DirectXReadback* staging = nullptr;
+	FunctionResult copied(true, RESULT::SSUCCESS, "No readback recorded.");
+
+	if (mHeadless) {
+		result = mReadback.beginCopy(staging);
+		if (!result.is_successfull) return(result);
+		copying = true;
+
+		RenderGraphPass copy = mGraph.addPass("Readback", [this, cmdList, staging, &copied]() {
+			copied = recordReadback(cmdList, *staging);
+		});
+		mGraph.read(copy, backBuffer, ResourceState::COPY_SOURCE);
+		mGraph.setSideEffect(copy);
+	}
+
+	result = mGraph.compile();
+	if (!result.is_successfull) return(result);
+
+	result = placeTransients();
+	if (!result.is_successfull) return(result);
 
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
+	GraphExecutor graphExecutor = { *this, mGraph, cmdList };
+	mGraph.execute(graphExecutor);
+	if (!copied.is_successfull) return(copied);
 
-	hr = mCommandList->Close();
+	HRESULT hr = cmdList->Close();
+	recording = false;
 	if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to close the command list."));
 
-	ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
+	// Pages in everything the frame used and evicts for it in one batch; staying over budget is not an error
+	result = mResidency.update();
+	if (!result.is_successfull) return(result);
+
+	ID3D12CommandList* cmdsLists[] = { cmdList };
 	mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+	submitted = true;
 
-	hr = mSwapChain->Present(0, 0);
-	if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to present the swap chain."));
+	if (!mHeadless) {
+		result = mPacer.present();
+		if (!result.is_successfull) return(result);
+
+		mCurrBackBuffer = mSwapChain->GetCurrentBackBufferIndex();
+	}
 
-	mCurrBackBuffer = (mCurrBackBuffer + 1) % SwapChainBufferCount;
+	std::uint64_t fenceValue = 0;
+	result = mFrames.endFrame(fenceValue);
+	if (!result.is_successfull) return(result);
 
-	flushCommandQueue();
+	{
+		std::lock_guard<std::mutex> lock(mUploadMutex);
+		result = mUploadRing.retire(uploadCursor, fenceValue);
+		if (!result.is_successfull) return(result);
+	}
 
+	if (mHeadless) {
+		mReadback.endCopy(fenceValue, mFrameCount, mClientWidth, mClientHeight);
+		mCurrBackBuffer = (mCurrBackBuffer + 1) % mPacing.bufferCount;
+		copying = false;
+	}
+	++mFrameCount;
+	abandonFrame.dismiss();
+
+	mDirectCommandPool->retire(context, fenceValue);
 	return(SyrenEngine::FunctionResult(true, RESULT::SSUCCESS, "Successfully rendered frame."));
 }
 
+/** Queues a recorded command stream for the next frame.
+ *
+ * @details
+ * May be called from any thread. The packets are copied, so the caller can reset and reuse its
+ * stream straight away. Submitted streams are replayed in submission order by render().
+ *
+ * @param[in] stream: Stream recorded by the caller.
+ *
+ * @return FunctionResult indicating that the stream was queued.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::submit(const CommandStream& stream) {
+	std::lock_guard<std::mutex> lock(mStreamMutex);
+	mFrameStream.append(stream);
+	return(SyrenEngine::FunctionResult(true, RESULT::SSUCCESS, "Command stream queued."));
+}
+
+/** Allocates per-frame memory that the GPU reads straight from the upload heap.
+ *
+ * @details
+ * May be called from any thread. The allocation stays valid until the frame that consumes the next
+ * submitted stream completes, so it has to be submitted before the render() call that follows it.
+ * Streams refer to the allocation through UploadRingResource and its offset.
+ *
+ * @param[in] size: Size of the allocation.
+ * @param[in] alignment: Power of two alignment, ConstantBufferAlignment for constant buffers.
+ * @param[out] allocation: Mapped address, GPU address and offset of the allocation.
+ *
+ * @retval False if the ring is full. Returns a plain bool as this is called once per draw.
+ */
+bool SyrenEngine::DirectX::allocateUpload(std::uint64_t size, std::uint64_t alignment, UploadAllocation& allocation) {
+	std::lock_guard<std::mutex> lock(mUploadMutex);
+	return mUploadRing.allocate(size, alignment, allocation);
+}
+
+/** Takes a staging descriptor to create a view in.
+ *
+ * @details
+ * May be called from any thread. The view has to be copied into a table with copyDescriptorTable()
+ * before shaders can use it.
+ *
+ * @param[in] type: Heap type of the descriptor.
+ * @param[out] descriptor: Index and CPU handle of the descriptor.
+ *
+ * @retval False if the staging heap is full.
+ */
+bool SyrenEngine::DirectX::allocateDescriptor(D3D12_DESCRIPTOR_HEAP_TYPE type, DirectXDescriptor& descriptor) {
+	return(stagingHeap(type).allocate(descriptor));
+}
+
+/** Returns a staging descriptor. Tables it was copied into stay valid. */
+void SyrenEngine::DirectX::freeDescriptor(D3D12_DESCRIPTOR_HEAP_TYPE type, DirectXDescriptor& descriptor) {
+	stagingHeap(type).free(descriptor);
+}
+
+/** Copies staging descriptors into a table of the frame being recorded.
+ *
+ * @details
+ * May be called from any thread while the frame records its command lists. The table lives until
+ * the frame slot is reused.
+ *
+ * @param[in] type: CBV_SRV_UAV or SAMPLER.
+ * @param[in] sources: Staging descriptors in table order.
+ * @param[in] count: Number of descriptors in the table.
+ * @param[out] table: GPU handle to bind as the root descriptor table.
+ *
+ * @retval False if the frame has run out of shader visible descriptors.
+ */
+bool SyrenEngine::DirectX::copyDescriptorTable(D3D12_DESCRIPTOR_HEAP_TYPE type, const D3D12_CPU_DESCRIPTOR_HANDLE* sources, UINT count, D3D12_GPU_DESCRIPTOR_HANDLE& table) {
+	DirectXDescriptorRing& ring = type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER ? mShaderSamplers : mShaderDescriptors;
+	return(ring.copyTable(sources, count, table));
+}
+
+/** Gives a view a permanent slot in the bindless table.
+ *
+ * @details
+ * May be called from any thread. The view is copied straight away, so the staging descriptor may be
+ * freed afterwards. Shaders reach the view through BindlessTable::index(handle).
+ *
+ * @param[in] view: Staging CBV, SRV or UAV of the resource.
+ * @param[out] handle: Generation checked handle of the slot.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::addBindless(D3D12_CPU_DESCRIPTOR_HANDLE view, BindlessHandle& handle) {
+	FunctionResult result = mBindless.allocate(handle);
+	if (!result.is_successfull) return(result);
+
+	md3dDevice->CopyDescriptorsSimple(1, mShaderDescriptors.cpuHandle(BindlessTable::index(handle)), view, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	return(result);
+}
+
+/** Frees a bindless slot once the frame currently being recorded, which may still index it, has completed. */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::removeBindless(BindlessHandle& handle) {
+	return(mBindless.free(handle, mTimeline->lastSignaledValue() + 1));
+}
+
+bool SyrenEngine::DirectX::isBindlessValid(BindlessHandle handle) const {
+	return(mBindless.isValid(handle));
+}
+
+/** Returns the start of the bindless region, bound once per frame as an unbounded descriptor table. */
+D3D12_GPU_DESCRIPTOR_HANDLE SyrenEngine::DirectX::bindlessTable() const {
+	return(mShaderDescriptors.gpuHandle(0));
+}
+
+/** Starts tracking a heap or committed resource that may be evicted when the budget runs out.
+ *
+ * @details
+ * Placed resources are tracked through their heap. Every frame that uses a tracked object has to
+ * report it with useResidency() while it is recorded, so that evicted objects are paged in before the
+ * frame executes.
+ *
+ * @param[in] object: Heap or committed resource.
+ * @param[in] size: Video memory the object occupies.
+ * @param[out] handle: Handle the frames use the object through.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::trackResidency(ID3D12Pageable* object, UINT64 size, ResidencyHandle& handle) {
+	return(mResidency.track(object, size, handle));
+}
+
+/** Stops tracking an object. Called before the object is handed to deferRelease(). */
+void SyrenEngine::DirectX::untrackResidency(ResidencyHandle& handle) {
+	mResidency.untrack(handle);
+}
+
+void SyrenEngine::DirectX::useResidency(ResidencyHandle handle) {
+	mResidency.use(handle);
+}
+
+void SyrenEngine::DirectX::useResidency(const ResidencyHandle* handles, std::size_t count) {
+	mResidency.use(handles, count);
+}
+
+SyrenEngine::ResidencyStatistics SyrenEngine::DirectX::residencyStatistics() const {
+	return(mResidency.statistics());
+}
+
+/** Creates a graphics pipeline state, from the blob compiled by an earlier run when one is cached.
+ *
+ * @param[in] desc: Pipeline description. Its CachedPSO is ignored.
+ * @param[in] rootSignatureHash: Stable hash of the serialized root signature the description references.
+ * @param[out] pipeline: Created pipeline state.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::createGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash,
+	Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipeline) {
+	return(mPipelineCache->createGraphicsPipeline(desc, rootSignatureHash, pipeline));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::DirectX::createComputePipeline(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash,
+	Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipeline) {
+	return(mPipelineCache->createComputePipeline(desc, rootSignatureHash, pipeline));
+}
+
+/** Writes the pipelines compiled so far to the cache file. Called on shutdown; no pipeline may be in creation. */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::savePipelineCache() {
+	if (mPipelineCachePath.empty()) return(FunctionResult(true, RESULT::WSUCCESS, "The pipeline cache is disabled."));
+	return(mPipelineCache->save());
+}
+
+SyrenEngine::PipelineCacheStatistics SyrenEngine::DirectX::pipelineCacheStatistics() const {
+	return(mPipelineCache->statistics());
+}
+
+/** Looks up a shader in the shader archive for a pipeline description. May be called from any thread.
+ *
+ * @param[in] name: Name the shader was packed under.
+ * @param[out] bytecode: Bytecode, pointing into the archive until the renderer is destroyed.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::shaderBytecode(const char* name, D3D12_SHADER_BYTECODE& bytecode) {
+	ShaderBytecode found;
+	FunctionResult result = mShaderArchive.find(name, found);
+	bytecode.pShaderBytecode = found.data;
+	bytecode.BytecodeLength = found.size;
+	return(result);
+}
+
+SyrenEngine::FunctionResult SyrenEngine::DirectX::shaderBytecode(ShaderKey key, D3D12_SHADER_BYTECODE& bytecode) {
+	ShaderBytecode found;
+	FunctionResult result = mShaderArchive.find(key, found);
+	bytecode.pShaderBytecode = found.data;
+	bytecode.BytecodeLength = found.size;
+	return(result);
+}
+
+/** Queues a graphics pipeline for compilation on the workers, going through the pipeline cache.
+ *
+ * @details
+ * The description is copied, but the shader bytecode, input layout and root signature it points at have
+ * to stay alive until the pipeline is ready. Requesting a pipeline twice returns the same handle.
+ *
+ * @param[in] desc: Pipeline description.
+ * @param[in] rootSignatureHash: Stable hash of the serialized root signature the description references.
+ * @param[in] fallback: Pipeline drawn with until this one is ready.
+ *
+ * @retval Handle resolved with resolvePipeline() when drawing.
+ */
+SyrenEngine::PipelineHandle SyrenEngine::DirectX::requestGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash, PipelineHandle fallback) {
+	return(mPipelines.request(DirectXPipelineCache::hash(desc, rootSignatureHash), [this, desc, rootSignatureHash](void*& pipeline) {
+		Microsoft::WRL::ComPtr<ID3D12PipelineState> state;
+		FunctionResult result = mPipelineCache->createGraphicsPipeline(desc, rootSignatureHash, state);
+		pipeline = state.Detach();
+		return(result);
+	}, fallback));
+}
+
+/** Queues a compute pipeline for compilation on the workers. See requestGraphicsPipeline(). */
+SyrenEngine::PipelineHandle SyrenEngine::DirectX::requestComputePipeline(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash, PipelineHandle fallback) {
+	return(mPipelines.request(DirectXPipelineCache::hash(desc, rootSignatureHash), [this, desc, rootSignatureHash](void*& pipeline) {
+		Microsoft::WRL::ComPtr<ID3D12PipelineState> state;
+		FunctionResult result = mPipelineCache->createComputePipeline(desc, rootSignatureHash, state);
+		pipeline = state.Detach();
+		return(result);
+	}, fallback));
+}
+
+/** Queues a graphics pipeline using a registered root signature. See requestGraphicsPipeline().
+ *
+ * @param[in] desc: Pipeline description. Its pRootSignature is replaced by the registered root signature.
+ * @param[in] rootSignature: Root signature acquired with acquireRootSignature().
+ * @param[in] fallback: Pipeline drawn with until this one is ready.
+ */
+SyrenEngine::PipelineHandle SyrenEngine::DirectX::requestGraphicsPipeline(D3D12_GRAPHICS_PIPELINE_STATE_DESC desc, RootSignatureHandle rootSignature, PipelineHandle fallback) {
+	desc.pRootSignature = mRootSignatures->get(rootSignature);
+	return(requestGraphicsPipeline(desc, mRootSignatures->hash(rootSignature), fallback));
+}
+
+/** Queues a compute pipeline using a registered root signature. See requestGraphicsPipeline(). */
+SyrenEngine::PipelineHandle SyrenEngine::DirectX::requestComputePipeline(D3D12_COMPUTE_PIPELINE_STATE_DESC desc, RootSignatureHandle rootSignature, PipelineHandle fallback) {
+	desc.pRootSignature = mRootSignatures->get(rootSignature);
+	return(requestComputePipeline(desc, mRootSignatures->hash(rootSignature), fallback));
+}
+
+bool SyrenEngine::DirectX::setPipelineFallback(PipelineHandle handle, PipelineHandle fallback) {
+	return(mPipelines.setFallback(handle, fallback));
+}
+
+/** Registers a callback fired on the render thread once the pipeline is compiled, or failed to. */
+void SyrenEngine::DirectX::onPipelineReady(PipelineHandle handle, PipelineCallback callback) {
+	mPipelines.onReady(handle, std::move(callback));
+}
+
+/** Returns the pipeline a draw uses this frame: the pipeline, a ready fallback, or nullptr to skip the draw. */
+ID3D12PipelineState* SyrenEngine::DirectX::resolvePipeline(PipelineHandle handle) const {
+	return(static_cast<ID3D12PipelineState*>(mPipelines.resolve(handle)));
+}
+
+SyrenEngine::PipelineSchedulerStatistics SyrenEngine::DirectX::pipelineSchedulerStatistics() const {
+	return(mPipelines.statistics());
+}
+
+/** Returns the shared root signature of a layout, creating it if no earlier description had the same layout.
+ *
+ * @param[in] desc: Root signature description.
+ * @param[out] handle: Root signature, valid until the renderer is destroyed.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::acquireRootSignature(const D3D12_VERSIONED_ROOT_SIGNATURE_DESC& desc, RootSignatureHandle& handle) {
+	return(mRootSignatures->acquire(desc, handle));
+}
+
+ID3D12RootSignature* SyrenEngine::DirectX::rootSignature(RootSignatureHandle handle) const {
+	return(mRootSignatures->get(handle));
+}
+
+/** Returns the stable hash of a root signature, which pipelines using it are cached under. */
+std::uint64_t SyrenEngine::DirectX::rootSignatureHash(RootSignatureHandle handle) const {
+	return(mRootSignatures->hash(handle));
+}
+
+/** Returns the index draw sort keys order root signatures by, so sorted draws switch them least often. */
+std::uint32_t SyrenEngine::DirectX::rootSignatureSortIndex(RootSignatureHandle handle) const {
+	return(mRootSignatures->sortIndex(handle));
+}
+
+/** Sets a graphics root signature on a command list, skipping the set if the list already uses it.
+ *
+ * @param[in] cmdList: Command list being recorded.
+ * @param[in,out] binding: Root signatures set on the command list, default constructed for a new list.
+ * @param[in] handle: Root signature to draw with.
+ */
+void SyrenEngine::DirectX::bindGraphicsRootSignature(ID3D12GraphicsCommandList* cmdList, RootSignatureBinding& binding, RootSignatureHandle handle) {
+	mRootSignatures->bindGraphics(cmdList, binding, handle);
+}
+
+void SyrenEngine::DirectX::bindComputeRootSignature(ID3D12GraphicsCommandList* cmdList, RootSignatureBinding& binding, RootSignatureHandle handle) {
+	mRootSignatures->bindCompute(cmdList, binding, handle);
+}
+
+/** Returns how many layouts were shared and how many root signature switches the recorded draws needed. */
+SyrenEngine::RootSignatureStatistics SyrenEngine::DirectX::rootSignatureStatistics() const {
+	return(mRootSignatures->statistics());
+}
+
+/** Returns the arena of the frame being recorded, for draw lists, culling output and messages built on
+ * the render thread. It is rewound once the GPU has completed the frame, so its contents must not be
+ * kept past it.
+ */
+SyrenEngine::FrameArena& SyrenEngine::DirectX::frameArena() {
+	return(mFrames.slot(mFrames.currentIndex()).resources.arena);
+}
+
+/** Returns the arena of the calling thread for the frame being recorded, for jobs the frame fans out.
+ *
+ * @retval nullptr if more threads than hardware threads have asked for one this frame.
+ */
+SyrenEngine::FrameArena* SyrenEngine::DirectX::threadArena() {
+	return(mFrames.slot(mFrames.currentIndex()).resources.threadArenas->local());
+}
+
+/** Releases a resource and its memory once every frame that may have used it has completed.
+ *
+ * @details
+ * May be called from any thread. The resource is stamped with the timeline value of the frame being
+ * recorded, so it may still be used by that frame. The caller's reference is cleared.
+ */
+void SyrenEngine::DirectX::deferRelease(DirectXPlacedResource& placed) {
+	if (!placed.resource && !placed.allocation.valid()) return;
+
+	mReleases.retire(std::move(placed), mTimeline->lastSignaledValue() + 1);
+	placed = DirectXPlacedResource();
+}
+
+/** Releases a resource that does not own heap memory of the backend, e.g. a committed resource. */
+void SyrenEngine::DirectX::deferRelease(Microsoft::WRL::ComPtr<ID3D12Resource>& resource) {
+	DirectXPlacedResource placed;
+	placed.resource = std::move(resource);
+	deferRelease(placed);
+}
+
+/** Returns a heap range once the resources placed in it can no longer be in use. */
+void SyrenEngine::DirectX::deferRelease(HeapAllocation& allocation) {
+	DirectXPlacedResource placed;
+	placed.allocation = allocation;
+	deferRelease(placed);
+	allocation = HeapAllocation();
+}
+
+/** Queues a buffer upload on the copy queue.
+ *
+ * @details
+ * May be called from any thread. The destination must be an ID3D12Resource in the COMMON state that
+ * the GPU is not using. The data is staged before this returns.
+ *
+ * @param[in] upload: Data and destination of the upload.
+ * @param[out] token: Token to pass to waitForUpload() before the frame that uses the buffer.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::upload(const BufferUpload& upload, UploadToken& token) {
+	return(mUploader.upload(upload, token));
+}
+
+/** Queues a texture upload on the copy queue. The same rules as for buffer uploads apply. */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::upload(const TextureUpload& upload, UploadToken& token) {
+	return(mUploader.upload(upload, token));
+}
+
+bool SyrenEngine::DirectX::isUploadComplete(UploadToken token) const {
+	return(mUploader.isComplete(token));
+}
+
+/** Makes the direct queue wait on the GPU for an upload before it executes the next frame.
+ *
+ * @details
+ * The CPU does not block. The batch holding the upload is submitted first if it is still open.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::waitForUpload(UploadToken token) {
+	if (mUploader.isComplete(token)) return(SyrenEngine::FunctionResult(true, RESULT::SSUCCESS, "Upload has completed."));
+
+	FunctionResult result = mUploader.ensureSubmitted(token);
+	if (!result.is_successfull) return(result);
+
+	HRESULT hr = mCommandQueue->Wait(mCopyBackend->fence(), token);
+	if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to make the direct queue wait for an upload."));
+
+	return(SyrenEngine::FunctionResult(true, RESULT::SSUCCESS, "Direct queue waits for the upload."));
+}
+
+/** Takes the oldest headless frame whose copy has completed.
+ *
+ * @param[out] frame: Receives the pixels of the frame with the row padding removed.
+ * @param[in] wait: Block until the oldest copy completes instead of returning straight away.
+ *
+ * @return FunctionResult with RESULT::WSUCCESS if no frame was ready.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectX::readback(ReadbackFrame& frame, bool wait) {
+	if (!mHeadless) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Frames can only be read back when rendering headless."));
+
+	DirectXReadback* staging = nullptr;
+	FunctionResult result = mReadback.acquire(staging, frame, wait);
+	if (result.result != RESULT::SSUCCESS) return(result);
+
+	void* data = nullptr;
+	D3D12_RANGE readRange = { 0, static_cast<SIZE_T>(staging->size) };
+	HRESULT hr = staging->buffer.resource->Map(0, &readRange, &data);
+	if (FAILED(hr)) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Failed to map a readback buffer."));
+
+	const unsigned char* source = static_cast<const unsigned char*>(data) + staging->footprint.Offset;
+	const std::size_t rowSize = static_cast<std::size_t>(frame.width) * sizeof(std::uint32_t);
+
+	frame.pixels.resize(static_cast<std::size_t>(frame.width) * frame.height);
+	for (int row = 0; row < frame.height; ++row)
+		std::memcpy(&frame.pixels[static_cast<std::size_t>(row) * frame.width], source + static_cast<std::size_t>(row) * staging->footprint.Footprint.RowPitch, rowSize);
+
+	D3D12_RANGE writeRange = { 0, 0 };
+	staging->buffer.resource->Unmap(0, &writeRange);
+
+	mReadback.release();
+	return(SyrenEngine::FunctionResult(true, RESULT::SSUCCESS, "Frame read back."));
+}
+
 SyrenEngine::FunctionResult SyrenEngine::DirectX::update() {
 	return(SyrenEngine::FunctionResult(true, RESULT::SSUCCESS, "Succseeful."));
 }
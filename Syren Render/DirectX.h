@@ -33,19 +33,65 @@
 #include <DirectXColors.h>
 
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
 #include "GraphicsAPI.h"
+#include "BindlessTable.h"
+#include "CommandStream.h"
+#include "DeferredReleaseQueue.h"
+#include "DirectXCommandPool.h"
+#include "DirectXCopyBackend.h"
+#include "DirectXDescriptorAllocator.h"
+#include "DirectXHeapAllocator.h"
+#include "DirectXPipelineCache.h"
+#include "DirectXPresenter.h"
+#include "DirectXResidencySource.h"
+#include "DirectXRootSignatureRegistry.h"
+#include "DirectXTimeline.h"
+#include "FrameArena.h"
+#include "FramePacing.h"
+#include "FrameRing.h"
+#include "PipelineScheduler.h"
+#include "ReadbackRing.h"
+#include "RenderGraph.h"
+#include "ResidencyManager.h"
+#include "ShaderArchive.h"
+#include "UploadBatcher.h"
+#include "UploadRing.h"
 #include "common.h"
 
 using namespace DirectX;
 
 
 namespace SyrenEngine {
+	/** Resources owned by a single frame in flight. */
+	struct FrameResources {
+		FrameArena arena;                           /*!< Transient CPU data of the render thread */
+		std::unique_ptr<ThreadArenas> threadArenas; /*!< Transient CPU data of the jobs the frame fans out */
+	};
+
+	/** Readback heap buffer a headless frame is copied into. */
+	struct DirectXReadback {
+		DirectXPlacedResource buffer;
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint = {}; /*!< Layout of the copied back buffer, rows are 256 byte aligned */
+		UINT64 size = 0;
+	};
+
+	/** A transient render target placed in the shared transient heap. */
+	struct DirectXTransient {
+		ResourceId id = NullResource;
+		RenderGraphTextureDesc desc;
+		UINT64 offset = 0;
+		ResourceState state = ResourceState::COMMON; /*!< State the resource was left in by the last frame */
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+	};
+
 	class DirectX : public GraphicsAPI {
 	private:
 		HWND mhMainWnd;
+		bool mHeadless; /*!< Render into offscreen textures instead of a swap chain */
 		
 		int mClientWidth = 800;
 		int mClientHeight = 600;
@@ -54,45 +100,144 @@ namespace SyrenEngine {
 		DXGI_FORMAT  mDepthStencilFormat;
 		D3D_DRIVER_TYPE md3dDriverType;
 
-		UINT64 mCurrentFence = 0;
-
 		bool m4xMsaaState = false; /*!< 4X MSAA enabled */
 		UINT m4xMsaaQuality = 0;   /*!< Quality level of 4X MSAA */   
 
-		static const int SwapChainBufferCount = 2;
+		FramePacing mPacing;
+		UINT mSwapChainFlags = 0;
 		int mCurrBackBuffer = 0;
 
+		FramePacer mPacer;
+		DirectXPresenter mPresenter;
+		FrameRing<FrameResources> mFrames;
+		ReadbackRing<DirectXReadback> mReadback;
+		std::unique_ptr<DirectXTimeline> mTimeline;
+		std::uint64_t mFrameCount = 0;
+
 		Microsoft::WRL::ComPtr<IDXGIFactory6> mFactory;
 		Microsoft::WRL::ComPtr<ID3D12Device> md3dDevice;
-		Microsoft::WRL::ComPtr<ID3D12Fence> mFence;
-		Microsoft::WRL::ComPtr<IDXGISwapChain> mSwapChain;
+		std::unique_ptr<DirectXHeapAllocator> mHeapAllocator; /*!< Places every resource the backend creates itself */
+		DeferredReleaseQueue<DirectXPlacedResource> mReleases; /*!< Resources waiting for the frames that may still use them */
+		Microsoft::WRL::ComPtr<IDXGISwapChain3> mSwapChain;
 
 		Microsoft::WRL::ComPtr<ID3D12CommandQueue> mCommandQueue;
-		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> mDirectCmdListAlloc;
-		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> mCommandList;
+		std::unique_ptr<DirectXCommandPool> mDirectCommandPool;
 
-		Microsoft::WRL::ComPtr<ID3D12Resource> mSwapChainBuffer[SwapChainBufferCount];
+		Microsoft::WRL::ComPtr<ID3D12Resource> mSwapChainBuffer[MaxSwapChainBufferCount];
+		HeapAllocation mOffscreenAllocations[MaxSwapChainBufferCount]; /*!< Memory of the headless back buffers */
 		Microsoft::WRL::ComPtr<ID3D12Resource> mDepthStencilBuffer;
 
-		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mRtvHeap;
-		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mDsvHeap;
+		DirectXDescriptorHeap mRtvHeap;
+		DirectXDescriptorHeap mDsvHeap;
+		DirectXDescriptorHeap mCbvSrvUavHeap;
+		DirectXDescriptorHeap mSamplerHeap;
+		DirectXDescriptorRing mShaderDescriptors; /*!< Shader visible CBV, SRV and UAV tables of the frames in flight */
+		DirectXDescriptorRing mShaderSamplers;
+		BindlessTable mBindless; /*!< Slots of the bindless region at the start of mShaderDescriptors */
+		DirectXDescriptor mBackBufferViews[MaxSwapChainBufferCount];
+		DirectXDescriptor mDepthStencilView;
 
 		D3D12_VIEWPORT mScreenViewport;
 		D3D12_RECT mScissorRect;
 
+		std::mutex mStreamMutex;
+		CommandStream mFrameStream; /*!< Streams submitted for the next frame */
+		RenderGraph mGraph;         /*!< Passes of the frame being recorded */
+
+		AliasingPlanner mAliasingPlanner;
+		HeapAllocation mTransientBlock; /*!< Memory shared by the transient render targets */
+		std::vector<DirectXTransient> mTransients;
+		RenderGraphTextureDesc mDepthStencilDesc;
+
+		std::mutex mUploadMutex;
+		DirectXPlacedResource mUploadBuffer; /*!< Persistently mapped buffer behind the upload ring */
+		UploadRing mUploadRing;
+
+		std::unique_ptr<DirectXCopyBackend> mCopyBackend;
+		UploadBatcher mUploader; /*!< Streams asset data over the copy queue */
+
+		std::unique_ptr<DirectXResidencySource> mResidencySource;
+		ResidencyManager mResidency; /*!< Keeps the streamed heaps and resources within the video memory budget */
+
+		std::unique_ptr<DirectXPipelineCache> mPipelineCache;
+		std::string mPipelineCachePath; /*!< Empty when compiled pipelines are not kept between runs */
+		std::unique_ptr<DirectXRootSignatureRegistry> mRootSignatures; /*!< One shared root signature per distinct layout */
+		ShaderArchive mShaderArchive;
+		std::string mShaderArchivePath;
+		std::unique_ptr<WorkerPool> mWorkers;
+		PipelineScheduler mPipelines; /*!< Compiles pipelines off the render thread */
+
 		UINT mRtvDescriptorSize;
 		UINT mDsvDescriptorSize;
 		UINT mCbvSrvDescriptorSize;
 	public:
-		DirectX(HWND phMainWnd);
+		DirectX(HWND phMainWnd, const GraphicsConfig& pConfig);
 		~DirectX();
 
 		virtual FunctionResult initialise();
 		virtual FunctionResult onResize();
+		virtual FunctionResult waitForNextFrame();
 		virtual FunctionResult render();
+		virtual FunctionResult submit(const CommandStream& stream);
+		virtual FunctionResult readback(ReadbackFrame& frame, bool wait);
 		virtual FunctionResult update();
 		virtual FunctionResult destroy();
 
+		bool allocateUpload(std::uint64_t size, std::uint64_t alignment, UploadAllocation& allocation);
+		FunctionResult upload(const BufferUpload& upload, UploadToken& token);
+		FunctionResult upload(const TextureUpload& upload, UploadToken& token);
+		bool isUploadComplete(UploadToken token) const;
+		FunctionResult waitForUpload(UploadToken token);
+
+		FunctionResult trackResidency(ID3D12Pageable* object, UINT64 size, ResidencyHandle& handle);
+		void untrackResidency(ResidencyHandle& handle);
+		void useResidency(ResidencyHandle handle);
+		void useResidency(const ResidencyHandle* handles, std::size_t count);
+		ResidencyStatistics residencyStatistics() const;
+
+		FunctionResult createGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash,
+			Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipeline);
+		FunctionResult createComputePipeline(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash,
+			Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipeline);
+		FunctionResult savePipelineCache();
+		PipelineCacheStatistics pipelineCacheStatistics() const;
+
+		FunctionResult shaderBytecode(const char* name, D3D12_SHADER_BYTECODE& bytecode);
+		FunctionResult shaderBytecode(ShaderKey key, D3D12_SHADER_BYTECODE& bytecode);
+
+		PipelineHandle requestGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash, PipelineHandle fallback = PipelineHandle());
+		PipelineHandle requestComputePipeline(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash, PipelineHandle fallback = PipelineHandle());
+		PipelineHandle requestGraphicsPipeline(D3D12_GRAPHICS_PIPELINE_STATE_DESC desc, RootSignatureHandle rootSignature, PipelineHandle fallback = PipelineHandle());
+		PipelineHandle requestComputePipeline(D3D12_COMPUTE_PIPELINE_STATE_DESC desc, RootSignatureHandle rootSignature, PipelineHandle fallback = PipelineHandle());
+		bool setPipelineFallback(PipelineHandle handle, PipelineHandle fallback);
+		void onPipelineReady(PipelineHandle handle, PipelineCallback callback);
+		ID3D12PipelineState* resolvePipeline(PipelineHandle handle) const;
+		PipelineSchedulerStatistics pipelineSchedulerStatistics() const;
+
+		FunctionResult acquireRootSignature(const D3D12_VERSIONED_ROOT_SIGNATURE_DESC& desc, RootSignatureHandle& handle);
+		ID3D12RootSignature* rootSignature(RootSignatureHandle handle) const;
+		std::uint64_t rootSignatureHash(RootSignatureHandle handle) const;
+		std::uint32_t rootSignatureSortIndex(RootSignatureHandle handle) const;
+		void bindGraphicsRootSignature(ID3D12GraphicsCommandList* cmdList, RootSignatureBinding& binding, RootSignatureHandle handle);
+		void bindComputeRootSignature(ID3D12GraphicsCommandList* cmdList, RootSignatureBinding& binding, RootSignatureHandle handle);
+		RootSignatureStatistics rootSignatureStatistics() const;
+
+		FrameArena& frameArena();
+		FrameArena* threadArena();
+
+		void deferRelease(DirectXPlacedResource& placed);
+		void deferRelease(Microsoft::WRL::ComPtr<ID3D12Resource>& resource);
+		void deferRelease(HeapAllocation& allocation);
+
+		bool allocateDescriptor(D3D12_DESCRIPTOR_HEAP_TYPE type, DirectXDescriptor& descriptor);
+		void freeDescriptor(D3D12_DESCRIPTOR_HEAP_TYPE type, DirectXDescriptor& descriptor);
+		bool copyDescriptorTable(D3D12_DESCRIPTOR_HEAP_TYPE type, const D3D12_CPU_DESCRIPTOR_HANDLE* sources, UINT count, D3D12_GPU_DESCRIPTOR_HANDLE& table);
+
+		FunctionResult addBindless(D3D12_CPU_DESCRIPTOR_HANDLE view, BindlessHandle& handle);
+		FunctionResult removeBindless(BindlessHandle& handle);
+		bool isBindlessValid(BindlessHandle handle) const;
+		D3D12_GPU_DESCRIPTOR_HANDLE bindlessTable() const;
+
 		FunctionResult getAdapters(GraphicsAdapterList& adapters);
 		FunctionResult getOutputs(int index, GraphicsOutputList& outputs);
 		FunctionResult getDisplayModes(int pAdapterIndex, int pOutputIndex, DisplayModeList& pDisplayModes);
@@ -100,13 +245,31 @@ namespace SyrenEngine {
 		DirectX() = delete;
 		DirectX(const DirectX& rhs) = delete;
 		DirectX& operator=(const DirectX& rhs) = delete;
-		
+
+		struct StreamExecutor;
+		struct GraphExecutor;
+
 		FunctionResult initialiseDXGI();
 		FunctionResult initialiseD3D12();
 		FunctionResult initialiseFence();
 		FunctionResult initialiseCommandObjects();
+		FunctionResult initialiseFrameResources();
 		FunctionResult initialiseSwapChain(const int rrNumerator, const int rrDenominator);
-		FunctionResult initialiseRtvAndDsvDescriptorHeaps();
+		FunctionResult initialiseDescriptorHeaps();
+		FunctionResult initialiseUploadRing();
+		FunctionResult initialiseCopyQueue();
+		FunctionResult initialiseResidency();
+		FunctionResult initialisePipelineCache();
+		FunctionResult initialiseShaderArchive();
+		FunctionResult initialiseRootSignatures();
+		FunctionResult initialisePipelineScheduler();
+		FunctionResult initialiseOffscreenTargets();
+		FunctionResult recordReadback(ID3D12GraphicsCommandList* cmdList, DirectXReadback& staging);
+		FunctionResult placeTransients();
+		FunctionResult allocateTransientBlock(UINT64 size, bool multisampled);
+		void releaseOffscreenTargets();
+		void collectReleases(bool all);
+		ResourceState transientState(ResourceId id) const;
 
 		void cacheDescriptorSizes();
 		FunctionResult checkMultisampling();
@@ -118,6 +281,11 @@ namespace SyrenEngine {
 		D3D12_CPU_DESCRIPTOR_HANDLE DepthStencilView()const;
 		D3D12_CPU_DESCRIPTOR_HANDLE CurrentBackBufferView()const;
 		ID3D12Resource* CurrentBackBuffer()const;
+		DirectXDescriptorHeap& stagingHeap(D3D12_DESCRIPTOR_HEAP_TYPE type);
+		ID3D12Resource* resolveResource(ResourceId id)const;
+		D3D12_RESOURCE_DESC toD3D12Desc(const RenderGraphTextureDesc& desc)const;
+
+		static D3D12_RESOURCE_STATES toD3D12State(ResourceState state);
 	};
 }
 
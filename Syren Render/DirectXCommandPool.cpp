@@ -0,0 +1,94 @@
+/***********************************************************************************************************
+ * @file DirectXCommandPool.cpp
+ *
+ * @brief Implements functions of the DirectXCommandPool class found in DirectXCommandPool.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "DirectXCommandPool.h"
+
+
+/** Constructor for the DirectXCommandPool class.
+ *
+ * @param[in] pDevice: Device used to create allocators and lists.
+ * @param[in] pType: Queue type the pooled lists are recorded for.
+ * @param[in] pTimeline: Timeline of the queue the lists are submitted to.
+ */
+SyrenEngine::DirectXCommandPool::DirectXCommandPool(ID3D12Device* pDevice, D3D12_COMMAND_LIST_TYPE pType, Timeline* pTimeline)
+	: mAllocators(pTimeline), mLists(pTimeline) {
+	md3dDevice = pDevice;
+	mType = pType;
+}
+
+/** Hands out a command allocator and an open command list recording into it.
+ *
+ * @details
+ * Reuses the oldest retired allocator whose submission has completed and creates a new one only when
+ * none is available. The returned list has been reset and is ready for recording.
+ *
+ * @param[out] context: Receives the allocator and the open command list.
+ *
+ * @retval FunctionResult indicating whether a command context could be provided.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXCommandPool::acquire(DirectXCommandContext& context) {
+	if (mAllocators.acquire(context.allocator)) {
+		HRESULT hr = context.allocator->Reset();
+		if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to reset a pooled command allocator."));
+	}
+	else {
+		HRESULT hr = md3dDevice->CreateCommandAllocator(mType, IID_PPV_ARGS(context.allocator.ReleaseAndGetAddressOf()));
+		if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create a pooled command allocator."));
+	}
+
+	if (mLists.acquire(context.list)) {
+		HRESULT hr = context.list->Reset(context.allocator.Get(), nullptr);
+		if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to reset a pooled command list."));
+	}
+	else {
+		HRESULT hr = md3dDevice->CreateCommandList(0, mType, context.allocator.Get(), nullptr, IID_PPV_ARGS(context.list.ReleaseAndGetAddressOf()));
+		if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create a pooled command list."));
+	}
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Command context acquired."));
+}
+
+/** Returns a submitted command context to the pool.
+ *
+ * @details
+ * The allocator is tagged with the fence value of its submission. The list itself may be reset as
+ * soon as it has been executed, so it is immediately available again.
+ *
+ * @param[in] context: Context that was executed on the queue.
+ * @param[in] fenceValue: Timeline value signalled after the submission.
+ */
+void SyrenEngine::DirectXCommandPool::retire(DirectXCommandContext& context, std::uint64_t fenceValue) {
+	mAllocators.retire(std::move(context.allocator), fenceValue);
+	mLists.retire(std::move(context.list), 0);
+}
+
+/** Returns a command context that was never executed to the pool.
+ *
+ * @details
+ * Used when recording fails part way. Nothing on the GPU refers to the context, so both the
+ * allocator and the list are immediately reusable. Either may be missing if acquire() failed.
+ *
+ * @param[in] context: Context that was acquired but not executed.
+ * @param[in] recording: Whether the list is still open and has to be closed first.
+ */
+void SyrenEngine::DirectXCommandPool::discard(DirectXCommandContext& context, bool recording) {
+	// Closing a list with recording errors fails, which does not matter for a list that is reset next
+	if (context.list && recording) context.list->Close();
+
+	if (context.allocator) mAllocators.retire(std::move(context.allocator), 0);
+	if (context.list) mLists.retire(std::move(context.list), 0);
+}
+
+D3D12_COMMAND_LIST_TYPE SyrenEngine::DirectXCommandPool::type() const {
+	return mType;
+}
@@ -0,0 +1,61 @@
+/***********************************************************************************************************
+ * @file DirectXCommandPool.h
+ *
+ * @brief Pools command allocators and command lists of one queue type and recycles them by fence value
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Every acquired command context is exclusively owned by the calling thread until it is retired, so
+ * several threads can record lists for the same queue at once. Allocators are only reused after the
+ * fence value of their last submission completes, while command lists can be reset as soon as they
+ * have been handed to ExecuteCommandLists.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <Windows.h>
+#include <wrl.h>
+
+#include <d3d12.h>
+
+#include <cstdint>
+
+#include "FenceRecycler.h"
+#include "Timeline.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	/** A command allocator paired with the open command list recording into it. */
+	struct DirectXCommandContext {
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> list;
+	};
+
+	class DirectXCommandPool {
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device> md3dDevice;
+		D3D12_COMMAND_LIST_TYPE mType;
+
+		FenceRecycler<Microsoft::WRL::ComPtr<ID3D12CommandAllocator> > mAllocators;
+		FenceRecycler<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> > mLists;
+	public:
+		DirectXCommandPool(ID3D12Device* pDevice, D3D12_COMMAND_LIST_TYPE pType, Timeline* pTimeline);
+
+		FunctionResult acquire(DirectXCommandContext& context);
+		void retire(DirectXCommandContext& context, std::uint64_t fenceValue);
+		void discard(DirectXCommandContext& context, bool recording);
+
+		D3D12_COMMAND_LIST_TYPE type() const;
+	private:
+		DirectXCommandPool() = delete;
+		DirectXCommandPool(const DirectXCommandPool& rhs) = delete;
+		DirectXCommandPool& operator=(const DirectXCommandPool& rhs) = delete;
+	};
+}
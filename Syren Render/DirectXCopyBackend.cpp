@@ -0,0 +1,134 @@
+/***********************************************************************************************************
+ * @file DirectXCopyBackend.cpp
+ *
+ * @brief Implements functions of the DirectXCopyBackend class found in DirectXCopyBackend.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "DirectXCopyBackend.h"
+
+
+/** Constructor for the DirectXCopyBackend class.
+ *
+ * @param[in] pDevice: Device the copy queue is created on.
+ * @param[in] pHeapAllocator: Allocator the staging buffer is placed with.
+ * @param[in] pStagingSize: Size of the staging buffer.
+ */
+SyrenEngine::DirectXCopyBackend::DirectXCopyBackend(ID3D12Device* pDevice, DirectXHeapAllocator* pHeapAllocator, std::uint64_t pStagingSize)
+	: md3dDevice(pDevice), mHeapAllocator(pHeapAllocator), mStagingSize(pStagingSize) {}
+
+/** Destructor for the DirectXCopyBackend class.
+ *
+ * @details
+ * Waits for the submitted batches before the staging buffer is released.
+ */
+SyrenEngine::DirectXCopyBackend::~DirectXCopyBackend() {
+	if (mTimeline) mTimeline->waitForValue(mTimeline->lastSignaledValue());
+
+	if (mStaging.resource) mStaging.resource->Unmap(0, nullptr);
+	mHeapAllocator->release(mStaging);
+}
+
+/** Creates the copy queue, its timeline and command pool, and maps the staging buffer.
+ *
+ * @retval FunctionResult indicating the success of the initialisation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXCopyBackend::initialise() {
+	D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+	queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+	queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+
+	HRESULT hr = md3dDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(mCopyQueue.GetAddressOf()));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create the copy queue."));
+
+	mTimeline = std::make_unique<DirectXTimeline>(md3dDevice.Get(), mCopyQueue.Get());
+	FunctionResult result = mTimeline->initialise();
+	if (!result.is_successfull) return(result);
+
+	mCommandPool = std::make_unique<DirectXCommandPool>(md3dDevice.Get(), D3D12_COMMAND_LIST_TYPE_COPY, mTimeline.get());
+
+	result = mHeapAllocator->createResource(HeapClass::UPLOAD_BUFFER, CD3DX12_RESOURCE_DESC::Buffer(mStagingSize), D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, mStaging);
+	if (!result.is_successfull) return(FunctionResult(false, RESULT::FAIL, "Failed to create the copy staging buffer. " + result.message));
+
+	CD3DX12_RANGE readRange(0, 0);
+	hr = mStaging.resource->Map(0, &readRange, &mStagingMemory);
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to map the copy staging buffer."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created the copy queue."));
+}
+
+SyrenEngine::Timeline* SyrenEngine::DirectXCopyBackend::timeline() {
+	return mTimeline.get();
+}
+
+void* SyrenEngine::DirectXCopyBackend::stagingMemory() {
+	return mStagingMemory;
+}
+
+std::uint64_t SyrenEngine::DirectXCopyBackend::stagingSize() const {
+	return mStagingSize;
+}
+
+std::uint64_t SyrenEngine::DirectXCopyBackend::textureStagingSize(const TextureUpload& upload) {
+	return(GetRequiredIntermediateSize(static_cast<ID3D12Resource*>(upload.destination), upload.firstSubresource, upload.subresourceCount));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::DirectXCopyBackend::copyBuffer(const BufferUpload& upload, const UploadAllocation& staging) {
+	FunctionResult result = openContext();
+	if (!result.is_successfull) return(result);
+
+	mContext.list->CopyBufferRegion(static_cast<ID3D12Resource*>(upload.destination), upload.destinationOffset, mStaging.resource.Get(), staging.offset, upload.size);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Buffer copy recorded."));
+}
+
+/** Lets UpdateSubresources lay the subresources out in the staging buffer and record their copies. */
+SyrenEngine::FunctionResult SyrenEngine::DirectXCopyBackend::copyTexture(const TextureUpload& upload, const UploadAllocation& staging) {
+	FunctionResult result = openContext();
+	if (!result.is_successfull) return(result);
+
+	mSubresourceData.resize(upload.subresourceCount);
+	for (std::uint32_t i = 0; i < upload.subresourceCount; ++i) {
+		mSubresourceData[i].pData = upload.subresources[i].data;
+		mSubresourceData[i].RowPitch = static_cast<LONG_PTR>(upload.subresources[i].rowPitch);
+		mSubresourceData[i].SlicePitch = static_cast<LONG_PTR>(upload.subresources[i].slicePitch);
+	}
+
+	UINT64 size = UpdateSubresources(mContext.list.Get(), static_cast<ID3D12Resource*>(upload.destination), mStaging.resource.Get(), staging.offset,
+		upload.firstSubresource, upload.subresourceCount, mSubresourceData.data());
+	if (size == 0) return(FunctionResult(false, RESULT::FAIL, "Failed to record a texture upload."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Texture copy recorded."));
+}
+
+/** Executes the open batch on the copy queue and recycles its context once the batch completes. */
+SyrenEngine::FunctionResult SyrenEngine::DirectXCopyBackend::submit(std::uint64_t& fenceValue) {
+	if (!mContext.list) return(FunctionResult(false, RESULT::FAIL, "No copies have been recorded."));
+
+	HRESULT hr = mContext.list->Close();
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to close the copy command list."));
+
+	ID3D12CommandList* cmdsLists[] = { mContext.list.Get() };
+	mCopyQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+
+	FunctionResult result = mTimeline->signal(fenceValue);
+	if (!result.is_successfull) return(result);
+
+	mCommandPool->retire(mContext, fenceValue);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Copy batch submitted."));
+}
+
+ID3D12Fence* SyrenEngine::DirectXCopyBackend::fence() const {
+	return mTimeline->fence();
+}
+
+/** Acquires a command context for the open batch if it does not have one yet. */
+SyrenEngine::FunctionResult SyrenEngine::DirectXCopyBackend::openContext() {
+	if (mContext.list) return(FunctionResult(true, RESULT::SSUCCESS, "Copy context is open."));
+	return(mCommandPool->acquire(mContext));
+}
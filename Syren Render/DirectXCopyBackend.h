@@ -0,0 +1,83 @@
+/***********************************************************************************************************
+ * @file DirectXCopyBackend.h
+ *
+ * @brief Declares the copy backend that records uploads on a dedicated D3D12 copy queue
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The backend owns a copy queue with its own fence timeline and command pool, and a persistently
+ * mapped staging buffer placed by the DirectXHeapAllocator. Buffer uploads become CopyBufferRegion
+ * calls and texture uploads go through UpdateSubresources, which writes the rows into the staging
+ * buffer in the footprint layout and records one CopyTextureRegion per subresource.
+ *
+ * Destinations are ID3D12Resources in the COMMON state. The copy queue promotes them to COPY_DEST
+ * implicitly and they decay back to COMMON once the batch has executed, so no barriers are recorded.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include "./D3DX12/d3dx12.h"
+
+#include <Windows.h>
+#include <wrl.h>
+
+#include <d3d12.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "DirectXCommandPool.h"
+#include "DirectXHeapAllocator.h"
+#include "DirectXTimeline.h"
+#include "UploadBatcher.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	static const std::uint64_t DefaultCopyStagingSize = 32ull << 20;
+
+	class DirectXCopyBackend : public CopyBackend {
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device> md3dDevice;
+		DirectXHeapAllocator* mHeapAllocator;
+
+		Microsoft::WRL::ComPtr<ID3D12CommandQueue> mCopyQueue;
+		std::unique_ptr<DirectXTimeline> mTimeline;
+		std::unique_ptr<DirectXCommandPool> mCommandPool;
+		DirectXCommandContext mContext; /*!< Context of the open batch, empty until the first copy is recorded */
+
+		DirectXPlacedResource mStaging;
+		void* mStagingMemory = nullptr;
+		std::uint64_t mStagingSize;
+
+		std::vector<D3D12_SUBRESOURCE_DATA> mSubresourceData;
+	public:
+		DirectXCopyBackend(ID3D12Device* pDevice, DirectXHeapAllocator* pHeapAllocator, std::uint64_t pStagingSize = DefaultCopyStagingSize);
+		~DirectXCopyBackend();
+
+		FunctionResult initialise();
+
+		virtual Timeline* timeline();
+		virtual void* stagingMemory();
+		virtual std::uint64_t stagingSize() const;
+		virtual std::uint64_t textureStagingSize(const TextureUpload& upload);
+		virtual FunctionResult copyBuffer(const BufferUpload& upload, const UploadAllocation& staging);
+		virtual FunctionResult copyTexture(const TextureUpload& upload, const UploadAllocation& staging);
+		virtual FunctionResult submit(std::uint64_t& fenceValue);
+
+		ID3D12Fence* fence() const;
+	private:
+		DirectXCopyBackend() = delete;
+		DirectXCopyBackend(const DirectXCopyBackend& rhs) = delete;
+		DirectXCopyBackend& operator=(const DirectXCopyBackend& rhs) = delete;
+
+		FunctionResult openContext();
+	};
+}
@@ -0,0 +1,122 @@
+/***********************************************************************************************************
+ * @file DirectXDescriptorAllocator.cpp
+ *
+ * @brief Implements functions of the classes found in DirectXDescriptorAllocator.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "DirectXDescriptorAllocator.h"
+
+
+/** Creates a CPU-only staging heap.
+ *
+ * @param[in] device: Device the heap is created on.
+ * @param[in] type: Type of descriptors in the heap.
+ * @param[in] capacity: Number of descriptors in the heap.
+ *
+ * @retval FunctionResult indicating the success of the heap creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXDescriptorHeap::initialise(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT capacity) {
+	D3D12_DESCRIPTOR_HEAP_DESC heapDesc;
+	heapDesc.NumDescriptors = capacity;
+	heapDesc.Type = type;
+	heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+	heapDesc.NodeMask = 0;
+
+	HRESULT hr = device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(mHeap.ReleaseAndGetAddressOf()));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create a staging descriptor heap."));
+
+	mCpuStart = mHeap->GetCPUDescriptorHandleForHeapStart();
+	mIncrementSize = device->GetDescriptorHandleIncrementSize(type);
+	mFreeList.initialise(capacity);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created a staging descriptor heap."));
+}
+
+/** Takes a descriptor to create a view in.
+ *
+ * @retval False if the heap is full.
+ */
+bool SyrenEngine::DirectXDescriptorHeap::allocate(DirectXDescriptor& descriptor) {
+	if (!mFreeList.allocate(descriptor.index)) return false;
+
+	descriptor.cpu = CD3DX12_CPU_DESCRIPTOR_HANDLE(mCpuStart, descriptor.index, mIncrementSize);
+	return true;
+}
+
+void SyrenEngine::DirectXDescriptorHeap::free(DirectXDescriptor& descriptor) {
+	mFreeList.free(descriptor.index);
+	descriptor.cpu = {};
+}
+
+/** Creates a shader visible heap and splits it between the frames in flight.
+ *
+ * @param[in] device: Device the heap is created on.
+ * @param[in] type: CBV_SRV_UAV or SAMPLER.
+ * @param[in] capacity: Number of descriptors in the heap.
+ * @param[in] frameCount: Number of frames that may be in flight at once.
+ * @param[in] reservedCount: Descriptors kept out of the ring at the start of the heap.
+ *
+ * @retval FunctionResult indicating the success of the heap creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXDescriptorRing::initialise(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT capacity, std::size_t frameCount, UINT reservedCount) {
+	if (reservedCount >= capacity) return(FunctionResult(false, RESULT::FAIL, "Descriptor ring reserves its whole heap."));
+
+	D3D12_DESCRIPTOR_HEAP_DESC heapDesc;
+	heapDesc.NumDescriptors = capacity;
+	heapDesc.Type = type;
+	heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	heapDesc.NodeMask = 0;
+
+	HRESULT hr = device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(mHeap.ReleaseAndGetAddressOf()));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create a shader visible descriptor heap."));
+
+	md3dDevice = device;
+	mType = type;
+	mCpuStart = mHeap->GetCPUDescriptorHandleForHeapStart();
+	mGpuStart = mHeap->GetGPUDescriptorHandleForHeapStart();
+	mIncrementSize = device->GetDescriptorHandleIncrementSize(type);
+	mReservedCount = reservedCount;
+	return(mRing.initialise(capacity - reservedCount, frameCount));
+}
+
+void SyrenEngine::DirectXDescriptorRing::beginFrame(std::size_t frameIndex) {
+	mRing.beginFrame(frameIndex);
+}
+
+/** Gathers scattered staging descriptors into a contiguous table of the current frame.
+ *
+ * @param[in] sources: Staging descriptors in table order.
+ * @param[in] count: Number of descriptors in the table.
+ * @param[out] table: GPU handle of the first descriptor of the table.
+ *
+ * @retval False if the frame has run out of descriptors.
+ */
+bool SyrenEngine::DirectXDescriptorRing::copyTable(const D3D12_CPU_DESCRIPTOR_HANDLE* sources, UINT count, D3D12_GPU_DESCRIPTOR_HANDLE& table) {
+	DescriptorIndex first;
+	if (!mRing.allocate(count, first)) return false;
+	first += mReservedCount;
+
+	D3D12_CPU_DESCRIPTOR_HANDLE destination = CD3DX12_CPU_DESCRIPTOR_HANDLE(mCpuStart, first, mIncrementSize);
+	md3dDevice->CopyDescriptors(1, &destination, &count, count, sources, nullptr, mType);
+
+	table = CD3DX12_GPU_DESCRIPTOR_HANDLE(mGpuStart, first, mIncrementSize);
+	return true;
+}
+
+/** Copies a contiguous range of staging descriptors into a table of the current frame. */
+bool SyrenEngine::DirectXDescriptorRing::copyRange(D3D12_CPU_DESCRIPTOR_HANDLE source, UINT count, D3D12_GPU_DESCRIPTOR_HANDLE& table) {
+	DescriptorIndex first;
+	if (!mRing.allocate(count, first)) return false;
+	first += mReservedCount;
+
+	md3dDevice->CopyDescriptorsSimple(count, CD3DX12_CPU_DESCRIPTOR_HANDLE(mCpuStart, first, mIncrementSize), source, mType);
+
+	table = CD3DX12_GPU_DESCRIPTOR_HANDLE(mGpuStart, first, mIncrementSize);
+	return true;
+}
@@ -0,0 +1,105 @@
+/***********************************************************************************************************
+ * @file DirectXDescriptorAllocator.h
+ *
+ * @brief Declares the D3D12 staging descriptor heaps and the per-frame shader visible descriptor ring
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Views are created in CPU-only staging heaps, which are cheap to write and never bound. At draw time
+ * the views a table needs are copied into the shader visible ring with one CopyDescriptors call, so
+ * the tables of a frame are contiguous ranges of the only heap that is bound. Since the copy takes a
+ * snapshot, a staging descriptor may be freed or overwritten as soon as its tables have been copied.
+ *
+ * The shader visible CBV/SRV/UAV heap starts with the bindless region, whose slots are handed out by
+ * a BindlessTable and written once per resource; the ring only uses the descriptors behind it.
+ *
+ * Both heaps are created at initialisation and never grow. CopyDescriptors is free-threaded and the
+ * index allocators are lock-free, so any thread may create views and copy tables.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include "./D3DX12/d3dx12.h"
+
+#include <Windows.h>
+#include <wrl.h>
+
+#include <d3d12.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "DescriptorAllocator.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	static const UINT StagingRtvDescriptorCount = 256;
+	static const UINT StagingDsvDescriptorCount = 64;
+	static const UINT StagingCbvSrvUavDescriptorCount = 16384;
+	static const UINT StagingSamplerDescriptorCount = 1024;
+	static const UINT ShaderVisibleCbvSrvUavDescriptorCount = 1000000; /*!< Limit for shader visible heaps on binding tiers 1 and 2 */
+	static const UINT BindlessDescriptorCount = 1u << 19;
+	static const UINT ShaderVisibleSamplerDescriptorCount = 2048; /*!< Hardware limit for shader visible sampler heaps */
+
+	/** A descriptor of a staging heap. */
+	struct DirectXDescriptor {
+		DescriptorIndex index = InvalidDescriptor;
+		D3D12_CPU_DESCRIPTOR_HANDLE cpu = {};
+	};
+
+	class DirectXDescriptorHeap {
+	private:
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mHeap;
+		D3D12_CPU_DESCRIPTOR_HANDLE mCpuStart = {};
+		UINT mIncrementSize = 0;
+		DescriptorFreeList mFreeList;
+	public:
+		DirectXDescriptorHeap() = default;
+
+		FunctionResult initialise(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT capacity);
+
+		bool allocate(DirectXDescriptor& descriptor);
+		void free(DirectXDescriptor& descriptor);
+
+		std::uint32_t capacity() const { return mFreeList.capacity(); }
+		std::uint32_t allocatedCount() const { return mFreeList.allocatedCount(); }
+	private:
+		DirectXDescriptorHeap(const DirectXDescriptorHeap& rhs) = delete;
+		DirectXDescriptorHeap& operator=(const DirectXDescriptorHeap& rhs) = delete;
+	};
+
+	class DirectXDescriptorRing {
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device> md3dDevice;
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mHeap;
+		D3D12_DESCRIPTOR_HEAP_TYPE mType = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+		D3D12_CPU_DESCRIPTOR_HANDLE mCpuStart = {};
+		D3D12_GPU_DESCRIPTOR_HANDLE mGpuStart = {};
+		UINT mIncrementSize = 0;
+		UINT mReservedCount = 0; /*!< Descriptors at the start of the heap that the ring does not touch */
+		DescriptorRing mRing;
+	public:
+		DirectXDescriptorRing() = default;
+
+		FunctionResult initialise(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT capacity, std::size_t frameCount, UINT reservedCount = 0);
+		void beginFrame(std::size_t frameIndex);
+
+		bool copyTable(const D3D12_CPU_DESCRIPTOR_HANDLE* sources, UINT count, D3D12_GPU_DESCRIPTOR_HANDLE& table);
+		bool copyRange(D3D12_CPU_DESCRIPTOR_HANDLE source, UINT count, D3D12_GPU_DESCRIPTOR_HANDLE& table);
+
+		D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle(UINT index) const { return CD3DX12_CPU_DESCRIPTOR_HANDLE(mCpuStart, index, mIncrementSize); }
+		D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle(UINT index) const { return CD3DX12_GPU_DESCRIPTOR_HANDLE(mGpuStart, index, mIncrementSize); }
+		ID3D12DescriptorHeap* heap() const { return mHeap.Get(); }
+		std::uint32_t usedCount() const { return mRing.usedCount(); }
+	private:
+		DirectXDescriptorRing(const DirectXDescriptorRing& rhs) = delete;
+		DirectXDescriptorRing& operator=(const DirectXDescriptorRing& rhs) = delete;
+	};
+}
@@ -0,0 +1,121 @@
+/***********************************************************************************************************
+ * @file DirectXHeapAllocator.cpp
+ *
+ * @brief Implements functions of the DirectXHeapAllocator class found in DirectXHeapAllocator.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "DirectXHeapAllocator.h"
+
+
+/** Constructor for the DirectXHeapAllocator class.
+ *
+ * @param[in] pDevice: Device the heaps and resources are created on.
+ * @param[in] pPageSize: Size of a regular heap.
+ */
+SyrenEngine::DirectXHeapAllocator::DirectXHeapAllocator(ID3D12Device* pDevice, std::uint64_t pPageSize) : md3dDevice(pDevice), mAllocator(this, pPageSize) {}
+
+/** Creates a resource placed into a sub-allocated range.
+ *
+ * @param[in] heapClass: Class of heap the resource belongs in.
+ * @param[in] desc: Description of the resource.
+ * @param[in] initialState: State the resource is created in.
+ * @param[in] clearValue: Optimised clear value for render targets and depth stencils, otherwise nullptr.
+ * @param[out] placed: The resource and the range it occupies.
+ *
+ * @retval FunctionResult indicating the success of the resource creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXHeapAllocator::createResource(HeapClass heapClass, const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES initialState,
+	const D3D12_CLEAR_VALUE* clearValue, DirectXPlacedResource& placed) {
+	D3D12_RESOURCE_ALLOCATION_INFO info = md3dDevice->GetResourceAllocationInfo(0, 1, &desc);
+	if (info.SizeInBytes == UINT64_MAX) return(FunctionResult(false, RESULT::FAIL, "Invalid description of a placed resource."));
+
+	FunctionResult result = mAllocator.allocate(heapClass, info.SizeInBytes, info.Alignment, placed.allocation);
+	if (!result.is_successfull) return(result);
+
+	HRESULT hr = md3dDevice->CreatePlacedResource(heap(placed.allocation), placed.allocation.offset, &desc, initialState, clearValue, IID_PPV_ARGS(placed.resource.ReleaseAndGetAddressOf()));
+	if (FAILED(hr)) {
+		mAllocator.free(placed.allocation);
+		return(FunctionResult(false, RESULT::FAIL, "Failed to create a placed resource."));
+	}
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Created a placed resource."));
+}
+
+/** Allocates a raw range for resources the caller places itself, such as aliased transients. */
+SyrenEngine::FunctionResult SyrenEngine::DirectXHeapAllocator::allocate(HeapClass heapClass, std::uint64_t size, std::uint64_t alignment, HeapAllocation& allocation) {
+	return(mAllocator.allocate(heapClass, size, alignment, allocation));
+}
+
+/** Destroys a placed resource and returns its range. */
+void SyrenEngine::DirectXHeapAllocator::release(DirectXPlacedResource& placed) {
+	placed.resource.Reset();
+	mAllocator.free(placed.allocation);
+}
+
+void SyrenEngine::DirectXHeapAllocator::free(HeapAllocation& allocation) {
+	mAllocator.free(allocation);
+}
+
+ID3D12Heap* SyrenEngine::DirectXHeapAllocator::heap(const HeapAllocation& allocation) const {
+	if (!allocation.valid()) return nullptr;
+	return mHeaps[static_cast<std::size_t>(allocation.heapClass)][allocation.page].Get();
+}
+
+SyrenEngine::HeapStatistics SyrenEngine::DirectXHeapAllocator::statistics(HeapClass heapClass) const {
+	return(mAllocator.statistics(heapClass));
+}
+
+/** Creates the D3D12 heap of a new page.
+ *
+ * @details
+ * CPU visible buffers get upload or readback heaps. Everything else lives in default heaps restricted
+ * to one resource category, as resource heap tier 1 requires.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXHeapAllocator::createHeap(HeapClass heapClass, std::uint32_t page, std::uint64_t size) {
+	D3D12_HEAP_DESC heapDesc = {};
+	heapDesc.SizeInBytes = size;
+	heapDesc.Alignment = HeapAllocator::classAlignment(heapClass);
+
+	switch (heapClass) {
+	case HeapClass::UPLOAD_BUFFER:
+		heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+		heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		break;
+	case HeapClass::READBACK_BUFFER:
+		heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK);
+		heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		break;
+	case HeapClass::TEXTURE:
+		heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+		heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+		break;
+	case HeapClass::RENDER_TARGET:
+	case HeapClass::MSAA_RENDER_TARGET:
+		heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+		heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+		break;
+	default:
+		heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+		heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		break;
+	}
+
+	std::vector<Microsoft::WRL::ComPtr<ID3D12Heap> >& heaps = mHeaps[static_cast<std::size_t>(heapClass)];
+	if (page >= heaps.size()) heaps.resize(page + 1);
+
+	HRESULT hr = md3dDevice->CreateHeap(&heapDesc, IID_PPV_ARGS(heaps[page].ReleaseAndGetAddressOf()));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create a resource heap."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Created a resource heap."));
+}
+
+void SyrenEngine::DirectXHeapAllocator::destroyHeap(HeapClass heapClass, std::uint32_t page) {
+	mHeaps[static_cast<std::size_t>(heapClass)][page].Reset();
+}
@@ -0,0 +1,70 @@
+/***********************************************************************************************************
+ * @file DirectXHeapAllocator.h
+ *
+ * @brief Places D3D12 resources into heaps sub-allocated by the HeapAllocator
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Each heap class maps onto one heap type and set of heap flags, chosen so that every class is valid
+ * on resource heap tier 1. Creating a resource is a range allocation and a CreatePlacedResource call
+ * into an existing heap; a kernel allocation only happens when a class runs out of pages.
+ *
+ * Releasing a placed resource returns its range straight away, so the caller must make sure the GPU no
+ * longer uses the resource.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include "./D3DX12/d3dx12.h"
+
+#include <Windows.h>
+#include <wrl.h>
+
+#include <d3d12.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "HeapAllocator.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	/** A resource placed into a range of a sub-allocated heap. */
+	struct DirectXPlacedResource {
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+		HeapAllocation allocation;
+	};
+
+	class DirectXHeapAllocator : public HeapSource {
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device> md3dDevice;
+		std::vector<Microsoft::WRL::ComPtr<ID3D12Heap> > mHeaps[static_cast<std::size_t>(HeapClass::COUNT)];
+
+		HeapAllocator mAllocator;
+	public:
+		DirectXHeapAllocator(ID3D12Device* pDevice, std::uint64_t pPageSize = DefaultHeapPageSize);
+
+		FunctionResult createResource(HeapClass heapClass, const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* clearValue,
+			DirectXPlacedResource& placed);
+		FunctionResult allocate(HeapClass heapClass, std::uint64_t size, std::uint64_t alignment, HeapAllocation& allocation);
+		void release(DirectXPlacedResource& placed);
+		void free(HeapAllocation& allocation);
+
+		ID3D12Heap* heap(const HeapAllocation& allocation) const;
+		HeapStatistics statistics(HeapClass heapClass) const;
+
+		virtual FunctionResult createHeap(HeapClass heapClass, std::uint32_t page, std::uint64_t size);
+		virtual void destroyHeap(HeapClass heapClass, std::uint32_t page);
+	private:
+		DirectXHeapAllocator() = delete;
+		DirectXHeapAllocator(const DirectXHeapAllocator& rhs) = delete;
+		DirectXHeapAllocator& operator=(const DirectXHeapAllocator& rhs) = delete;
+	};
+}
@@ -0,0 +1,233 @@
+/***********************************************************************************************************
+ * @file DirectXPipelineCache.cpp
+ *
+ * @brief Implements functions of the DirectXPipelineCache class found in DirectXPipelineCache.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "DirectXPipelineCache.h"
+
+#include "Hash.h"
+
+
+namespace {
+	void addShader(SyrenEngine::Hasher& hasher, const D3D12_SHADER_BYTECODE& shader) {
+		hasher.addBlock(shader.pShaderBytecode, shader.BytecodeLength);
+	}
+
+	void addDepthStencilOp(SyrenEngine::Hasher& hasher, const D3D12_DEPTH_STENCILOP_DESC& op) {
+		hasher.add(op.StencilFailOp);
+		hasher.add(op.StencilDepthFailOp);
+		hasher.add(op.StencilPassOp);
+		hasher.add(op.StencilFunc);
+	}
+}
+
+
+/** Constructor for the DirectXPipelineCache class.
+ *
+ * @param[in] pDevice: Device the pipelines are created on.
+ */
+SyrenEngine::DirectXPipelineCache::DirectXPipelineCache(ID3D12Device* pDevice) : md3dDevice(pDevice) {}
+
+/** Loads the cache file if it was written for the same adapter and driver.
+ *
+ * @param[in] adapter: Adapter the device was created on.
+ * @param[in] path: Cache file.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXPipelineCache::initialise(IDXGIAdapter1* adapter, const std::string& path) {
+	DXGI_ADAPTER_DESC1 desc = {};
+	HRESULT hr = adapter->GetDesc1(&desc);
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to query the adapter identity."));
+
+	// Reports the version of the user mode driver, which compiles the pipelines
+	LARGE_INTEGER driverVersion = {};
+	hr = adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &driverVersion);
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to query the driver version."));
+
+	PipelineCacheIdentity identity;
+	identity.vendorId = desc.VendorId;
+	identity.deviceId = desc.DeviceId;
+	identity.subSysId = desc.SubSysId;
+	identity.revision = desc.Revision;
+	identity.driverVersion = static_cast<std::uint64_t>(driverVersion.QuadPart);
+
+	return(mCache.load(path, identity));
+}
+
+/** Writes the pipelines compiled during this run to the cache file. No pipeline may be in creation. */
+SyrenEngine::FunctionResult SyrenEngine::DirectXPipelineCache::save() {
+	return(mCache.save());
+}
+
+/** Creates a graphics pipeline state from the cache, compiling and caching it on a miss.
+ *
+ * @param[in] desc: Pipeline description. Its CachedPSO is ignored.
+ * @param[in] rootSignatureHash: Stable hash of the serialized root signature the description references.
+ * @param[out] pipeline: Created pipeline state.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if the pipeline was compiled but its blob could not be cached.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXPipelineCache::createGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash,
+	Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipeline) {
+	const std::uint64_t key = hash(desc, rootSignatureHash);
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC cached = desc;
+	cached.CachedPSO = {};
+
+	const void* blob = nullptr;
+	std::size_t size = 0;
+	if (mCache.find(key, blob, size)) {
+		cached.CachedPSO.pCachedBlob = blob;
+		cached.CachedPSO.CachedBlobSizeInBytes = size;
+
+		HRESULT hr = md3dDevice->CreateGraphicsPipelineState(&cached, IID_PPV_ARGS(&pipeline));
+		if (SUCCEEDED(hr)) return(FunctionResult(true, RESULT::SSUCCESS, "Created the graphics pipeline from the cache."));
+
+		// D3D12_ERROR_DRIVER_VERSION_MISMATCH or a blob the driver does not accept any more
+		cached.CachedPSO = {};
+	}
+
+	HRESULT hr = md3dDevice->CreateGraphicsPipelineState(&cached, IID_PPV_ARGS(&pipeline));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create the graphics pipeline state."));
+
+	return(storeBlob(key, pipeline.Get()));
+}
+
+/** Creates a compute pipeline state from the cache, compiling and caching it on a miss.
+ *
+ * @param[in] desc: Pipeline description. Its CachedPSO is ignored.
+ * @param[in] rootSignatureHash: Stable hash of the serialized root signature the description references.
+ * @param[out] pipeline: Created pipeline state.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if the pipeline was compiled but its blob could not be cached.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXPipelineCache::createComputePipeline(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash,
+	Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipeline) {
+	const std::uint64_t key = hash(desc, rootSignatureHash);
+	D3D12_COMPUTE_PIPELINE_STATE_DESC cached = desc;
+	cached.CachedPSO = {};
+
+	const void* blob = nullptr;
+	std::size_t size = 0;
+	if (mCache.find(key, blob, size)) {
+		cached.CachedPSO.pCachedBlob = blob;
+		cached.CachedPSO.CachedBlobSizeInBytes = size;
+
+		HRESULT hr = md3dDevice->CreateComputePipelineState(&cached, IID_PPV_ARGS(&pipeline));
+		if (SUCCEEDED(hr)) return(FunctionResult(true, RESULT::SSUCCESS, "Created the compute pipeline from the cache."));
+
+		cached.CachedPSO = {};
+	}
+
+	HRESULT hr = md3dDevice->CreateComputePipelineState(&cached, IID_PPV_ARGS(&pipeline));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create the compute pipeline state."));
+
+	return(storeBlob(key, pipeline.Get()));
+}
+
+SyrenEngine::PipelineCacheStatistics SyrenEngine::DirectXPipelineCache::statistics() const {
+	return(mCache.statistics());
+}
+
+/** Hashes every field of a graphics pipeline description that affects the compiled pipeline. */
+std::uint64_t SyrenEngine::DirectXPipelineCache::hash(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash) {
+	Hasher hasher;
+	hasher.add(rootSignatureHash);
+
+	addShader(hasher, desc.VS);
+	addShader(hasher, desc.PS);
+	addShader(hasher, desc.DS);
+	addShader(hasher, desc.HS);
+	addShader(hasher, desc.GS);
+
+	const D3D12_STREAM_OUTPUT_DESC& streamOutput = desc.StreamOutput;
+	hasher.add(streamOutput.NumEntries);
+	for (UINT i = 0; i < streamOutput.NumEntries; ++i) {
+		const D3D12_SO_DECLARATION_ENTRY& entry = streamOutput.pSODeclaration[i];
+		hasher.add(entry.Stream);
+		hasher.addString(entry.SemanticName);
+		hasher.add(entry.SemanticIndex);
+		hasher.add(entry.StartComponent);
+		hasher.add(entry.ComponentCount);
+		hasher.add(entry.OutputSlot);
+	}
+	hasher.addBlock(streamOutput.pBufferStrides, streamOutput.NumStrides * sizeof(UINT));
+	hasher.add(streamOutput.RasterizedStream);
+
+	// Blend and depth stencil descriptions contain padding, so they are hashed member by member
+	hasher.add(desc.BlendState.AlphaToCoverageEnable);
+	hasher.add(desc.BlendState.IndependentBlendEnable);
+	for (const D3D12_RENDER_TARGET_BLEND_DESC& target : desc.BlendState.RenderTarget) {
+		hasher.add(target.BlendEnable);
+		hasher.add(target.LogicOpEnable);
+		hasher.add(target.SrcBlend);
+		hasher.add(target.DestBlend);
+		hasher.add(target.BlendOp);
+		hasher.add(target.SrcBlendAlpha);
+		hasher.add(target.DestBlendAlpha);
+		hasher.add(target.BlendOpAlpha);
+		hasher.add(target.LogicOp);
+		hasher.add(target.RenderTargetWriteMask);
+	}
+	hasher.add(desc.SampleMask);
+	hasher.add(desc.RasterizerState);
+
+	hasher.add(desc.DepthStencilState.DepthEnable);
+	hasher.add(desc.DepthStencilState.DepthWriteMask);
+	hasher.add(desc.DepthStencilState.DepthFunc);
+	hasher.add(desc.DepthStencilState.StencilEnable);
+	hasher.add(desc.DepthStencilState.StencilReadMask);
+	hasher.add(desc.DepthStencilState.StencilWriteMask);
+	addDepthStencilOp(hasher, desc.DepthStencilState.FrontFace);
+	addDepthStencilOp(hasher, desc.DepthStencilState.BackFace);
+
+	hasher.add(desc.InputLayout.NumElements);
+	for (UINT i = 0; i < desc.InputLayout.NumElements; ++i) {
+		const D3D12_INPUT_ELEMENT_DESC& element = desc.InputLayout.pInputElementDescs[i];
+		hasher.addString(element.SemanticName);
+		hasher.add(element.SemanticIndex);
+		hasher.add(element.Format);
+		hasher.add(element.InputSlot);
+		hasher.add(element.AlignedByteOffset);
+		hasher.add(element.InputSlotClass);
+		hasher.add(element.InstanceDataStepRate);
+	}
+
+	hasher.add(desc.IBStripCutValue);
+	hasher.add(desc.PrimitiveTopologyType);
+	hasher.add(desc.NumRenderTargets);
+	for (UINT i = 0; i < desc.NumRenderTargets && i < D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT; ++i)
+		hasher.add(desc.RTVFormats[i]);
+	hasher.add(desc.DSVFormat);
+	hasher.add(desc.SampleDesc.Count);
+	hasher.add(desc.SampleDesc.Quality);
+	hasher.add(desc.NodeMask);
+	hasher.add(desc.Flags);
+	return(hasher.value());
+}
+
+/** Hashes every field of a compute pipeline description that affects the compiled pipeline. */
+std::uint64_t SyrenEngine::DirectXPipelineCache::hash(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash) {
+	Hasher hasher;
+	hasher.add(rootSignatureHash);
+	addShader(hasher, desc.CS);
+	hasher.add(desc.NodeMask);
+	hasher.add(desc.Flags);
+	return(hasher.value());
+}
+
+/** Keeps the compiled blob of a pipeline for the next save(). */
+SyrenEngine::FunctionResult SyrenEngine::DirectXPipelineCache::storeBlob(std::uint64_t key, ID3D12PipelineState* pipeline) {
+	Microsoft::WRL::ComPtr<ID3DBlob> blob;
+	HRESULT hr = pipeline->GetCachedBlob(&blob);
+	if (FAILED(hr) || blob == nullptr) return(FunctionResult(true, RESULT::WSUCCESS, "Compiled the pipeline state, but the driver returned no blob to cache."));
+
+	mCache.store(key, blob->GetBufferPointer(), blob->GetBufferSize());
+	return(FunctionResult(true, RESULT::SSUCCESS, "Compiled the pipeline state and added it to the cache."));
+}
@@ -0,0 +1,65 @@
+/***********************************************************************************************************
+ * @file DirectXPipelineCache.h
+ *
+ * @brief Declares the creation of D3D12 pipeline states through the persistent pipeline cache
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Pipeline descriptions are hashed field by field, following the shader bytecode, input layout and
+ * stream output declarations they point at. The root signature is only referenced by the description,
+ * so callers pass a stable hash of its serialized form. Cached blobs are handed to the driver as
+ * CachedPSO; a blob the driver rejects is dropped and the pipeline is compiled from scratch.
+ *
+ * The identity the cache is validated against is the PCI identity of the adapter together with the
+ * version of its user mode driver, which changes whenever the driver's compiler may have.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <Windows.h>
+#include <wrl.h>
+
+#include <dxgi1_6.h>
+#include <d3d12.h>
+
+#include <cstdint>
+#include <string>
+
+#include "PipelineCache.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	class DirectXPipelineCache {
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device> md3dDevice;
+		PipelineCache mCache;
+	public:
+		DirectXPipelineCache(ID3D12Device* pDevice);
+
+		FunctionResult initialise(IDXGIAdapter1* adapter, const std::string& path);
+		FunctionResult save();
+
+		FunctionResult createGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash,
+			Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipeline);
+		FunctionResult createComputePipeline(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash,
+			Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipeline);
+
+		PipelineCacheStatistics statistics() const;
+
+		static std::uint64_t hash(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash);
+		static std::uint64_t hash(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, std::uint64_t rootSignatureHash);
+	private:
+		DirectXPipelineCache() = delete;
+		DirectXPipelineCache(const DirectXPipelineCache& rhs) = delete;
+		DirectXPipelineCache& operator=(const DirectXPipelineCache& rhs) = delete;
+
+		FunctionResult storeBlob(std::uint64_t key, ID3D12PipelineState* pipeline);
+	};
+}
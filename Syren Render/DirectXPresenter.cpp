@@ -0,0 +1,76 @@
+/***********************************************************************************************************
+ * @file DirectXPresenter.cpp
+ *
+ * @brief Implements functions of the DirectXPresenter class found in DirectXPresenter.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "DirectXPresenter.h"
+
+
+/** Destructor for the DirectXPresenter class. */
+SyrenEngine::DirectXPresenter::~DirectXPresenter() {
+	reset();
+}
+
+/** Binds the presenter to a swap chain created with DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT.
+ *
+ * @param[in] pSwapChain: Swap chain to present.
+ * @param[in] pMaxFrameLatency: Number of frames that may be queued for presentation.
+ *
+ * @retval FunctionResult indicating whether the latency object could be obtained.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXPresenter::initialise(IDXGISwapChain3* pSwapChain, int pMaxFrameLatency) {
+	reset();
+	mSwapChain = pSwapChain;
+
+	HRESULT hr = mSwapChain->SetMaximumFrameLatency(static_cast<UINT>(pMaxFrameLatency));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to set the maximum frame latency."));
+
+	mFrameLatencyWaitableObject = mSwapChain->GetFrameLatencyWaitableObject();
+	if (mFrameLatencyWaitableObject == nullptr) return(FunctionResult(false, RESULT::FAIL, "Failed to get the frame latency waitable object."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the presenter."));
+}
+
+/** Releases the swap chain and closes the latency object. */
+void SyrenEngine::DirectXPresenter::reset() {
+	if (mFrameLatencyWaitableObject != nullptr) {
+		CloseHandle(mFrameLatencyWaitableObject);
+		mFrameLatencyWaitableObject = nullptr;
+	}
+	mSwapChain.Reset();
+}
+
+/** Blocks on the swap chain's frame latency object.
+ *
+ * @param[in] timeoutMs: Longest time to block for.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if the timeout expired.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXPresenter::waitForLatency(std::uint32_t timeoutMs) {
+	if (mFrameLatencyWaitableObject == nullptr) return(FunctionResult(false, RESULT::FAIL, "The presenter has not been initialised."));
+
+	DWORD status = WaitForSingleObjectEx(mFrameLatencyWaitableObject, timeoutMs, TRUE);
+	if (status == WAIT_TIMEOUT) return(FunctionResult(true, RESULT::WSUCCESS, "Timed out waiting for the frame latency object."));
+	if (status == WAIT_FAILED) return(FunctionResult(false, RESULT::FAIL, "Failed to wait for the frame latency object."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Frame latency object signalled."));
+}
+
+/** Presents the current back buffer.
+ *
+ * @param[in] syncInterval: Number of vertical blanks to synchronise with.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXPresenter::present(std::uint32_t syncInterval) {
+	HRESULT hr = mSwapChain->Present(syncInterval, 0);
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to present the swap chain."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Presented."));
+}
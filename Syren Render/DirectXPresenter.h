@@ -0,0 +1,45 @@
+/***********************************************************************************************************
+ * @file DirectXPresenter.h
+ *
+ * @brief Implements the FramePresenter interface over a latency-waitable DXGI swap chain
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <Windows.h>
+#include <wrl.h>
+
+#include <dxgi1_6.h>
+
+#include <cstdint>
+
+#include "FramePacing.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	class DirectXPresenter : public FramePresenter {
+	private:
+		Microsoft::WRL::ComPtr<IDXGISwapChain3> mSwapChain;
+		HANDLE mFrameLatencyWaitableObject = nullptr;
+	public:
+		DirectXPresenter() = default;
+		~DirectXPresenter();
+
+		FunctionResult initialise(IDXGISwapChain3* pSwapChain, int pMaxFrameLatency);
+		void reset();
+
+		virtual FunctionResult waitForLatency(std::uint32_t timeoutMs);
+		virtual FunctionResult present(std::uint32_t syncInterval);
+	private:
+		DirectXPresenter(const DirectXPresenter& rhs) = delete;
+		DirectXPresenter& operator=(const DirectXPresenter& rhs) = delete;
+	};
+}
@@ -0,0 +1,47 @@
+/***********************************************************************************************************
+ * @file DirectXResidencySource.cpp
+ *
+ * @brief Implements functions of the DirectXResidencySource class found in DirectXResidencySource.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "DirectXResidencySource.h"
+
+
+/** Constructor for the DirectXResidencySource class.
+ *
+ * @param[in] pDevice: Device the tracked objects were created on.
+ * @param[in] pAdapter: Adapter of the device, which reports the budget.
+ */
+SyrenEngine::DirectXResidencySource::DirectXResidencySource(ID3D12Device* pDevice, IDXGIAdapter3* pAdapter) : md3dDevice(pDevice), mAdapter(pAdapter) {}
+
+SyrenEngine::FunctionResult SyrenEngine::DirectXResidencySource::queryBudget(ResidencyBudget& budget) {
+	DXGI_QUERY_VIDEO_MEMORY_INFO info = {};
+	HRESULT hr = mAdapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &info);
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to query the video memory budget."));
+
+	budget.budget = info.Budget;
+	budget.usage = info.CurrentUsage;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Queried the video memory budget."));
+}
+
+/** Pages objects back in. MakeResident returns once the memory is available to the GPU. */
+SyrenEngine::FunctionResult SyrenEngine::DirectXResidencySource::makeResident(void* const* objects, std::uint32_t count) {
+	HRESULT hr = md3dDevice->MakeResident(count, reinterpret_cast<ID3D12Pageable* const*>(objects));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to make objects resident."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Made objects resident."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::DirectXResidencySource::evict(void* const* objects, std::uint32_t count) {
+	HRESULT hr = md3dDevice->Evict(count, reinterpret_cast<ID3D12Pageable* const*>(objects));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to evict objects."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Evicted objects."));
+}
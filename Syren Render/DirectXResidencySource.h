@@ -0,0 +1,49 @@
+/***********************************************************************************************************
+ * @file DirectXResidencySource.h
+ *
+ * @brief Declares the residency source that pages D3D12 heaps and resources in and out
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The budget is the local segment group reported by IDXGIAdapter3::QueryVideoMemoryInfo, which the OS
+ * updates as other processes come and go. Tracked objects are ID3D12Pageables, i.e. heaps and committed
+ * resources; placed resources are paged with the heap they live in.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <Windows.h>
+#include <wrl.h>
+
+#include <dxgi1_6.h>
+#include <d3d12.h>
+
+#include <cstdint>
+
+#include "ResidencyManager.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	class DirectXResidencySource : public ResidencySource {
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device> md3dDevice;
+		Microsoft::WRL::ComPtr<IDXGIAdapter3> mAdapter;
+	public:
+		DirectXResidencySource(ID3D12Device* pDevice, IDXGIAdapter3* pAdapter);
+
+		virtual FunctionResult queryBudget(ResidencyBudget& budget);
+		virtual FunctionResult makeResident(void* const* objects, std::uint32_t count);
+		virtual FunctionResult evict(void* const* objects, std::uint32_t count);
+	private:
+		DirectXResidencySource() = delete;
+		DirectXResidencySource(const DirectXResidencySource& rhs) = delete;
+		DirectXResidencySource& operator=(const DirectXResidencySource& rhs) = delete;
+	};
+}
@@ -0,0 +1,253 @@
+/***********************************************************************************************************
+ * @file DirectXRootSignatureRegistry.cpp
+ *
+ * @brief Implements functions of the DirectXRootSignatureRegistry class found in DirectXRootSignatureRegistry.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "DirectXRootSignatureRegistry.h"
+
+#include "./D3DX12/d3dx12.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Hash.h"
+
+
+namespace {
+	void addRange(SyrenEngine::Hasher& hasher, const D3D12_DESCRIPTOR_RANGE& range, UINT offset) {
+		hasher.add(range.RangeType);
+		hasher.add(range.NumDescriptors);
+		hasher.add(range.BaseShaderRegister);
+		hasher.add(range.RegisterSpace);
+		hasher.add(offset);
+	}
+
+	void addRange(SyrenEngine::Hasher& hasher, const D3D12_DESCRIPTOR_RANGE1& range, UINT offset) {
+		hasher.add(range.RangeType);
+		hasher.add(range.NumDescriptors);
+		hasher.add(range.BaseShaderRegister);
+		hasher.add(range.RegisterSpace);
+		hasher.add(range.Flags);
+		hasher.add(offset);
+	}
+
+	/** Hashes a table with the offset every range resolves to, whether it was given or appended. */
+	template<typename Range>
+	void addTable(SyrenEngine::Hasher& hasher, const Range* ranges, UINT count) {
+		hasher.add(count);
+
+		UINT offset = 0;
+		for (UINT i = 0; i < count; ++i) {
+			if (ranges[i].OffsetInDescriptorsFromTableStart != D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND) offset = ranges[i].OffsetInDescriptorsFromTableStart;
+			addRange(hasher, ranges[i], offset);
+			offset += ranges[i].NumDescriptors;
+		}
+	}
+
+	void addDescriptor(SyrenEngine::Hasher& hasher, const D3D12_ROOT_DESCRIPTOR& descriptor) {
+		hasher.add(descriptor.ShaderRegister);
+		hasher.add(descriptor.RegisterSpace);
+	}
+
+	void addDescriptor(SyrenEngine::Hasher& hasher, const D3D12_ROOT_DESCRIPTOR1& descriptor) {
+		hasher.add(descriptor.ShaderRegister);
+		hasher.add(descriptor.RegisterSpace);
+		hasher.add(descriptor.Flags);
+	}
+
+	/** Hashes the member of the parameter union its type selects. */
+	template<typename Parameter>
+	void addParameter(SyrenEngine::Hasher& hasher, const Parameter& parameter) {
+		hasher.add(parameter.ParameterType);
+		hasher.add(parameter.ShaderVisibility);
+
+		switch (parameter.ParameterType) {
+		case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+			addTable(hasher, parameter.DescriptorTable.pDescriptorRanges, parameter.DescriptorTable.NumDescriptorRanges);
+			break;
+		case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+			hasher.add(parameter.Constants.ShaderRegister);
+			hasher.add(parameter.Constants.RegisterSpace);
+			hasher.add(parameter.Constants.Num32BitValues);
+			break;
+		default:
+			addDescriptor(hasher, parameter.Descriptor);
+			break;
+		}
+	}
+
+	/** Hashes a static sampler without the fields its filter and address modes leave unused. */
+	template<typename Sampler>
+	void addSamplerState(SyrenEngine::Hasher& hasher, const Sampler& sampler) {
+		hasher.add(sampler.Filter);
+		hasher.add(sampler.AddressU);
+		hasher.add(sampler.AddressV);
+		hasher.add(sampler.AddressW);
+		hasher.add(sampler.MipLODBias);
+		if (D3D12_DECODE_IS_ANISOTROPIC_FILTER(sampler.Filter)) hasher.add(sampler.MaxAnisotropy);
+		if (D3D12_DECODE_FILTER_REDUCTION(sampler.Filter) == D3D12_FILTER_REDUCTION_TYPE_COMPARISON) hasher.add(sampler.ComparisonFunc);
+		if (sampler.AddressU == D3D12_TEXTURE_ADDRESS_MODE_BORDER || sampler.AddressV == D3D12_TEXTURE_ADDRESS_MODE_BORDER || sampler.AddressW == D3D12_TEXTURE_ADDRESS_MODE_BORDER)
+			hasher.add(sampler.BorderColor);
+		hasher.add(sampler.MinLOD);
+		hasher.add(sampler.MaxLOD);
+		hasher.add(sampler.ShaderRegister);
+		hasher.add(sampler.RegisterSpace);
+		hasher.add(sampler.ShaderVisibility);
+	}
+
+	void addSampler(SyrenEngine::Hasher& hasher, const D3D12_STATIC_SAMPLER_DESC& sampler) {
+		addSamplerState(hasher, sampler);
+	}
+
+#if defined(D3D12_SDK_VERSION) && (D3D12_SDK_VERSION >= 609)
+	void addSampler(SyrenEngine::Hasher& hasher, const D3D12_STATIC_SAMPLER_DESC1& sampler) {
+		addSamplerState(hasher, sampler);
+		hasher.add(sampler.Flags);
+	}
+#endif
+
+	/** Hashes the static samplers ordered by register, since their order does not affect the layout. */
+	template<typename Sampler>
+	void addSamplers(SyrenEngine::Hasher& hasher, const Sampler* samplers, UINT count) {
+		std::vector<const Sampler*> sorted(count);
+		for (UINT i = 0; i < count; ++i)
+			sorted[i] = &samplers[i];
+		std::sort(sorted.begin(), sorted.end(), [](const Sampler* lhs, const Sampler* rhs) {
+			return(lhs->RegisterSpace != rhs->RegisterSpace ? lhs->RegisterSpace < rhs->RegisterSpace : lhs->ShaderRegister < rhs->ShaderRegister);
+		});
+
+		hasher.add(count);
+		for (const Sampler* sampler : sorted)
+			addSampler(hasher, *sampler);
+	}
+
+	template<typename Desc>
+	void addDesc(SyrenEngine::Hasher& hasher, const Desc& desc) {
+		hasher.add(desc.NumParameters);
+		for (UINT i = 0; i < desc.NumParameters; ++i)
+			addParameter(hasher, desc.pParameters[i]);
+		addSamplers(hasher, desc.pStaticSamplers, desc.NumStaticSamplers);
+		hasher.add(desc.Flags);
+	}
+}
+
+
+/** Constructor for the DirectXRootSignatureRegistry class.
+ *
+ * @param[in] pDevice: Device the root signatures are created on.
+ */
+SyrenEngine::DirectXRootSignatureRegistry::DirectXRootSignatureRegistry(ID3D12Device* pDevice) : md3dDevice(pDevice) {}
+
+/** Queries the highest root signature version of the device and prepares the registry. */
+SyrenEngine::FunctionResult SyrenEngine::DirectXRootSignatureRegistry::initialise() {
+	D3D12_FEATURE_DATA_ROOT_SIGNATURE feature = {};
+#if defined(D3D12_SDK_VERSION) && (D3D12_SDK_VERSION >= 609)
+	feature.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_2;
+#else
+	feature.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
+#endif
+	// Runtimes that do not know the requested version fail the query, so step down until one answers
+	while (FAILED(md3dDevice->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &feature, sizeof(feature)))) {
+		if (feature.HighestVersion == D3D_ROOT_SIGNATURE_VERSION_1_0) break;
+		feature.HighestVersion = feature.HighestVersion == D3D_ROOT_SIGNATURE_VERSION_1_1 ? D3D_ROOT_SIGNATURE_VERSION_1_0 : D3D_ROOT_SIGNATURE_VERSION_1_1;
+	}
+	mHighestVersion = feature.HighestVersion;
+
+	return(mRegistry.initialise([](void* rootSignature) { static_cast<ID3D12RootSignature*>(rootSignature)->Release(); }));
+}
+
+/** Releases every root signature. No pipeline or command list may use them any more. */
+void SyrenEngine::DirectXRootSignatureRegistry::shutdown() {
+	mRegistry.shutdown();
+}
+
+/** Returns the shared root signature of a layout, serializing and creating it on the first request.
+ *
+ * @param[in] desc: Root signature description, in any version the runtime knows.
+ * @param[out] handle: Shared root signature.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXRootSignatureRegistry::acquire(const D3D12_VERSIONED_ROOT_SIGNATURE_DESC& desc, RootSignatureHandle& handle) {
+	mCanonical.clear();
+	const std::uint64_t key = hash(desc, &mCanonical);
+
+	return(mRegistry.acquire(key, mCanonical.data(), mCanonical.size(), [this, &desc](void*& rootSignature) {
+		Microsoft::WRL::ComPtr<ID3DBlob> blob;
+		Microsoft::WRL::ComPtr<ID3DBlob> error;
+		HRESULT hr = D3DX12SerializeVersionedRootSignature(&desc, mHighestVersion, &blob, &error);
+		if (FAILED(hr)) {
+			std::string message = "Failed to serialize the root signature.";
+			if (error != nullptr) message += " " + std::string(static_cast<const char*>(error->GetBufferPointer()), error->GetBufferSize());
+			return(FunctionResult(false, RESULT::FAIL, message));
+		}
+
+		Microsoft::WRL::ComPtr<ID3D12RootSignature> created;
+		hr = md3dDevice->CreateRootSignature(0, blob->GetBufferPointer(), blob->GetBufferSize(), IID_PPV_ARGS(&created));
+		if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create the root signature."));
+
+		rootSignature = created.Detach();
+		return(FunctionResult(true, RESULT::SSUCCESS, "Created the root signature."));
+	}, handle));
+}
+
+ID3D12RootSignature* SyrenEngine::DirectXRootSignatureRegistry::get(RootSignatureHandle handle) const {
+	return(static_cast<ID3D12RootSignature*>(mRegistry.get(handle)));
+}
+
+/** Returns the hash pipelines using the root signature are cached under. */
+std::uint64_t SyrenEngine::DirectXRootSignatureRegistry::hash(RootSignatureHandle handle) const {
+	return(mRegistry.key(handle));
+}
+
+std::uint32_t SyrenEngine::DirectXRootSignatureRegistry::sortIndex(RootSignatureHandle handle) const {
+	return(mRegistry.sortIndex(handle));
+}
+
+/** Sets a graphics root signature on a command list unless it is already set. */
+void SyrenEngine::DirectXRootSignatureRegistry::bindGraphics(ID3D12GraphicsCommandList* cmdList, RootSignatureBinding& binding, RootSignatureHandle handle) {
+	if (mRegistry.bindGraphics(binding, handle)) cmdList->SetGraphicsRootSignature(get(handle));
+}
+
+/** Sets a compute root signature on a command list unless it is already set. */
+void SyrenEngine::DirectXRootSignatureRegistry::bindCompute(ID3D12GraphicsCommandList* cmdList, RootSignatureBinding& binding, RootSignatureHandle handle) {
+	if (mRegistry.bindCompute(binding, handle)) cmdList->SetComputeRootSignature(get(handle));
+}
+
+SyrenEngine::RootSignatureStatistics SyrenEngine::DirectXRootSignatureRegistry::statistics() const {
+	return(mRegistry.statistics());
+}
+
+/** Hashes the canonical form of a root signature description.
+ *
+ * @param[in] desc: Root signature description.
+ * @param[out] canonical: Receives the canonical bytes the hash is computed over, if not nullptr.
+ */
+std::uint64_t SyrenEngine::DirectXRootSignatureRegistry::hash(const D3D12_VERSIONED_ROOT_SIGNATURE_DESC& desc, std::vector<unsigned char>* canonical) {
+	Hasher hasher(canonical);
+	hasher.add(desc.Version);
+
+	switch (desc.Version) {
+	case D3D_ROOT_SIGNATURE_VERSION_1_0:
+		addDesc(hasher, desc.Desc_1_0);
+		break;
+	case D3D_ROOT_SIGNATURE_VERSION_1_1:
+		addDesc(hasher, desc.Desc_1_1);
+		break;
+#if defined(D3D12_SDK_VERSION) && (D3D12_SDK_VERSION >= 609)
+	case D3D_ROOT_SIGNATURE_VERSION_1_2:
+		addDesc(hasher, desc.Desc_1_2);
+		break;
+#endif
+	default:
+		break;
+	}
+	return(hasher.value());
+}
@@ -0,0 +1,67 @@
+/***********************************************************************************************************
+ * @file DirectXRootSignatureRegistry.h
+ *
+ * @brief Declares the creation of shared D3D12 root signatures through the root signature registry
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Versioned root signature descriptions are hashed in a canonical form, so descriptions that differ
+ * only in how they are written share one root signature. Descriptor ranges are hashed with their resolved
+ * table offsets, so appended and explicit offsets match. Static samplers are hashed in register order.
+ * Sampler fields that the filter and address modes leave unused are skipped. Each distinct layout is
+ * serialized once, at the highest root signature version the device supports, and then created.
+ *
+ * The hash of a layout is stable between runs and is the root signature hash the pipeline cache expects.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <Windows.h>
+#include <wrl.h>
+
+#include <d3d12.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "RootSignatureRegistry.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	class DirectXRootSignatureRegistry {
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device> md3dDevice;
+		D3D_ROOT_SIGNATURE_VERSION mHighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+		RootSignatureRegistry mRegistry;
+		std::vector<unsigned char> mCanonical; /*!< Canonical description of the layout being acquired */
+	public:
+		DirectXRootSignatureRegistry(ID3D12Device* pDevice);
+
+		FunctionResult initialise();
+		void shutdown();
+
+		FunctionResult acquire(const D3D12_VERSIONED_ROOT_SIGNATURE_DESC& desc, RootSignatureHandle& handle);
+
+		ID3D12RootSignature* get(RootSignatureHandle handle) const;
+		std::uint64_t hash(RootSignatureHandle handle) const;
+		std::uint32_t sortIndex(RootSignatureHandle handle) const;
+
+		void bindGraphics(ID3D12GraphicsCommandList* cmdList, RootSignatureBinding& binding, RootSignatureHandle handle);
+		void bindCompute(ID3D12GraphicsCommandList* cmdList, RootSignatureBinding& binding, RootSignatureHandle handle);
+
+		RootSignatureStatistics statistics() const;
+
+		static std::uint64_t hash(const D3D12_VERSIONED_ROOT_SIGNATURE_DESC& desc, std::vector<unsigned char>* canonical = nullptr);
+	private:
+		DirectXRootSignatureRegistry() = delete;
+		DirectXRootSignatureRegistry(const DirectXRootSignatureRegistry& rhs) = delete;
+		DirectXRootSignatureRegistry& operator=(const DirectXRootSignatureRegistry& rhs) = delete;
+	};
+}
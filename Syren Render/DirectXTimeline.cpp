@@ -0,0 +1,157 @@
+/***********************************************************************************************************
+ * @file DirectXTimeline.cpp
+ *
+ * @brief Implements functions of the DirectXTimeline class found in DirectXTimeline.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "DirectXTimeline.h"
+
+
+/** Constructor for the DirectXTimeline class.
+ *
+ * @param[in] pDevice: Device used to create the fence.
+ * @param[in] pCommandQueue: Queue that signals the fence.
+ */
+SyrenEngine::DirectXTimeline::DirectXTimeline(ID3D12Device* pDevice, ID3D12CommandQueue* pCommandQueue) {
+	md3dDevice = pDevice;
+	mCommandQueue = pCommandQueue;
+	mFence = nullptr;
+}
+
+/** Destructor for the DirectXTimeline class.
+ *
+ * @details
+ * Closes the cached wait events. No thread may be waiting on the timeline at this point.
+ */
+SyrenEngine::DirectXTimeline::~DirectXTimeline() {
+	for (HANDLE eventHandle : mFreeEvents)
+		CloseHandle(eventHandle);
+	mFreeEvents.clear();
+}
+
+/** Creates the fence object backing the timeline.
+ *
+ * @retval FunctionResult indicating the success of the fence creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXTimeline::initialise() {
+	HRESULT hr = md3dDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence));
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to create a fence object."));
+
+	mLastSignaledValue = 0;
+	mCompletedValue = 0;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created a fence object."));
+}
+
+/** Queues a signal of the next fence value on the command queue.
+ *
+ * @details
+ * Signals are serialised so that values reach the queue in increasing order even when several
+ * threads submit work.
+ *
+ * @param[out] value: Fence value that is reached once all previously submitted work completes.
+ *
+ * @retval FunctionResult indicating whether the signal was queued.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXTimeline::signal(std::uint64_t& value) {
+	std::lock_guard<std::mutex> lock(mSignalMutex);
+
+	std::uint64_t nextValue = mLastSignaledValue.load(std::memory_order_relaxed) + 1;
+	HRESULT hr = mCommandQueue->Signal(mFence.Get(), nextValue);
+	if (FAILED(hr)) return(FunctionResult(false, RESULT::FAIL, "Failed to signal the command queue."));
+
+	mLastSignaledValue.store(nextValue, std::memory_order_release);
+	value = nextValue;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Signalled the command queue."));
+}
+
+/** Blocks until the fence reaches the given value.
+ *
+ * @details
+ * Returns straight away when the value is already known to be complete. Otherwise the calling thread
+ * borrows a cached event, so concurrent waiters never share or recreate OS handles.
+ *
+ * @param[in] value: Fence value to wait for.
+ *
+ * @retval FunctionResult indicating whether the wait succeeded.
+ */
+SyrenEngine::FunctionResult SyrenEngine::DirectXTimeline::waitForValue(std::uint64_t value) {
+	if (isComplete(value)) return(FunctionResult(true, RESULT::SSUCCESS, "Fence value reached."));
+
+	if (value > mLastSignaledValue.load(std::memory_order_acquire))
+		return(FunctionResult(false, RESULT::FAIL, "Cannot wait for a fence value that has not been signalled."));
+
+	HANDLE eventHandle = acquireEvent();
+	if (eventHandle == nullptr) return(FunctionResult(false, RESULT::FAIL, "Failed to create a fence wait event."));
+
+	HRESULT hr = mFence->SetEventOnCompletion(value, eventHandle);
+	if (FAILED(hr)) {
+		releaseEvent(eventHandle);
+		return(FunctionResult(false, RESULT::FAIL, "Failed to fire event on fence completion."));
+	}
+
+	WaitForSingleObject(eventHandle, INFINITE);
+	releaseEvent(eventHandle);
+
+	completedValue();
+	return(FunctionResult(true, RESULT::SSUCCESS, "Fence value reached."));
+}
+
+/** Polls the fence and refreshes the cached completed value.
+ *
+ * @retval The last fence value reached by the queue.
+ */
+std::uint64_t SyrenEngine::DirectXTimeline::completedValue() {
+	std::uint64_t value = mFence->GetCompletedValue();
+
+	std::uint64_t cached = mCompletedValue.load(std::memory_order_relaxed);
+	while (cached < value && !mCompletedValue.compare_exchange_weak(cached, value, std::memory_order_relaxed));
+
+	return value;
+}
+
+/** Checks whether a fence value has been reached.
+ *
+ * @details
+ * Answers from the cached completed value and only polls the fence when the cache cannot decide.
+ *
+ * @param[in] value: Fence value to check.
+ */
+bool SyrenEngine::DirectXTimeline::isComplete(std::uint64_t value) {
+	if (value <= mCompletedValue.load(std::memory_order_relaxed)) return true;
+	return(value <= completedValue());
+}
+
+std::uint64_t SyrenEngine::DirectXTimeline::lastSignaledValue() const {
+	return mLastSignaledValue.load(std::memory_order_acquire);
+}
+
+ID3D12Fence* SyrenEngine::DirectXTimeline::fence() const {
+	return mFence.Get();
+}
+
+/** Takes a wait event from the cache, creating one only when the cache is empty. */
+HANDLE SyrenEngine::DirectXTimeline::acquireEvent() {
+	{
+		std::lock_guard<std::mutex> lock(mEventMutex);
+		if (!mFreeEvents.empty()) {
+			HANDLE eventHandle = mFreeEvents.back();
+			mFreeEvents.pop_back();
+			return eventHandle;
+		}
+	}
+
+	return(CreateEventEx(nullptr, NULL, 0, EVENT_ALL_ACCESS));
+}
+
+/** Returns a wait event to the cache. */
+void SyrenEngine::DirectXTimeline::releaseEvent(HANDLE eventHandle) {
+	std::lock_guard<std::mutex> lock(mEventMutex);
+	mFreeEvents.push_back(eventHandle);
+}
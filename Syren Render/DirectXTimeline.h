@@ -0,0 +1,69 @@
+/***********************************************************************************************************
+ * @file DirectXTimeline.h
+ *
+ * @brief Implements the Timeline interface over an ID3D12Fence signalled by a command queue
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Wait events are created on demand and kept in a free list, so steady-state waits do not create or
+ * close any OS handles. Each waiting thread borrows its own event, which lets several threads wait on
+ * different values of the same fence at once.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <Windows.h>
+#include <wrl.h>
+
+#include <d3d12.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "Timeline.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	class DirectXTimeline : public Timeline {
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device> md3dDevice;
+		Microsoft::WRL::ComPtr<ID3D12CommandQueue> mCommandQueue;
+		Microsoft::WRL::ComPtr<ID3D12Fence> mFence;
+
+		std::mutex mSignalMutex;
+		std::atomic<std::uint64_t> mLastSignaledValue = 0;
+		std::atomic<std::uint64_t> mCompletedValue = 0; /*!< Last value observed through GetCompletedValue */
+
+		std::mutex mEventMutex;
+		std::vector<HANDLE> mFreeEvents;
+	public:
+		DirectXTimeline(ID3D12Device* pDevice, ID3D12CommandQueue* pCommandQueue);
+		~DirectXTimeline();
+
+		FunctionResult initialise();
+
+		virtual FunctionResult signal(std::uint64_t& value);
+		virtual FunctionResult waitForValue(std::uint64_t value);
+		virtual std::uint64_t completedValue();
+		virtual bool isComplete(std::uint64_t value);
+		virtual std::uint64_t lastSignaledValue() const;
+
+		ID3D12Fence* fence() const;
+	private:
+		DirectXTimeline() = delete;
+		DirectXTimeline(const DirectXTimeline& rhs) = delete;
+		DirectXTimeline& operator=(const DirectXTimeline& rhs) = delete;
+
+		HANDLE acquireEvent();
+		void releaseEvent(HANDLE eventHandle);
+	};
+}
@@ -0,0 +1,99 @@
+/***********************************************************************************************************
+ * @file FenceRecycler.h
+ *
+ * @brief Declares a thread-safe pool that hands objects back out once the GPU has finished with them
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Objects are retired together with the timeline value of the submission that last used them. Since
+ * a queue completes its work in order, retired objects are kept in a FIFO and only the oldest entry
+ * has to be compared against the completed timeline value. Objects retired with value 0 never reached
+ * the GPU; they are kept apart and handed out first, so they never queue behind a running submission.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Timeline.h"
+
+
+namespace SyrenEngine {
+	template<typename T>
+	class FenceRecycler {
+	private:
+		struct Entry {
+			std::uint64_t fenceValue;
+			T object;
+		};
+
+		Timeline* mTimeline;
+		std::deque<Entry> mRetired; /*!< Objects waiting for their submission, oldest first */
+		std::vector<T> mReady;      /*!< Objects retired with value 0 */
+		mutable std::mutex mMutex;
+
+	public:
+		explicit FenceRecycler(Timeline* pTimeline) : mTimeline(pTimeline) {};
+
+		/** Takes an object retired with value 0, or else the oldest object once its submission has completed.
+		 *
+		 * @param[out] object: Receives the recycled object.
+		 *
+		 * @retval true if an object was recycled, false if the caller has to create a new one.
+		 */
+		bool acquire(T& object) {
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (!mReady.empty()) {
+				object = std::move(mReady.back());
+				mReady.pop_back();
+				return true;
+			}
+
+			if (mRetired.empty()) return false;
+
+			Entry& oldest = mRetired.front();
+			if (!mTimeline->isComplete(oldest.fenceValue)) return false;
+
+			object = std::move(oldest.object);
+			mRetired.pop_front();
+			return true;
+		}
+
+		/** Returns an object to the pool.
+		 *
+		 * @param[in] object: Object to recycle.
+		 * @param[in] fenceValue: Timeline value of the last submission using the object, 0 if it is
+		 *                        immediately reusable.
+		 */
+		void retire(T object, std::uint64_t fenceValue) {
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (fenceValue == 0) {
+				mReady.push_back(std::move(object));
+				return;
+			}
+			mRetired.push_back(Entry{ fenceValue, std::move(object) });
+		}
+
+		std::size_t size() const {
+			std::lock_guard<std::mutex> lock(mMutex);
+			return(mRetired.size() + mReady.size());
+		}
+
+		void clear() {
+			std::lock_guard<std::mutex> lock(mMutex);
+			mRetired.clear();
+			mReady.clear();
+		}
+	};
+}
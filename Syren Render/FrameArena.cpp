@@ -0,0 +1,129 @@
+/***********************************************************************************************************
+ * @file FrameArena.cpp
+ *
+ * @brief Implements functions of the FrameArena and ThreadArenas classes found in FrameArena.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "FrameArena.h"
+
+#include <cstring>
+
+
+/** Constructor for the FrameArena class. No memory is reserved until the first allocation.
+ *
+ * @param[in] pBlockSize: Size of the first block and smallest size of every further one.
+ */
+SyrenEngine::FrameArena::FrameArena(std::size_t pBlockSize) : mBlockSize(pBlockSize) {}
+
+const char* SyrenEngine::FrameArena::copy(const char* text, std::size_t length) {
+	char* destination = allocateArray<char>(length + 1);
+	std::memcpy(destination, text, length);
+	destination[length] = '\0';
+	return destination;
+}
+
+/** Rewinds the arena. Everything allocated from it must no longer be in use.
+ *
+ * @details
+ * If the frame needed several blocks they are merged into one that holds the largest frame so far,
+ * so that later frames of the same size stay within a single block.
+ */
+void SyrenEngine::FrameArena::reset() {
+	const std::size_t used = usedSize();
+	if (used > mHighWater) mHighWater = used;
+
+	if (mBlocks.size() > 1) {
+		const std::size_t size = capacity();
+		mBlocks.clear();
+		addBlock(size > mHighWater ? size : mHighWater);
+	}
+	else if (!mBlocks.empty()) {
+		mCursor = mBlocks.back().memory.get();
+		mEnd = mCursor + mBlocks.back().size;
+	}
+
+	mRetiredSize = 0;
+}
+
+std::size_t SyrenEngine::FrameArena::usedSize() const {
+	if (mBlocks.empty()) return 0;
+	return(mRetiredSize + static_cast<std::size_t>(mCursor - mBlocks.back().memory.get()));
+}
+
+std::size_t SyrenEngine::FrameArena::capacity() const {
+	std::size_t size = 0;
+	for (const Block& block : mBlocks)
+		size += block.size;
+	return size;
+}
+
+/** Chains on a block once the current one is exhausted and allocates from it. */
+void* SyrenEngine::FrameArena::allocateBlock(std::size_t size, std::size_t alignment) {
+	if (!mBlocks.empty()) mRetiredSize += static_cast<std::size_t>(mCursor - mBlocks.back().memory.get());
+
+	std::size_t blockSize = size + alignment;
+	if (blockSize < mBlockSize) blockSize = mBlockSize;
+	if (!mBlocks.empty() && blockSize < mBlocks.back().size * 2) blockSize = mBlocks.back().size * 2;
+	addBlock(blockSize);
+
+	return allocate(size, alignment);
+}
+
+void SyrenEngine::FrameArena::addBlock(std::size_t size) {
+	mBlocks.push_back(Block{ std::make_unique<unsigned char[]>(size), size });
+	mCursor = mBlocks.back().memory.get();
+	mEnd = mCursor + size;
+}
+
+/** Constructor for the ThreadArenas class.
+ *
+ * @param[in] pThreadCount: Largest number of threads that record one frame.
+ * @param[in] pBlockSize: Size of the first block of each arena.
+ */
+SyrenEngine::ThreadArenas::ThreadArenas(std::uint32_t pThreadCount, std::size_t pBlockSize) : mCount(pThreadCount), mClaimed(0) {
+	mArenas = std::make_unique<FrameArena[]>(pThreadCount);
+	mOwners = std::make_unique<std::atomic<std::thread::id>[]>(pThreadCount);
+	for (std::uint32_t i = 0; i < pThreadCount; ++i) {
+		mArenas[i] = FrameArena(pBlockSize);
+		mOwners[i].store(std::thread::id(), std::memory_order_relaxed);
+	}
+}
+
+/** Returns the arena of the calling thread, claiming a free one on the thread's first call of the frame.
+ *
+ * @retval nullptr if more threads than arenas have asked for one.
+ */
+SyrenEngine::FrameArena* SyrenEngine::ThreadArenas::local() {
+	const std::thread::id self = std::this_thread::get_id();
+
+	std::uint32_t claimed = mClaimed.load(std::memory_order_acquire);
+	if (claimed > mCount) claimed = mCount;
+	for (std::uint32_t i = 0; i < claimed; ++i) {
+		if (mOwners[i].load(std::memory_order_relaxed) == self) return &mArenas[i];
+	}
+
+	const std::uint32_t index = mClaimed.fetch_add(1, std::memory_order_acq_rel);
+	if (index >= mCount) return nullptr;
+
+	mOwners[index].store(self, std::memory_order_release);
+	return &mArenas[index];
+}
+
+/** Rewinds every arena and releases the claims. No thread may still use the arenas. */
+void SyrenEngine::ThreadArenas::reset() {
+	std::uint32_t claimed = mClaimed.load(std::memory_order_acquire);
+	if (claimed > mCount) claimed = mCount;
+
+	for (std::uint32_t i = 0; i < claimed; ++i) {
+		mArenas[i].reset();
+		mOwners[i].store(std::thread::id(), std::memory_order_relaxed);
+	}
+	mClaimed.store(0, std::memory_order_release);
+}
@@ -0,0 +1,147 @@
+/***********************************************************************************************************
+ * @file FrameArena.h
+ *
+ * @brief Declares the bump arenas that hold transient CPU data for the duration of a frame
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Allocating from an arena aligns and advances a cursor; nothing is freed individually. The whole
+ * arena is rewound at once when the frame that used it has completed. When a frame needs more than the
+ * current block, further blocks are chained on, and the next reset replaces them with a single block
+ * large enough for the whole frame, so a steady state frame allocates nothing from the general heap.
+ *
+ * ArenaAllocator lets standard containers and strings draw from an arena. Their destructors still run,
+ * but deallocation is a no-op, and growing a container leaves the old storage behind until the reset.
+ * Objects placed directly with create() are never destroyed and must be trivially destructible.
+ *
+ * A FrameArena is used by one thread at a time. ThreadArenas hands each thread that records a frame an
+ * arena of its own without locking.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace SyrenEngine {
+	static const std::size_t DefaultFrameArenaSize = 64ull << 10;
+
+	class FrameArena {
+	private:
+		struct Block {
+			std::unique_ptr<unsigned char[]> memory;
+			std::size_t size;
+		};
+
+		std::vector<Block> mBlocks;
+		unsigned char* mCursor = nullptr;
+		unsigned char* mEnd = nullptr;
+		std::size_t mRetiredSize = 0; /*!< Bytes handed out from blocks before the current one */
+		std::size_t mBlockSize;
+		std::size_t mHighWater = 0;
+
+	public:
+		explicit FrameArena(std::size_t pBlockSize = DefaultFrameArenaSize);
+		FrameArena(FrameArena&& rhs) = default;
+		FrameArena& operator=(FrameArena&& rhs) = default;
+
+		/** Allocates uninitialised memory that stays valid until the next reset.
+		 *
+		 * @param[in] size: Size of the allocation.
+		 * @param[in] alignment: Power of two alignment of the allocation.
+		 */
+		void* allocate(std::size_t size, std::size_t alignment) {
+			const std::uintptr_t address = (reinterpret_cast<std::uintptr_t>(mCursor) + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+			if (mCursor != nullptr && address + size <= reinterpret_cast<std::uintptr_t>(mEnd)) {
+				mCursor = reinterpret_cast<unsigned char*>(address + size);
+				return reinterpret_cast<void*>(address);
+			}
+			return allocateBlock(size, alignment);
+		}
+
+		template<typename T, typename... Args>
+		T* create(Args&&... args) {
+			static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed.");
+			return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		template<typename T>
+		T* allocateArray(std::size_t count) {
+			return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+		}
+
+		/** Copies a string into the arena, e.g. to hand a composed message to code that keeps a pointer. */
+		const char* copy(const char* text, std::size_t length);
+
+		void reset();
+
+		std::size_t usedSize() const;
+		std::size_t capacity() const;
+		std::size_t highWater() const { return mHighWater; }
+	private:
+		FrameArena(const FrameArena& rhs) = delete;
+		FrameArena& operator=(const FrameArena& rhs) = delete;
+
+		void* allocateBlock(std::size_t size, std::size_t alignment);
+		void addBlock(std::size_t size);
+	};
+
+	/** Standard allocator drawing from a FrameArena. */
+	template<typename T>
+	class ArenaAllocator {
+	private:
+		FrameArena* mArena;
+
+	public:
+		typedef T value_type;
+
+		explicit ArenaAllocator(FrameArena* pArena) noexcept : mArena(pArena) {};
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& rhs) noexcept : mArena(rhs.arena()) {};
+
+		T* allocate(std::size_t count) { return mArena->allocateArray<T>(count); }
+		void deallocate(T*, std::size_t) noexcept {}
+
+		FrameArena* arena() const noexcept { return mArena; }
+
+		template<typename U>
+		bool operator==(const ArenaAllocator<U>& rhs) const noexcept { return mArena == rhs.arena(); }
+	};
+
+	template<typename T>
+	using ArenaVector = std::vector<T, ArenaAllocator<T> >;
+	typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char> > ArenaString;
+
+	/** One arena for every thread that records a frame. */
+	class ThreadArenas {
+	private:
+		std::unique_ptr<FrameArena[]> mArenas;
+		std::unique_ptr<std::atomic<std::thread::id>[]> mOwners;
+		std::uint32_t mCount = 0;
+		std::atomic<std::uint32_t> mClaimed;
+
+	public:
+		ThreadArenas(std::uint32_t pThreadCount, std::size_t pBlockSize = DefaultFrameArenaSize);
+
+		FrameArena* local();
+		void reset();
+	private:
+		ThreadArenas(const ThreadArenas& rhs) = delete;
+		ThreadArenas& operator=(const ThreadArenas& rhs) = delete;
+	};
+}
@@ -0,0 +1,90 @@
+/***********************************************************************************************************
+ * @file FramePacing.cpp
+ *
+ * @brief Implements the frame pacing policy declared in FramePacing.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "FramePacing.h"
+
+#include <algorithm>
+
+
+/** Resolves the configured presentation settings into a valid pacing description.
+ *
+ * @details
+ * The buffer count is clamped to the supported range of two to four buffers. At most bufferCount - 1
+ * frames can be queued behind the one being scanned out, which bounds the frame latency. The CPU
+ * records one frame ahead of the frames queued for presentation.
+ *
+ * @param[in] config: Graphics configuration loaded from render.cfg.
+ *
+ * @retval The resolved pacing description.
+ */
+SyrenEngine::FramePacing SyrenEngine::resolveFramePacing(const GraphicsConfig& config) {
+	FramePacing pacing;
+
+	pacing.bufferCount = std::clamp(config.SwapChainBufferCount, MinSwapChainBufferCount, MaxSwapChainBufferCount);
+	pacing.maxFrameLatency = std::clamp(config.MaxFrameLatency, 1, std::min(pacing.bufferCount - 1, MaxFrameLatencyLimit));
+	pacing.framesInFlight = pacing.maxFrameLatency + 1;
+
+	return pacing;
+}
+
+/** Binds the pacer to a presenter.
+ *
+ * @param[in] pPresenter: Presentation surface of the backend.
+ * @param[in] pPacing: Resolved pacing description.
+ * @param[in] pSyncInterval: Number of vertical blanks to wait for on present, 0 for immediate.
+ */
+SyrenEngine::FunctionResult SyrenEngine::FramePacer::initialise(FramePresenter* pPresenter, const FramePacing& pPacing, std::uint32_t pSyncInterval) {
+	if (pPresenter == nullptr) return(FunctionResult(false, RESULT::FAIL, "Frame pacer requires a presenter."));
+
+	mPresenter = pPresenter;
+	mPacing = pPacing;
+	mSyncInterval = pSyncInterval;
+	mPresentedFrames = 0;
+	mLatencyTimeouts = 0;
+	mWaitedForFrame = false;
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the frame pacer."));
+}
+
+/** Blocks until the presentation queue can accept another frame.
+ *
+ * @details
+ * Called before any CPU work of the next frame, so input is sampled as late as possible. Waiting
+ * twice for the same frame would consume a second latency slot and stall a whole frame, so repeated
+ * calls before present() return immediately. A timeout is reported as a warning and the frame goes
+ * ahead, which keeps a hung display from blocking the render loop forever.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if the wait timed out.
+ */
+SyrenEngine::FunctionResult SyrenEngine::FramePacer::waitForNextFrame() {
+	if (mWaitedForFrame) return(FunctionResult(true, RESULT::SSUCCESS, "Frame already paced."));
+
+	FunctionResult result = mPresenter->waitForLatency(mTimeoutMs);
+	if (!result.is_successfull) return(result);
+
+	if (result.result == RESULT::WSUCCESS) ++mLatencyTimeouts;
+	mWaitedForFrame = true;
+
+	return(result);
+}
+
+/** Presents the current frame and opens the next pacing interval. */
+SyrenEngine::FunctionResult SyrenEngine::FramePacer::present() {
+	FunctionResult result = mPresenter->present(mSyncInterval);
+	if (!result.is_successfull) return(result);
+
+	++mPresentedFrames;
+	mWaitedForFrame = false;
+
+	return(result);
+}
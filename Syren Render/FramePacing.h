@@ -0,0 +1,79 @@
+/***********************************************************************************************************
+ * @file FramePacing.h
+ *
+ * @brief Declares the presentation pacing policy shared by the graphics backends
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The swap chain depth and the maximum number of queued frames trade throughput against input latency.
+ * Both come from the graphics configuration and are resolved into a FramePacing description here. The
+ * FramePacer then blocks on the presenter's latency object before CPU work for the next frame begins,
+ * so that the CPU never runs further ahead of the display than the configured latency allows.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "common.h"
+
+
+namespace SyrenEngine {
+	static const int MinSwapChainBufferCount = 2;
+	static const int MaxSwapChainBufferCount = 4;
+	static const int MaxFrameLatencyLimit = 16;
+
+	/** Resolved presentation settings. */
+	struct FramePacing {
+		int bufferCount;     /*!< Number of swap chain buffers */
+		int maxFrameLatency; /*!< Number of frames that may be queued for presentation */
+		int framesInFlight;  /*!< Number of frames the CPU may record ahead of the GPU */
+	};
+
+	/** Presentation surface the pacer drives, implemented by each backend. */
+	class FramePresenter {
+	public:
+		virtual ~FramePresenter() = default;
+
+		/** Blocks until the presentation queue can accept another frame or the timeout expires.
+		 *
+		 * @retval FunctionResult with RESULT::WSUCCESS if the timeout expired.
+		 */
+		virtual FunctionResult waitForLatency(std::uint32_t timeoutMs) = 0;
+
+		/** Queues the current back buffer for presentation. */
+		virtual FunctionResult present(std::uint32_t syncInterval) = 0;
+	};
+
+	FramePacing resolveFramePacing(const GraphicsConfig& config);
+
+	class FramePacer {
+	private:
+		FramePresenter* mPresenter = nullptr;
+		FramePacing mPacing = { MinSwapChainBufferCount, 1, 2 };
+
+		std::uint32_t mTimeoutMs = 1000;
+		std::uint32_t mSyncInterval = 0;
+
+		std::uint64_t mPresentedFrames = 0;
+		std::uint64_t mLatencyTimeouts = 0;
+		bool mWaitedForFrame = false;
+	public:
+		FramePacer() = default;
+
+		FunctionResult initialise(FramePresenter* pPresenter, const FramePacing& pPacing, std::uint32_t pSyncInterval = 0);
+
+		FunctionResult waitForNextFrame();
+		FunctionResult present();
+
+		const FramePacing& pacing() const { return mPacing; }
+		std::uint64_t presentedFrames() const { return mPresentedFrames; }
+		std::uint64_t latencyTimeouts() const { return mLatencyTimeouts; }
+	};
+}
@@ -0,0 +1,119 @@
+/***********************************************************************************************************
+ * @file FrameRing.h
+ *
+ * @brief Declares the ring of frame slots that lets the CPU record ahead of the GPU
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Each slot owns the per-frame resources of one frame in flight together with the timeline value that
+ * was signalled when that frame was submitted. Beginning a frame only blocks when the CPU has lapped
+ * the ring and the slot it is about to reuse is still being consumed by the GPU.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common.h"
+#include "Timeline.h"
+
+
+namespace SyrenEngine {
+	template<typename FrameResources>
+	class FrameRing {
+	public:
+		struct Slot {
+			std::uint64_t fenceValue = 0; /*!< Timeline value signalled when the slot was last submitted */
+			FrameResources resources;
+		};
+
+	private:
+		Timeline* mTimeline = nullptr;
+		std::vector<Slot> mSlots;
+
+		std::size_t mCurrentSlot = 0;
+		std::uint64_t mFrameNumber = 0;
+
+	public:
+		FrameRing() = default;
+
+		/** Sizes the ring and binds it to the timeline its frames are signalled on.
+		 *
+		 * @param[in] pTimeline: Timeline signalled at the end of each frame.
+		 * @param[in] pFrameCount: Number of frames that may be in flight at once.
+		 */
+		FunctionResult initialise(Timeline* pTimeline, std::size_t pFrameCount) {
+			if (pTimeline == nullptr) return(FunctionResult(false, RESULT::FAIL, "Frame ring requires a timeline."));
+			if (pFrameCount == 0) return(FunctionResult(false, RESULT::FAIL, "Frame ring requires at least one frame slot."));
+
+			mTimeline = pTimeline;
+			mSlots.clear();
+			mSlots.resize(pFrameCount);
+			mCurrentSlot = 0;
+			mFrameNumber = 0;
+
+			return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the frame ring."));
+		}
+
+		/** Acquires the resources of the next frame slot.
+		 *
+		 * @details
+		 * Waits for the GPU only when the slot was submitted by an earlier lap of the ring and has not
+		 * completed yet. Once this returns the slot resources may be reset and re-recorded.
+		 *
+		 * @param[out] pResources: Resources of the slot that the current frame owns.
+		 */
+		FunctionResult beginFrame(FrameResources*& pResources) {
+			Slot& slot = mSlots[mCurrentSlot];
+
+			if (slot.fenceValue != 0 && !mTimeline->isComplete(slot.fenceValue)) {
+				FunctionResult result = mTimeline->waitForValue(slot.fenceValue);
+				if (!result.is_successfull) return(result);
+			}
+
+			pResources = &slot.resources;
+			return(FunctionResult(true, RESULT::SSUCCESS, "Frame slot acquired."));
+		}
+
+		/** Signals the timeline for the current frame, stamps its slot and advances the ring.
+		 *
+		 * @param[out] fenceValue: Timeline value the frame's work completes at.
+		 */
+		FunctionResult endFrame(std::uint64_t& fenceValue) {
+			FunctionResult result = mTimeline->signal(fenceValue);
+			if (!result.is_successfull) return(result);
+
+			mSlots[mCurrentSlot].fenceValue = fenceValue;
+			mCurrentSlot = (mCurrentSlot + 1) % mSlots.size();
+			++mFrameNumber;
+
+			return(FunctionResult(true, RESULT::SSUCCESS, "Frame slot submitted."));
+		}
+
+		/** Blocks until every submitted frame slot has been consumed by the GPU. */
+		FunctionResult waitForIdle() {
+			std::uint64_t lastValue = 0;
+			for (const Slot& slot : mSlots) {
+				if (slot.fenceValue > lastValue) lastValue = slot.fenceValue;
+			}
+
+			if (lastValue == 0) return(FunctionResult(true, RESULT::SSUCCESS, "No frames in flight."));
+			return(mTimeline->waitForValue(lastValue));
+		}
+
+		std::size_t frameCount() const { return mSlots.size(); }
+		std::size_t currentIndex() const { return mCurrentSlot; }
+		std::uint64_t frameNumber() const { return mFrameNumber; }
+
+		Slot& slot(std::size_t index) { return mSlots[index]; }
+		const Slot& slot(std::size_t index) const { return mSlots[index]; }
+	};
+}
@@ -1,14 +1,21 @@
 #pragma once
 
 #include "common.h"
+#include "CommandStream.h"
+#include "ReadbackRing.h"
 
 
 namespace SyrenEngine {
     class GraphicsAPI {
     public:
+        virtual ~GraphicsAPI() = default;
+
         virtual FunctionResult initialise() = 0;
         virtual FunctionResult onResize() = 0;
+        virtual FunctionResult waitForNextFrame() = 0;
         virtual FunctionResult render() = 0;
+        virtual FunctionResult submit(const CommandStream& stream) = 0;
+        virtual FunctionResult readback(ReadbackFrame& frame, bool wait) = 0;
         virtual FunctionResult update() = 0;
         virtual FunctionResult destroy() = 0;
 
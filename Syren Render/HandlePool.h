@@ -0,0 +1,155 @@
+/***********************************************************************************************************
+ * @file HandlePool.h
+ *
+ * @brief Declares the generational slot map that owns engine objects and hands out handles to them
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Objects live by value in one dense array, so per-frame loops walk contiguous memory instead of
+ * following pointers. Users hold a Handle, which is the index of a slot together with the generation
+ * the slot had when the object was created. The slot records where its object currently sits in the
+ * dense array; destroying an object moves the last object into the hole and advances the generation of
+ * the slot, which turns every handle still referring to it stale. Creating and destroying are O(1) and
+ * no reference counts are kept: a pool is the single owner of its objects.
+ *
+ * Pointers returned by get() are invalidated by create() and destroy(). Pools are not thread-safe; the
+ * system owning a pool serialises access to it.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace SyrenEngine {
+	static const std::uint32_t InvalidHandleIndex = 0xFFFFFFFFu;
+
+	/** Generation checked reference to an object of a HandlePool<T>. */
+	template<typename T>
+	struct Handle {
+		std::uint32_t index = InvalidHandleIndex;
+		std::uint32_t generation = 0;
+
+		bool valid() const { return index != InvalidHandleIndex; }
+		bool operator==(const Handle& rhs) const = default;
+	};
+
+	template<typename T>
+	class HandlePool {
+	private:
+		struct Slot {
+			std::uint32_t dense;      /*!< Position of the object in mObjects, or the next free slot */
+			std::uint32_t generation; /*!< Never 0, so default constructed handles are never live */
+		};
+
+		std::vector<T> mObjects;
+		std::vector<std::uint32_t> mOwners; /*!< Slot of each object in mObjects */
+		std::vector<Slot> mSlots;
+		std::uint32_t mFreeSlot = InvalidHandleIndex;
+
+	public:
+		HandlePool() = default;
+		HandlePool(HandlePool&& rhs) = default;
+		HandlePool& operator=(HandlePool&& rhs) = default;
+
+		void reserve(std::size_t count) {
+			mObjects.reserve(count);
+			mOwners.reserve(count);
+			mSlots.reserve(count);
+		}
+
+		/** Constructs an object at the end of the dense array. */
+		template<typename... Args>
+		Handle<T> create(Args&&... args) {
+			std::uint32_t slot = mFreeSlot;
+			if (slot != InvalidHandleIndex) mFreeSlot = mSlots[slot].dense;
+			else {
+				slot = static_cast<std::uint32_t>(mSlots.size());
+				mSlots.push_back(Slot{ 0, 1 });
+			}
+
+			mSlots[slot].dense = static_cast<std::uint32_t>(mObjects.size());
+			mObjects.emplace_back(std::forward<Args>(args)...);
+			mOwners.push_back(slot);
+			return(Handle<T>{ slot, mSlots[slot].generation });
+		}
+
+		/** Destroys an object and invalidates the caller's handle.
+		 *
+		 * @retval False if the handle was already stale.
+		 */
+		bool destroy(Handle<T>& handle) {
+			if (!contains(handle)) return false;
+
+			const std::uint32_t dense = mSlots[handle.index].dense;
+			const std::uint32_t last = static_cast<std::uint32_t>(mObjects.size() - 1);
+			if (dense != last) {
+				mObjects[dense] = std::move(mObjects[last]);
+				mOwners[dense] = mOwners[last];
+				mSlots[mOwners[dense]].dense = dense;
+			}
+			mObjects.pop_back();
+			mOwners.pop_back();
+
+			Slot& slot = mSlots[handle.index];
+			slot.generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+			slot.dense = mFreeSlot;
+			mFreeSlot = handle.index;
+
+			handle = Handle<T>();
+			return true;
+		}
+
+		bool contains(Handle<T> handle) const {
+			return(handle.index < mSlots.size() && mSlots[handle.index].generation == handle.generation);
+		}
+
+		/** Returns the object of a handle, or nullptr if the handle is stale. */
+		T* get(Handle<T> handle) {
+			return(contains(handle) ? &mObjects[mSlots[handle.index].dense] : nullptr);
+		}
+
+		const T* get(Handle<T> handle) const {
+			return(contains(handle) ? &mObjects[mSlots[handle.index].dense] : nullptr);
+		}
+
+		/** Returns the handle of the object at a position of the dense array. */
+		Handle<T> handle(std::size_t dense) const {
+			const std::uint32_t slot = mOwners[dense];
+			return(Handle<T>{ slot, mSlots[slot].generation });
+		}
+
+		void clear() {
+			for (std::size_t dense = 0; dense < mObjects.size(); ++dense) {
+				Slot& slot = mSlots[mOwners[dense]];
+				slot.generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+				slot.dense = mFreeSlot;
+				mFreeSlot = mOwners[dense];
+			}
+			mObjects.clear();
+			mOwners.clear();
+		}
+
+		std::size_t size() const { return mObjects.size(); }
+		bool empty() const { return mObjects.empty(); }
+
+		T* data() { return mObjects.data(); }
+		const T* data() const { return mObjects.data(); }
+		typename std::vector<T>::iterator begin() { return mObjects.begin(); }
+		typename std::vector<T>::iterator end() { return mObjects.end(); }
+		typename std::vector<T>::const_iterator begin() const { return mObjects.begin(); }
+		typename std::vector<T>::const_iterator end() const { return mObjects.end(); }
+	private:
+		HandlePool(const HandlePool& rhs) = delete;
+		HandlePool& operator=(const HandlePool& rhs) = delete;
+	};
+}
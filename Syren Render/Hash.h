@@ -0,0 +1,81 @@
+/***********************************************************************************************************
+ * @file Hash.h
+ *
+ * @brief Declares the stable 64 bit hash used to key data that is persisted between runs
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * FNV-1a over bytes. Unlike std::hash the result is the same on every platform, build and run, so it
+ * can be written to disk. Values are fed in field by field: hashing whole structs would pick up the
+ * padding between their members, and pointers have to be followed to the data they point at.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+
+namespace SyrenEngine {
+	static const std::uint64_t FnvOffsetBasis = 0xCBF29CE484222325ull;
+	static const std::uint64_t FnvPrime = 0x00000100000001B3ull;
+
+	inline std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t hash = FnvOffsetBasis) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (std::size_t i = 0; i < size; ++i) {
+			hash ^= bytes[i];
+			hash *= FnvPrime;
+		}
+		return hash;
+	}
+
+	/** Accumulates a hash over a sequence of values. */
+	class Hasher {
+	private:
+		std::uint64_t mHash = FnvOffsetBasis;
+		std::vector<unsigned char>* mRecord = nullptr;
+
+	public:
+		Hasher() = default;
+
+		/** Constructor that keeps the hashed bytes, so that values sharing a hash can still be told apart.
+		 *
+		 * @param[in] pRecord: Every byte added is appended to it.
+		 */
+		explicit Hasher(std::vector<unsigned char>* pRecord) : mRecord(pRecord) {};
+
+		void addBytes(const void* data, std::size_t size) {
+			mHash = fnv1a(data, size, mHash);
+			if (mRecord != nullptr) mRecord->insert(mRecord->end(), static_cast<const unsigned char*>(data), static_cast<const unsigned char*>(data) + size);
+		}
+
+		/** Adds a value without padding, such as an integer, enum or float. */
+		template<typename T>
+		void add(const T& value) {
+			static_assert(std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value, "Only plain values can be hashed by their bytes.");
+			addBytes(&value, sizeof(T));
+		}
+
+		/** Adds a block prefixed with its size, so that neighbouring blocks cannot run into each other. */
+		void addBlock(const void* data, std::size_t size) {
+			add(static_cast<std::uint64_t>(size));
+			if (size > 0) addBytes(data, size);
+		}
+
+		/** Adds a string, or an empty string for nullptr. */
+		void addString(const char* text) {
+			addBlock(text, text != nullptr ? std::strlen(text) : 0);
+		}
+
+		std::uint64_t value() const { return mHash; }
+	};
+}
@@ -0,0 +1,166 @@
+/***********************************************************************************************************
+ * @file HeapAllocator.cpp
+ *
+ * @brief Implements functions of the HeapAllocator class found in HeapAllocator.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "HeapAllocator.h"
+
+
+/** Constructor for the HeapAllocator class.
+ *
+ * @param[in] pSource: Backend that creates the heaps of new pages.
+ * @param[in] pPageSize: Size of a regular page.
+ */
+SyrenEngine::HeapAllocator::HeapAllocator(HeapSource* pSource, std::uint64_t pPageSize) : mSource(pSource), mPageSize(pPageSize) {}
+
+/** Allocates a range for a resource.
+ *
+ * @param[in] heapClass: Class of the resource.
+ * @param[in] size: Size the resource needs.
+ * @param[in] alignment: Placement alignment, or 0 for the default alignment of the class.
+ * @param[out] allocation: The range handed out.
+ *
+ * @retval FunctionResult indicating whether the range could be allocated.
+ */
+SyrenEngine::FunctionResult SyrenEngine::HeapAllocator::allocate(HeapClass heapClass, std::uint64_t size, std::uint64_t alignment, HeapAllocation& allocation) {
+	if (alignment == 0) alignment = classAlignment(heapClass);
+	if (alignment & (alignment - 1)) return(FunctionResult(false, RESULT::FAIL, "Heap allocations must be aligned to a power of two."));
+
+	std::vector<Page>& classPages = pages(heapClass);
+	std::uint64_t offset = 0;
+	std::uint32_t block = TlsfAllocator::InvalidBlock;
+
+	std::uint32_t page = 0;
+	for (; page < classPages.size(); ++page) {
+		if (classPages[page].allocator && classPages[page].allocator->allocate(size, alignment, offset, block)) break;
+	}
+
+	if (page == classPages.size()) {
+		// The allocation is tried on the new page before its heap is created, so a failure leaves nothing behind
+		std::unique_ptr<TlsfAllocator> allocator;
+		if (size < mPageSize) {
+			allocator = std::make_unique<TlsfAllocator>(mPageSize);
+			if (!allocator->allocate(size, alignment, offset, block)) allocator.reset();
+		}
+
+		// Anything an empty page can not hold gets a page of exactly its size, where offset 0 meets any alignment
+		const std::uint64_t dedicatedSize = (size + TlsfAllocator::Granularity - 1) / TlsfAllocator::Granularity * TlsfAllocator::Granularity;
+
+		page = unusedPage(heapClass);
+		FunctionResult result = mSource->createHeap(heapClass, page, allocator ? mPageSize : dedicatedSize);
+		if (!result.is_successfull) return(result);
+
+		if (allocator) {
+			classPages[page].allocator = std::move(allocator);
+		}
+		else {
+			classPages[page].dedicatedSize = dedicatedSize;
+			offset = 0;
+			block = TlsfAllocator::InvalidBlock;
+		}
+	}
+
+	allocation.heapClass = heapClass;
+	allocation.page = page;
+	allocation.block = block;
+	allocation.offset = offset;
+	allocation.size = classPages[page].allocator ? classPages[page].allocator->blockSize(block) : classPages[page].dedicatedSize;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Heap range allocated."));
+}
+
+/** Returns a range to its page and releases the page if it became empty and is not the last shared one. */
+void SyrenEngine::HeapAllocator::free(HeapAllocation& allocation) {
+	if (!allocation.valid()) return;
+
+	std::vector<Page>& classPages = pages(allocation.heapClass);
+	Page& page = classPages[allocation.page];
+
+	if (!page.allocator) {
+		mSource->destroyHeap(allocation.heapClass, allocation.page);
+		page.dedicatedSize = 0;
+		allocation = HeapAllocation();
+		return;
+	}
+
+	page.allocator->free(allocation.block);
+
+	if (page.allocator->allocationCount() == 0 && sharedPageCount(allocation.heapClass) > 1) {
+		mSource->destroyHeap(allocation.heapClass, allocation.page);
+		page.allocator.reset();
+	}
+
+	allocation = HeapAllocation();
+}
+
+/** Collects the statistics of every page of a class. */
+SyrenEngine::HeapStatistics SyrenEngine::HeapAllocator::statistics(HeapClass heapClass) const {
+	HeapStatistics statistics;
+	std::uint64_t freeSize = 0;
+
+	for (const Page& page : pages(heapClass)) {
+		if (page.dedicatedSize != 0) {
+			++statistics.pageCount;
+			++statistics.allocationCount;
+			statistics.reservedSize += page.dedicatedSize;
+			statistics.usedSize += page.dedicatedSize;
+		}
+		if (!page.allocator) continue;
+
+		++statistics.pageCount;
+		statistics.allocationCount += page.allocator->allocationCount();
+		statistics.freeBlockCount += page.allocator->freeBlockCount();
+		statistics.reservedSize += page.allocator->size();
+		statistics.usedSize += page.allocator->usedSize();
+		freeSize += page.allocator->freeSize();
+
+		const std::uint64_t largest = page.allocator->largestFreeBlock();
+		if (largest > statistics.largestFreeBlock) statistics.largestFreeBlock = largest;
+	}
+
+	if (freeSize > 0)
+		statistics.fragmentation = 1.0f - static_cast<float>(static_cast<double>(statistics.largestFreeBlock) / static_cast<double>(freeSize));
+
+	return statistics;
+}
+
+/** Returns the default placement alignment of a class.
+ *
+ * @details
+ * These match the D3D12 placement rules, which are also valid for the other backends: 64KB for buffers
+ * and textures and 4MB for multisampled render targets.
+ */
+std::uint64_t SyrenEngine::HeapAllocator::classAlignment(HeapClass heapClass) {
+	switch (heapClass) {
+	case HeapClass::MSAA_RENDER_TARGET: return 4ull << 20;
+	default: return 64ull << 10;
+	}
+}
+
+std::uint32_t SyrenEngine::HeapAllocator::sharedPageCount(HeapClass heapClass) const {
+	std::uint32_t count = 0;
+	for (const Page& page : pages(heapClass)) {
+		if (page.allocator) ++count;
+	}
+	return count;
+}
+
+/** Returns the index of a released page, or of a new one, for a page about to be created. */
+std::uint32_t SyrenEngine::HeapAllocator::unusedPage(HeapClass heapClass) {
+	std::vector<Page>& classPages = pages(heapClass);
+
+	std::uint32_t page = 0;
+	for (; page < classPages.size(); ++page) {
+		if (!classPages[page].live()) return page;
+	}
+
+	classPages.emplace_back();
+	return page;
+}
@@ -0,0 +1,116 @@
+/***********************************************************************************************************
+ * @file HeapAllocator.h
+ *
+ * @brief Declares the API independent sub-allocator that carves resources out of large GPU heaps
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Resources are grouped into heap classes: buffers, textures and render targets need separate heaps on
+ * the lowest resource heap tier, CPU visible buffers need their own heap types and multisampled
+ * targets need a larger placement alignment. Each class owns a list of pages, each page being one heap
+ * created through a HeapSource and managed by a TlsfAllocator. A new page is only created when no page
+ * of the class has room. Requests that would not fit into an empty page, because of their size plus the
+ * padding and size class rounding of the TLSF, get a dedicated page sized to fit them exactly, which holds
+ * only that resource and is released with it. Empty pages are released, except for the last shared one
+ * of each class, which is kept to absorb churn.
+ *
+ * The allocator keeps per class statistics, including how fragmented the free memory is.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common.h"
+#include "TlsfAllocator.h"
+
+
+namespace SyrenEngine {
+	enum class HeapClass : unsigned char {
+		BUFFER, UPLOAD_BUFFER, READBACK_BUFFER, TEXTURE, RENDER_TARGET, MSAA_RENDER_TARGET, COUNT
+	};
+
+	static const std::uint32_t InvalidHeapPage = 0xFFFFFFFFu;
+	static const std::uint64_t DefaultHeapPageSize = 64ull << 20;
+
+	/** A range of a heap page handed out by the HeapAllocator. */
+	struct HeapAllocation {
+		HeapClass heapClass = HeapClass::BUFFER;
+		std::uint32_t page = InvalidHeapPage;
+		std::uint32_t block = TlsfAllocator::InvalidBlock; /*!< InvalidBlock for a dedicated page */
+		std::uint64_t offset = 0;
+		std::uint64_t size = 0;
+
+		bool valid() const { return page != InvalidHeapPage; }
+	};
+
+	struct HeapStatistics {
+		std::uint32_t pageCount = 0;
+		std::uint32_t allocationCount = 0;
+		std::uint32_t freeBlockCount = 0;
+		std::uint64_t reservedSize = 0;     /*!< Size of all pages of the class */
+		std::uint64_t usedSize = 0;
+		std::uint64_t largestFreeBlock = 0;
+		float fragmentation = 0.0f;         /*!< 1 - largest free block / free memory, 0 when the free memory is contiguous */
+	};
+
+	/** Creates and destroys the heaps backing the pages, implemented by each backend. */
+	class HeapSource {
+	public:
+		virtual ~HeapSource() = default;
+
+		/** Creates the heap of a new page.
+		 *
+		 * @param[in] heapClass: Class of the resources placed in the heap.
+		 * @param[in] page: Index of the page within its class.
+		 * @param[in] size: Size of the heap.
+		 */
+		virtual FunctionResult createHeap(HeapClass heapClass, std::uint32_t page, std::uint64_t size) = 0;
+
+		/** Destroys the heap of a page that no longer holds any allocations. */
+		virtual void destroyHeap(HeapClass heapClass, std::uint32_t page) = 0;
+	};
+
+	class HeapAllocator {
+	private:
+		struct Page {
+			std::unique_ptr<TlsfAllocator> allocator; /*!< Manages a shared page, empty for a dedicated one */
+			std::uint64_t dedicatedSize = 0;          /*!< Size of a page holding a single resource */
+
+			bool live() const { return allocator || dedicatedSize != 0; }
+		};
+
+		HeapSource* mSource;
+		std::uint64_t mPageSize;
+		std::vector<Page> mPages[static_cast<std::size_t>(HeapClass::COUNT)];
+
+	public:
+		HeapAllocator(HeapSource* pSource, std::uint64_t pPageSize = DefaultHeapPageSize);
+
+		FunctionResult allocate(HeapClass heapClass, std::uint64_t size, std::uint64_t alignment, HeapAllocation& allocation);
+		void free(HeapAllocation& allocation);
+
+		HeapStatistics statistics(HeapClass heapClass) const;
+		std::uint64_t pageSize() const { return mPageSize; }
+
+		static std::uint64_t classAlignment(HeapClass heapClass);
+	private:
+		HeapAllocator() = delete;
+		HeapAllocator(const HeapAllocator& rhs) = delete;
+		HeapAllocator& operator=(const HeapAllocator& rhs) = delete;
+
+		std::vector<Page>& pages(HeapClass heapClass) { return mPages[static_cast<std::size_t>(heapClass)]; }
+		const std::vector<Page>& pages(HeapClass heapClass) const { return mPages[static_cast<std::size_t>(heapClass)]; }
+		std::uint32_t sharedPageCount(HeapClass heapClass) const;
+		std::uint32_t unusedPage(HeapClass heapClass);
+	};
+}
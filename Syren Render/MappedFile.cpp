@@ -0,0 +1,116 @@
+/***********************************************************************************************************
+ * @file MappedFile.cpp
+ *
+ * @brief Implements functions of the MappedFile class found in MappedFile.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+SyrenEngine::MappedFile::MappedFile(MappedFile&& rhs) noexcept {
+	*this = std::move(rhs);
+}
+
+SyrenEngine::MappedFile& SyrenEngine::MappedFile::operator=(MappedFile&& rhs) noexcept {
+	if (this != &rhs) {
+		close();
+		std::swap(mData, rhs.mData);
+		std::swap(mSize, rhs.mSize);
+		std::swap(mFile, rhs.mFile);
+#ifdef _WIN32
+		std::swap(mMapping, rhs.mMapping);
+#endif
+	}
+	return *this;
+}
+
+SyrenEngine::MappedFile::~MappedFile() {
+	close();
+}
+
+/** Maps a whole file read only, replacing any file that was mapped before.
+ *
+ * @param[in] path: File to map. Empty files cannot be mapped and fail like missing ones.
+ */
+SyrenEngine::FunctionResult SyrenEngine::MappedFile::open(const std::string& path) {
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return(FunctionResult(false, RESULT::FAIL, "Failed to open " + path + "."));
+	mFile = file;
+
+	LARGE_INTEGER size = {};
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		close();
+		return(FunctionResult(false, RESULT::FAIL, "Cannot map the empty file " + path + "."));
+	}
+
+	mMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mMapping == nullptr) {
+		close();
+		return(FunctionResult(false, RESULT::FAIL, "Failed to create a mapping of " + path + "."));
+	}
+
+	mData = static_cast<const unsigned char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+	if (mData == nullptr) {
+		close();
+		return(FunctionResult(false, RESULT::FAIL, "Failed to map " + path + "."));
+	}
+	mSize = static_cast<std::size_t>(size.QuadPart);
+#else
+	mFile = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (mFile < 0) return(FunctionResult(false, RESULT::FAIL, "Failed to open " + path + "."));
+
+	struct stat status = {};
+	if (fstat(mFile, &status) != 0 || status.st_size == 0) {
+		close();
+		return(FunctionResult(false, RESULT::FAIL, "Cannot map the empty file " + path + "."));
+	}
+
+	void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, mFile, 0);
+	if (data == MAP_FAILED) {
+		close();
+		return(FunctionResult(false, RESULT::FAIL, "Failed to map " + path + "."));
+	}
+	mData = static_cast<const unsigned char*>(data);
+	mSize = static_cast<std::size_t>(status.st_size);
+#endif
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Mapped the file."));
+}
+
+/** Unmaps the file. Pointers into it become invalid. */
+void SyrenEngine::MappedFile::close() {
+#ifdef _WIN32
+	if (mData != nullptr) UnmapViewOfFile(mData);
+	if (mMapping != nullptr) CloseHandle(mMapping);
+	if (mFile != nullptr) CloseHandle(mFile);
+	mMapping = nullptr;
+	mFile = nullptr;
+#else
+	if (mData != nullptr) munmap(const_cast<unsigned char*>(mData), mSize);
+	if (mFile >= 0) ::close(mFile);
+	mFile = -1;
+#endif
+	mData = nullptr;
+	mSize = 0;
+}
@@ -0,0 +1,54 @@
+/***********************************************************************************************************
+ * @file MappedFile.h
+ *
+ * @brief Declares a read only view of a file mapped into memory
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Mapping instead of reading lets caches and archives of many megabytes open instantly; the OS pages
+ * in only what is looked up. Uses a file mapping on Windows and mmap elsewhere.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "common.h"
+
+
+namespace SyrenEngine {
+	class MappedFile {
+	private:
+		const unsigned char* mData = nullptr;
+		std::size_t mSize = 0;
+#ifdef _WIN32
+		void* mFile = nullptr;    /*!< HANDLE of the file */
+		void* mMapping = nullptr; /*!< HANDLE of the file mapping */
+#else
+		int mFile = -1;
+#endif
+
+	public:
+		MappedFile() = default;
+		MappedFile(MappedFile&& rhs) noexcept;
+		MappedFile& operator=(MappedFile&& rhs) noexcept;
+		~MappedFile();
+
+		FunctionResult open(const std::string& path);
+		void close();
+
+		bool isOpen() const { return mData != nullptr; }
+		const unsigned char* data() const { return mData; }
+		std::size_t size() const { return mSize; }
+	private:
+		MappedFile(const MappedFile& rhs) = delete;
+		MappedFile& operator=(const MappedFile& rhs) = delete;
+	};
+}
@@ -0,0 +1,782 @@
+/***********************************************************************************************************
+ * @file OpenGL.cpp
+ *
+ * @brief Implements functions of the OpenGL class found in OpenGL.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "OpenGL.h"
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+
+#include "SoftwareRasteriser.h"
+
+
+namespace {
+	const char* VertexShaderSource =
+		"#version 450 core\n"
+		"layout(location = 0) in vec4 position;\n"
+		"layout(location = 1) in vec4 color;\n"
+		"out vec4 vertexColor;\n"
+		"void main() {\n"
+		"	gl_Position = position;\n"
+		"	vertexColor = color;\n"
+		"}\n";
+
+	const char* FragmentShaderSource =
+		"#version 450 core\n"
+		"in vec4 vertexColor;\n"
+		"layout(location = 0) out vec4 fragmentColor;\n"
+		"void main() {\n"
+		"	fragmentColor = vertexColor;\n"
+		"}\n";
+
+	/** Whether size bytes from offset lie within a buffer of the given size, without offset + size wrapping. */
+	inline bool rangeFits(std::uint64_t offset, std::uint64_t size, std::uint64_t bufferSize) {
+		return(offset <= bufferSize && size <= bufferSize - offset);
+	}
+
+	/** Checks a space separated extension string for a whole extension name. */
+	bool hasExtension(const char* extensions, const char* name) {
+		if (extensions == nullptr) return false;
+
+		const std::size_t length = std::strlen(name);
+		for (const char* start = extensions; (start = std::strstr(start, name)) != nullptr; start += length) {
+			bool atStart = start == extensions || start[-1] == ' ';
+			bool atEnd = start[length] == ' ' || start[length] == '\0';
+			if (atStart && atEnd) return true;
+		}
+		return false;
+	}
+
+	GLuint compileShader(const SyrenEngine::OpenGLFunctions& gl, GLenum type, const char* source, std::string& log) {
+		GLuint shader = gl.glCreateShader(type);
+		gl.glShaderSource(shader, 1, &source, nullptr);
+		gl.glCompileShader(shader);
+
+		GLint compiled = GL_FALSE;
+		gl.glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+		if (compiled == GL_TRUE) return shader;
+
+		char buffer[1024] = {};
+		gl.glGetShaderInfoLog(shader, sizeof(buffer), nullptr, buffer);
+		log = buffer;
+		gl.glDeleteShader(shader);
+		return 0;
+	}
+}
+
+
+/** Constructor for the OpenGL class.
+ *
+ * @param[in] pWindow: Unused, the OpenGL backend always renders offscreen.
+ * @param[in] pConfig: Graphics configuration providing the frame size, sample count and frame latency.
+ */
+SyrenEngine::OpenGL::OpenGL(void* pWindow, const GraphicsConfig& pConfig) {
+	mWindow = pWindow;
+	mPacing = resolveFramePacing(pConfig);
+	mClientWidth = pConfig.Width > 0 ? pConfig.Width : mClientWidth;
+	mClientHeight = pConfig.Height > 0 ? pConfig.Height : mClientHeight;
+	mSampleCount = pConfig.SampleCount == 4 ? 4 : 1;
+
+	mDisplay = EGL_NO_DISPLAY;
+	mContext = EGL_NO_CONTEXT;
+	mTimeline = nullptr;
+
+	mState = {};
+}
+
+/** Destructor for the OpenGL class. Waits for the frames in flight before releasing the context. */
+SyrenEngine::OpenGL::~OpenGL() {
+	if (mContext != EGL_NO_CONTEXT) {
+		if (mTimeline) mFrames.waitForIdle();
+
+		releaseBuffers();
+		releaseReadback();
+		releaseFramebuffers();
+
+		if (mGL.glDeleteProgram != nullptr) {
+			mGL.glDeleteProgram(mProgram);
+			mGL.glDeleteVertexArrays(1, &mVertexArray);
+		}
+
+		mTimeline.reset();
+		eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext(mDisplay, mContext);
+		mContext = EGL_NO_CONTEXT;
+	}
+
+	if (mDisplay != EGL_NO_DISPLAY) eglTerminate(mDisplay);
+}
+
+/***********************************************************************************************************
+ * OpenGL command stream replay
+ *
+ **********************************************************************************************************/
+
+/** Translates command stream packets into OpenGL calls.
+ *
+ * @details
+ * The executor holds the bindings the stream has made this frame, while the state cache of the
+ * backend holds what the driver last saw. Clears ignore the scissor rectangle like they do in
+ * Direct3D, so the scissor test is only switched on around draws.
+ */
+struct SyrenEngine::OpenGL::StreamExecutor {
+	OpenGL& api;
+
+	ResourceId vertexBuffer = NullResource;
+	std::uint32_t vertexOffset = 0;
+	std::uint32_t vertexStride = sizeof(SoftwareVertex);
+	ResourceId indexBuffer = NullResource;
+
+	void execute(const ClearRenderTargetCommand& command) {
+		if (command.target != BackBufferResource) return;
+		api.enableScissor(false);
+		api.mGL.glClearNamedFramebufferfv(api.mFramebuffer, GL_COLOR, 0, command.color);
+	}
+
+	void execute(const ClearDepthStencilCommand& command) {
+		if (command.target != DepthStencilResource) return;
+		api.enableScissor(false);
+
+		if (command.clearDepth && command.clearStencil) {
+			api.mGL.glClearNamedFramebufferfi(api.mFramebuffer, GL_DEPTH_STENCIL, 0, command.depth, command.stencil);
+		}
+		else if (command.clearDepth) {
+			api.mGL.glClearNamedFramebufferfv(api.mFramebuffer, GL_DEPTH, 0, &command.depth);
+		}
+		else if (command.clearStencil) {
+			GLint stencil = command.stencil;
+			api.mGL.glClearNamedFramebufferiv(api.mFramebuffer, GL_STENCIL, 0, &stencil);
+		}
+	}
+
+	void execute(const SetViewportCommand& command) {
+		const float viewport[6] = { command.x, command.y, command.width, command.height, command.minDepth, command.maxDepth };
+		api.setViewport(viewport);
+	}
+
+	void execute(const SetScissorCommand& command) {
+		api.setScissor(command.left, command.top, command.right, command.bottom);
+	}
+
+	/** Streams can only draw into the frame's own targets, which stay bound. */
+	void execute(const SetRenderTargetsCommand&) {}
+	void execute(const SetPipelineCommand&) {}
+
+	void execute(const SetVertexBufferCommand& command) {
+		if (command.slot != 0) return;
+		vertexBuffer = command.buffer;
+		vertexOffset = command.offset;
+		vertexStride = std::max<std::uint32_t>(command.stride, sizeof(SoftwareVertex));
+	}
+
+	void execute(const SetIndexBufferCommand& command) {
+		indexBuffer = command.buffer;
+		api.mIndexOffset = command.offset;
+		api.mIndexSize = command.indexSize == 4 ? 4 : 2;
+		api.mIndexType = command.indexSize == 4 ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+	}
+
+	void execute(const DrawCommand& command) {
+		if (command.instanceCount == 0 || !bindVertexBuffer()) return;
+
+		api.enableScissor(true);
+		api.mGL.glDrawArraysInstancedBaseInstance(GL_TRIANGLES, static_cast<GLint>(command.firstVertex), static_cast<GLsizei>(command.vertexCount),
+			static_cast<GLsizei>(command.instanceCount), command.firstInstance);
+	}
+
+	void execute(const DrawIndexedCommand& command) {
+		if (command.instanceCount == 0 || !bindVertexBuffer()) return;
+
+		Buffer* indices = api.findBuffer(indexBuffer);
+		if (indices == nullptr) return;
+		api.useBuffer(*indices);
+		api.setIndexBuffer(indices->name);
+
+		const std::uintptr_t offset = api.mIndexOffset + static_cast<std::uintptr_t>(command.firstIndex) * api.mIndexSize;
+
+		api.enableScissor(true);
+		api.mGL.glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(command.indexCount), api.mIndexType,
+			reinterpret_cast<const void*>(offset), static_cast<GLsizei>(command.instanceCount), command.baseVertex, command.firstInstance);
+	}
+
+	/** No compute programs exist yet. */
+	void execute(const DispatchCommand&) {}
+
+	/** The driver tracks hazards between draws and copies; only shader writes need an explicit barrier. */
+	void execute(const BarrierCommand& command) {
+		if (command.before == ResourceState::UNORDERED_ACCESS || command.after == ResourceState::UNORDERED_ACCESS)
+			api.mGL.glMemoryBarrier(GL_ALL_BARRIER_BITS);
+	}
+
+	void execute(const CopyBufferCommand& command) {
+		Buffer* destination = api.findBuffer(command.destination);
+		Buffer* source = api.findBuffer(command.source);
+		if (destination == nullptr || source == nullptr) return;
+		if (!rangeFits(command.sourceOffset, command.size, source->size) || !rangeFits(command.destinationOffset, command.size, destination->size)) return;
+
+		api.useBuffer(*destination);
+		api.useBuffer(*source);
+		api.mGL.glCopyNamedBufferSubData(source->name, destination->name, static_cast<GLintptr>(command.sourceOffset),
+			static_cast<GLintptr>(command.destinationOffset), static_cast<GLsizeiptr>(command.size));
+	}
+
+	void execute(const CopyTextureCommand&) {}
+
+	bool bindVertexBuffer() {
+		Buffer* vertices = api.findBuffer(vertexBuffer);
+		if (vertices == nullptr) return false;
+
+		api.useBuffer(*vertices);
+		api.setVertexBuffer(vertices->name, vertexOffset, static_cast<GLsizei>(vertexStride));
+		return true;
+	}
+};
+
+/***********************************************************************************************************
+ * OpenGL private member functions
+ *
+ **********************************************************************************************************/
+
+/** Opens the Mesa surfaceless EGL display.
+ *
+ * @retval FunctionResult indicating whether a display without a window system could be opened.
+ */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::initialiseDisplay() {
+	const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	if (!hasExtension(clientExtensions, "EGL_EXT_platform_base") || !hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+		return(FunctionResult(false, RESULT::FAIL, "EGL does not support the surfaceless platform."));
+
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+	if (getPlatformDisplay == nullptr) return(FunctionResult(false, RESULT::FAIL, "Failed to load eglGetPlatformDisplayEXT."));
+
+	mDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	if (mDisplay == EGL_NO_DISPLAY) return(FunctionResult(false, RESULT::FAIL, "Failed to open the surfaceless EGL display."));
+
+	EGLint major = 0, minor = 0;
+	if (eglInitialize(mDisplay, &major, &minor) != EGL_TRUE) {
+		mDisplay = EGL_NO_DISPLAY;
+		return(FunctionResult(false, RESULT::FAIL, "Failed to initialise the EGL display."));
+	}
+
+	std::string message = "Opened a surfaceless EGL " + std::to_string(major) + "." + std::to_string(minor) + " display.";
+	return(FunctionResult(true, RESULT::SSUCCESS, message));
+}
+
+/** Creates an OpenGL 4.5 core context, makes it current without a surface and loads the entry points. */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::initialiseContext() {
+	if (!hasExtension(eglQueryString(mDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+		return(FunctionResult(false, RESULT::FAIL, "EGL does not support surfaceless contexts."));
+
+	if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE) return(FunctionResult(false, RESULT::FAIL, "EGL does not support desktop OpenGL."));
+
+	const EGLint configAttributes[] = {
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_SURFACE_TYPE, 0,
+		EGL_NONE
+	};
+
+	EGLConfig config = nullptr;
+	EGLint configCount = 0;
+	if (eglChooseConfig(mDisplay, configAttributes, &config, 1, &configCount) != EGL_TRUE || configCount == 0)
+		return(FunctionResult(false, RESULT::FAIL, "No EGL configuration supports desktop OpenGL."));
+
+	const EGLint contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 4,
+		EGL_CONTEXT_MINOR_VERSION, 5,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+#ifdef _DEBUG
+		EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE,
+#endif
+		EGL_NONE
+	};
+
+	mContext = eglCreateContext(mDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+	if (mContext == EGL_NO_CONTEXT) return(FunctionResult(false, RESULT::FAIL, "Failed to create an OpenGL 4.5 core context."));
+
+	if (eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, mContext) != EGL_TRUE)
+		return(FunctionResult(false, RESULT::FAIL, "Failed to make the OpenGL context current."));
+
+	FunctionResult result = loadOpenGLFunctions(mGL);
+	if (!result.is_successfull) return(result);
+
+	std::string message = "Created an OpenGL 4.5 context on " + std::string(reinterpret_cast<const char*>(mGL.glGetString(GL_RENDERER))) + ".";
+	return(FunctionResult(true, RESULT::SSUCCESS, message));
+}
+
+/** Creates the fence timeline and the frame ring that bounds the frames queued in the driver. */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::initialiseFence() {
+	mTimeline = std::make_unique<OpenGLTimeline>(mGL);
+
+	FunctionResult result = mFrames.initialise(mTimeline.get(), mPacing.framesInFlight);
+	if (!result.is_successfull) return(result);
+
+	result = mReadback.initialise(mTimeline.get(), mPacing.bufferCount);
+	if (!result.is_successfull) return(result);
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Created the OpenGL fence timeline."));
+}
+
+/** Builds the program and vertex array shared by every draw and sets the fixed pipeline state.
+ *
+ * @details
+ * Clip control is set to the Direct3D conventions, so the first row of the framebuffer is the top of
+ * the frame and depth runs from zero to one, matching the other backends.
+ */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::initialiseProgram() {
+	std::string log;
+
+	GLuint vertexShader = compileShader(mGL, GL_VERTEX_SHADER, VertexShaderSource, log);
+	if (vertexShader == 0) return(FunctionResult(false, RESULT::FAIL, "Failed to compile the vertex shader. " + log));
+
+	GLuint fragmentShader = compileShader(mGL, GL_FRAGMENT_SHADER, FragmentShaderSource, log);
+	if (fragmentShader == 0) {
+		mGL.glDeleteShader(vertexShader);
+		return(FunctionResult(false, RESULT::FAIL, "Failed to compile the fragment shader. " + log));
+	}
+
+	mProgram = mGL.glCreateProgram();
+	mGL.glAttachShader(mProgram, vertexShader);
+	mGL.glAttachShader(mProgram, fragmentShader);
+	mGL.glLinkProgram(mProgram);
+	mGL.glDeleteShader(vertexShader);
+	mGL.glDeleteShader(fragmentShader);
+
+	GLint linked = GL_FALSE;
+	mGL.glGetProgramiv(mProgram, GL_LINK_STATUS, &linked);
+	if (linked != GL_TRUE) {
+		char buffer[1024] = {};
+		mGL.glGetProgramInfoLog(mProgram, sizeof(buffer), nullptr, buffer);
+		return(FunctionResult(false, RESULT::FAIL, "Failed to link the OpenGL program. " + std::string(buffer)));
+	}
+
+	mGL.glCreateVertexArrays(1, &mVertexArray);
+	mGL.glEnableVertexArrayAttrib(mVertexArray, 0);
+	mGL.glVertexArrayAttribFormat(mVertexArray, 0, 4, GL_FLOAT, GL_FALSE, offsetof(SoftwareVertex, position));
+	mGL.glVertexArrayAttribBinding(mVertexArray, 0, 0);
+	mGL.glEnableVertexArrayAttrib(mVertexArray, 1);
+	mGL.glVertexArrayAttribFormat(mVertexArray, 1, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(SoftwareVertex, color));
+	mGL.glVertexArrayAttribBinding(mVertexArray, 1, 0);
+
+	mGL.glUseProgram(mProgram);
+	mGL.glBindVertexArray(mVertexArray);
+
+	mGL.glClipControl(GL_UPPER_LEFT, GL_ZERO_TO_ONE);
+	mGL.glEnable(GL_DEPTH_TEST);
+	mGL.glDepthFunc(GL_LESS);
+	mGL.glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Built the OpenGL program."));
+}
+
+/** Creates the colour and depth targets for the current client size and binds the framebuffer. */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::initialiseFramebuffers() {
+	const GLenum target = mSampleCount > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+
+	mGL.glCreateTextures(target, 1, &mColorTexture);
+	mGL.glCreateTextures(target, 1, &mDepthStencilTexture);
+
+	if (mSampleCount > 1) {
+		mGL.glTextureStorage2DMultisample(mColorTexture, mSampleCount, GL_RGBA8, mClientWidth, mClientHeight, GL_TRUE);
+		mGL.glTextureStorage2DMultisample(mDepthStencilTexture, mSampleCount, GL_DEPTH24_STENCIL8, mClientWidth, mClientHeight, GL_TRUE);
+	}
+	else {
+		mGL.glTextureStorage2D(mColorTexture, 1, GL_RGBA8, mClientWidth, mClientHeight);
+		mGL.glTextureStorage2D(mDepthStencilTexture, 1, GL_DEPTH24_STENCIL8, mClientWidth, mClientHeight);
+	}
+
+	mGL.glCreateFramebuffers(1, &mFramebuffer);
+	mGL.glNamedFramebufferTexture(mFramebuffer, GL_COLOR_ATTACHMENT0, mColorTexture, 0);
+	mGL.glNamedFramebufferTexture(mFramebuffer, GL_DEPTH_STENCIL_ATTACHMENT, mDepthStencilTexture, 0);
+	if (mGL.glCheckNamedFramebufferStatus(mFramebuffer, GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		return(FunctionResult(false, RESULT::FAIL, "The OpenGL framebuffer is incomplete."));
+
+	if (mSampleCount > 1) {
+		mGL.glCreateTextures(GL_TEXTURE_2D, 1, &mResolveTexture);
+		mGL.glTextureStorage2D(mResolveTexture, 1, GL_RGBA8, mClientWidth, mClientHeight);
+
+		mGL.glCreateFramebuffers(1, &mResolveFramebuffer);
+		mGL.glNamedFramebufferTexture(mResolveFramebuffer, GL_COLOR_ATTACHMENT0, mResolveTexture, 0);
+		if (mGL.glCheckNamedFramebufferStatus(mResolveFramebuffer, GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			return(FunctionResult(false, RESULT::FAIL, "The OpenGL resolve framebuffer is incomplete."));
+	}
+
+	mGL.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFramebuffer);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Created the OpenGL framebuffers."));
+}
+
+void SyrenEngine::OpenGL::releaseFramebuffers() {
+	if (mGL.glDeleteFramebuffers == nullptr) return;
+
+	mGL.glDeleteFramebuffers(1, &mFramebuffer);
+	mGL.glDeleteFramebuffers(1, &mResolveFramebuffer);
+	mGL.glDeleteTextures(1, &mColorTexture);
+	mGL.glDeleteTextures(1, &mDepthStencilTexture);
+	mGL.glDeleteTextures(1, &mResolveTexture);
+
+	mFramebuffer = mResolveFramebuffer = 0;
+	mColorTexture = mDepthStencilTexture = mResolveTexture = 0;
+}
+
+void SyrenEngine::OpenGL::releaseBuffers() {
+	if (mGL.glDeleteBuffers == nullptr) return;
+
+	for (Buffer& buffer : mBuffers) {
+		if (buffer.name == 0) continue;
+		mGL.glUnmapNamedBuffer(buffer.name);
+		mGL.glDeleteBuffers(1, &buffer.name);
+	}
+	mBuffers.clear();
+
+	mState.vertexBuffer = 0;
+	mState.indexBuffer = 0;
+}
+
+void SyrenEngine::OpenGL::releaseReadback() {
+	if (mGL.glDeleteBuffers == nullptr) return;
+
+	for (std::size_t i = 0; i < mReadback.slotCount(); ++i) {
+		OpenGLReadback& staging = mReadback.slot(i).staging;
+		if (staging.buffer == 0) continue;
+
+		mGL.glUnmapNamedBuffer(staging.buffer);
+		mGL.glDeleteBuffers(1, &staging.buffer);
+		staging = OpenGLReadback();
+	}
+	mReadback.clear();
+}
+
+/** Queues a copy of the frame into a pixel pack buffer, reallocating the buffer if the frame size changed.
+ *
+ * @details
+ * The copy runs asynchronously and is covered by the fence signalled at the end of the frame. The
+ * buffer is persistently and coherently mapped, so its contents are visible once that fence completes.
+ */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::copyToReadback(OpenGLReadback& staging) {
+	const std::size_t size = static_cast<std::size_t>(mClientWidth) * mClientHeight * sizeof(std::uint32_t);
+
+	if (staging.size != size) {
+		if (staging.buffer != 0) {
+			mGL.glUnmapNamedBuffer(staging.buffer);
+			mGL.glDeleteBuffers(1, &staging.buffer);
+		}
+
+		const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		mGL.glCreateBuffers(1, &staging.buffer);
+		mGL.glNamedBufferStorage(staging.buffer, static_cast<GLsizeiptr>(size), nullptr, flags);
+		staging.mapping = static_cast<const unsigned char*>(mGL.glMapNamedBufferRange(staging.buffer, 0, static_cast<GLsizeiptr>(size), flags));
+		staging.size = size;
+		if (staging.mapping == nullptr) return(FunctionResult(false, RESULT::FAIL, "Failed to map a readback buffer."));
+	}
+
+	const GLuint texture = mSampleCount > 1 ? mResolveTexture : mColorTexture;
+	mGL.glBindBuffer(GL_PIXEL_PACK_BUFFER, staging.buffer);
+	mGL.glGetTextureImage(texture, 0, GL_RGBA, GL_UNSIGNED_BYTE, static_cast<GLsizei>(size), nullptr);
+	mGL.glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Queued the readback copy."));
+}
+
+/** Restores the full frame viewport and scissor rectangle at the start of a frame. */
+void SyrenEngine::OpenGL::resetState() {
+	const float viewport[6] = { 0.0f, 0.0f, static_cast<float>(mClientWidth), static_cast<float>(mClientHeight), 0.0f, 1.0f };
+	setViewport(viewport);
+	setScissor(0, 0, mClientWidth, mClientHeight);
+}
+
+SyrenEngine::OpenGL::Buffer* SyrenEngine::OpenGL::findBuffer(ResourceId id) {
+	if (id == NullResource || id > mBuffers.size()) return nullptr;
+	return &mBuffers[id - 1];
+}
+
+/** Records that the frame being replayed reads or writes a buffer. */
+void SyrenEngine::OpenGL::useBuffer(Buffer& buffer) {
+	assert(mCurrentFrame != nullptr);
+
+	if (buffer.usedInFrame == mFrameCount + 1) return;
+	buffer.usedInFrame = mFrameCount + 1;
+	mCurrentFrame->usedBuffers.push_back(static_cast<ResourceId>(&buffer - mBuffers.data() + 1));
+}
+
+void SyrenEngine::OpenGL::setViewport(const float viewport[6]) {
+	if (std::memcmp(mState.viewport, viewport, sizeof(mState.viewport)) == 0) {
+		++mRedundantStateChanges;
+		return;
+	}
+
+	std::memcpy(mState.viewport, viewport, sizeof(mState.viewport));
+	mGL.glViewportIndexedf(0, viewport[0], viewport[1], viewport[2], viewport[3]);
+	mGL.glDepthRangeIndexed(0, viewport[4], viewport[5]);
+	++mStateChanges;
+}
+
+void SyrenEngine::OpenGL::setScissor(GLint left, GLint top, GLint right, GLint bottom) {
+	const GLint scissor[4] = { left, top, std::max(right - left, 0), std::max(bottom - top, 0) };
+	if (std::memcmp(mState.scissor, scissor, sizeof(scissor)) == 0) {
+		++mRedundantStateChanges;
+		return;
+	}
+
+	std::memcpy(mState.scissor, scissor, sizeof(scissor));
+	mGL.glScissor(scissor[0], scissor[1], scissor[2], scissor[3]);
+	++mStateChanges;
+}
+
+void SyrenEngine::OpenGL::enableScissor(bool enabled) {
+	if (mState.scissorEnabled == enabled) return;
+
+	mState.scissorEnabled = enabled;
+	if (enabled) mGL.glEnable(GL_SCISSOR_TEST);
+	else mGL.glDisable(GL_SCISSOR_TEST);
+	++mStateChanges;
+}
+
+void SyrenEngine::OpenGL::setVertexBuffer(GLuint buffer, GLintptr offset, GLsizei stride) {
+	if (mState.vertexBuffer == buffer && mState.vertexOffset == offset && mState.vertexStride == stride) {
+		++mRedundantStateChanges;
+		return;
+	}
+
+	mState.vertexBuffer = buffer;
+	mState.vertexOffset = offset;
+	mState.vertexStride = stride;
+	mGL.glVertexArrayVertexBuffer(mVertexArray, 0, buffer, offset, stride);
+	++mStateChanges;
+}
+
+void SyrenEngine::OpenGL::setIndexBuffer(GLuint buffer) {
+	if (mState.indexBuffer == buffer) {
+		++mRedundantStateChanges;
+		return;
+	}
+
+	mState.indexBuffer = buffer;
+	mGL.glVertexArrayElementBuffer(mVertexArray, buffer);
+	++mStateChanges;
+}
+
+/***********************************************************************************************************
+ * OpenGL public member functions
+ *
+ **********************************************************************************************************/
+
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::initialise() {
+	std::string message = "Initialising OpenGL. \n";
+
+	FunctionResult initialised = initialiseDisplay();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	initialised = initialiseContext();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	initialised = initialiseFence();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	initialised = initialiseProgram();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	initialised = onResize();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	message += "Initialising OpenGL was successful.";
+
+	return(FunctionResult(true, RESULT::SSUCCESS, message));
+}
+
+/** Recreates the framebuffers for the current client size once the frames in flight have retired. */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::onResize() {
+	assert(mContext != EGL_NO_CONTEXT);
+	assert(mTimeline);
+
+	FunctionResult result = mFrames.waitForIdle();
+	if (!result.is_successfull) return(result);
+
+	releaseFramebuffers();
+
+	result = initialiseFramebuffers();
+	if (!result.is_successfull) return(result);
+
+	resetState();
+	return(FunctionResult(true, RESULT::SSUCCESS, "Succseeful."));
+}
+
+/** Frames are never presented, so throughput is bounded only by the frame ring. */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::waitForNextFrame() {
+	return(FunctionResult(true, RESULT::SSUCCESS, "OpenGL frames are not paced."));
+}
+
+/** Replays the submitted command streams into the offscreen framebuffer.
+ *
+ * @details
+ * Submitters keep recording into a second stream while the frame is replayed. Buffers used by the
+ * frame are stamped with its fence value so that updates only wait for the frames that read them.
+ *
+ * @return FunctionResult indicating the success of the frame.
+ */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::render() {
+	assert(mContext != EGL_NO_CONTEXT);
+	assert(mTimeline);
+
+	OpenGLFrameResources* frame = nullptr;
+	FunctionResult result = mFrames.beginFrame(frame);
+	if (!result.is_successfull) return(result);
+
+	{
+		std::lock_guard<std::mutex> lock(mStreamMutex);
+		std::swap(mFrameStream, mReplayStream);
+	}
+
+	mCurrentFrame = frame;
+	resetState();
+
+	StreamExecutor executor = { *this };
+	replayCommandStream(mReplayStream, executor);
+	mReplayStream.reset();
+
+	if (mSampleCount > 1) {
+		enableScissor(false);
+		mGL.glBlitNamedFramebuffer(mFramebuffer, mResolveFramebuffer, 0, 0, mClientWidth, mClientHeight,
+			0, 0, mClientWidth, mClientHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	}
+
+	OpenGLReadback* staging = nullptr;
+	std::uint64_t fenceValue = 0;
+	result = mReadback.beginCopy(staging);
+	if (!result.is_successfull) return(result);
+
+	result = copyToReadback(*staging);
+	if (result.is_successfull) result = mFrames.endFrame(fenceValue);
+	if (!result.is_successfull) {
+		mReadback.cancelCopy();
+		return(result);
+	}
+
+	mReadback.endCopy(fenceValue, mFrameCount, mClientWidth, mClientHeight);
+
+	for (ResourceId id : frame->usedBuffers)
+		mBuffers[id - 1].lastUse = fenceValue;
+	frame->usedBuffers.clear();
+
+	mCurrentFrame = nullptr;
+	++mFrameCount;
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Frame rendered."));
+}
+
+/** Queues a recorded command stream for the next frame. May be called from any thread. */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::submit(const CommandStream& stream) {
+	std::lock_guard<std::mutex> lock(mStreamMutex);
+	mFrameStream.append(stream);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Command stream queued."));
+}
+
+/** Takes the oldest rendered frame whose copy has completed.
+ *
+ * @param[out] frame: Receives the pixels of the frame.
+ * @param[in] wait: Block until the oldest copy completes instead of returning straight away.
+ *
+ * @return FunctionResult with RESULT::WSUCCESS if no frame was ready.
+ */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::readback(ReadbackFrame& frame, bool wait) {
+	OpenGLReadback* staging = nullptr;
+	FunctionResult result = mReadback.acquire(staging, frame, wait);
+	if (result.result != RESULT::SSUCCESS) return(result);
+
+	frame.pixels.resize(static_cast<std::size_t>(frame.width) * frame.height);
+	std::memcpy(frame.pixels.data(), staging->mapping, frame.pixels.size() * sizeof(std::uint32_t));
+
+	mReadback.release();
+	return(FunctionResult(true, RESULT::SSUCCESS, "Frame read back."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::update() {
+	return(FunctionResult(true, RESULT::SSUCCESS, "Succseeful."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::destroy() {
+	return(FunctionResult(true, RESULT::SSUCCESS, "Succseeful."));
+}
+
+/** Reports the renderer of the current context as the only adapter. */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::getAdapters(GraphicsAdapterList& adapters) {
+	if (mContext == EGL_NO_CONTEXT) return(FunctionResult(false, RESULT::FAIL, "OpenGL has not been initialised."));
+
+	adapters.emplace_back(0, std::string(reinterpret_cast<const char*>(mGL.glGetString(GL_RENDERER))));
+	return(FunctionResult(true, RESULT::SSUCCESS, "Adapters returned."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::getOutputs(int, GraphicsOutputList&) {
+	return(FunctionResult(true, RESULT::WSUCCESS, "The surfaceless OpenGL backend has no output devices."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::getDisplayModes(int, int, DisplayModeList&) {
+	return(FunctionResult(true, RESULT::WSUCCESS, "The surfaceless OpenGL backend has no display modes."));
+}
+
+/** Creates a persistently mapped buffer that command streams can reference.
+ *
+ * @param[in] data: Initial contents, or nullptr for a zeroed buffer.
+ * @param[in] size: Size in bytes.
+ *
+ * @retval ResourceId of the new buffer, or NullResource if it could not be created.
+ */
+SyrenEngine::ResourceId SyrenEngine::OpenGL::createBuffer(const void* data, std::size_t size) {
+	if (mContext == EGL_NO_CONTEXT || size == 0) return NullResource;
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	Buffer buffer;
+	buffer.size = size;
+	mGL.glCreateBuffers(1, &buffer.name);
+	mGL.glNamedBufferStorage(buffer.name, static_cast<GLsizeiptr>(size), nullptr, flags);
+	buffer.mapping = static_cast<unsigned char*>(mGL.glMapNamedBufferRange(buffer.name, 0, static_cast<GLsizeiptr>(size), flags));
+	if (buffer.mapping == nullptr) {
+		mGL.glDeleteBuffers(1, &buffer.name);
+		return NullResource;
+	}
+
+	if (data != nullptr) std::memcpy(buffer.mapping, data, size);
+	else std::memset(buffer.mapping, 0, size);
+
+	mBuffers.push_back(buffer);
+	return static_cast<ResourceId>(mBuffers.size());
+}
+
+/** Overwrites part of a buffer through its persistent mapping.
+ *
+ * @details
+ * Waits only for the last frame that used the buffer, so buffers that frames in flight do not read
+ * are updated without stalling.
+ */
+SyrenEngine::FunctionResult SyrenEngine::OpenGL::updateBuffer(ResourceId buffer, std::size_t offset, const void* data, std::size_t size) {
+	Buffer* destination = findBuffer(buffer);
+	if (destination == nullptr) return(FunctionResult(false, RESULT::FAIL, "Unknown buffer."));
+	if (!rangeFits(offset, size, destination->size)) return(FunctionResult(false, RESULT::FAIL, "Buffer update out of range."));
+
+	if (destination->lastUse != 0) {
+		FunctionResult result = mTimeline->waitForValue(destination->lastUse);
+		if (!result.is_successfull) return(result);
+	}
+
+	std::memcpy(destination->mapping + offset, data, size);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Buffer updated."));
+}
+
+#endif
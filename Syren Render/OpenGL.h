@@ -0,0 +1,182 @@
+/***********************************************************************************************************
+ * @file OpenGL.h
+ *
+ * @brief Implements OpenGL 4.5 as a graphics API for the Syren Render Engine
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The OpenGL backend renders headless through an EGL context on the Mesa surfaceless platform, so it
+ * runs on Linux render nodes and on llvmpipe without a display server. Frames are drawn into an
+ * offscreen framebuffer and copied into persistently mapped pixel pack buffers, which the client
+ * reads through a readback ring once the copies have completed.
+ *
+ * Every object is created and modified through direct state access, so the only binds are the
+ * framebuffer, vertex array and program, which are made once. Buffers are allocated with immutable
+ * storage and stay persistently mapped: updates are plain memory copies that wait only for the frame
+ * that last used the buffer. Pipeline state issued by command streams is cached and redundant
+ * changes are never sent to the driver.
+ *
+ * Like the software rasteriser, draws consume SoftwareVertex records with clip space positions, so
+ * both backends render identical scenes from the same command streams.
+ *
+ * The context is current on the thread that called initialise(), and every function other than
+ * submit() must be called from that thread.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "GraphicsAPI.h"
+#include "CommandStream.h"
+#include "FramePacing.h"
+#include "FrameRing.h"
+#include "OpenGLFunctions.h"
+#include "OpenGLTimeline.h"
+#include "ReadbackRing.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	/** Resources owned by a single OpenGL frame in flight. */
+	struct OpenGLFrameResources {
+		std::vector<ResourceId> usedBuffers; /*!< Buffers read or written by the frame */
+	};
+
+	/** Pixel pack buffer a headless frame is copied into. */
+	struct OpenGLReadback {
+		GLuint buffer = 0;
+		const unsigned char* mapping = nullptr;
+		std::size_t size = 0;
+	};
+
+	class OpenGL : public GraphicsAPI {
+	private:
+		/** Immutable buffer storage that stays mapped for its whole lifetime. */
+		struct Buffer {
+			GLuint name = 0;
+			unsigned char* mapping = nullptr;
+			std::size_t size = 0;
+			std::uint64_t lastUse = 0; /*!< Timeline value of the last frame that used the buffer */
+			std::uint64_t usedInFrame = 0;
+		};
+
+		/** Pipeline state as last sent to the driver. */
+		struct StateCache {
+			float viewport[6];
+			GLint scissor[4];
+			bool scissorEnabled;
+			GLuint vertexBuffer;
+			GLintptr vertexOffset;
+			GLsizei vertexStride;
+			GLuint indexBuffer;
+		};
+
+		void* mWindow;
+
+		int mClientWidth = 800;
+		int mClientHeight = 600;
+		int mSampleCount = 1;
+
+		FramePacing mPacing;
+		FrameRing<OpenGLFrameResources> mFrames;
+		OpenGLFrameResources* mCurrentFrame = nullptr;
+		std::uint64_t mFrameCount = 0;
+
+		EGLDisplay mDisplay;
+		EGLContext mContext;
+
+		OpenGLFunctions mGL;
+		std::unique_ptr<OpenGLTimeline> mTimeline;
+
+		GLuint mProgram = 0;
+		GLuint mVertexArray = 0;
+
+		GLuint mFramebuffer = 0;        /*!< Framebuffer that command streams draw into */
+		GLuint mResolveFramebuffer = 0; /*!< Single sampled copy of the frame when multisampling */
+		GLuint mColorTexture = 0;
+		GLuint mDepthStencilTexture = 0;
+		GLuint mResolveTexture = 0;
+
+		std::vector<Buffer> mBuffers; /*!< Buffer with ResourceId i is stored at i - 1 */
+		ReadbackRing<OpenGLReadback> mReadback;
+
+		StateCache mState;
+		GLenum mIndexType = GL_UNSIGNED_SHORT;
+		std::uint32_t mIndexOffset = 0;
+		std::uint32_t mIndexSize = 2;
+		std::uint64_t mStateChanges = 0;
+		std::uint64_t mRedundantStateChanges = 0;
+
+		std::mutex mStreamMutex;
+		CommandStream mFrameStream;
+		CommandStream mReplayStream;
+	public:
+		OpenGL(void* pWindow, const GraphicsConfig& pConfig);
+		~OpenGL();
+
+		virtual FunctionResult initialise();
+		virtual FunctionResult onResize();
+		virtual FunctionResult waitForNextFrame();
+		virtual FunctionResult render();
+		virtual FunctionResult submit(const CommandStream& stream);
+		virtual FunctionResult readback(ReadbackFrame& frame, bool wait);
+		virtual FunctionResult update();
+		virtual FunctionResult destroy();
+
+		FunctionResult getAdapters(GraphicsAdapterList& adapters);
+		FunctionResult getOutputs(int index, GraphicsOutputList& outputs);
+		FunctionResult getDisplayModes(int pAdapterIndex, int pOutputIndex, DisplayModeList& pDisplayModes);
+
+		ResourceId createBuffer(const void* data, std::size_t size);
+		FunctionResult updateBuffer(ResourceId buffer, std::size_t offset, const void* data, std::size_t size);
+
+		std::uint64_t frameCount() const { return mFrameCount; }
+		std::uint64_t stateChanges() const { return mStateChanges; }
+		std::uint64_t redundantStateChanges() const { return mRedundantStateChanges; }
+	private:
+		OpenGL() = delete;
+		OpenGL(const OpenGL& rhs) = delete;
+		OpenGL& operator=(const OpenGL& rhs) = delete;
+
+		struct StreamExecutor;
+
+		FunctionResult initialiseDisplay();
+		FunctionResult initialiseContext();
+		FunctionResult initialiseFence();
+		FunctionResult initialiseProgram();
+		FunctionResult initialiseFramebuffers();
+
+		void releaseFramebuffers();
+		void releaseBuffers();
+		void releaseReadback();
+		FunctionResult copyToReadback(OpenGLReadback& staging);
+		void resetState();
+
+		Buffer* findBuffer(ResourceId id);
+		void useBuffer(Buffer& buffer);
+
+		void setViewport(const float viewport[6]);
+		void setScissor(GLint left, GLint top, GLint right, GLint bottom);
+		void enableScissor(bool enabled);
+		void setVertexBuffer(GLuint buffer, GLintptr offset, GLsizei stride);
+		void setIndexBuffer(GLuint buffer);
+	};
+}
+
+#endif
@@ -0,0 +1,38 @@
+/***********************************************************************************************************
+ * @file OpenGLFunctions.cpp
+ *
+ * @brief Implements the loader declared in OpenGLFunctions.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "OpenGLFunctions.h"
+
+#ifndef _WIN32
+
+#include <string>
+
+
+/** Resolves every entry point of the table through EGL.
+ *
+ * @param[out] gl: Table to fill.
+ *
+ * @retval FunctionResult naming the first entry point that could not be resolved.
+ */
+SyrenEngine::FunctionResult SyrenEngine::loadOpenGLFunctions(OpenGLFunctions& gl) {
+#define SYREN_OPENGL_LOAD(type, name) \
+	gl.name = reinterpret_cast<type>(eglGetProcAddress(#name)); \
+	if (gl.name == nullptr) return(FunctionResult(false, RESULT::FAIL, std::string("Failed to load the OpenGL function ") + #name + "."));
+
+	SYREN_OPENGL_FUNCTIONS(SYREN_OPENGL_LOAD)
+#undef SYREN_OPENGL_LOAD
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Loaded the OpenGL functions."));
+}
+
+#endif
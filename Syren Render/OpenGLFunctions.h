@@ -0,0 +1,101 @@
+/***********************************************************************************************************
+ * @file OpenGLFunctions.h
+ *
+ * @brief Declares the table of OpenGL 4.5 entry points used by the OpenGL backend
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Entry points are resolved through eglGetProcAddress once the context is current, so the backend
+ * only links against libEGL and never depends on which GL version the system library exports.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <EGL/egl.h>
+#include <GL/glcorearb.h>
+
+#include "common.h"
+
+
+#define SYREN_OPENGL_FUNCTIONS(X) \
+	X(PFNGLGETSTRINGPROC, glGetString) \
+	X(PFNGLGETERRORPROC, glGetError) \
+	X(PFNGLENABLEPROC, glEnable) \
+	X(PFNGLDISABLEPROC, glDisable) \
+	X(PFNGLDEPTHFUNCPROC, glDepthFunc) \
+	X(PFNGLCLIPCONTROLPROC, glClipControl) \
+	X(PFNGLVIEWPORTINDEXEDFPROC, glViewportIndexedf) \
+	X(PFNGLDEPTHRANGEINDEXEDPROC, glDepthRangeIndexed) \
+	X(PFNGLSCISSORPROC, glScissor) \
+	X(PFNGLPIXELSTOREIPROC, glPixelStorei) \
+	X(PFNGLFLUSHPROC, glFlush) \
+	X(PFNGLMEMORYBARRIERPROC, glMemoryBarrier) \
+	X(PFNGLCREATEBUFFERSPROC, glCreateBuffers) \
+	X(PFNGLBINDBUFFERPROC, glBindBuffer) \
+	X(PFNGLNAMEDBUFFERSTORAGEPROC, glNamedBufferStorage) \
+	X(PFNGLMAPNAMEDBUFFERRANGEPROC, glMapNamedBufferRange) \
+	X(PFNGLUNMAPNAMEDBUFFERPROC, glUnmapNamedBuffer) \
+	X(PFNGLCOPYNAMEDBUFFERSUBDATAPROC, glCopyNamedBufferSubData) \
+	X(PFNGLDELETEBUFFERSPROC, glDeleteBuffers) \
+	X(PFNGLCREATEVERTEXARRAYSPROC, glCreateVertexArrays) \
+	X(PFNGLDELETEVERTEXARRAYSPROC, glDeleteVertexArrays) \
+	X(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray) \
+	X(PFNGLENABLEVERTEXARRAYATTRIBPROC, glEnableVertexArrayAttrib) \
+	X(PFNGLVERTEXARRAYATTRIBFORMATPROC, glVertexArrayAttribFormat) \
+	X(PFNGLVERTEXARRAYATTRIBBINDINGPROC, glVertexArrayAttribBinding) \
+	X(PFNGLVERTEXARRAYVERTEXBUFFERPROC, glVertexArrayVertexBuffer) \
+	X(PFNGLVERTEXARRAYELEMENTBUFFERPROC, glVertexArrayElementBuffer) \
+	X(PFNGLCREATETEXTURESPROC, glCreateTextures) \
+	X(PFNGLTEXTURESTORAGE2DPROC, glTextureStorage2D) \
+	X(PFNGLTEXTURESTORAGE2DMULTISAMPLEPROC, glTextureStorage2DMultisample) \
+	X(PFNGLGETTEXTUREIMAGEPROC, glGetTextureImage) \
+	X(PFNGLDELETETEXTURESPROC, glDeleteTextures) \
+	X(PFNGLCREATEFRAMEBUFFERSPROC, glCreateFramebuffers) \
+	X(PFNGLNAMEDFRAMEBUFFERTEXTUREPROC, glNamedFramebufferTexture) \
+	X(PFNGLCHECKNAMEDFRAMEBUFFERSTATUSPROC, glCheckNamedFramebufferStatus) \
+	X(PFNGLBINDFRAMEBUFFERPROC, glBindFramebuffer) \
+	X(PFNGLBLITNAMEDFRAMEBUFFERPROC, glBlitNamedFramebuffer) \
+	X(PFNGLCLEARNAMEDFRAMEBUFFERFVPROC, glClearNamedFramebufferfv) \
+	X(PFNGLCLEARNAMEDFRAMEBUFFERFIPROC, glClearNamedFramebufferfi) \
+	X(PFNGLCLEARNAMEDFRAMEBUFFERIVPROC, glClearNamedFramebufferiv) \
+	X(PFNGLDELETEFRAMEBUFFERSPROC, glDeleteFramebuffers) \
+	X(PFNGLCREATESHADERPROC, glCreateShader) \
+	X(PFNGLSHADERSOURCEPROC, glShaderSource) \
+	X(PFNGLCOMPILESHADERPROC, glCompileShader) \
+	X(PFNGLGETSHADERIVPROC, glGetShaderiv) \
+	X(PFNGLGETSHADERINFOLOGPROC, glGetShaderInfoLog) \
+	X(PFNGLDELETESHADERPROC, glDeleteShader) \
+	X(PFNGLCREATEPROGRAMPROC, glCreateProgram) \
+	X(PFNGLATTACHSHADERPROC, glAttachShader) \
+	X(PFNGLLINKPROGRAMPROC, glLinkProgram) \
+	X(PFNGLGETPROGRAMIVPROC, glGetProgramiv) \
+	X(PFNGLGETPROGRAMINFOLOGPROC, glGetProgramInfoLog) \
+	X(PFNGLUSEPROGRAMPROC, glUseProgram) \
+	X(PFNGLDELETEPROGRAMPROC, glDeleteProgram) \
+	X(PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC, glDrawArraysInstancedBaseInstance) \
+	X(PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC, glDrawElementsInstancedBaseVertexBaseInstance) \
+	X(PFNGLFENCESYNCPROC, glFenceSync) \
+	X(PFNGLCLIENTWAITSYNCPROC, glClientWaitSync) \
+	X(PFNGLDELETESYNCPROC, glDeleteSync)
+
+
+namespace SyrenEngine {
+	/** OpenGL entry points, resolved for the current context. */
+	struct OpenGLFunctions {
+#define SYREN_OPENGL_DECLARE(type, name) type name = nullptr;
+		SYREN_OPENGL_FUNCTIONS(SYREN_OPENGL_DECLARE)
+#undef SYREN_OPENGL_DECLARE
+	};
+
+	FunctionResult loadOpenGLFunctions(OpenGLFunctions& gl);
+}
+
+#endif
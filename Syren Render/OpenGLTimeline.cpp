@@ -0,0 +1,109 @@
+/***********************************************************************************************************
+ * @file OpenGLTimeline.cpp
+ *
+ * @brief Implements functions of the OpenGLTimeline class found in OpenGLTimeline.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "OpenGLTimeline.h"
+
+#ifndef _WIN32
+
+
+/** Constructor for the OpenGLTimeline class.
+ *
+ * @param[in] pGL: Entry points of the context the fences are inserted into.
+ */
+SyrenEngine::OpenGLTimeline::OpenGLTimeline(const OpenGLFunctions& pGL) : mGL(pGL) {}
+
+/** Destructor for the OpenGLTimeline class. The context must still be current. */
+SyrenEngine::OpenGLTimeline::~OpenGLTimeline() {
+	for (PendingFence& fence : mPending)
+		mGL.glDeleteSync(fence.sync);
+	mPending.clear();
+}
+
+/** Inserts a fence behind all previously issued commands and flushes it to the driver.
+ *
+ * @param[out] value: Timeline value that is reached once all previously issued commands complete.
+ *
+ * @retval FunctionResult indicating whether the fence was inserted.
+ */
+SyrenEngine::FunctionResult SyrenEngine::OpenGLTimeline::signal(std::uint64_t& value) {
+	GLsync sync = mGL.glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	if (sync == nullptr) return(FunctionResult(false, RESULT::FAIL, "Failed to insert a fence sync object."));
+
+	mGL.glFlush();
+
+	value = ++mLastSignaledValue;
+	mPending.push_back({ value, sync });
+	return(FunctionResult(true, RESULT::SSUCCESS, "Inserted a fence sync object."));
+}
+
+/** Blocks until the timeline reaches the given value.
+ *
+ * @param[in] value: Timeline value to wait for.
+ *
+ * @retval FunctionResult indicating whether the wait succeeded.
+ */
+SyrenEngine::FunctionResult SyrenEngine::OpenGLTimeline::waitForValue(std::uint64_t value) {
+	if (isComplete(value)) return(FunctionResult(true, RESULT::SSUCCESS, "Timeline value reached."));
+
+	if (value > mLastSignaledValue)
+		return(FunctionResult(false, RESULT::FAIL, "Cannot wait for a timeline value that has not been signalled."));
+
+	for (const PendingFence& fence : mPending) {
+		if (fence.value < value) continue;
+
+		GLenum status = mGL.glClientWaitSync(fence.sync, 0, GL_TIMEOUT_IGNORED);
+		if (status == GL_WAIT_FAILED) return(FunctionResult(false, RESULT::FAIL, "Failed to wait for a fence sync object."));
+
+		retireUpTo(fence.value);
+		break;
+	}
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Timeline value reached."));
+}
+
+/** Polls the pending fences in signal order and releases the completed ones.
+ *
+ * @retval The last timeline value reached.
+ */
+std::uint64_t SyrenEngine::OpenGLTimeline::completedValue() {
+	std::uint64_t reached = mCompletedValue;
+
+	for (const PendingFence& fence : mPending) {
+		GLenum status = mGL.glClientWaitSync(fence.sync, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+		reached = fence.value;
+	}
+
+	retireUpTo(reached);
+	return mCompletedValue;
+}
+
+bool SyrenEngine::OpenGLTimeline::isComplete(std::uint64_t value) {
+	if (value <= mCompletedValue) return true;
+	return(value <= completedValue());
+}
+
+std::uint64_t SyrenEngine::OpenGLTimeline::lastSignaledValue() const {
+	return mLastSignaledValue;
+}
+
+/** Deletes the sync objects of every value up to and including the given one. */
+void SyrenEngine::OpenGLTimeline::retireUpTo(std::uint64_t value) {
+	while (!mPending.empty() && mPending.front().value <= value) {
+		mGL.glDeleteSync(mPending.front().sync);
+		mPending.pop_front();
+	}
+	if (value > mCompletedValue) mCompletedValue = value;
+}
+
+#endif
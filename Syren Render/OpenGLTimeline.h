@@ -0,0 +1,65 @@
+/***********************************************************************************************************
+ * @file OpenGLTimeline.h
+ *
+ * @brief Implements the Timeline interface over OpenGL fence sync objects
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * OpenGL has no counting fence, so every signal inserts a sync object and the timeline keeps them in
+ * signal order. Because the command stream executes in order, a value is complete once its own sync
+ * object is, and every older sync object can be released at the same time.
+ *
+ * Sync objects belong to the context, so the timeline may only be used on the thread the context is
+ * current on.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <cstdint>
+#include <deque>
+
+#include "OpenGLFunctions.h"
+#include "Timeline.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	class OpenGLTimeline : public Timeline {
+	private:
+		struct PendingFence {
+			std::uint64_t value;
+			GLsync sync;
+		};
+
+		const OpenGLFunctions& mGL;
+		std::deque<PendingFence> mPending;
+
+		std::uint64_t mLastSignaledValue = 0;
+		std::uint64_t mCompletedValue = 0;
+	public:
+		explicit OpenGLTimeline(const OpenGLFunctions& pGL);
+		~OpenGLTimeline();
+
+		virtual FunctionResult signal(std::uint64_t& value);
+		virtual FunctionResult waitForValue(std::uint64_t value);
+		virtual std::uint64_t completedValue();
+		virtual bool isComplete(std::uint64_t value);
+		virtual std::uint64_t lastSignaledValue() const;
+	private:
+		OpenGLTimeline() = delete;
+		OpenGLTimeline(const OpenGLTimeline& rhs) = delete;
+		OpenGLTimeline& operator=(const OpenGLTimeline& rhs) = delete;
+
+		void retireUpTo(std::uint64_t value);
+	};
+}
+
+#endif
@@ -0,0 +1,216 @@
+/***********************************************************************************************************
+ * @file PipelineCache.cpp
+ *
+ * @brief Implements functions of the PipelineCache class found in PipelineCache.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "PipelineCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "Hash.h"
+
+
+/** Opens the cache file written by an earlier run.
+ *
+ * @details
+ * A missing, foreign or damaged file is not an error; the cache starts empty and the file is rewritten
+ * by the next save().
+ *
+ * @param[in] path: Cache file, which does not have to exist yet.
+ * @param[in] identity: Driver and adapter the blobs of this run are compiled by.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if the file was not used.
+ */
+SyrenEngine::FunctionResult SyrenEngine::PipelineCache::load(const std::string& path, const PipelineCacheIdentity& identity) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	mPath = path;
+	mIdentity = identity;
+	mStored.clear();
+	mStatistics = PipelineCacheStatistics();
+	return(map());
+}
+
+/** Writes every blob of the loaded file and of this run to the cache file.
+ *
+ * @details
+ * The file is written beside the old one and renamed over it, so an interrupted save leaves the old
+ * cache intact. The file is mapped again afterwards, which invalidates the blobs returned by find(), so
+ * no pipeline may be in creation while the cache is saved.
+ */
+SyrenEngine::FunctionResult SyrenEngine::PipelineCache::save() {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mPath.empty()) return(FunctionResult(false, RESULT::FAIL, "The pipeline cache has not been loaded."));
+	if (mStored.empty()) return(FunctionResult(true, RESULT::SSUCCESS, "The pipeline cache is up to date."));
+
+	struct Blob {
+		std::uint64_t key;
+		const unsigned char* data;
+		std::uint64_t size;
+		std::uint64_t checksum;
+	};
+
+	// Checksums of loaded blobs are carried over rather than recomputed, so damage stays detectable
+	std::vector<Blob> blobs;
+	blobs.reserve(mEntryCount + mStored.size());
+	for (std::uint32_t i = 0; i < mEntryCount; ++i) {
+		const FileEntry& entry = mEntries[i];
+		if (mStored.find(entry.key) == mStored.end()) blobs.push_back(Blob{ entry.key, mFile.data() + entry.offset, entry.size, entry.checksum });
+	}
+	for (const auto& stored : mStored)
+		blobs.push_back(Blob{ stored.first, stored.second.data(), stored.second.size(), fnv1a(stored.second.data(), stored.second.size()) });
+
+	std::sort(blobs.begin(), blobs.end(), [](const Blob& lhs, const Blob& rhs) { return lhs.key < rhs.key; });
+
+	FileHeader header = { PipelineCacheMagic, PipelineCacheVersion, mIdentity, static_cast<std::uint32_t>(blobs.size()), 0 };
+	std::vector<FileEntry> index(blobs.size());
+	std::uint64_t offset = sizeof(FileHeader) + blobs.size() * sizeof(FileEntry);
+	for (std::size_t i = 0; i < blobs.size(); ++i) {
+		index[i] = FileEntry{ blobs[i].key, offset, blobs[i].size, blobs[i].checksum };
+		offset += blobs[i].size;
+	}
+
+	const std::string temporary = mPath + ".tmp";
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) return(FunctionResult(false, RESULT::FAIL, "Failed to create " + temporary + "."));
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(FileEntry)));
+	for (const Blob& blob : blobs)
+		file.write(reinterpret_cast<const char*>(blob.data), static_cast<std::streamsize>(blob.size));
+	file.close();
+
+	std::error_code error;
+	if (file.fail()) {
+		std::filesystem::remove(temporary, error);
+		return(FunctionResult(false, RESULT::FAIL, "Failed to write " + temporary + "."));
+	}
+
+	// The old file cannot be replaced while it is mapped
+	mEntries = nullptr;
+	mEntryCount = 0;
+	mFile.close();
+
+	std::filesystem::rename(temporary, mPath, error);
+	if (error) {
+		std::filesystem::remove(temporary, error);
+		map();
+		return(FunctionResult(false, RESULT::FAIL, "Failed to replace " + mPath + "."));
+	}
+
+	mStored.clear();
+	FunctionResult result = map();
+	if (result.result != RESULT::SSUCCESS) return(FunctionResult(false, RESULT::FAIL, "Failed to map the saved pipeline cache. " + result.message));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Saved the pipeline cache."));
+}
+
+/** Looks up the blob of a pipeline.
+ *
+ * @param[in] key: Hash of the full pipeline description.
+ * @param[out] blob: Blob to hand to the driver, valid until the key is stored again or the cache is saved.
+ * @param[out] size: Size of the blob.
+ *
+ * @retval False if the pipeline has to be compiled.
+ */
+bool SyrenEngine::PipelineCache::find(std::uint64_t key, const void*& blob, std::size_t& size) {
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto stored = mStored.find(key);
+	if (stored != mStored.end()) {
+		blob = stored->second.data();
+		size = stored->second.size();
+		++mStatistics.hitCount;
+		return true;
+	}
+
+	const FileEntry* entry = findEntry(key);
+	if (entry == nullptr) {
+		++mStatistics.missCount;
+		return false;
+	}
+
+	const unsigned char* data = mFile.data() + entry->offset;
+	if (fnv1a(data, static_cast<std::size_t>(entry->size)) != entry->checksum) {
+		++mStatistics.corruptCount;
+		++mStatistics.missCount;
+		return false;
+	}
+
+	blob = data;
+	size = static_cast<std::size_t>(entry->size);
+	++mStatistics.hitCount;
+	return true;
+}
+
+/** Keeps the blob of a freshly compiled pipeline until the next save(), replacing any blob of the key. */
+void SyrenEngine::PipelineCache::store(std::uint64_t key, const void* blob, std::size_t size) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(blob);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mStored[key].assign(bytes, bytes + size);
+}
+
+SyrenEngine::PipelineCacheStatistics SyrenEngine::PipelineCache::statistics() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	PipelineCacheStatistics statistics = mStatistics;
+	statistics.storedCount = static_cast<std::uint32_t>(mStored.size());
+	return statistics;
+}
+
+/** Maps the cache file and validates its header and index. The blobs are checked when they are looked up. */
+SyrenEngine::FunctionResult SyrenEngine::PipelineCache::map() {
+	static_assert(sizeof(FileHeader) == 40 && sizeof(FileEntry) == 32, "The cache file layout must not contain padding.");
+
+	mEntries = nullptr;
+	mEntryCount = 0;
+	mStatistics.loadedCount = 0;
+
+	FunctionResult result = mFile.open(mPath);
+	if (!result.is_successfull) return(FunctionResult(true, RESULT::WSUCCESS, "No pipeline cache found, starting empty."));
+
+	auto ignore = [this](const char* message) {
+		mFile.close();
+		return(FunctionResult(true, RESULT::WSUCCESS, message));
+	};
+
+	if (mFile.size() < sizeof(FileHeader)) return(ignore("The pipeline cache is truncated and was ignored."));
+
+	FileHeader header;
+	std::memcpy(&header, mFile.data(), sizeof(header));
+	if (header.magic != PipelineCacheMagic || header.version != PipelineCacheVersion) return(ignore("The pipeline cache has an unknown format and was ignored."));
+	if (!(header.identity == mIdentity)) return(ignore("The pipeline cache was written by another driver or adapter and was ignored."));
+
+	const std::uint64_t fileSize = mFile.size();
+	const std::uint64_t indexEnd = sizeof(FileHeader) + static_cast<std::uint64_t>(header.entryCount) * sizeof(FileEntry);
+	if (indexEnd > fileSize) return(ignore("The pipeline cache is truncated and was ignored."));
+
+	const FileEntry* entries = reinterpret_cast<const FileEntry*>(mFile.data() + sizeof(FileHeader));
+	for (std::uint32_t i = 0; i < header.entryCount; ++i) {
+		if (i > 0 && entries[i].key <= entries[i - 1].key) return(ignore("The pipeline cache index is not sorted and was ignored."));
+		if (entries[i].offset < indexEnd || entries[i].offset > fileSize || entries[i].size > fileSize - entries[i].offset)
+			return(ignore("The pipeline cache index points outside the file and was ignored."));
+	}
+
+	mEntries = entries;
+	mEntryCount = header.entryCount;
+	mStatistics.loadedCount = header.entryCount;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Loaded the pipeline cache."));
+}
+
+const SyrenEngine::PipelineCache::FileEntry* SyrenEngine::PipelineCache::findEntry(std::uint64_t key) const {
+	const FileEntry* end = mEntries + mEntryCount;
+	const FileEntry* entry = std::lower_bound(mEntries, end, key, [](const FileEntry& lhs, std::uint64_t value) { return lhs.key < value; });
+	return(entry != end && entry->key == key ? entry : nullptr);
+}
@@ -0,0 +1,111 @@
+/***********************************************************************************************************
+ * @file PipelineCache.h
+ *
+ * @brief Declares the API independent cache of compiled pipeline blobs that persists between runs
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Compiling a pipeline state turns its shaders into GPU code, which takes milliseconds per pipeline and
+ * hitches the first frames that use them. Drivers can hand the compiled result back as an opaque blob
+ * and accept it again when the same pipeline is created later. The cache keeps these blobs keyed by a
+ * stable hash of the full pipeline description and writes them to disk, so that the next run skips the
+ * compilation.
+ *
+ * The file is a header, an index of entries sorted by key and the blobs behind it. It is mapped into
+ * memory at startup and lookups binary search the index in place, so opening a cache of any size costs
+ * nothing up front. Blobs only fit the driver and adapter that produced them, so the file records their
+ * identity and a file written by anything else is ignored as a whole. Every blob carries a checksum,
+ * which is verified when it is looked up; a corrupt file costs a recompile, never a crash.
+ *
+ * Blobs compiled during a run are kept in memory and merged into the file by save(). Lookups and stores
+ * may come from any thread.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+#include "MappedFile.h"
+
+
+namespace SyrenEngine {
+	static const std::uint32_t PipelineCacheMagic = 0x43505953u; /*!< "SYPC" */
+	static const std::uint32_t PipelineCacheVersion = 1;
+
+	/** Driver and adapter the blobs were compiled by. */
+	struct PipelineCacheIdentity {
+		std::uint32_t vendorId = 0;
+		std::uint32_t deviceId = 0;
+		std::uint32_t subSysId = 0;
+		std::uint32_t revision = 0;
+		std::uint64_t driverVersion = 0;
+
+		bool operator==(const PipelineCacheIdentity& rhs) const = default;
+	};
+
+	struct PipelineCacheStatistics {
+		std::uint32_t loadedCount = 0;   /*!< Entries in the file that was loaded */
+		std::uint32_t storedCount = 0;   /*!< Blobs compiled during this run and not saved yet */
+		std::uint64_t hitCount = 0;
+		std::uint64_t missCount = 0;
+		std::uint64_t corruptCount = 0;  /*!< Lookups whose blob failed its checksum */
+	};
+
+	class PipelineCache {
+	private:
+		struct FileHeader {
+			std::uint32_t magic;
+			std::uint32_t version;
+			PipelineCacheIdentity identity;
+			std::uint32_t entryCount;
+			std::uint32_t reserved;
+		};
+
+		struct FileEntry {
+			std::uint64_t key;
+			std::uint64_t offset;   /*!< Offset of the blob from the start of the file */
+			std::uint64_t size;
+			std::uint64_t checksum; /*!< Hash of the blob */
+		};
+
+		std::string mPath;
+		PipelineCacheIdentity mIdentity;
+
+		MappedFile mFile;
+		const FileEntry* mEntries = nullptr;
+		std::uint32_t mEntryCount = 0;
+
+		std::unordered_map<std::uint64_t, std::vector<unsigned char> > mStored;
+
+		PipelineCacheStatistics mStatistics;
+		mutable std::mutex mMutex;
+	public:
+		PipelineCache() = default;
+
+		FunctionResult load(const std::string& path, const PipelineCacheIdentity& identity);
+		FunctionResult save();
+
+		bool find(std::uint64_t key, const void*& blob, std::size_t& size);
+		void store(std::uint64_t key, const void* blob, std::size_t size);
+
+		PipelineCacheStatistics statistics() const;
+	private:
+		PipelineCache(const PipelineCache& rhs) = delete;
+		PipelineCache& operator=(const PipelineCache& rhs) = delete;
+
+		FunctionResult map();
+		const FileEntry* findEntry(std::uint64_t key) const;
+	};
+}
@@ -0,0 +1,210 @@
+/***********************************************************************************************************
+ * @file PipelineScheduler.cpp
+ *
+ * @brief Implements functions of the PipelineScheduler class found in PipelineScheduler.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "PipelineScheduler.h"
+
+#include <utility>
+
+
+/** Destructor for the PipelineScheduler class. Waits for the running compile jobs and releases every pipeline. */
+SyrenEngine::PipelineScheduler::~PipelineScheduler() {
+	shutdown();
+}
+
+/** Prepares the scheduler for requests.
+ *
+ * @param[in] pWorkers: Pool the compile jobs run on. It has to finish the queued jobs before it is destroyed.
+ * @param[in] pRelease: Frees a backend pipeline once no frame can use it any more.
+ */
+SyrenEngine::FunctionResult SyrenEngine::PipelineScheduler::initialise(WorkerPool* pWorkers, std::function<void(void*)> pRelease) {
+	if (pWorkers == nullptr || !pRelease) return(FunctionResult(false, RESULT::FAIL, "Pipeline scheduler requires a worker pool and a release function."));
+
+	mWorkers = pWorkers;
+	mRelease = std::move(pRelease);
+	mStopping.store(false);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the pipeline scheduler."));
+}
+
+/** Cancels the compile jobs that have not started, waits for the running ones and releases every pipeline.
+ *
+ * @details
+ * Callbacks of pipelines that never finished are dropped without being fired. The GPU must no longer use
+ * any of the pipelines.
+ */
+void SyrenEngine::PipelineScheduler::shutdown() {
+	mStopping.store(true);
+
+	{
+		std::unique_lock<std::mutex> lock(mCompletionMutex);
+		mIdle.wait(lock, [this]() { return mInFlight == 0; });
+
+		for (Completion& completion : mCompleted) {
+			if (completion.pipeline != nullptr) mRelease(completion.pipeline);
+		}
+		mCompleted.clear();
+	}
+
+	for (ScheduledPipeline& pipeline : mPipelines) {
+		if (pipeline.pipeline != nullptr) mRelease(pipeline.pipeline);
+	}
+	mPipelines.clear();
+	mKeys.clear();
+	mStatistics = PipelineSchedulerStatistics();
+}
+
+/** Queues the compilation of a pipeline, unless a pipeline with the same key was requested before.
+ *
+ * @param[in] key: Stable hash of the pipeline description.
+ * @param[in] compile: Job compiling the pipeline on a worker thread. Everything it references has to stay
+ *                     alive until the pipeline is finished.
+ * @param[in] fallback: Pipeline drawn with until this one is ready, if the pipeline has none yet.
+ *
+ * @retval Handle the pipeline is resolved through, invalid after shutdown().
+ */
+SyrenEngine::PipelineHandle SyrenEngine::PipelineScheduler::request(std::uint64_t key, PipelineCompileJob compile, PipelineHandle fallback) {
+	if (mWorkers == nullptr || mStopping.load()) return(PipelineHandle());
+
+	auto existing = mKeys.find(key);
+	if (existing != mKeys.end()) {
+		if (!mPipelines.get(existing->second)->fallback.valid()) setFallback(existing->second, fallback);
+		return(existing->second);
+	}
+
+	PipelineHandle handle = mPipelines.create();
+	ScheduledPipeline& pipeline = *mPipelines.get(handle);
+	pipeline.key = key;
+	pipeline.fallback = fallback;
+	mKeys.emplace(key, handle);
+
+	++mStatistics.requestedCount;
+	++mStatistics.pendingCount;
+
+	{
+		std::lock_guard<std::mutex> lock(mCompletionMutex);
+		++mInFlight;
+	}
+
+	mWorkers->enqueue([this, handle, compile = std::move(compile)]() {
+		void* pipeline = nullptr;
+		FunctionResult result = mStopping.load() ? FunctionResult(false, RESULT::FAIL, "Pipeline compilation was cancelled.") : compile(pipeline);
+
+		std::lock_guard<std::mutex> lock(mCompletionMutex);
+		mCompleted.push_back(Completion{ handle, pipeline, std::move(result) });
+		--mInFlight;
+		mIdle.notify_all();
+	});
+
+	return(handle);
+}
+
+/** Sets the pipeline drawn with while a pipeline is not ready.
+ *
+ * @retval False if the pipeline is unknown or the fallback would lead back to it.
+ */
+bool SyrenEngine::PipelineScheduler::setFallback(PipelineHandle handle, PipelineHandle fallback) {
+	ScheduledPipeline* pipeline = mPipelines.get(handle);
+	if (pipeline == nullptr) return false;
+
+	for (const ScheduledPipeline* next = mPipelines.get(fallback); next != nullptr; next = mPipelines.get(next->fallback)) {
+		if (next == pipeline) return false;
+	}
+
+	pipeline->fallback = fallback;
+	return true;
+}
+
+/** Registers a callback for when a pipeline is finished. Fires at once if it already is. */
+void SyrenEngine::PipelineScheduler::onReady(PipelineHandle handle, PipelineCallback callback) {
+	ScheduledPipeline* pipeline = mPipelines.get(handle);
+	if (pipeline == nullptr) return;
+
+	if (pipeline->status == PipelineStatus::PENDING) {
+		pipeline->callbacks.push_back(std::move(callback));
+		return;
+	}
+	callback(handle, pipeline->status == PipelineStatus::READY ? pipeline->pipeline : nullptr);
+}
+
+/** Publishes the pipelines the workers have finished and fires their callbacks. Called once per frame.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if a pipeline failed to compile. Draws keep using its fallback.
+ */
+SyrenEngine::FunctionResult SyrenEngine::PipelineScheduler::pump() {
+	{
+		std::lock_guard<std::mutex> lock(mCompletionMutex);
+		mPublishing.swap(mCompleted);
+	}
+
+	std::string failure;
+	for (Completion& completion : mPublishing) {
+		ScheduledPipeline* pipeline = mPipelines.get(completion.handle);
+		if (pipeline == nullptr) {
+			if (completion.pipeline != nullptr) mRelease(completion.pipeline);
+			continue;
+		}
+
+		--mStatistics.pendingCount;
+		if (completion.result.is_successfull && completion.pipeline != nullptr) {
+			pipeline->pipeline = completion.pipeline;
+			pipeline->status = PipelineStatus::READY;
+			++mStatistics.readyCount;
+		}
+		else {
+			if (completion.pipeline != nullptr) mRelease(completion.pipeline);
+			pipeline->status = PipelineStatus::FAILED;
+			++mStatistics.failedCount;
+			if (failure.empty()) failure = "Failed to compile a pipeline. " + completion.result.message;
+		}
+
+		// Callbacks may request pipelines, which moves the pool's objects
+		std::vector<PipelineCallback> callbacks = std::move(pipeline->callbacks);
+		pipeline->callbacks.clear();
+		void* published = pipeline->pipeline;
+		for (PipelineCallback& callback : callbacks)
+			callback(completion.handle, published);
+	}
+	mPublishing.clear();
+
+	if (!failure.empty()) return(FunctionResult(true, RESULT::WSUCCESS, failure));
+	return(FunctionResult(true, RESULT::SSUCCESS, "Pipelines published."));
+}
+
+/** Returns the pipeline to draw with this frame.
+ *
+ * @retval The pipeline once it is ready, otherwise the first ready pipeline along its fallbacks, or nullptr
+ *         if the draw has to be skipped.
+ */
+void* SyrenEngine::PipelineScheduler::resolve(PipelineHandle handle) const {
+	const ScheduledPipeline* pipeline = mPipelines.get(handle);
+	if (pipeline != nullptr && pipeline->status == PipelineStatus::READY) return(pipeline->pipeline);
+
+	while (pipeline != nullptr) {
+		pipeline = mPipelines.get(pipeline->fallback);
+		if (pipeline != nullptr && pipeline->status == PipelineStatus::READY) {
+			++mStatistics.fallbackCount;
+			return(pipeline->pipeline);
+		}
+	}
+
+	++mStatistics.skippedCount;
+	return(nullptr);
+}
+
+SyrenEngine::PipelineStatus SyrenEngine::PipelineScheduler::status(PipelineHandle handle) const {
+	const ScheduledPipeline* pipeline = mPipelines.get(handle);
+	return(pipeline != nullptr ? pipeline->status : PipelineStatus::FAILED);
+}
+
+SyrenEngine::PipelineSchedulerStatistics SyrenEngine::PipelineScheduler::statistics() const {
+	return(mStatistics);
+}
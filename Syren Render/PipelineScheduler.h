@@ -0,0 +1,114 @@
+/***********************************************************************************************************
+ * @file PipelineScheduler.h
+ *
+ * @brief Declares the API independent scheduler that compiles pipelines on worker threads
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Creating a pipeline that is not cached compiles its shaders, which takes long enough to spike the
+ * frame it happens in. Pipelines are therefore requested up front and compiled on a WorkerPool, and the
+ * frames that need one before it is ready draw with a cheaper fallback pipeline, or skip the draw when
+ * no fallback is ready either. Requests are deduplicated by the stable hash of the pipeline
+ * description, so the same pipeline requested by several materials is compiled once.
+ *
+ * Workers only run the compile jobs and queue their results. pump(), called once per frame on the
+ * render thread, publishes the finished pipelines and fires the callbacks registered for them, so
+ * resolving a pipeline for a draw takes no lock. Apart from the compile jobs, every function is called
+ * on the render thread.
+ *
+ * The scheduler knows nothing about backend objects. Jobs return an opaque pipeline, which the release
+ * function given to initialise() frees on shutdown.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+#include "HandlePool.h"
+#include "WorkerPool.h"
+
+
+namespace SyrenEngine {
+	enum class PipelineStatus : unsigned char { PENDING, READY, FAILED };
+
+	struct ScheduledPipeline;
+	typedef Handle<ScheduledPipeline> PipelineHandle;
+
+	/** Compiles a pipeline on a worker thread and hands back the backend object. */
+	typedef std::function<FunctionResult(void*& pipeline)> PipelineCompileJob;
+
+	/** Fired on the render thread when a pipeline is finished, with nullptr if it failed to compile. */
+	typedef std::function<void(PipelineHandle handle, void* pipeline)> PipelineCallback;
+
+	struct ScheduledPipeline {
+		std::uint64_t key = 0;                 /*!< Hash of the pipeline description */
+		void* pipeline = nullptr;              /*!< Backend object once ready */
+		PipelineHandle fallback;               /*!< Drawn with while this pipeline is not ready */
+		PipelineStatus status = PipelineStatus::PENDING;
+		std::vector<PipelineCallback> callbacks;
+	};
+
+	struct PipelineSchedulerStatistics {
+		std::uint32_t requestedCount = 0;  /*!< Distinct pipelines requested */
+		std::uint32_t pendingCount = 0;
+		std::uint32_t readyCount = 0;
+		std::uint32_t failedCount = 0;
+		std::uint64_t fallbackCount = 0;   /*!< Resolves answered with a fallback */
+		std::uint64_t skippedCount = 0;    /*!< Resolves with nothing to draw with */
+	};
+
+	class PipelineScheduler {
+	private:
+		struct Completion {
+			PipelineHandle handle;
+			void* pipeline;
+			FunctionResult result;
+		};
+
+		WorkerPool* mWorkers = nullptr;
+		std::function<void(void*)> mRelease;
+
+		HandlePool<ScheduledPipeline> mPipelines;
+		std::unordered_map<std::uint64_t, PipelineHandle> mKeys;
+
+		std::mutex mCompletionMutex;
+		std::condition_variable mIdle;
+		std::vector<Completion> mCompleted;  /*!< Filled by the workers */
+		std::vector<Completion> mPublishing; /*!< Swapped with mCompleted by pump() */
+		std::uint32_t mInFlight = 0;
+		std::atomic<bool> mStopping{ false };
+
+		mutable PipelineSchedulerStatistics mStatistics;
+	public:
+		PipelineScheduler() = default;
+		~PipelineScheduler();
+
+		FunctionResult initialise(WorkerPool* pWorkers, std::function<void(void*)> pRelease);
+		void shutdown();
+
+		PipelineHandle request(std::uint64_t key, PipelineCompileJob compile, PipelineHandle fallback = PipelineHandle());
+		bool setFallback(PipelineHandle handle, PipelineHandle fallback);
+		void onReady(PipelineHandle handle, PipelineCallback callback);
+		FunctionResult pump();
+
+		void* resolve(PipelineHandle handle) const;
+		PipelineStatus status(PipelineHandle handle) const;
+		PipelineSchedulerStatistics statistics() const;
+	private:
+		PipelineScheduler(const PipelineScheduler& rhs) = delete;
+		PipelineScheduler& operator=(const PipelineScheduler& rhs) = delete;
+	};
+}
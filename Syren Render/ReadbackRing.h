@@ -0,0 +1,189 @@
+/***********************************************************************************************************
+ * @file ReadbackRing.h
+ *
+ * @brief Declares the ring of staging buffers that headless frames are copied into for the client
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Every headless frame ends with a copy of its render target into the next staging slot, tagged with
+ * the timeline value of the frame. The client takes frames from the oldest end of the ring once their
+ * copies have completed, so reading a frame back never stalls rendering of the frames behind it. If
+ * the client falls a whole ring behind, the oldest unread frame is dropped instead of blocking.
+ *
+ * The staging type is backend specific: a readback heap buffer, a host visible Vulkan buffer, a
+ * mapped pixel pack buffer or plain memory for the software rasteriser.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common.h"
+#include "Timeline.h"
+
+
+namespace SyrenEngine {
+	/** A frame read back from a headless render target. */
+	struct ReadbackFrame {
+		std::uint64_t frameIndex = 0;      /*!< Number of the frame, counting from zero */
+		int width = 0;
+		int height = 0;
+		std::vector<std::uint32_t> pixels; /*!< RGBA8 pixels, top row first and without padding */
+	};
+
+	template<typename Staging>
+	class ReadbackRing {
+	public:
+		struct Slot {
+			Staging staging;
+			std::uint64_t fenceValue = 0; /*!< Timeline value reached once the copy has completed */
+			std::uint64_t frameIndex = 0;
+			int width = 0;
+			int height = 0;
+			bool pending = false;         /*!< Holds a frame the client has not read yet */
+		};
+
+	private:
+		Timeline* mTimeline = nullptr;
+		std::vector<Slot> mSlots;
+
+		std::size_t mNextSlot = 0;
+		std::size_t mOldestSlot = 0;
+		std::size_t mPendingCount = 0;
+		std::uint64_t mDroppedFrames = 0;
+		bool mCopying = false;
+
+	public:
+		ReadbackRing() = default;
+
+		/** Sizes the ring and binds it to the timeline the copies are signalled on.
+		 *
+		 * @param[in] pTimeline: Timeline signalled at the end of each frame.
+		 * @param[in] pSlotCount: Number of frames that may wait to be read back.
+		 */
+		FunctionResult initialise(Timeline* pTimeline, std::size_t pSlotCount) {
+			if (pTimeline == nullptr) return(FunctionResult(false, RESULT::FAIL, "Readback ring requires a timeline."));
+			if (pSlotCount == 0) return(FunctionResult(false, RESULT::FAIL, "Readback ring requires at least one slot."));
+
+			mTimeline = pTimeline;
+			mSlots.clear();
+			mSlots.resize(pSlotCount);
+			mNextSlot = 0;
+			mOldestSlot = 0;
+			mPendingCount = 0;
+			mDroppedFrames = 0;
+			mCopying = false;
+			return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the readback ring."));
+		}
+
+		/** Claims the staging memory the current frame is copied into.
+		 *
+		 * @details
+		 * If the slot still holds an unread frame, that frame is dropped once its copy has completed.
+		 * The slot stays claimed until endCopy() publishes it or cancelCopy() gives it back.
+		 *
+		 * @param[out] pStaging: Staging memory of the claimed slot.
+		 */
+		FunctionResult beginCopy(Staging*& pStaging) {
+			assert(!mCopying);
+			Slot& slot = mSlots[mNextSlot];
+
+			if (slot.pending) {
+				FunctionResult result = mTimeline->waitForValue(slot.fenceValue);
+				if (!result.is_successfull) return(result);
+
+				slot.pending = false;
+				--mPendingCount;
+				++mDroppedFrames;
+				mOldestSlot = (mOldestSlot + 1) % mSlots.size();
+			}
+
+			pStaging = &slot.staging;
+			mCopying = true;
+			return(FunctionResult(true, RESULT::SSUCCESS, "Readback slot acquired."));
+		}
+
+		/** Publishes the slot claimed by beginCopy() once the frame has been submitted.
+		 *
+		 * @param[in] fenceValue: Timeline value signalled after the copy.
+		 * @param[in] frameIndex: Number of the frame that was copied.
+		 * @param[in] width: Width of the frame in pixels.
+		 * @param[in] height: Height of the frame in pixels.
+		 */
+		void endCopy(std::uint64_t fenceValue, std::uint64_t frameIndex, int width, int height) {
+			assert(mCopying);
+			Slot& slot = mSlots[mNextSlot];
+			slot.fenceValue = fenceValue;
+			slot.frameIndex = frameIndex;
+			slot.width = width;
+			slot.height = height;
+			slot.pending = true;
+
+			++mPendingCount;
+			mNextSlot = (mNextSlot + 1) % mSlots.size();
+			mCopying = false;
+		}
+
+		/** Gives back the slot claimed by beginCopy() when the frame failed before it was submitted. */
+		void cancelCopy() {
+			mCopying = false;
+		}
+
+		/** Returns the oldest unread frame once its copy has completed.
+		 *
+		 * @param[out] pStaging: Staging memory holding the frame.
+		 * @param[out] frame: Receives the index and size of the frame; the pixels are left to the backend.
+		 * @param[in] wait: Block until the copy completes instead of returning straight away.
+		 *
+		 * @retval FunctionResult with RESULT::WSUCCESS if no frame is ready.
+		 */
+		FunctionResult acquire(Staging*& pStaging, ReadbackFrame& frame, bool wait) {
+			if (mPendingCount == 0) return(FunctionResult(true, RESULT::WSUCCESS, "No frames are waiting to be read back."));
+
+			Slot& slot = mSlots[mOldestSlot];
+			if (!mTimeline->isComplete(slot.fenceValue)) {
+				if (!wait) return(FunctionResult(true, RESULT::WSUCCESS, "The oldest frame is still being copied."));
+
+				FunctionResult result = mTimeline->waitForValue(slot.fenceValue);
+				if (!result.is_successfull) return(result);
+			}
+
+			pStaging = &slot.staging;
+			frame.frameIndex = slot.frameIndex;
+			frame.width = slot.width;
+			frame.height = slot.height;
+			return(FunctionResult(true, RESULT::SSUCCESS, "Frame ready to be read back."));
+		}
+
+		/** Hands the slot returned by acquire() back to the ring. */
+		void release() {
+			mSlots[mOldestSlot].pending = false;
+			--mPendingCount;
+			mOldestSlot = (mOldestSlot + 1) % mSlots.size();
+		}
+
+		/** Forgets every unread frame. The caller must have waited for the copies to complete. */
+		void clear() {
+			for (Slot& slot : mSlots)
+				slot.pending = false;
+			mNextSlot = 0;
+			mOldestSlot = 0;
+			mPendingCount = 0;
+			mCopying = false;
+		}
+
+		Slot& slot(std::size_t index) { return mSlots[index]; }
+		std::size_t slotCount() const { return mSlots.size(); }
+		std::size_t pendingCount() const { return mPendingCount; }
+		std::uint64_t droppedFrames() const { return mDroppedFrames; }
+	};
+}
@@ -0,0 +1,436 @@
+/***********************************************************************************************************
+ * @file RenderGraph.cpp
+ *
+ * @brief Implements functions of the RenderGraph class found in RenderGraph.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "RenderGraph.h"
+
+#include <algorithm>
+
+
+/** Adds a resource that lives outside the graph, such as the back buffer.
+ *
+ * @details
+ * Imported resources keep their contents across frames, so passes writing them are never culled.
+ * Once the last pass has run the resource is transitioned into its final state.
+ *
+ * @param[in] name: Name used in diagnostics.
+ * @param[in] id: Backend resource the graph resource stands for.
+ * @param[in] initialState: State the resource is in when the frame starts.
+ * @param[in] finalState: State the resource must be left in when the frame ends.
+ *
+ * @retval Handle of the resource within the graph.
+ */
+SyrenEngine::RenderGraphResource SyrenEngine::RenderGraph::importResource(const char* name, ResourceId id, ResourceState initialState, ResourceState finalState) {
+	Resource resource;
+	resource.name = name;
+	resource.id = id;
+	resource.initialState = initialState;
+	resource.finalState = finalState;
+	resource.imported = true;
+
+	mResources.push_back(std::move(resource));
+	return static_cast<RenderGraphResource>(mResources.size() - 1);
+}
+
+/** Adds a resource whose contents only live for the duration of the frame.
+ *
+ * @details
+ * The contents are undefined before the first pass that touches the resource and discarded after the
+ * last one. The resource is left in the state of its last use, which the backend passes back in as the
+ * initial state when it reuses the resource in a later frame.
+ *
+ * @param[in] name: Name used in diagnostics.
+ * @param[in] id: Backend resource id the passes refer to the resource by.
+ * @param[in] desc: Size and format of the resource.
+ * @param[in] initialState: State the backend resource is in, or will be created in.
+ *
+ * @retval Handle of the resource within the graph.
+ */
+SyrenEngine::RenderGraphResource SyrenEngine::RenderGraph::createTransient(const char* name, ResourceId id, const RenderGraphTextureDesc& desc, ResourceState initialState) {
+	Resource resource;
+	resource.name = name;
+	resource.id = id;
+	resource.desc = desc;
+	resource.initialState = initialState;
+	resource.finalState = initialState;
+
+	mResources.push_back(std::move(resource));
+	return static_cast<RenderGraphResource>(mResources.size() - 1);
+}
+
+/** Places transient resources into shared heaps with the given planner on every compile.
+ *
+ * @param[in] planner: Planner laying out the heaps, or nullptr to leave transients unplaced.
+ */
+void SyrenEngine::RenderGraph::setAliasingPlanner(AliasingPlanner* planner) {
+	mPlanner = planner;
+}
+
+/** Destructor for the RenderGraph class. Destroys the callbacks of the passes still declared. */
+SyrenEngine::RenderGraph::~RenderGraph() {
+	destroyCallbacks();
+}
+
+/** Appends a pass without a callback, with its lists drawing from the arena. */
+SyrenEngine::RenderGraph::Pass& SyrenEngine::RenderGraph::addPass(const char* name) {
+	mPasses.emplace_back(name, &mArena);
+	return mPasses.back();
+}
+
+void SyrenEngine::RenderGraph::read(RenderGraphPass pass, RenderGraphResource resource, ResourceState state) {
+	addAccess(pass, resource, state, false);
+}
+
+void SyrenEngine::RenderGraph::write(RenderGraphPass pass, RenderGraphResource resource, ResourceState state) {
+	addAccess(pass, resource, state, true);
+}
+
+/** Keeps a pass alive even though nothing in the graph reads its results, e.g. a readback copy. */
+void SyrenEngine::RenderGraph::setSideEffect(RenderGraphPass pass) {
+	mPasses[pass].sideEffect = true;
+}
+
+/** Culls, orders and derives the barriers of the declared passes.
+ *
+ * @retval FunctionResult indicating whether the declarations were consistent.
+ */
+SyrenEngine::FunctionResult SyrenEngine::RenderGraph::compile() {
+	mOrder.clear();
+	mSteps.clear();
+	mBarriers.clear();
+	mSplitBarrierCount = 0;
+
+	FunctionResult result = validate();
+	if (!result.is_successfull) return(result);
+
+	buildDependencies();
+	cullPasses();
+	schedulePasses();
+	buildBarriers();
+
+	result = placeTransients();
+	if (!result.is_successfull) return(result);
+
+	flattenBatches();
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Compiled the render graph."));
+}
+
+/** Removes every pass and resource while keeping the allocated memory for the next frame. */
+void SyrenEngine::RenderGraph::reset() {
+	destroyCallbacks();
+	mPasses.clear();
+	mResources.clear();
+	mOrder.clear();
+	mSteps.clear();
+	mBarriers.clear();
+	mSplitBarrierCount = 0;
+	mArena.reset();
+}
+
+void SyrenEngine::RenderGraph::destroyCallbacks() {
+	for (Pass& pass : mPasses) {
+		if (pass.destroy) pass.destroy(pass.record);
+		pass.destroy = nullptr;
+		pass.invoke = nullptr;
+	}
+}
+
+/** Records an access, merging it with an earlier access of the same pass in the same state. */
+void SyrenEngine::RenderGraph::addAccess(RenderGraphPass pass, RenderGraphResource resource, ResourceState state, bool write) {
+	ArenaVector<Access>& accesses = mPasses[pass].accesses;
+
+	for (Access& access : accesses) {
+		if (access.resource == resource && access.state == state) {
+			access.write = access.write || write;
+			return;
+		}
+	}
+
+	accesses.push_back({ resource, state, write });
+}
+
+/** Checks that every access names a resource of the graph and that no pass needs a resource in two states. */
+SyrenEngine::FunctionResult SyrenEngine::RenderGraph::validate() const {
+	for (const Pass& pass : mPasses) {
+		for (std::size_t i = 0; i < pass.accesses.size(); ++i) {
+			if (pass.accesses[i].resource >= mResources.size())
+				return(FunctionResult(false, RESULT::FAIL, std::string("Render pass ") + pass.name + " uses a resource that is not part of the graph."));
+
+			for (std::size_t j = i + 1; j < pass.accesses.size(); ++j) {
+				if (pass.accesses[i].resource == pass.accesses[j].resource)
+					return(FunctionResult(false, RESULT::FAIL, std::string("Render pass ") + pass.name + " uses " + mResources[pass.accesses[i].resource].name + " in two states."));
+			}
+		}
+	}
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Render graph is consistent."));
+}
+
+/** Derives the dependencies between passes from the declaration order of their accesses.
+ *
+ * @details
+ * A pass depends on the last earlier writer of every resource it touches, and a writer also depends on
+ * the readers since that write. Only the former carry data, so only they are recorded as producers.
+ */
+void SyrenEngine::RenderGraph::buildDependencies() {
+	const ArenaAllocator<RenderGraphPass> allocator(&mArena);
+	ArenaVector<RenderGraphPass> lastWriter(mResources.size(), RenderGraphNone, allocator);
+	ArenaVector<ArenaVector<RenderGraphPass> > readers(mResources.size(), ArenaVector<RenderGraphPass>(allocator), allocator);
+
+	auto addDependency = [](ArenaVector<RenderGraphPass>& list, RenderGraphPass pass) {
+		if (std::find(list.begin(), list.end(), pass) == list.end()) list.push_back(pass);
+	};
+
+	for (RenderGraphPass p = 0; p < mPasses.size(); ++p) {
+		Pass& pass = mPasses[p];
+		pass.dependencies.clear();
+		pass.producers.clear();
+		pass.culled = false;
+
+		for (const Access& access : pass.accesses) {
+			RenderGraphPass writer = lastWriter[access.resource];
+			if (writer != RenderGraphNone) {
+				addDependency(pass.dependencies, writer);
+				addDependency(pass.producers, writer);
+			}
+
+			if (access.write) {
+				for (RenderGraphPass reader : readers[access.resource])
+					addDependency(pass.dependencies, reader);
+
+				lastWriter[access.resource] = p;
+				readers[access.resource].clear();
+			}
+			else {
+				readers[access.resource].push_back(p);
+			}
+		}
+	}
+}
+
+/** Marks every pass that does not contribute to an imported resource or a side effect as culled. */
+void SyrenEngine::RenderGraph::cullPasses() {
+	ArenaVector<RenderGraphPass> live{ ArenaAllocator<RenderGraphPass>(&mArena) };
+
+	for (RenderGraphPass p = 0; p < mPasses.size(); ++p) {
+		Pass& pass = mPasses[p];
+		bool root = pass.sideEffect;
+
+		for (const Access& access : pass.accesses)
+			root = root || (access.write && mResources[access.resource].imported);
+
+		pass.culled = !root;
+		if (root) live.push_back(p);
+	}
+
+	while (!live.empty()) {
+		RenderGraphPass p = live.back();
+		live.pop_back();
+
+		for (RenderGraphPass producer : mPasses[p].producers) {
+			if (!mPasses[producer].culled) continue;
+			mPasses[producer].culled = false;
+			live.push_back(producer);
+		}
+	}
+}
+
+/** Orders the live passes so that every pass runs after its dependencies.
+ *
+ * @details
+ * Among the passes that are ready, the first declared one that does not consume the results of the
+ * pass scheduled just before it is preferred. Interleaving independent work this way leaves room
+ * between a producer and its consumer for split barriers.
+ */
+void SyrenEngine::RenderGraph::schedulePasses() {
+	const ArenaAllocator<RenderGraphPass> allocator(&mArena);
+	ArenaVector<std::uint32_t> waiting(mPasses.size(), 0, allocator);
+	ArenaVector<ArenaVector<RenderGraphPass> > dependents(mPasses.size(), ArenaVector<RenderGraphPass>(allocator), allocator);
+	ArenaVector<RenderGraphPass> ready(allocator);
+
+	for (RenderGraphPass p = 0; p < mPasses.size(); ++p) {
+		if (mPasses[p].culled) continue;
+
+		for (RenderGraphPass dependency : mPasses[p].dependencies) {
+			if (mPasses[dependency].culled) continue;
+			dependents[dependency].push_back(p);
+			++waiting[p];
+		}
+
+		if (waiting[p] == 0) ready.push_back(p);
+	}
+
+	RenderGraphPass previous = RenderGraphNone;
+	while (!ready.empty()) {
+		std::sort(ready.begin(), ready.end());
+
+		std::size_t pick = 0;
+		for (std::size_t i = 0; i < ready.size(); ++i) {
+			const ArenaVector<RenderGraphPass>& producers = mPasses[ready[i]].producers;
+			if (std::find(producers.begin(), producers.end(), previous) == producers.end()) {
+				pick = i;
+				break;
+			}
+		}
+
+		previous = ready[pick];
+		ready.erase(ready.begin() + pick);
+		mOrder.push_back(previous);
+
+		for (RenderGraphPass dependent : dependents[previous]) {
+			if (--waiting[dependent] == 0) ready.push_back(dependent);
+		}
+	}
+}
+
+/** Walks the ordered passes, tracking the state of every resource, and emits the barriers between them.
+ *
+ * @details
+ * Step i runs the i-th ordered pass. A final step without a pass returns imported resources to their
+ * final states. Barriers are gathered per step so each step issues a single batch.
+ */
+void SyrenEngine::RenderGraph::buildBarriers() {
+	const std::uint32_t finalStep = static_cast<std::uint32_t>(mOrder.size());
+
+	mBatches.resize(std::max<std::size_t>(mBatches.size(), mOrder.size() + 1));
+	for (std::uint32_t i = 0; i <= finalStep; ++i)
+		mBatches[i].clear();
+
+	ArenaVector<ResourceState> state(mResources.size(), ResourceState::COMMON, ArenaAllocator<ResourceState>(&mArena));
+	ArenaVector<bool> lastWasWrite(mResources.size(), false, ArenaAllocator<bool>(&mArena));
+
+	for (RenderGraphResource r = 0; r < mResources.size(); ++r) {
+		mResources[r].firstStep = RenderGraphNone;
+		mResources[r].lastStep = RenderGraphNone;
+		state[r] = mResources[r].initialState;
+	}
+
+	for (std::uint32_t step = 0; step < finalStep; ++step) {
+		for (const Access& access : mPasses[mOrder[step]].accesses) {
+			Resource& resource = mResources[access.resource];
+
+			if (resource.firstStep == RenderGraphNone && !resource.imported) {
+				if (state[access.resource] != access.state)
+					mBatches[step].push_back({ access.resource, state[access.resource], access.state, RenderGraphBarrierType::TRANSITION });
+			}
+			else if (state[access.resource] != access.state) {
+				transition(access.resource, state[access.resource], access.state, resource.lastStep, step);
+			}
+			else if (resource.lastStep != RenderGraphNone && (access.write || lastWasWrite[access.resource]) && access.state == ResourceState::UNORDERED_ACCESS) {
+				// Any unordered access next to a write has to wait for the earlier pass, a read before a write included
+				mBatches[step].push_back({ access.resource, access.state, access.state, RenderGraphBarrierType::UAV });
+			}
+
+			if (resource.firstStep == RenderGraphNone) resource.firstStep = step;
+			resource.lastStep = step;
+			state[access.resource] = access.state;
+			lastWasWrite[access.resource] = access.write;
+		}
+	}
+
+	for (RenderGraphResource r = 0; r < mResources.size(); ++r) {
+		if (!mResources[r].imported)
+			mResources[r].finalState = state[r];
+		else if (state[r] != mResources[r].finalState)
+			transition(r, state[r], mResources[r].finalState, mResources[r].lastStep, finalStep);
+	}
+}
+
+/** Lays out the used transient resources with the aliasing planner and adds the aliasing barriers.
+ *
+ * @details
+ * The aliasing barrier goes to the front of the batch of the first use, ahead of the transition of the
+ * resource into the state of that use.
+ */
+SyrenEngine::FunctionResult SyrenEngine::RenderGraph::placeTransients() {
+	if (mPlanner == nullptr) return(FunctionResult(true, RESULT::SSUCCESS, "No aliasing planner attached."));
+
+	mPlannedResources.clear();
+	mAliasingRequests.clear();
+
+	for (RenderGraphResource r = 0; r < mResources.size(); ++r) {
+		Resource& resource = mResources[r];
+		resource.heap = RenderGraphNone;
+		resource.heapOffset = 0;
+		if (resource.imported || resource.firstStep == RenderGraphNone) continue;
+
+		if (resource.desc.size == 0)
+			return(FunctionResult(false, RESULT::FAIL, std::string("Transient resource ") + resource.name + " has no memory size."));
+
+		mPlannedResources.push_back(r);
+		mAliasingRequests.push_back({ resource.desc.size, resource.desc.alignment, resource.firstStep, resource.lastStep });
+	}
+
+	FunctionResult result = mPlanner->plan(mAliasingRequests, mPlacements);
+	if (!result.is_successfull) return(result);
+
+	for (std::size_t i = 0; i < mPlannedResources.size(); ++i) {
+		Resource& resource = mResources[mPlannedResources[i]];
+		resource.heap = mPlacements[i].heap;
+		resource.heapOffset = mPlacements[i].offset;
+
+		const std::uint32_t aliases = mPlacements[i].aliases;
+		if (aliases == AliasingNone) continue;
+
+		RenderGraphBarrier barrier = { mPlannedResources[i], ResourceState::COMMON, ResourceState::COMMON, RenderGraphBarrierType::ALIASING };
+		barrier.previous = aliases == AliasingMany ? RenderGraphNone : mPlannedResources[aliases];
+
+		std::vector<RenderGraphBarrier>& batch = mBatches[resource.firstStep];
+		batch.insert(batch.begin(), barrier);
+	}
+
+	return(result);
+}
+
+/** Copies the per-step batches into the compiled step list. */
+void SyrenEngine::RenderGraph::flattenBatches() {
+	const std::uint32_t finalStep = static_cast<std::uint32_t>(mOrder.size());
+
+	for (std::uint32_t step = 0; step <= finalStep; ++step) {
+		const std::vector<RenderGraphBarrier>& batch = mBatches[step];
+		if (step == finalStep && batch.empty()) break;
+
+		RenderGraphStep compiled;
+		compiled.pass = step < finalStep ? mOrder[step] : RenderGraphNone;
+		compiled.firstBarrier = static_cast<std::uint32_t>(mBarriers.size());
+		compiled.barrierCount = static_cast<std::uint32_t>(batch.size());
+
+		mBarriers.insert(mBarriers.end(), batch.begin(), batch.end());
+		mSteps.push_back(compiled);
+	}
+}
+
+/** Emits a transition between the last use of a resource and its next use.
+ *
+ * @details
+ * If passes run in between, the transition is split: it begins in the batch right after the last use
+ * and ends in the batch of the next use.
+ *
+ * @param[in] resource: Resource to transition.
+ * @param[in] before: State of the last use.
+ * @param[in] after: State of the next use.
+ * @param[in] lastStep: Step of the last use, or RenderGraphNone if the resource was not used yet.
+ * @param[in] step: Step of the next use.
+ */
+void SyrenEngine::RenderGraph::transition(RenderGraphResource resource, ResourceState before, ResourceState after, std::uint32_t lastStep, std::uint32_t step) {
+	const std::uint32_t beginStep = lastStep == RenderGraphNone ? 0 : lastStep + 1;
+
+	if (beginStep < step) {
+		mBatches[beginStep].push_back({ resource, before, after, RenderGraphBarrierType::BEGIN_ONLY });
+		mBatches[step].push_back({ resource, before, after, RenderGraphBarrierType::END_ONLY });
+		++mSplitBarrierCount;
+	}
+	else {
+		mBatches[step].push_back({ resource, before, after, RenderGraphBarrierType::TRANSITION });
+	}
+}
@@ -0,0 +1,231 @@
+/***********************************************************************************************************
+ * @file RenderGraph.h
+ *
+ * @brief Declares the frame graph that orders render passes and derives their resource barriers
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * A frame is described as passes that declare which resources they read and write and in which state.
+ * compile() turns the declarations into a list of steps: each step is one batch of barriers followed
+ * by one pass. Passes whose results never reach an imported resource or a pass with side effects are
+ * culled. Independent passes are scheduled apart from the passes that consume their results, and a
+ * transition that spans other passes is split into a begin and an end barrier, so the GPU can resolve
+ * it while the passes in between run.
+ *
+ * Transient resources only live between their first and last use. Their transitions are never split
+ * across other passes, as the memory may belong to another transient until the first use. With an
+ * AliasingPlanner attached, transients with disjoint lifetimes share memory, and an aliasing barrier is
+ * issued before the first use of a transient that takes memory over from another one. That first use
+ * must initialise the resource, e.g. by clearing it.
+ *
+ * The graph is backend neutral. Backends walk the compiled steps with execute() and translate each
+ * barrier batch into a single API call.
+ *
+ * Everything that only lives for one frame, the pass callbacks, the access lists and the scratch data
+ * of compile(), is allocated from a FrameArena that reset() rewinds, so rebuilding the graph every
+ * frame does not touch the general heap. Names are not copied and must outlive the frame.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+#include "AliasingPlanner.h"
+#include "CommandStream.h"
+#include "FrameArena.h"
+
+
+namespace SyrenEngine {
+	typedef std::uint32_t RenderGraphResource;
+	typedef std::uint32_t RenderGraphPass;
+
+	static const std::uint32_t RenderGraphNone = 0xFFFFFFFFu;
+
+	enum class RenderGraphBarrierType : unsigned char {
+		TRANSITION, /*!< Complete transition issued right before the pass that needs it */
+		BEGIN_ONLY, /*!< First half of a split transition, issued right after the last use in the old state */
+		END_ONLY,   /*!< Second half of a split transition, issued right before the first use in the new state */
+		UAV,        /*!< Orders unordered accesses of two passes when either of them writes */
+		ALIASING    /*!< Hands memory over from the previous transient placed there */
+	};
+
+	struct RenderGraphBarrier {
+		RenderGraphResource resource;
+		ResourceState before;
+		ResourceState after;
+		RenderGraphBarrierType type;
+		RenderGraphResource previous = RenderGraphNone; /*!< Aliasing barriers only, RenderGraphNone if several transients used the memory */
+	};
+
+	/** Size and format of a resource owned by the graph. Format and flags are backend values. */
+	struct RenderGraphTextureDesc {
+		std::uint32_t width = 0;
+		std::uint32_t height = 0;
+		std::uint32_t format = 0;
+		std::uint32_t sampleCount = 1;
+		std::uint32_t flags = 0;
+		std::uint64_t size = 0;      /*!< Memory the resource needs, required for aliasing */
+		std::uint64_t alignment = 0; /*!< Placement alignment of that memory */
+	};
+
+	/** A batch of barriers and the pass that runs after it. The last step may have no pass. */
+	struct RenderGraphStep {
+		RenderGraphPass pass;
+		std::uint32_t firstBarrier;
+		std::uint32_t barrierCount;
+	};
+
+	class RenderGraph {
+	private:
+		struct Access {
+			RenderGraphResource resource;
+			ResourceState state;
+			bool write;
+		};
+
+		struct Pass {
+			const char* name;
+			void* record = nullptr;              /*!< Callback placed in the arena */
+			void (*invoke)(void*) = nullptr;
+			void (*destroy)(void*) = nullptr;
+			ArenaVector<Access> accesses;
+			ArenaVector<RenderGraphPass> dependencies; /*!< Passes that must run before this one */
+			ArenaVector<RenderGraphPass> producers;    /*!< Passes whose writes this one reads or extends */
+			bool sideEffect = false;
+			bool culled = false;
+
+			Pass(const char* pName, FrameArena* pArena)
+				: name(pName), accesses(ArenaAllocator<Access>(pArena)), dependencies(ArenaAllocator<RenderGraphPass>(pArena)), producers(ArenaAllocator<RenderGraphPass>(pArena)) {};
+		};
+
+		struct Resource {
+			const char* name = nullptr;
+			ResourceId id = NullResource;
+			RenderGraphTextureDesc desc;
+			ResourceState initialState = ResourceState::COMMON;
+			ResourceState finalState = ResourceState::COMMON; /*!< For transients, the state of the last use once compiled */
+			bool imported = false;
+			std::uint32_t firstStep = RenderGraphNone; /*!< First step using the resource once compiled */
+			std::uint32_t lastStep = RenderGraphNone;  /*!< Last step using the resource once compiled */
+			std::uint32_t heap = RenderGraphNone;      /*!< Transient heap the resource is placed in */
+			std::uint64_t heapOffset = 0;
+		};
+
+		FrameArena mArena;
+		std::vector<Pass> mPasses;
+		std::vector<Resource> mResources;
+
+		std::vector<RenderGraphPass> mOrder;
+		std::vector<RenderGraphStep> mSteps;
+		std::vector<RenderGraphBarrier> mBarriers;
+		std::vector<std::vector<RenderGraphBarrier> > mBatches; /*!< Barriers of each step while compiling */
+
+		AliasingPlanner* mPlanner = nullptr;
+		std::vector<RenderGraphResource> mPlannedResources;
+		std::vector<AliasingRequest> mAliasingRequests;
+		std::vector<AliasingPlacement> mPlacements;
+
+		std::uint32_t mSplitBarrierCount = 0;
+
+	public:
+		RenderGraph() = default;
+		~RenderGraph();
+
+		RenderGraphResource importResource(const char* name, ResourceId id, ResourceState initialState, ResourceState finalState);
+		RenderGraphResource createTransient(const char* name, ResourceId id, const RenderGraphTextureDesc& desc, ResourceState initialState);
+		void setAliasingPlanner(AliasingPlanner* planner);
+
+		/** Adds a pass to the graph.
+		 *
+		 * @param[in] name: Name used in diagnostics.
+		 * @param[in] record: Callable run when the pass executes, after the barriers it needs have been
+		 *                    issued. It is moved into the arena and destroyed by reset().
+		 *
+		 * @retval Handle of the pass within the graph.
+		 */
+		template<typename Record>
+		RenderGraphPass addPass(const char* name, Record&& record) {
+			typedef typename std::decay<Record>::type Callback;
+
+			Pass& pass = addPass(name);
+			pass.record = new (mArena.allocate(sizeof(Callback), alignof(Callback))) Callback(std::forward<Record>(record));
+			pass.invoke = [](void* callback) { (*static_cast<Callback*>(callback))(); };
+			pass.destroy = [](void* callback) { static_cast<Callback*>(callback)->~Callback(); };
+			return static_cast<RenderGraphPass>(mPasses.size() - 1);
+		}
+
+		void read(RenderGraphPass pass, RenderGraphResource resource, ResourceState state);
+		void write(RenderGraphPass pass, RenderGraphResource resource, ResourceState state);
+		void setSideEffect(RenderGraphPass pass);
+
+		FunctionResult compile();
+		void reset();
+
+		/** Runs the compiled steps through a backend executor.
+		 *
+		 * @details
+		 * The executor provides barriers(const RenderGraphBarrier*, std::uint32_t), called once for every
+		 * non-empty batch. Pass callbacks are invoked in between.
+		 *
+		 * @param[in] executor: Backend object translating barrier batches into API calls.
+		 */
+		template<typename Executor>
+		void execute(Executor& executor) const {
+			for (const RenderGraphStep& step : mSteps) {
+				if (step.barrierCount > 0) executor.barriers(&mBarriers[step.firstBarrier], step.barrierCount);
+				if (step.pass != RenderGraphNone && mPasses[step.pass].invoke) mPasses[step.pass].invoke(mPasses[step.pass].record);
+			}
+		}
+
+		const std::vector<RenderGraphPass>& passOrder() const { return mOrder; }
+		const std::vector<RenderGraphStep>& steps() const { return mSteps; }
+		const RenderGraphBarrier* barriers(const RenderGraphStep& step) const { return mBarriers.data() + step.firstBarrier; }
+
+		std::size_t passCount() const { return mPasses.size(); }
+		std::size_t resourceCount() const { return mResources.size(); }
+		std::size_t barrierCount() const { return mBarriers.size(); }
+		std::uint32_t splitBarrierCount() const { return mSplitBarrierCount; }
+
+		const char* passName(RenderGraphPass pass) const { return mPasses[pass].name; }
+		bool isCulled(RenderGraphPass pass) const { return mPasses[pass].culled; }
+
+		const char* resourceName(RenderGraphResource resource) const { return mResources[resource].name; }
+		ResourceId resourceId(RenderGraphResource resource) const { return mResources[resource].id; }
+		const RenderGraphTextureDesc& resourceDesc(RenderGraphResource resource) const { return mResources[resource].desc; }
+		bool isImported(RenderGraphResource resource) const { return mResources[resource].imported; }
+		ResourceState initialState(RenderGraphResource resource) const { return mResources[resource].initialState; }
+		ResourceState finalState(RenderGraphResource resource) const { return mResources[resource].finalState; }
+		std::uint32_t firstStep(RenderGraphResource resource) const { return mResources[resource].firstStep; }
+		std::uint32_t lastStep(RenderGraphResource resource) const { return mResources[resource].lastStep; }
+		std::uint32_t heap(RenderGraphResource resource) const { return mResources[resource].heap; }
+		std::uint64_t heapOffset(RenderGraphResource resource) const { return mResources[resource].heapOffset; }
+	private:
+		RenderGraph(const RenderGraph& rhs) = delete;
+		RenderGraph& operator=(const RenderGraph& rhs) = delete;
+
+		Pass& addPass(const char* name);
+		void destroyCallbacks();
+		void addAccess(RenderGraphPass pass, RenderGraphResource resource, ResourceState state, bool write);
+
+		FunctionResult validate() const;
+		void buildDependencies();
+		void cullPasses();
+		void schedulePasses();
+		void buildBarriers();
+		FunctionResult placeTransients();
+		void flattenBatches();
+		void transition(RenderGraphResource resource, ResourceState before, ResourceState after, std::uint32_t lastStep, std::uint32_t step);
+	};
+}
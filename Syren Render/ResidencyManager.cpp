@@ -0,0 +1,244 @@
+/***********************************************************************************************************
+ * @file ResidencyManager.cpp
+ *
+ * @brief Implements functions of the ResidencyManager class found in ResidencyManager.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "ResidencyManager.h"
+
+
+/** Prepares the manager for tracking.
+ *
+ * @param[in] pSource: Backend that queries the budget and pages objects in and out.
+ * @param[in] pTimeline: Timeline of the queue the tracked objects are used on.
+ * @param[in] pHeadroom: Share of the budget kept free, between 0 and 1.
+ */
+SyrenEngine::FunctionResult SyrenEngine::ResidencyManager::initialise(ResidencySource* pSource, Timeline* pTimeline, float pHeadroom) {
+	if (pSource == nullptr || pTimeline == nullptr) return(FunctionResult(false, RESULT::FAIL, "Residency manager requires a source and a timeline."));
+	if (pHeadroom < 0.0f || pHeadroom >= 1.0f) return(FunctionResult(false, RESULT::FAIL, "Residency headroom must be in [0, 1)."));
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mSource = pSource;
+	mTimeline = pTimeline;
+	mHeadroom = pHeadroom;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the residency manager."));
+}
+
+/** Starts tracking an object. Objects are resident when they are created.
+ *
+ * @param[in] object: Backend object that can be paged in and out.
+ * @param[in] size: Video memory the object occupies.
+ * @param[out] handle: Handle the frames use the object through.
+ */
+SyrenEngine::FunctionResult SyrenEngine::ResidencyManager::track(void* object, std::uint64_t size, ResidencyHandle& handle) {
+	if (object == nullptr) return(FunctionResult(false, RESULT::FAIL, "Cannot track a null object."));
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	handle = mObjects.create();
+
+	ResidencyObject& entry = *mObjects.get(handle);
+	entry.object = object;
+	entry.size = size;
+	entry.lastUse = mTimeline->lastSignaledValue() + 1;
+	link(handle, entry);
+
+	++mStatistics.trackedCount;
+	++mStatistics.residentCount;
+	mStatistics.residentSize += size;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Tracking the object for residency."));
+}
+
+/** Stops tracking an object and invalidates the handle. The object itself is not touched. */
+void SyrenEngine::ResidencyManager::untrack(ResidencyHandle& handle) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	ResidencyObject* entry = mObjects.get(handle);
+	if (entry == nullptr) return;
+
+	if (entry->resident) {
+		unlink(*entry);
+		--mStatistics.residentCount;
+		mStatistics.residentSize -= entry->size;
+	}
+	else mStatistics.evictedSize -= entry->size;
+	--mStatistics.trackedCount;
+
+	// A pending request turns stale with the handle and is skipped by update()
+	mObjects.destroy(handle);
+}
+
+/** Marks an object as used by the frame being recorded. */
+void SyrenEngine::ResidencyManager::use(ResidencyHandle handle) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	useLocked(handle, mTimeline->lastSignaledValue() + 1);
+}
+
+/** Marks a set of objects as used by the frame being recorded, taking the lock once. */
+void SyrenEngine::ResidencyManager::use(const ResidencyHandle* handles, std::size_t count) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	const std::uint64_t frameValue = mTimeline->lastSignaledValue() + 1;
+	for (std::size_t i = 0; i < count; ++i)
+		useLocked(handles[i], frameValue);
+}
+
+/** Evicts and restores objects for the frame being recorded. Called once per frame before it is submitted.
+ *
+ * @details
+ * The objects the frame needs are counted against the budget before they are paged in, so the
+ * eviction makes room for them in the same batch.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if the frame stays over budget.
+ */
+SyrenEngine::FunctionResult SyrenEngine::ResidencyManager::update() {
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	ResidencyBudget budget;
+	FunctionResult result = mSource->queryBudget(budget);
+	if (!result.is_successfull) return(result);
+
+	mStatistics.budget = budget.budget;
+	mStatistics.usage = budget.usage;
+
+	std::uint64_t required = 0;
+	for (ResidencyHandle handle : mRequests) {
+		if (const ResidencyObject* entry = mObjects.get(handle)) required += entry->size;
+	}
+
+	const std::uint64_t limit = budget.budget - static_cast<std::uint64_t>(static_cast<double>(budget.budget) * mHeadroom);
+	const std::uint64_t projected = budget.usage + required;
+	bool overBudget = false;
+
+	if (projected > limit) {
+		std::uint64_t evicted = 0;
+		result = evictLocked(projected - limit, evicted);
+		if (!result.is_successfull) return(result);
+
+		overBudget = evicted < projected - limit;
+		if (overBudget) ++mStatistics.overBudgetFrames;
+	}
+
+	mBatch.clear();
+	for (ResidencyHandle handle : mRequests) {
+		if (const ResidencyObject* entry = mObjects.get(handle)) mBatch.push_back(entry->object);
+	}
+
+	if (!mBatch.empty()) {
+		result = mSource->makeResident(mBatch.data(), static_cast<std::uint32_t>(mBatch.size()));
+		if (!result.is_successfull) return(result);
+
+		for (ResidencyHandle handle : mRequests) {
+			ResidencyObject* entry = mObjects.get(handle);
+			if (entry == nullptr) continue;
+
+			entry->requested = false;
+			entry->resident = true;
+			link(handle, *entry);
+
+			++mStatistics.residentCount;
+			mStatistics.residentSize += entry->size;
+			mStatistics.evictedSize -= entry->size;
+		}
+		mStatistics.makeResidentCount += mBatch.size();
+	}
+	mRequests.clear();
+
+	if (overBudget) return(FunctionResult(true, RESULT::WSUCCESS, "Every evictable object has been evicted and the frame is still over budget."));
+	return(FunctionResult(true, RESULT::SSUCCESS, "Residency updated."));
+}
+
+bool SyrenEngine::ResidencyManager::isResident(ResidencyHandle handle) const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	const ResidencyObject* entry = mObjects.get(handle);
+	return(entry != nullptr && entry->resident);
+}
+
+SyrenEngine::ResidencyStatistics SyrenEngine::ResidencyManager::statistics() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mStatistics;
+}
+
+void SyrenEngine::ResidencyManager::useLocked(ResidencyHandle handle, std::uint64_t frameValue) {
+	ResidencyObject* entry = mObjects.get(handle);
+	if (entry == nullptr) return;
+
+	entry->lastUse = frameValue;
+
+	if (entry->resident) {
+		if (mNewest == handle) return;
+		unlink(*entry);
+		link(handle, *entry);
+	}
+	else if (!entry->requested) {
+		entry->requested = true;
+		mRequests.push_back(handle);
+	}
+}
+
+/** Evicts the least recently used objects until enough memory has been freed.
+ *
+ * @details
+ * The list is ordered by last use, so the walk stops at the first object a frame in flight may still
+ * use; every object behind it is used by the same or a later frame.
+ *
+ * @param[in] required: Memory that should be freed.
+ * @param[out] evicted: Memory that was freed.
+ */
+SyrenEngine::FunctionResult SyrenEngine::ResidencyManager::evictLocked(std::uint64_t required, std::uint64_t& evicted) {
+	evicted = 0;
+	mBatch.clear();
+
+	ResidencyHandle last = mOldest;
+	for (const ResidencyObject* entry = mObjects.get(mOldest); entry != nullptr && evicted < required; entry = mObjects.get(entry->next)) {
+		if (!mTimeline->isComplete(entry->lastUse)) break;
+
+		mBatch.push_back(entry->object);
+		evicted += entry->size;
+		last = entry->next;
+	}
+	if (mBatch.empty()) return(FunctionResult(true, RESULT::SSUCCESS, "Nothing to evict."));
+
+	FunctionResult result = mSource->evict(mBatch.data(), static_cast<std::uint32_t>(mBatch.size()));
+	if (!result.is_successfull) {
+		evicted = 0;
+		return(result);
+	}
+
+	while (mOldest != last) {
+		ResidencyObject& entry = *mObjects.get(mOldest);
+		unlink(entry);
+		entry.resident = false;
+
+		--mStatistics.residentCount;
+		mStatistics.residentSize -= entry.size;
+		mStatistics.evictedSize += entry.size;
+	}
+	mStatistics.evictionCount += mBatch.size();
+	return(FunctionResult(true, RESULT::SSUCCESS, "Evicted the least recently used objects."));
+}
+
+/** Appends a resident entry to the LRU list as the most recently used one. */
+void SyrenEngine::ResidencyManager::link(ResidencyHandle handle, ResidencyObject& entry) {
+	entry.previous = mNewest;
+	entry.next = ResidencyHandle();
+
+	if (ResidencyObject* newest = mObjects.get(mNewest)) newest->next = handle;
+	else mOldest = handle;
+	mNewest = handle;
+}
+
+void SyrenEngine::ResidencyManager::unlink(ResidencyObject& entry) {
+	if (ResidencyObject* previous = mObjects.get(entry.previous)) previous->next = entry.next;
+	else mOldest = entry.next;
+
+	if (ResidencyObject* next = mObjects.get(entry.next)) next->previous = entry.previous;
+	else mNewest = entry.previous;
+
+	entry.previous = ResidencyHandle();
+	entry.next = ResidencyHandle();
+}
@@ -0,0 +1,129 @@
+/***********************************************************************************************************
+ * @file ResidencyManager.h
+ *
+ * @brief Declares the API independent manager that keeps video memory usage within the OS budget
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Heaps and resources that may be paged out are tracked with their size. Every use by a frame moves
+ * an object to the back of a least-recently-used list and stamps it with the timeline value of that
+ * frame. Once per frame, before the frame is submitted, the manager polls the budget the OS grants the
+ * process and works in one batch: if the objects the frame needs plus the current usage exceed the
+ * budget, the least recently used objects the GPU has finished with are evicted, and then every
+ * evicted object the frame uses is made resident again. Evicting under our own control keeps the OS
+ * from demoting memory at an arbitrary point, which stalls the GPU for hundreds of milliseconds.
+ *
+ * Objects that are in use by submitted frames are never evicted, so the manager may end up over budget
+ * for a frame when everything left is still in flight. It retries on the next frame.
+ *
+ * Tracked objects are owned by a HandlePool, so handles kept past untrack() are ignored instead of
+ * reaching whatever object is tracked next. The manager does not know the backend objects; a
+ * ResidencySource queries the budget and pages them in and out, so the policy runs without a device
+ * against a CpuTimeline. All functions may be called from any thread.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "common.h"
+#include "HandlePool.h"
+#include "Timeline.h"
+
+
+namespace SyrenEngine {
+	/** Bookkeeping of a tracked object. */
+	struct ResidencyObject {
+		void* object = nullptr;                /*!< Backend object */
+		std::uint64_t size = 0;
+		std::uint64_t lastUse = 0;             /*!< Timeline value of the last frame using the object */
+		Handle<ResidencyObject> previous;      /*!< Neighbours in the LRU list while resident */
+		Handle<ResidencyObject> next;
+		bool resident = true;
+		bool requested = false;                /*!< Evicted and used by the frame being recorded */
+	};
+
+	typedef Handle<ResidencyObject> ResidencyHandle;
+
+	static const float DefaultResidencyHeadroom = 0.1f; /*!< Share of the budget kept free for allocations between polls */
+
+	/** Video memory the OS grants the process. */
+	struct ResidencyBudget {
+		std::uint64_t budget = 0;
+		std::uint64_t usage = 0; /*!< Memory the process currently has resident, tracked or not */
+	};
+
+	struct ResidencyStatistics {
+		std::uint32_t trackedCount = 0;
+		std::uint32_t residentCount = 0;
+		std::uint64_t residentSize = 0;
+		std::uint64_t evictedSize = 0;
+		std::uint64_t budget = 0;
+		std::uint64_t usage = 0;
+		std::uint64_t evictionCount = 0;      /*!< Objects evicted since initialisation */
+		std::uint64_t makeResidentCount = 0;  /*!< Objects made resident again since initialisation */
+		std::uint64_t overBudgetFrames = 0;   /*!< Updates that could not get under the budget */
+	};
+
+	/** Queries the budget and pages objects in and out, implemented by each backend. */
+	class ResidencySource {
+	public:
+		virtual ~ResidencySource() = default;
+
+		virtual FunctionResult queryBudget(ResidencyBudget& budget) = 0;
+
+		/** Pages objects back in. Returns once they may be used by submitted work. */
+		virtual FunctionResult makeResident(void* const* objects, std::uint32_t count) = 0;
+
+		/** Pages out objects that no submitted work uses any more. */
+		virtual FunctionResult evict(void* const* objects, std::uint32_t count) = 0;
+	};
+
+	class ResidencyManager {
+	private:
+		ResidencySource* mSource = nullptr;
+		Timeline* mTimeline = nullptr;
+		float mHeadroom = DefaultResidencyHeadroom;
+
+		HandlePool<ResidencyObject> mObjects;
+		ResidencyHandle mOldest; /*!< Least recently used resident object */
+		ResidencyHandle mNewest;
+
+		std::vector<ResidencyHandle> mRequests; /*!< Evicted objects the frame being recorded uses */
+		std::vector<void*> mBatch;
+
+		ResidencyStatistics mStatistics;
+		mutable std::mutex mMutex;
+	public:
+		ResidencyManager() = default;
+
+		FunctionResult initialise(ResidencySource* pSource, Timeline* pTimeline, float pHeadroom = DefaultResidencyHeadroom);
+
+		FunctionResult track(void* object, std::uint64_t size, ResidencyHandle& handle);
+		void untrack(ResidencyHandle& handle);
+
+		void use(ResidencyHandle handle);
+		void use(const ResidencyHandle* handles, std::size_t count);
+		FunctionResult update();
+
+		bool isResident(ResidencyHandle handle) const;
+		ResidencyStatistics statistics() const;
+	private:
+		ResidencyManager(const ResidencyManager& rhs) = delete;
+		ResidencyManager& operator=(const ResidencyManager& rhs) = delete;
+
+		void useLocked(ResidencyHandle handle, std::uint64_t frameValue);
+		FunctionResult evictLocked(std::uint64_t required, std::uint64_t& evicted);
+		void link(ResidencyHandle handle, ResidencyObject& entry);
+		void unlink(ResidencyObject& entry);
+	};
+}
@@ -0,0 +1,145 @@
+/***********************************************************************************************************
+ * @file RootSignatureRegistry.cpp
+ *
+ * @brief Implements functions of the RootSignatureRegistry class found in RootSignatureRegistry.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "RootSignatureRegistry.h"
+
+#include <cstring>
+#include <utility>
+
+
+/** Destructor for the RootSignatureRegistry class. Releases every root signature. */
+SyrenEngine::RootSignatureRegistry::~RootSignatureRegistry() {
+	shutdown();
+}
+
+/** Prepares the registry for requests.
+ *
+ * @param[in] pRelease: Frees a backend root signature on shutdown.
+ */
+SyrenEngine::FunctionResult SyrenEngine::RootSignatureRegistry::initialise(std::function<void(void*)> pRelease) {
+	if (!pRelease) return(FunctionResult(false, RESULT::FAIL, "Root signature registry requires a release function."));
+
+	mRelease = std::move(pRelease);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the root signature registry."));
+}
+
+/** Releases every root signature. No pipeline or command list may use them any more. */
+void SyrenEngine::RootSignatureRegistry::shutdown() {
+	for (std::size_t i = 0; i < mKeys.size(); ++i) {
+		RegisteredRootSignature* rootSignature = mRootSignatures.get(mRootSignatures.handle(i));
+		if (rootSignature->rootSignature != nullptr) mRelease(rootSignature->rootSignature);
+	}
+	mRootSignatures.clear();
+	mKeys.clear();
+
+	mRequestCount = 0;
+	mSharedCount = 0;
+	mBindCount.store(0);
+	mSwitchCount.store(0);
+}
+
+/** Returns the root signature of a layout, creating it if the layout was not registered before.
+ *
+ * @param[in] key: Stable hash of the canonical layout description.
+ * @param[in] description: Canonical layout description the key was hashed from.
+ * @param[in] descriptionSize: Size of the description in bytes.
+ * @param[in] create: Creates the root signature, only called for a new layout.
+ * @param[out] handle: Shared root signature of the layout.
+ *
+ * @retval FunctionResult with RESULT::FAIL if creation failed or a different layout has the same key.
+ */
+SyrenEngine::FunctionResult SyrenEngine::RootSignatureRegistry::acquire(std::uint64_t key, const void* description, std::size_t descriptionSize, const RootSignatureCreateJob& create, RootSignatureHandle& handle) {
+	if (!mRelease) return(FunctionResult(false, RESULT::FAIL, "Root signature registry is not initialised."));
+	++mRequestCount;
+
+	auto existing = mKeys.find(key);
+	if (existing != mKeys.end()) {
+		const std::vector<unsigned char>& registered = mRootSignatures.get(existing->second)->description;
+		if (registered.size() != descriptionSize || (descriptionSize > 0 && std::memcmp(registered.data(), description, descriptionSize) != 0)) {
+			handle = RootSignatureHandle();
+			return(FunctionResult(false, RESULT::FAIL, "A different root signature layout has the same hash."));
+		}
+
+		++mSharedCount;
+		handle = existing->second;
+		return(FunctionResult(true, RESULT::SSUCCESS, "Shared an existing root signature."));
+	}
+
+	void* rootSignature = nullptr;
+	FunctionResult result = create(rootSignature);
+	if (!result.is_successfull || rootSignature == nullptr) {
+		if (rootSignature != nullptr) mRelease(rootSignature);
+		handle = RootSignatureHandle();
+		return(result.is_successfull ? FunctionResult(false, RESULT::FAIL, "Root signature creation returned no object.") : result);
+	}
+
+	RegisteredRootSignature registered;
+	registered.key = key;
+	registered.rootSignature = rootSignature;
+	registered.sortIndex = static_cast<std::uint32_t>(mKeys.size());
+	registered.description.assign(static_cast<const unsigned char*>(description), static_cast<const unsigned char*>(description) + descriptionSize);
+
+	handle = mRootSignatures.create(std::move(registered));
+	mKeys.emplace(key, handle);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Created a new root signature."));
+}
+
+/** Returns the backend root signature, or nullptr for an invalid handle. */
+void* SyrenEngine::RootSignatureRegistry::get(RootSignatureHandle handle) const {
+	const RegisteredRootSignature* rootSignature = mRootSignatures.get(handle);
+	return(rootSignature != nullptr ? rootSignature->rootSignature : nullptr);
+}
+
+/** Returns the hash of the layout, which pipelines created with the root signature are cached under. */
+std::uint64_t SyrenEngine::RootSignatureRegistry::key(RootSignatureHandle handle) const {
+	const RegisteredRootSignature* rootSignature = mRootSignatures.get(handle);
+	return(rootSignature != nullptr ? rootSignature->key : 0);
+}
+
+/** Returns the index draw sort keys group draws by, lower than the number of layouts. */
+std::uint32_t SyrenEngine::RootSignatureRegistry::sortIndex(RootSignatureHandle handle) const {
+	const RegisteredRootSignature* rootSignature = mRootSignatures.get(handle);
+	return(rootSignature != nullptr ? rootSignature->sortIndex : 0);
+}
+
+/** Records a graphics root signature for a command list.
+ *
+ * @retval True if the root signature differs from the one set last and has to be set on the command list.
+ */
+bool SyrenEngine::RootSignatureRegistry::bindGraphics(RootSignatureBinding& binding, RootSignatureHandle handle) {
+	return(bind(binding.graphics, handle));
+}
+
+/** Records a compute root signature for a command list. See bindGraphics(). */
+bool SyrenEngine::RootSignatureRegistry::bindCompute(RootSignatureBinding& binding, RootSignatureHandle handle) {
+	return(bind(binding.compute, handle));
+}
+
+SyrenEngine::RootSignatureStatistics SyrenEngine::RootSignatureRegistry::statistics() const {
+	RootSignatureStatistics statistics;
+	statistics.layoutCount = static_cast<std::uint32_t>(mKeys.size());
+	statistics.requestCount = mRequestCount;
+	statistics.sharedCount = mSharedCount;
+	statistics.bindCount = mBindCount.load(std::memory_order_relaxed);
+	statistics.switchCount = mSwitchCount.load(std::memory_order_relaxed);
+	return(statistics);
+}
+
+bool SyrenEngine::RootSignatureRegistry::bind(RootSignatureHandle& current, RootSignatureHandle handle) {
+	mBindCount.fetch_add(1, std::memory_order_relaxed);
+	if (current == handle) return false;
+
+	current = handle;
+	mSwitchCount.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
@@ -0,0 +1,105 @@
+/***********************************************************************************************************
+ * @file RootSignatureRegistry.h
+ *
+ * @brief Declares the API independent registry that shares one root signature per distinct layout
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Materials that describe the same binding layout separately would each create their own root
+ * signature, which costs driver memory and makes every draw between them a root signature switch. The
+ * registry keys layouts by a stable hash of their canonical description and creates each distinct
+ * layout once; every later request for it gets the same handle. The key doubles as the root signature
+ * hash the pipeline cache expects. The description is kept and compared whenever a key is found, so a
+ * layout whose hash collides with another one fails instead of being handed the wrong root signature.
+ *
+ * Every layout also gets a small sort index in registration order. Draw sort keys put it above the
+ * pipeline, so sorted draws set each root signature once per run of draws. bind() filters out
+ * redundant sets on a command list and counts the switches that remain, which tells how well the sort
+ * worked.
+ *
+ * Root signatures live until shutdown(). Layouts are acquired on the render thread. The lookups and bind()
+ * may run on any thread recording a command list, as long as no layout is acquired at the same time.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+#include "HandlePool.h"
+
+
+namespace SyrenEngine {
+	struct RegisteredRootSignature;
+	typedef Handle<RegisteredRootSignature> RootSignatureHandle;
+
+	/** Creates the backend object of a layout that was not registered before. */
+	typedef std::function<FunctionResult(void*& rootSignature)> RootSignatureCreateJob;
+
+	struct RegisteredRootSignature {
+		std::uint64_t key = 0;                  /*!< Hash of the canonical description */
+		void* rootSignature = nullptr;          /*!< Backend object */
+		std::uint32_t sortIndex = 0;            /*!< Dense index for draw sort keys */
+		std::vector<unsigned char> description; /*!< Canonical description the key was hashed from */
+	};
+
+	/** Root signatures last set on a command list. Each recording command list keeps its own. */
+	struct RootSignatureBinding {
+		RootSignatureHandle graphics;
+		RootSignatureHandle compute;
+	};
+
+	struct RootSignatureStatistics {
+		std::uint32_t layoutCount = 0;     /*!< Distinct root signatures created */
+		std::uint64_t requestCount = 0;
+		std::uint64_t sharedCount = 0;     /*!< Requests answered with an existing root signature */
+		std::uint64_t bindCount = 0;
+		std::uint64_t switchCount = 0;     /*!< Binds that changed the root signature of a command list */
+	};
+
+	class RootSignatureRegistry {
+	private:
+		std::function<void(void*)> mRelease;
+
+		HandlePool<RegisteredRootSignature> mRootSignatures;
+		std::unordered_map<std::uint64_t, RootSignatureHandle> mKeys;
+
+		std::uint64_t mRequestCount = 0;
+		std::uint64_t mSharedCount = 0;
+		std::atomic<std::uint64_t> mBindCount{ 0 };
+		std::atomic<std::uint64_t> mSwitchCount{ 0 };
+	public:
+		RootSignatureRegistry() = default;
+		~RootSignatureRegistry();
+
+		FunctionResult initialise(std::function<void(void*)> pRelease);
+		void shutdown();
+
+		FunctionResult acquire(std::uint64_t key, const void* description, std::size_t descriptionSize, const RootSignatureCreateJob& create, RootSignatureHandle& handle);
+
+		void* get(RootSignatureHandle handle) const;
+		std::uint64_t key(RootSignatureHandle handle) const;
+		std::uint32_t sortIndex(RootSignatureHandle handle) const;
+
+		bool bindGraphics(RootSignatureBinding& binding, RootSignatureHandle handle);
+		bool bindCompute(RootSignatureBinding& binding, RootSignatureHandle handle);
+
+		RootSignatureStatistics statistics() const;
+	private:
+		RootSignatureRegistry(const RootSignatureRegistry& rhs) = delete;
+		RootSignatureRegistry& operator=(const RootSignatureRegistry& rhs) = delete;
+
+		bool bind(RootSignatureHandle& current, RootSignatureHandle handle);
+	};
+}
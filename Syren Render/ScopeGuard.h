@@ -0,0 +1,42 @@
+/***********************************************************************************************************
+ * @file ScopeGuard.h
+ *
+ * @brief Declares a guard that runs a cleanup action when a scope is left early
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Functions that claim several resources before they can fail, such as a frame claiming a command
+ * context and a readback slot, arm a guard that hands them back. Every early return then releases
+ * them, and the function dismisses the guard once it has handed the resources on.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <utility>
+
+
+namespace SyrenEngine {
+	template<typename Action>
+	class ScopeGuard {
+	private:
+		Action mAction;
+		bool mArmed = true;
+
+	public:
+		explicit ScopeGuard(Action pAction) : mAction(std::move(pAction)) {};
+		~ScopeGuard() { if (mArmed) mAction(); }
+
+		/** Keeps the action from running when the scope is left. */
+		void dismiss() { mArmed = false; }
+
+	private:
+		ScopeGuard(const ScopeGuard& rhs) = delete;
+		ScopeGuard& operator=(const ScopeGuard& rhs) = delete;
+	};
+}
@@ -0,0 +1,379 @@
+/***********************************************************************************************************
+ * @file ShaderArchive.cpp
+ *
+ * @brief Implements functions of the ShaderArchive and ShaderArchiveWriter classes found in ShaderArchive.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "ShaderArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "Hash.h"
+
+
+namespace {
+	/** The LZ format is a sequence of a token, literals and a match. The token holds the literal count
+	 * in its high nibble and the match length minus MinMatch in its low nibble; a nibble of 15 is
+	 * continued by bytes that are added up until one is below 255. The match is a 16 bit little endian
+	 * distance back into the output. The last sequence holds literals only.
+	 */
+	const std::size_t MinMatch = 4;
+	const std::size_t MaxDistance = 0xFFFF;
+	const unsigned int HashBits = 13;
+	const std::uint64_t MaxExpansion = 255; /*!< A length byte of 255 is the most output one input byte can describe */
+
+	std::uint32_t read32(const unsigned char* data) {
+		std::uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	void writeLength(std::vector<unsigned char>& out, std::size_t length) {
+		while (length >= 255) {
+			out.push_back(255);
+			length -= 255;
+		}
+		out.push_back(static_cast<unsigned char>(length));
+	}
+
+	void writeSequence(std::vector<unsigned char>& out, const unsigned char* literals, std::size_t literalCount, std::size_t distance, std::size_t matchLength) {
+		const std::size_t matchCode = matchLength > 0 ? matchLength - MinMatch : 0;
+		out.push_back(static_cast<unsigned char>(((literalCount < 15 ? literalCount : 15) << 4) | (matchCode < 15 ? matchCode : 15)));
+		if (literalCount >= 15) writeLength(out, literalCount - 15);
+		out.insert(out.end(), literals, literals + literalCount);
+
+		if (matchLength == 0) return;
+		out.push_back(static_cast<unsigned char>(distance & 0xFF));
+		out.push_back(static_cast<unsigned char>(distance >> 8));
+		if (matchCode >= 15) writeLength(out, matchCode - 15);
+	}
+
+	void compress(const unsigned char* data, std::size_t size, std::vector<unsigned char>& out) {
+		std::vector<std::size_t> table(std::size_t(1) << HashBits, SIZE_MAX);
+		out.clear();
+		out.reserve(size);
+
+		std::size_t anchor = 0;
+		std::size_t position = 0;
+		while (position + MinMatch <= size) {
+			const std::uint32_t sequence = read32(data + position);
+			const std::size_t slot = (sequence * 2654435761u) >> (32 - HashBits);
+			const std::size_t candidate = table[slot];
+			table[slot] = position;
+
+			if (candidate == SIZE_MAX || position - candidate > MaxDistance || read32(data + candidate) != sequence) {
+				++position;
+				continue;
+			}
+
+			std::size_t length = MinMatch;
+			while (position + length < size && data[candidate + length] == data[position + length])
+				++length;
+
+			writeSequence(out, data + anchor, position - anchor, position - candidate, length);
+			position += length;
+			anchor = position;
+		}
+		writeSequence(out, data + anchor, size - anchor, 0, 0);
+	}
+
+	bool readLength(const unsigned char*& in, const unsigned char* end, std::size_t& length) {
+		unsigned char byte;
+		do {
+			if (in == end) return false;
+			byte = *in++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+
+	/** Decodes into a buffer of exactly the uncompressed size, rejecting any input that would leave it. */
+	bool decompress(const unsigned char* in, std::size_t inSize, unsigned char* out, std::size_t outSize) {
+		const unsigned char* end = in + inSize;
+		unsigned char* cursor = out;
+		unsigned char* outEnd = out + outSize;
+
+		while (in < end) {
+			const unsigned char token = *in++;
+
+			std::size_t literalCount = token >> 4;
+			if (literalCount == 15 && !readLength(in, end, literalCount)) return false;
+			if (literalCount > static_cast<std::size_t>(end - in) || literalCount > static_cast<std::size_t>(outEnd - cursor)) return false;
+			std::memcpy(cursor, in, literalCount);
+			in += literalCount;
+			cursor += literalCount;
+
+			if (in == end) break;
+			if (end - in < 2) return false;
+			const std::size_t distance = in[0] | (static_cast<std::size_t>(in[1]) << 8);
+			in += 2;
+			if (distance == 0 || distance > static_cast<std::size_t>(cursor - out)) return false;
+
+			std::size_t length = token & 15;
+			if (length == 15 && !readLength(in, end, length)) return false;
+			length += MinMatch;
+			if (length > static_cast<std::size_t>(outEnd - cursor)) return false;
+
+			// Byte by byte, since a match may overlap the bytes it produces
+			const unsigned char* match = cursor - distance;
+			for (std::size_t i = 0; i < length; ++i)
+				cursor[i] = match[i];
+			cursor += length;
+		}
+		return(cursor == outEnd);
+	}
+}
+
+
+/** Maps an archive and validates its header and tables.
+ *
+ * @param[in] path: Archive written by ShaderArchiveWriter.
+ */
+SyrenEngine::FunctionResult SyrenEngine::ShaderArchive::open(const std::string& path) {
+	static_assert(sizeof(FileHeader) == 32 && sizeof(FileEntry) == 40 && sizeof(FileName) == 16, "The archive layout must not contain padding.");
+	close();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	FunctionResult result = mFile.open(path);
+	if (!result.is_successfull) return(result);
+
+	auto reject = [this](const std::string& message) {
+		mFile.close();
+		return(FunctionResult(false, RESULT::FAIL, message));
+	};
+
+	const std::uint64_t fileSize = mFile.size();
+	if (fileSize < sizeof(FileHeader)) return(reject(path + " is not a shader archive."));
+
+	FileHeader header;
+	std::memcpy(&header, mFile.data(), sizeof(header));
+	if (header.magic != ShaderArchiveMagic) return(reject(path + " is not a shader archive."));
+	if (header.version != ShaderArchiveVersion) return(reject(path + " was packed for another version of the engine."));
+
+	const std::uint64_t entriesEnd = sizeof(FileHeader) + static_cast<std::uint64_t>(header.entryCount) * sizeof(FileEntry);
+	const std::uint64_t namesEnd = header.namesOffset + static_cast<std::uint64_t>(header.nameCount) * sizeof(FileName);
+	if (entriesEnd > fileSize || header.namesOffset != entriesEnd || namesEnd > fileSize) return(reject(path + " is truncated."));
+
+	const FileEntry* entries = reinterpret_cast<const FileEntry*>(mFile.data() + sizeof(FileHeader));
+	for (std::uint32_t i = 0; i < header.entryCount; ++i) {
+		const FileEntry& entry = entries[i];
+		if (i > 0 && entry.key <= entries[i - 1].key) return(reject(path + " has an unsorted index."));
+		if (entry.offset < namesEnd || entry.offset % ShaderArchiveAlignment != 0 || entry.offset > fileSize || entry.storedSize > fileSize - entry.offset)
+			return(reject(path + " has a blob outside the file."));
+		if (entry.compression > static_cast<std::uint32_t>(ShaderCompression::LZ)) return(reject(path + " uses an unknown compression."));
+		if (entry.compression == static_cast<std::uint32_t>(ShaderCompression::NONE) && entry.storedSize != entry.size) return(reject(path + " has a blob of the wrong size."));
+		if (entry.compression == static_cast<std::uint32_t>(ShaderCompression::LZ) && entry.size > entry.storedSize * MaxExpansion) return(reject(path + " has a blob of the wrong size."));
+	}
+
+	const FileName* names = reinterpret_cast<const FileName*>(mFile.data() + header.namesOffset);
+	for (std::uint32_t i = 1; i < header.nameCount; ++i) {
+		if (names[i].nameHash <= names[i - 1].nameHash) return(reject(path + " has an unsorted name table."));
+	}
+
+	mEntries = entries;
+	mEntryCount = header.entryCount;
+	mNames = names;
+	mNameCount = header.nameCount;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Opened the shader archive."));
+}
+
+/** Unmaps the archive. Bytecode handed out before becomes invalid. */
+void SyrenEngine::ShaderArchive::close() {
+	std::lock_guard<std::mutex> lock(mMutex);
+	mEntries = nullptr;
+	mEntryCount = 0;
+	mNames = nullptr;
+	mNameCount = 0;
+	mDecompressed.clear();
+	mFile.close();
+}
+
+/** Looks up the bytecode of a shader. May be called from any thread.
+ *
+ * @param[in] key: Hash of the bytecode.
+ * @param[out] bytecode: Bytecode, valid until the archive is closed.
+ */
+SyrenEngine::FunctionResult SyrenEngine::ShaderArchive::find(ShaderKey key, ShaderBytecode& bytecode) {
+	const FileEntry* entry = findEntry(key);
+	if (entry == nullptr) return(FunctionResult(false, RESULT::FAIL, "The shader is not in the archive."));
+
+	const unsigned char* stored = mFile.data() + entry->offset;
+	if (entry->compression == static_cast<std::uint32_t>(ShaderCompression::NONE)) {
+		bytecode.data = stored;
+		bytecode.size = static_cast<std::size_t>(entry->size);
+		return(FunctionResult(true, RESULT::SSUCCESS, "Found the shader."));
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	std::unique_ptr<unsigned char[]>& decompressed = mDecompressed[key];
+	if (!decompressed) {
+		std::unique_ptr<unsigned char[]> buffer = std::make_unique<unsigned char[]>(static_cast<std::size_t>(entry->size));
+		if (!decompress(stored, static_cast<std::size_t>(entry->storedSize), buffer.get(), static_cast<std::size_t>(entry->size)) || this->key(buffer.get(), static_cast<std::size_t>(entry->size)) != key) {
+			mDecompressed.erase(key);
+			return(FunctionResult(false, RESULT::FAIL, "The compressed shader is damaged."));
+		}
+		decompressed = std::move(buffer);
+	}
+
+	bytecode.data = decompressed.get();
+	bytecode.size = static_cast<std::size_t>(entry->size);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Found the shader."));
+}
+
+/** Looks up the bytecode of a shader by the name it was packed under. */
+SyrenEngine::FunctionResult SyrenEngine::ShaderArchive::find(const char* name, ShaderBytecode& bytecode) {
+	const std::uint64_t nameHash = fnv1a(name, std::strlen(name));
+	const FileName* end = mNames + mNameCount;
+	const FileName* entry = std::lower_bound(mNames, end, nameHash, [](const FileName& lhs, std::uint64_t value) { return lhs.nameHash < value; });
+	if (entry == end || entry->nameHash != nameHash) return(FunctionResult(false, RESULT::FAIL, std::string("The shader ") + name + " is not in the archive."));
+
+	return(find(entry->key, bytecode));
+}
+
+/** Checks every blob against its key, e.g. after the archive was copied. Touches the whole file. */
+SyrenEngine::FunctionResult SyrenEngine::ShaderArchive::verify() {
+	for (std::uint32_t i = 0; i < mEntryCount; ++i) {
+		ShaderBytecode bytecode;
+		FunctionResult result = find(mEntries[i].key, bytecode);
+		if (!result.is_successfull) return(result);
+		if (key(bytecode.data, bytecode.size) != mEntries[i].key) return(FunctionResult(false, RESULT::FAIL, "A shader does not match its key."));
+	}
+	return(FunctionResult(true, RESULT::SSUCCESS, "Every shader matches its key."));
+}
+
+SyrenEngine::ShaderArchiveEntry SyrenEngine::ShaderArchive::entry(std::uint32_t index) const {
+	ShaderArchiveEntry entry;
+	entry.key = mEntries[index].key;
+	entry.size = mEntries[index].size;
+	entry.storedSize = mEntries[index].storedSize;
+	entry.compression = static_cast<ShaderCompression>(mEntries[index].compression);
+	return(entry);
+}
+
+SyrenEngine::ShaderKey SyrenEngine::ShaderArchive::key(const void* data, std::size_t size) {
+	return(fnv1a(data, size));
+}
+
+const SyrenEngine::ShaderArchive::FileEntry* SyrenEngine::ShaderArchive::findEntry(ShaderKey key) const {
+	const FileEntry* end = mEntries + mEntryCount;
+	const FileEntry* entry = std::lower_bound(mEntries, end, key, [](const FileEntry& lhs, ShaderKey value) { return lhs.key < value; });
+	return(entry != end && entry->key == key ? entry : nullptr);
+}
+
+/** Adds a shader to the archive. Identical bytecode added under several names is stored once.
+ *
+ * @param[in] name: Name the shader can be looked up by.
+ * @param[in] bytecode: Compiled shader.
+ * @param[in] size: Size of the bytecode.
+ * @param[out] key: Key of the shader.
+ */
+SyrenEngine::FunctionResult SyrenEngine::ShaderArchiveWriter::add(const std::string& name, const void* bytecode, std::size_t size, ShaderKey& key) {
+	if (size == 0) return(FunctionResult(false, RESULT::FAIL, "The shader " + name + " is empty."));
+
+	const std::uint64_t nameHash = fnv1a(name.data(), name.size());
+	auto named = mNames.find(nameHash);
+	if (named != mNames.end()) {
+		if (named->second == name) return(FunctionResult(false, RESULT::FAIL, "The shader " + name + " was added twice."));
+		return(FunctionResult(false, RESULT::FAIL, "The names " + name + " and " + named->second + " collide, rename one of them."));
+	}
+
+	key = ShaderArchive::key(bytecode, size);
+	if (mShaderIndices.find(key) == mShaderIndices.end()) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(bytecode);
+		mShaderIndices.emplace(key, mShaders.size());
+		mShaders.push_back(Shader{ key, std::vector<unsigned char>(bytes, bytes + size) });
+	}
+
+	mNames.emplace(nameHash, name);
+	mNameTable.push_back(ShaderArchive::FileName{ nameHash, key });
+	return(FunctionResult(true, RESULT::SSUCCESS, "Added the shader."));
+}
+
+/** Writes the archive, replacing the file only once it has been written completely.
+ *
+ * @param[in] path: Archive file.
+ * @param[in] compress: Store blobs LZ compressed where that saves at least an eighth of their size.
+ */
+SyrenEngine::FunctionResult SyrenEngine::ShaderArchiveWriter::write(const std::string& path, bool compress) const {
+	typedef ShaderArchive::FileHeader FileHeader;
+	typedef ShaderArchive::FileEntry FileEntry;
+	typedef ShaderArchive::FileName FileName;
+
+	std::vector<const Shader*> shaders;
+	shaders.reserve(mShaders.size());
+	for (const Shader& shader : mShaders)
+		shaders.push_back(&shader);
+	std::sort(shaders.begin(), shaders.end(), [](const Shader* lhs, const Shader* rhs) { return lhs->key < rhs->key; });
+
+	std::vector<FileName> names = mNameTable;
+	std::sort(names.begin(), names.end(), [](const FileName& lhs, const FileName& rhs) { return lhs.nameHash < rhs.nameHash; });
+
+	std::vector<std::vector<unsigned char> > compressed(shaders.size());
+	std::vector<FileEntry> entries(shaders.size());
+
+	FileHeader header = { ShaderArchiveMagic, ShaderArchiveVersion, static_cast<std::uint32_t>(shaders.size()), static_cast<std::uint32_t>(names.size()), 0, 0 };
+	header.namesOffset = sizeof(FileHeader) + entries.size() * sizeof(FileEntry);
+
+	std::uint64_t offset = header.namesOffset + names.size() * sizeof(FileName);
+	for (std::size_t i = 0; i < shaders.size(); ++i) {
+		const std::vector<unsigned char>& bytecode = shaders[i]->bytecode;
+		FileEntry& entry = entries[i];
+		entry = FileEntry{ shaders[i]->key, 0, bytecode.size(), bytecode.size(), static_cast<std::uint32_t>(ShaderCompression::NONE), 0 };
+
+		if (compress) {
+			::compress(bytecode.data(), bytecode.size(), compressed[i]);
+			if (compressed[i].size() <= bytecode.size() - bytecode.size() / 8) {
+				entry.storedSize = compressed[i].size();
+				entry.compression = static_cast<std::uint32_t>(ShaderCompression::LZ);
+			}
+			else compressed[i].clear();
+		}
+
+		offset = (offset + ShaderArchiveAlignment - 1) & ~(ShaderArchiveAlignment - 1);
+		entry.offset = offset;
+		offset += entry.storedSize;
+	}
+
+	const std::string temporary = path + ".tmp";
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) return(FunctionResult(false, RESULT::FAIL, "Failed to create " + temporary + "."));
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(FileEntry)));
+	file.write(reinterpret_cast<const char*>(names.data()), static_cast<std::streamsize>(names.size() * sizeof(FileName)));
+
+	const char padding[ShaderArchiveAlignment] = {};
+	std::uint64_t written = header.namesOffset + names.size() * sizeof(FileName);
+	for (std::size_t i = 0; i < shaders.size(); ++i) {
+		file.write(padding, static_cast<std::streamsize>(entries[i].offset - written));
+
+		const std::vector<unsigned char>& blob = compressed[i].empty() ? shaders[i]->bytecode : compressed[i];
+		file.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+		written = entries[i].offset + blob.size();
+	}
+	file.close();
+
+	std::error_code error;
+	if (file.fail()) {
+		std::filesystem::remove(temporary, error);
+		return(FunctionResult(false, RESULT::FAIL, "Failed to write " + temporary + "."));
+	}
+
+	std::filesystem::rename(temporary, path, error);
+	if (error) {
+		std::filesystem::remove(temporary, error);
+		return(FunctionResult(false, RESULT::FAIL, "Failed to replace " + path + "."));
+	}
+	return(FunctionResult(true, RESULT::SSUCCESS, "Wrote the shader archive."));
+}
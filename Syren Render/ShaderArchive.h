@@ -0,0 +1,144 @@
+/***********************************************************************************************************
+ * @file ShaderArchive.h
+ *
+ * @brief Declares the content addressed archive that shader bytecode is shipped in
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Every shader of the application lives in one file, so startup opens a single file instead of hundreds
+ * of loose ones. A shader is keyed by the hash of its bytecode, which makes identical shaders collapse
+ * into one blob and gives pipelines a key that changes exactly when the bytecode does. Shaders can also
+ * be looked up by the name they were packed under.
+ *
+ * The file is a header, an index of blobs sorted by key, a table of name hashes sorted by hash and the
+ * blobs, each starting on a ShaderArchiveAlignment boundary. The archive is mapped into memory and
+ * uncompressed blobs are handed out in place, so their bytecode reaches pipeline creation without a
+ * copy. Blobs the packer could shrink noticeably are stored LZ compressed; they are decompressed once
+ * on their first lookup and kept for the lifetime of the archive.
+ *
+ * ShaderArchiveWriter builds archives and is used by the Syren Shader Packer tool. Neither class depends
+ * on a graphics API.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+#include "MappedFile.h"
+
+
+namespace SyrenEngine {
+	static const std::uint32_t ShaderArchiveMagic = 0x41535953u; /*!< "SYSA" */
+	static const std::uint32_t ShaderArchiveVersion = 1;
+	static const std::uint64_t ShaderArchiveAlignment = 64;       /*!< Alignment of every blob within the file */
+
+	typedef std::uint64_t ShaderKey; /*!< Hash of the uncompressed bytecode */
+
+	enum class ShaderCompression : std::uint32_t { NONE, LZ };
+
+	/** Bytecode of a shader, laid out like D3D12_SHADER_BYTECODE. */
+	struct ShaderBytecode {
+		const void* data = nullptr;
+		std::size_t size = 0;
+	};
+
+	struct ShaderArchiveEntry {
+		ShaderKey key = 0;
+		std::uint64_t size = 0;       /*!< Size of the bytecode */
+		std::uint64_t storedSize = 0; /*!< Size of the blob in the file */
+		ShaderCompression compression = ShaderCompression::NONE;
+	};
+
+	class ShaderArchive {
+	private:
+		struct FileHeader {
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint32_t entryCount;
+			std::uint32_t nameCount;
+			std::uint64_t namesOffset;
+			std::uint64_t reserved;
+		};
+
+		struct FileEntry {
+			ShaderKey key;
+			std::uint64_t offset;
+			std::uint64_t storedSize;
+			std::uint64_t size;
+			std::uint32_t compression;
+			std::uint32_t reserved;
+		};
+
+		struct FileName {
+			std::uint64_t nameHash;
+			ShaderKey key;
+		};
+
+		friend class ShaderArchiveWriter;
+
+		MappedFile mFile;
+		const FileEntry* mEntries = nullptr;
+		std::uint32_t mEntryCount = 0;
+		const FileName* mNames = nullptr;
+		std::uint32_t mNameCount = 0;
+
+		std::unordered_map<ShaderKey, std::unique_ptr<unsigned char[]> > mDecompressed;
+		std::mutex mMutex;
+	public:
+		ShaderArchive() = default;
+
+		FunctionResult open(const std::string& path);
+		void close();
+
+		FunctionResult find(ShaderKey key, ShaderBytecode& bytecode);
+		FunctionResult find(const char* name, ShaderBytecode& bytecode);
+		FunctionResult verify();
+
+		std::uint32_t entryCount() const { return mEntryCount; }
+		ShaderArchiveEntry entry(std::uint32_t index) const;
+
+		static ShaderKey key(const void* data, std::size_t size);
+	private:
+		ShaderArchive(const ShaderArchive& rhs) = delete;
+		ShaderArchive& operator=(const ShaderArchive& rhs) = delete;
+
+		const FileEntry* findEntry(ShaderKey key) const;
+	};
+
+	class ShaderArchiveWriter {
+	private:
+		struct Shader {
+			ShaderKey key;
+			std::vector<unsigned char> bytecode;
+		};
+
+		std::vector<Shader> mShaders;
+		std::unordered_map<ShaderKey, std::size_t> mShaderIndices;
+		std::unordered_map<std::uint64_t, std::string> mNames; /*!< Names by hash, to reject collisions */
+		std::vector<ShaderArchive::FileName> mNameTable;
+
+	public:
+		ShaderArchiveWriter() = default;
+
+		FunctionResult add(const std::string& name, const void* bytecode, std::size_t size, ShaderKey& key);
+		FunctionResult write(const std::string& path, bool compress) const;
+
+		std::size_t shaderCount() const { return mShaders.size(); }
+	private:
+		ShaderArchiveWriter(const ShaderArchiveWriter& rhs) = delete;
+		ShaderArchiveWriter& operator=(const ShaderArchiveWriter& rhs) = delete;
+	};
+}
@@ -0,0 +1,189 @@
+/***********************************************************************************************************
+ * @file ShaderPermutation.h
+ *
+ * @brief Declares compile time shader permutation keys and the tables their variants are looked up in
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * A shader's features are declared as types, each with a fixed number of values and a value type:
+ *
+ *     struct Skinned : ShaderFlag { static constexpr const char* Name = "SKINNED"; };
+ *     struct Alpha : ShaderEnumFeature<AlphaMode> { static constexpr const char* Name = "ALPHA_MODE"; };
+ *     struct LightCount : ShaderFeature<5> { static constexpr const char* Name = "LIGHT_COUNT"; };
+ *
+ *     typedef ShaderPermutation<Skinned, Alpha, LightCount> ForwardPermutation;
+ *
+ * A permutation packs the values of its features into one index in mixed radix, so the indices of a
+ * permutation space are dense and a variant table has exactly one slot per combination. This packing
+ * replaces power of two bitfields, which would leave holes in the table. Setting and reading a feature
+ * is typed and constexpr, so permutations spelled out in code become constants.
+ *
+ * A ShaderPermutationSpace pairs a permutation with rules naming the combinations that must never be
+ * built. index<P>() rejects an invalid combination at compile time; index(P) returns
+ * InvalidShaderPermutation for one assembled at run time. Materials resolve their index once, so
+ * finding a variant per draw is a single array index into a ShaderVariantTable.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+
+namespace SyrenEngine {
+	static const std::uint32_t InvalidShaderPermutation = 0xFFFFFFFFu;
+
+	/** Base of a feature with ValueCount values of type ValueType, numbered from 0. */
+	template<std::uint32_t ValueCount, typename ValueType = std::uint32_t>
+	struct ShaderFeature {
+		static_assert(ValueCount >= 2, "A shader feature needs at least two values.");
+
+		typedef ValueType Value;
+		static constexpr std::uint32_t Count = ValueCount;
+	};
+
+	/** Feature that is either on or off. */
+	struct ShaderFlag : ShaderFeature<2, bool> {};
+
+	/** Feature taking the values of an enum, which has to end with a COUNT enumerator. */
+	template<typename Enum>
+	struct ShaderEnumFeature : ShaderFeature<static_cast<std::uint32_t>(Enum::COUNT), Enum> {};
+
+	/** Never called. Using a feature value out of its range in a constant expression fails to compile. */
+	inline void shaderFeatureValueOutOfRange() {}
+
+	template<typename... Features>
+	class ShaderPermutation {
+	private:
+		static_assert(sizeof...(Features) > 0, "A permutation needs at least one feature.");
+
+		static constexpr std::uint64_t Combinations = (static_cast<std::uint64_t>(Features::Count) * ...);
+		static_assert(Combinations < InvalidShaderPermutation, "The permutation has too many combinations to index.");
+
+	public:
+		static constexpr std::uint32_t Count = static_cast<std::uint32_t>(Combinations);
+
+		template<typename Feature>
+		static constexpr bool contains = ((std::is_same<Feature, Features>::value ? 1 : 0) + ...) == 1;
+
+		/** Packed feature values. Public so that permutations can be template arguments. */
+		std::uint32_t index = 0;
+
+		constexpr ShaderPermutation() = default;
+		constexpr explicit ShaderPermutation(std::uint32_t pIndex) : index(pIndex < Count ? pIndex : InvalidShaderPermutation) {}
+
+		/** Returns the distance between the indices of two permutations differing by one in a feature. */
+		template<typename Feature>
+		static constexpr std::uint32_t stride() {
+			static_assert(contains<Feature>, "The feature is not part of this permutation.");
+
+			std::uint32_t result = 1;
+			bool found = false;
+			((found = found || std::is_same<Feature, Features>::value, result *= found ? 1 : Features::Count), ...);
+			return result;
+		}
+
+		/** Returns a copy with a feature set to a value. An out of range value gives an invalid permutation. */
+		template<typename Feature>
+		constexpr ShaderPermutation with(typename Feature::Value value) const {
+			const std::uint32_t packed = static_cast<std::uint32_t>(value);
+			if (packed >= Feature::Count || !isValid()) {
+				if (std::is_constant_evaluated()) shaderFeatureValueOutOfRange();
+				return(ShaderPermutation(InvalidShaderPermutation));
+			}
+
+			ShaderPermutation result;
+			result.index = index - (index / stride<Feature>() % Feature::Count) * stride<Feature>() + packed * stride<Feature>();
+			return(result);
+		}
+
+		template<typename Feature>
+		constexpr typename Feature::Value get() const {
+			return(static_cast<typename Feature::Value>(index / stride<Feature>() % Feature::Count));
+		}
+
+		constexpr bool isValid() const { return index < Count; }
+
+		/** Calls visit(name, value) for every feature, e.g. to pass the permutation to the shader compiler as defines. */
+		template<typename Visit>
+		void forEachFeature(Visit&& visit) const {
+			(visit(Features::Name, index / stride<Features>() % Features::Count), ...);
+		}
+
+		constexpr bool operator==(const ShaderPermutation& rhs) const = default;
+	};
+
+	struct NoShaderPermutationRules {
+		template<typename Permutation>
+		static constexpr bool valid(const Permutation&) { return true; }
+	};
+
+	/** Permutation together with the rules its combinations have to follow.
+	 *
+	 * @details
+	 * Rules is a type with a static constexpr bool valid(const Permutation&).
+	 */
+	template<typename Permutation, typename Rules = NoShaderPermutationRules>
+	class ShaderPermutationSpace {
+	public:
+		static constexpr std::uint32_t Count = Permutation::Count;
+
+		static constexpr bool valid(Permutation permutation) {
+			return(permutation.isValid() && Rules::valid(permutation));
+		}
+
+		/** Returns the index of a permutation known at compile time, which has to follow the rules. */
+		template<Permutation P>
+		static consteval std::uint32_t index() {
+			static_assert(P.isValid(), "A shader feature value is out of range.");
+			static_assert(Rules::valid(P), "This combination of shader features is invalid.");
+			return(P.index);
+		}
+
+		/** Returns the index of a permutation assembled at run time, or InvalidShaderPermutation. */
+		static constexpr std::uint32_t index(Permutation permutation) {
+			return(valid(permutation) ? permutation.index : InvalidShaderPermutation);
+		}
+
+		static constexpr std::uint32_t validCount() {
+			std::uint32_t count = 0;
+			for (std::uint32_t i = 0; i < Count; ++i) {
+				if (valid(Permutation(i))) ++count;
+			}
+			return count;
+		}
+
+		/** Calls visit(permutation) for every valid permutation, e.g. to compile the variants of a shader. */
+		template<typename Visit>
+		static void forEachValid(Visit&& visit) {
+			for (std::uint32_t i = 0; i < Count; ++i) {
+				const Permutation permutation(i);
+				if (Rules::valid(permutation)) visit(permutation);
+			}
+		}
+	};
+
+	/** One T per permutation of a space, such as the pipeline of each shader variant. */
+	template<typename Space, typename T>
+	class ShaderVariantTable {
+	private:
+		std::vector<T> mVariants;
+
+	public:
+		ShaderVariantTable() : mVariants(Space::Count) {}
+
+		/** Returns the variant of an index obtained from Space::index(). */
+		T& operator[](std::uint32_t index) { return mVariants[index]; }
+		const T& operator[](std::uint32_t index) const { return mVariants[index]; }
+
+		std::size_t size() const { return mVariants.size(); }
+	};
+}
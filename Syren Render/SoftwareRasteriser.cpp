@@ -0,0 +1,797 @@
+/***********************************************************************************************************
+ * @file SoftwareRasteriser.cpp
+ *
+ * @brief Implements functions of the SoftwareRasteriser class found in SoftwareRasteriser.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Triangles are snapped to a 1/16 pixel grid and every edge function is computed from its end points
+ * in a canonical order, so the two triangles sharing an edge evaluate exactly negated values. Together
+ * with the top-left fill rule this keeps meshes watertight and the output bit-exact between runs,
+ * independent of how tiles are scheduled across threads.
+ *
+ * Four coverage samples are evaluated per SIMD step. Without multisampling the lanes are four
+ * neighbouring pixels, with 4x multisampling they are the four samples of one pixel, which is shaded
+ * once at its centre.
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "SoftwareRasteriser.h"
+#include "FramePacing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SYREN_RASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace {
+	const double SubpixelScale = 16.0;
+	const float NearClipW = 1.0e-5f;
+
+	/* Triangles are clipped to GuardBand times the viewport in x and y, which keeps screen coordinates
+	   small enough for the edge functions and the integer bounds while most triangles need no clipping */
+	const float GuardBand = 16.0f;
+	const int ClipPlaneCount = 6;
+	const int MaxClipVertices = 3 + ClipPlaneCount;
+
+	/* Bounds of a triangle are clamped to this before they are converted to int, for viewports so large
+	   that even the guard band lies outside the int range */
+	const double MaxScreenCoordinate = 1 << 30;
+
+	/** Whether size bytes from offset lie within a buffer of the given size, without offset + size wrapping. */
+	inline bool rangeFits(std::uint64_t offset, std::uint64_t size, std::uint64_t bufferSize) {
+		return(offset <= bufferSize && size <= bufferSize - offset);
+	}
+
+	/* D3D standard 4x sample pattern, relative to the pixel's top left corner */
+	const float SamplePatternX4[4] = { 0.375f, 0.875f, 0.125f, 0.625f };
+	const float SamplePatternY4[4] = { 0.125f, 0.375f, 0.625f, 0.875f };
+
+#ifdef SYREN_RASTER_SSE2
+	struct Lanes { __m128 v; };
+	struct LaneMask { __m128 v; };
+
+	inline Lanes broadcast(float value) { return { _mm_set1_ps(value) }; }
+	inline Lanes loadLanes(const float* values) { return { _mm_loadu_ps(values) }; }
+	inline void storeLanes(float* values, Lanes lanes) { _mm_storeu_ps(values, lanes.v); }
+
+	inline Lanes operator+(Lanes a, Lanes b) { return { _mm_add_ps(a.v, b.v) }; }
+	inline Lanes operator*(Lanes a, Lanes b) { return { _mm_mul_ps(a.v, b.v) }; }
+
+	inline LaneMask greater(Lanes a, Lanes b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+	inline LaneMask greaterEqual(Lanes a, Lanes b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+	inline LaneMask less(Lanes a, Lanes b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+	inline LaneMask operator&(LaneMask a, LaneMask b) { return { _mm_and_ps(a.v, b.v) }; }
+
+	inline Lanes select(LaneMask mask, Lanes a, Lanes b) { return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) }; }
+	inline int maskBits(LaneMask mask) { return _mm_movemask_ps(mask.v); }
+#else
+	struct Lanes { float v[4]; };
+	struct LaneMask { int bits; };
+
+	inline Lanes broadcast(float value) { return { { value, value, value, value } }; }
+	inline Lanes loadLanes(const float* values) { return { { values[0], values[1], values[2], values[3] } }; }
+	inline void storeLanes(float* values, Lanes lanes) { for (int i = 0; i < 4; ++i) values[i] = lanes.v[i]; }
+
+	inline Lanes operator+(Lanes a, Lanes b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+	inline Lanes operator*(Lanes a, Lanes b) { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+
+	inline LaneMask greater(Lanes a, Lanes b) { int bits = 0; for (int i = 0; i < 4; ++i) bits |= (a.v[i] > b.v[i]) << i; return { bits }; }
+	inline LaneMask greaterEqual(Lanes a, Lanes b) { int bits = 0; for (int i = 0; i < 4; ++i) bits |= (a.v[i] >= b.v[i]) << i; return { bits }; }
+	inline LaneMask less(Lanes a, Lanes b) { int bits = 0; for (int i = 0; i < 4; ++i) bits |= (a.v[i] < b.v[i]) << i; return { bits }; }
+	inline LaneMask operator&(LaneMask a, LaneMask b) { return { a.bits & b.bits }; }
+
+	inline Lanes select(LaneMask mask, Lanes a, Lanes b) { for (int i = 0; i < 4; ++i) if (!((mask.bits >> i) & 1)) a.v[i] = b.v[i]; return a; }
+	inline int maskBits(LaneMask mask) { return mask.bits; }
+#endif
+
+	inline Lanes makeLanes(float a, float b, float c, float d) {
+		const float values[4] = { a, b, c, d };
+		return loadLanes(values);
+	}
+
+	/** Coverage test of one edge, inclusive on top and left edges. */
+	inline LaneMask insideEdge(Lanes value, bool topLeft) {
+		return topLeft ? greaterEqual(value, broadcast(0.0f)) : greater(value, broadcast(0.0f));
+	}
+
+	inline std::uint32_t packColor(const float color[4]) {
+		std::uint32_t packed = 0;
+		for (int i = 0; i < 4; ++i) {
+			float channel = std::min(std::max(color[i], 0.0f), 1.0f);
+			packed |= static_cast<std::uint32_t>(channel * 255.0f + 0.5f) << (8 * i);
+		}
+		return packed;
+	}
+
+	/** Returns the signed distance of a clip space position to a clip plane, non-negative inside. */
+	inline float clipDistance(const float* position, int plane) {
+		switch (plane) {
+		case 0: return position[3] - NearClipW;
+		case 1: return position[2];
+		case 2: return GuardBand * position[3] - position[0];
+		case 3: return GuardBand * position[3] + position[0];
+		case 4: return GuardBand * position[3] - position[1];
+		default: return GuardBand * position[3] + position[1];
+		}
+	}
+
+	inline int toScreenBound(double coordinate) {
+		return static_cast<int>(std::clamp(coordinate, -MaxScreenCoordinate, MaxScreenCoordinate));
+	}
+
+	/** Computes the edge function through a and b from its end points in canonical order.
+	 *
+	 * @details
+	 * E(p) = A * p.x + B * p.y + C is positive to the left of a -> b. Evaluating the reversed edge
+	 * produces exactly the negated coefficients.
+	 */
+	inline void makeEdge(double ax, double ay, double bx, double by, double& A, double& B, double& C) {
+		bool swapped = (bx < ax) || (bx == ax && by < ay);
+		if (swapped) {
+			std::swap(ax, bx);
+			std::swap(ay, by);
+		}
+
+		A = ay - by;
+		B = bx - ax;
+		C = (by - ay) * ax - (bx - ax) * ay;
+
+		if (swapped) {
+			A = -A;
+			B = -B;
+			C = -C;
+		}
+	}
+}
+
+
+/***********************************************************************************************************
+ * SoftwareRasteriser entry and exit member functions
+ *
+ **********************************************************************************************************/
+
+/** Constructor for the SoftwareRasteriser class.
+ *
+ * @param[in] pConfig: Graphics configuration providing the frame size, sample count and readback depth.
+ */
+SyrenEngine::SoftwareRasteriser::SoftwareRasteriser(const GraphicsConfig& pConfig) {
+	mWidth = pConfig.Width > 0 ? pConfig.Width : mWidth;
+	mHeight = pConfig.Height > 0 ? pConfig.Height : mHeight;
+	mSampleCount = pConfig.SampleCount == 4 ? 4 : 1;
+	mReadback.initialise(&mReadbackTimeline, resolveFramePacing(pConfig).bufferCount);
+	resetState();
+}
+
+/** Destructor for the SoftwareRasteriser class. Joins the worker threads. */
+SyrenEngine::SoftwareRasteriser::~SoftwareRasteriser() {
+	mWorkers.reset();
+}
+
+/***********************************************************************************************************
+ * SoftwareRasteriser command stream replay
+ *
+ **********************************************************************************************************/
+
+/** Translates command stream packets into rasteriser work. */
+struct SyrenEngine::SoftwareRasteriser::StreamExecutor {
+	SoftwareRasteriser& api;
+
+	void execute(const ClearRenderTargetCommand& command) {
+		if (command.target != BackBufferResource) return;
+		api.flush();
+		api.clearColor(packColor(command.color));
+	}
+
+	void execute(const ClearDepthStencilCommand& command) {
+		if (command.target != DepthStencilResource || !command.clearDepth) return;
+		api.flush();
+		api.clearDepth(command.depth);
+	}
+
+	void execute(const SetViewportCommand& command) {
+		api.mViewport[0] = command.x;
+		api.mViewport[1] = command.y;
+		api.mViewport[2] = command.width;
+		api.mViewport[3] = command.height;
+		api.mViewport[4] = command.minDepth;
+		api.mViewport[5] = command.maxDepth;
+	}
+
+	void execute(const SetScissorCommand& command) {
+		api.mScissor.left = std::max(command.left, 0);
+		api.mScissor.top = std::max(command.top, 0);
+		api.mScissor.right = std::min(command.right, api.mWidth);
+		api.mScissor.bottom = std::min(command.bottom, api.mHeight);
+	}
+
+	void execute(const SetRenderTargetsCommand&) {}
+	void execute(const SetPipelineCommand&) {}
+
+	void execute(const SetVertexBufferCommand& command) {
+		if (command.slot != 0) return;
+		api.mVertexBuffer = command.buffer;
+		api.mVertexOffset = command.offset;
+		api.mVertexStride = std::max<std::uint32_t>(command.stride, sizeof(SoftwareVertex));
+	}
+
+	void execute(const SetIndexBufferCommand& command) {
+		api.mIndexBuffer = command.buffer;
+		api.mIndexOffset = command.offset;
+		api.mIndexSize = command.indexSize == 4 ? 4 : 2;
+	}
+
+	void execute(const DrawCommand& command) {
+		if (command.instanceCount == 0) return;
+		api.drawPrimitives(command.vertexCount, command.firstVertex, false, 0);
+	}
+
+	void execute(const DrawIndexedCommand& command) {
+		if (command.instanceCount == 0) return;
+		api.drawPrimitives(command.indexCount, command.firstIndex, true, command.baseVertex);
+	}
+
+	void execute(const DispatchCommand&) {}
+	void execute(const BarrierCommand&) {}
+
+	void execute(const CopyBufferCommand& command) {
+		std::vector<unsigned char>* destination = api.findBuffer(command.destination);
+		const std::vector<unsigned char>* source = api.findBuffer(command.source);
+		if (destination == nullptr || source == nullptr) return;
+		if (!rangeFits(command.sourceOffset, command.size, source->size()) || !rangeFits(command.destinationOffset, command.size, destination->size())) return;
+
+		std::memmove(destination->data() + command.destinationOffset, source->data() + command.sourceOffset, static_cast<std::size_t>(command.size));
+	}
+
+	void execute(const CopyTextureCommand&) {}
+};
+
+/***********************************************************************************************************
+ * SoftwareRasteriser private member functions
+ *
+ **********************************************************************************************************/
+
+/** Restores the default viewport, scissor and buffer bindings at the start of a frame. */
+void SyrenEngine::SoftwareRasteriser::resetState() {
+	mViewport[0] = 0.0f;
+	mViewport[1] = 0.0f;
+	mViewport[2] = static_cast<float>(mWidth);
+	mViewport[3] = static_cast<float>(mHeight);
+	mViewport[4] = 0.0f;
+	mViewport[5] = 1.0f;
+
+	mScissor = { 0, 0, mWidth, mHeight };
+
+	mVertexBuffer = NullResource;
+	mVertexOffset = 0;
+	mVertexStride = sizeof(SoftwareVertex);
+	mIndexBuffer = NullResource;
+	mIndexOffset = 0;
+	mIndexSize = 2;
+}
+
+std::vector<unsigned char>* SyrenEngine::SoftwareRasteriser::findBuffer(ResourceId id) {
+	if (id == NullResource || id > mBuffers.size()) return nullptr;
+	return &mBuffers[id - 1];
+}
+
+const std::vector<unsigned char>* SyrenEngine::SoftwareRasteriser::findBuffer(ResourceId id) const {
+	if (id == NullResource || id > mBuffers.size()) return nullptr;
+	return &mBuffers[id - 1];
+}
+
+/** Reads a vertex from the bound vertex buffer and expands its colour.
+ *
+ * @retval false if the vertex lies outside the bound buffer.
+ */
+bool SyrenEngine::SoftwareRasteriser::fetchVertex(std::uint32_t index, ClipVertex& vertex) const {
+	const std::vector<unsigned char>* buffer = findBuffer(mVertexBuffer);
+	if (buffer == nullptr) return false;
+
+	const std::uint64_t offset = static_cast<std::uint64_t>(mVertexOffset) + static_cast<std::uint64_t>(index) * mVertexStride;
+	if (!rangeFits(offset, sizeof(SoftwareVertex), buffer->size())) return false;
+
+	SoftwareVertex source;
+	std::memcpy(&source, buffer->data() + offset, sizeof(source));
+
+	for (int i = 0; i < 4; ++i) {
+		vertex.position[i] = source.position[i];
+		vertex.color[i] = static_cast<float>((source.color >> (8 * i)) & 0xFF) / 255.0f;
+	}
+
+	return true;
+}
+
+/** Assembles triangle lists from the bound buffers and bins them.
+ *
+ * @param[in] count: Number of vertices or indices.
+ * @param[in] first: First vertex or index.
+ * @param[in] indexed: Whether vertices are referenced through the index buffer.
+ * @param[in] baseVertex: Value added to every index.
+ */
+void SyrenEngine::SoftwareRasteriser::drawPrimitives(std::uint32_t count, std::uint32_t first, bool indexed, std::int32_t baseVertex) {
+	const std::vector<unsigned char>* indices = indexed ? findBuffer(mIndexBuffer) : nullptr;
+	if (indexed && indices == nullptr) return;
+
+	for (std::uint32_t primitive = 0; primitive + 3 <= count; primitive += 3) {
+		ClipVertex vertices[3];
+		bool valid = true;
+
+		for (std::uint32_t corner = 0; corner < 3 && valid; ++corner) {
+			std::uint32_t vertexIndex = first + primitive + corner;
+
+			if (indexed) {
+				const std::uint64_t offset = static_cast<std::uint64_t>(mIndexOffset) + static_cast<std::uint64_t>(vertexIndex) * mIndexSize;
+				if (!rangeFits(offset, mIndexSize, indices->size())) return;
+
+				std::uint32_t value = 0;
+				if (mIndexSize == 4) std::memcpy(&value, indices->data() + offset, 4);
+				else {
+					std::uint16_t shortValue = 0;
+					std::memcpy(&shortValue, indices->data() + offset, 2);
+					value = shortValue;
+				}
+				vertexIndex = static_cast<std::uint32_t>(static_cast<std::int64_t>(value) + baseVertex);
+			}
+
+			valid = fetchVertex(vertexIndex, vertices[corner]);
+		}
+
+		if (valid) clipAndBin(vertices[0], vertices[1], vertices[2]);
+	}
+}
+
+/** Clips a triangle against the w = 0 plane, the near plane and the guard band and sets up the pieces. */
+void SyrenEngine::SoftwareRasteriser::clipAndBin(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2) {
+	ClipVertex polygon[2][MaxClipVertices] = { { v0, v1, v2 } };
+	int count = 3;
+	int current = 0;
+
+	for (int plane = 0; plane < ClipPlaneCount; ++plane) {
+		const ClipVertex* input = polygon[current];
+		ClipVertex* output = polygon[current ^ 1];
+		int outputCount = 0;
+
+		for (int i = 0; i < count; ++i) {
+			const ClipVertex& a = input[i];
+			const ClipVertex& b = input[(i + 1) % count];
+
+			float da = clipDistance(a.position, plane);
+			float db = clipDistance(b.position, plane);
+
+			if (da >= 0.0f) output[outputCount++] = a;
+			if ((da >= 0.0f) != (db >= 0.0f)) {
+				float t = da / (da - db);
+				ClipVertex& clipped = output[outputCount++];
+				for (int c = 0; c < 4; ++c) {
+					clipped.position[c] = a.position[c] + (b.position[c] - a.position[c]) * t;
+					clipped.color[c] = a.color[c] + (b.color[c] - a.color[c]) * t;
+				}
+			}
+		}
+
+		count = outputCount;
+		current ^= 1;
+		if (count < 3) return;
+	}
+
+	for (int i = 1; i + 1 < count; ++i)
+		setupTriangle(polygon[current][0], polygon[current][i], polygon[current][i + 1]);
+}
+
+/** Projects a clipped triangle, computes its edge and attribute planes and bins it into tiles. */
+void SyrenEngine::SoftwareRasteriser::setupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2) {
+	const ClipVertex* corners[3] = { &v0, &v1, &v2 };
+	double x[3], y[3], z[3], attributes[3][5];
+
+	for (int i = 0; i < 3; ++i) {
+		const ClipVertex& vertex = *corners[i];
+		double invW = 1.0 / vertex.position[3];
+
+		double ndcX = vertex.position[0] * invW;
+		double ndcY = vertex.position[1] * invW;
+		double ndcZ = vertex.position[2] * invW;
+
+		double screenX = mViewport[0] + (ndcX * 0.5 + 0.5) * mViewport[2];
+		double screenY = mViewport[1] + (0.5 - ndcY * 0.5) * mViewport[3];
+
+		x[i] = std::round(screenX * SubpixelScale) / SubpixelScale;
+		y[i] = std::round(screenY * SubpixelScale) / SubpixelScale;
+		z[i] = mViewport[4] + ndcZ * (mViewport[5] - mViewport[4]);
+
+		attributes[i][0] = invW;
+		for (int c = 0; c < 4; ++c)
+			attributes[i][c + 1] = vertex.color[c] * invW;
+	}
+
+	double A[3], B[3], C[3];
+	makeEdge(x[1], y[1], x[2], y[2], A[0], B[0], C[0]);
+	makeEdge(x[2], y[2], x[0], y[0], A[1], B[1], C[1]);
+	makeEdge(x[0], y[0], x[1], y[1], A[2], B[2], C[2]);
+
+	double area = A[0] * x[0] + B[0] * y[0] + C[0];
+	if (area == 0.0) return;
+	if (area < 0.0) {
+		for (int e = 0; e < 3; ++e) {
+			A[e] = -A[e];
+			B[e] = -B[e];
+			C[e] = -C[e];
+		}
+		area = -area;
+	}
+
+	Triangle triangle;
+
+	triangle.minX = std::max({ toScreenBound(std::floor(std::min({ x[0], x[1], x[2] }))), mScissor.left, toScreenBound(mViewport[0]), 0 });
+	triangle.minY = std::max({ toScreenBound(std::floor(std::min({ y[0], y[1], y[2] }))), mScissor.top, toScreenBound(mViewport[1]), 0 });
+	triangle.maxX = std::min({ toScreenBound(std::ceil(std::max({ x[0], x[1], x[2] }))) + 1, mScissor.right, toScreenBound(std::ceil(mViewport[0] + mViewport[2])), mWidth });
+	triangle.maxY = std::min({ toScreenBound(std::ceil(std::max({ y[0], y[1], y[2] }))) + 1, mScissor.bottom, toScreenBound(std::ceil(mViewport[1] + mViewport[3])), mHeight });
+	if (triangle.minX >= triangle.maxX || triangle.minY >= triangle.maxY) return;
+
+	for (int e = 0; e < 3; ++e) {
+		triangle.edgeA[e] = static_cast<float>(A[e]);
+		triangle.edgeB[e] = static_cast<float>(B[e]);
+		triangle.edgeC[e] = C[e];
+		triangle.topLeft[e] = A[e] > 0.0 || (A[e] == 0.0 && B[e] > 0.0);
+	}
+
+	double zA = 0.0, zB = 0.0, zC = 0.0;
+	for (int i = 0; i < 3; ++i) {
+		zA += A[i] * z[i];
+		zB += B[i] * z[i];
+		zC += C[i] * z[i];
+	}
+	triangle.zA = static_cast<float>(zA / area);
+	triangle.zB = static_cast<float>(zB / area);
+	triangle.zC = zC / area;
+
+	for (int a = 0; a < 5; ++a) {
+		triangle.attributeA[a] = 0.0;
+		triangle.attributeB[a] = 0.0;
+		triangle.attributeC[a] = 0.0;
+		for (int i = 0; i < 3; ++i) {
+			triangle.attributeA[a] += A[i] * attributes[i][a];
+			triangle.attributeB[a] += B[i] * attributes[i][a];
+			triangle.attributeC[a] += C[i] * attributes[i][a];
+		}
+		triangle.attributeA[a] /= area;
+		triangle.attributeB[a] /= area;
+		triangle.attributeC[a] /= area;
+	}
+
+	std::uint32_t index = static_cast<std::uint32_t>(mTriangles.size());
+	mTriangles.push_back(triangle);
+
+	int tileX0 = triangle.minX / TileSize;
+	int tileY0 = triangle.minY / TileSize;
+	int tileX1 = (triangle.maxX - 1) / TileSize;
+	int tileY1 = (triangle.maxY - 1) / TileSize;
+
+	for (int ty = tileY0; ty <= tileY1; ++ty)
+		for (int tx = tileX0; tx <= tileX1; ++tx)
+			mBins[ty * mTilesX + tx].push_back(index);
+}
+
+/** Rasterises every binned triangle and empties the bins. */
+void SyrenEngine::SoftwareRasteriser::flush() {
+	if (mTriangles.empty()) return;
+
+	mWorkers->parallelFor(static_cast<std::uint32_t>(mBins.size()), [this](std::uint32_t tile) { rasteriseTile(tile); });
+
+	for (std::vector<std::uint32_t>& bin : mBins)
+		bin.clear();
+	mTriangles.clear();
+}
+
+/** Rasterises the triangles binned into one tile, in submission order.
+ *
+ * @details
+ * Each tile owns a disjoint region of the colour and depth buffers, so tiles run concurrently
+ * without synchronisation. Edge and attribute planes are rebased to the tile origin in double
+ * precision before they are evaluated in single precision.
+ */
+void SyrenEngine::SoftwareRasteriser::rasteriseTile(std::uint32_t tileIndex) {
+	const std::vector<std::uint32_t>& bin = mBins[tileIndex];
+	if (bin.empty()) return;
+
+	const int tileX0 = static_cast<int>(tileIndex % mTilesX) * TileSize;
+	const int tileY0 = static_cast<int>(tileIndex / mTilesX) * TileSize;
+	const int tileX1 = std::min(tileX0 + TileSize, mWidth);
+	const int tileY1 = std::min(tileY0 + TileSize, mHeight);
+
+	const bool multisampled = mSampleCount == 4;
+	const int step = multisampled ? 1 : 4;
+
+	const Lanes sampleX = multisampled ? loadLanes(SamplePatternX4) : makeLanes(0.5f, 1.5f, 2.5f, 3.5f);
+	const Lanes sampleY = multisampled ? loadLanes(SamplePatternY4) : broadcast(0.5f);
+	const Lanes laneOffset = makeLanes(0.0f, 1.0f, 2.0f, 3.0f);
+
+	for (std::uint32_t triangleIndex : bin) {
+		const Triangle& triangle = mTriangles[triangleIndex];
+
+		int xStart = std::max(triangle.minX, tileX0);
+		if (!multisampled) xStart &= ~3;
+		const int xEnd = std::min(triangle.maxX, tileX1);
+		const int yStart = std::max(triangle.minY, tileY0);
+		const int yEnd = std::min(triangle.maxY, tileY1);
+
+		Lanes edgeA[3], edgeB[3];
+		float edgeC[3];
+		for (int e = 0; e < 3; ++e) {
+			edgeA[e] = broadcast(triangle.edgeA[e]);
+			edgeB[e] = broadcast(triangle.edgeB[e]);
+			edgeC[e] = static_cast<float>(triangle.edgeA[e] * static_cast<double>(tileX0) + triangle.edgeB[e] * static_cast<double>(tileY0) + triangle.edgeC[e]);
+		}
+
+		const Lanes zA = broadcast(triangle.zA);
+		const Lanes zB = broadcast(triangle.zB);
+		const float zC = static_cast<float>(triangle.zA * static_cast<double>(tileX0) + triangle.zB * static_cast<double>(tileY0) + triangle.zC);
+
+		float attributeA[5], attributeB[5], attributeC[5];
+		for (int a = 0; a < 5; ++a) {
+			attributeA[a] = static_cast<float>(triangle.attributeA[a]);
+			attributeB[a] = static_cast<float>(triangle.attributeB[a]);
+			attributeC[a] = static_cast<float>(triangle.attributeA[a] * tileX0 + triangle.attributeB[a] * tileY0 + triangle.attributeC[a]);
+		}
+
+		auto shade = [&](float localX, float localY) {
+			float invW = attributeA[0] * localX + attributeB[0] * localY + attributeC[0];
+			float w = invW != 0.0f ? 1.0f / invW : 0.0f;
+
+			float color[4];
+			for (int c = 0; c < 4; ++c)
+				color[c] = (attributeA[c + 1] * localX + attributeB[c + 1] * localY + attributeC[c + 1]) * w;
+			return packColor(color);
+		};
+
+		const Lanes minX = broadcast(static_cast<float>(triangle.minX));
+		const Lanes maxX = broadcast(static_cast<float>(xEnd));
+
+		for (int y = yStart; y < yEnd; ++y) {
+			const float localY = static_cast<float>(y - tileY0);
+			const Lanes py = broadcast(localY) + sampleY;
+
+			for (int x = xStart; x < xEnd; x += step) {
+				const float localX = static_cast<float>(x - tileX0);
+				const Lanes px = broadcast(localX) + sampleX;
+
+				LaneMask coverage = insideEdge(edgeA[0] * px + edgeB[0] * py + broadcast(edgeC[0]), triangle.topLeft[0]);
+				coverage = coverage & insideEdge(edgeA[1] * px + edgeB[1] * py + broadcast(edgeC[1]), triangle.topLeft[1]);
+				coverage = coverage & insideEdge(edgeA[2] * px + edgeB[2] * py + broadcast(edgeC[2]), triangle.topLeft[2]);
+
+				if (!multisampled) {
+					const Lanes pixelX = broadcast(static_cast<float>(x)) + laneOffset;
+					coverage = coverage & greaterEqual(pixelX, minX) & less(pixelX, maxX);
+				}
+				if (maskBits(coverage) == 0) continue;
+
+				const std::size_t base = multisampled
+					? (static_cast<std::size_t>(y) * mStride + x) * 4
+					: static_cast<std::size_t>(y) * mStride + x;
+
+				const Lanes depth = zA * px + zB * py + broadcast(zC);
+				const Lanes stored = loadLanes(&mDepth[base]);
+				const LaneMask passed = coverage & less(depth, stored);
+
+				const int bits = maskBits(passed);
+				if (bits == 0) continue;
+
+				storeLanes(&mDepth[base], select(passed, depth, stored));
+
+				if (multisampled) {
+					const std::uint32_t color = shade(localX + 0.5f, localY + 0.5f);
+					for (int lane = 0; lane < 4; ++lane)
+						if ((bits >> lane) & 1) mColor[base + lane] = color;
+				}
+				else {
+					for (int lane = 0; lane < 4; ++lane)
+						if ((bits >> lane) & 1) mColor[base + lane] = shade(localX + lane + 0.5f, localY + 0.5f);
+				}
+			}
+		}
+	}
+}
+
+void SyrenEngine::SoftwareRasteriser::clearColor(std::uint32_t color) {
+	const std::size_t rowSize = static_cast<std::size_t>(mStride) * mSampleCount;
+	mWorkers->parallelFor(static_cast<std::uint32_t>(mHeight), [this, color, rowSize](std::uint32_t row) {
+		std::fill_n(mColor.begin() + row * rowSize, rowSize, color);
+	});
+}
+
+void SyrenEngine::SoftwareRasteriser::clearDepth(float depth) {
+	const std::size_t rowSize = static_cast<std::size_t>(mStride) * mSampleCount;
+	mWorkers->parallelFor(static_cast<std::uint32_t>(mHeight), [this, depth, rowSize](std::uint32_t row) {
+		std::fill_n(mDepth.begin() + row * rowSize, rowSize, depth);
+	});
+}
+
+/** Averages the coverage samples of every pixel into the resolved colour buffer. */
+void SyrenEngine::SoftwareRasteriser::resolve() {
+	mWorkers->parallelFor(static_cast<std::uint32_t>(mHeight), [this](std::uint32_t row) {
+		std::uint32_t* destination = &mResolved[static_cast<std::size_t>(row) * mWidth];
+
+		if (mSampleCount == 1) {
+			std::copy_n(&mColor[static_cast<std::size_t>(row) * mStride], mWidth, destination);
+			return;
+		}
+
+		const std::uint32_t* samples = &mColor[static_cast<std::size_t>(row) * mStride * 4];
+		for (int x = 0; x < mWidth; ++x) {
+			std::uint32_t resolved = 0;
+			for (int channel = 0; channel < 4; ++channel) {
+				std::uint32_t sum = 2;
+				for (int sample = 0; sample < 4; ++sample)
+					sum += (samples[x * 4 + sample] >> (8 * channel)) & 0xFF;
+				resolved |= (sum / 4) << (8 * channel);
+			}
+			destination[x] = resolved;
+		}
+	});
+}
+
+/***********************************************************************************************************
+ * SoftwareRasteriser public member functions
+ *
+ **********************************************************************************************************/
+
+/** Initializes the software rasteriser.
+ *
+ * @details
+ * Starts one worker per hardware thread and allocates the colour and depth buffers.
+ *
+ * @return FunctionResult indicating success or failure of the initialization process.
+ */
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::initialise() {
+	mWorkers = std::make_unique<WorkerPool>();
+
+	FunctionResult result = onResize();
+	if (!result.is_successfull) return(result);
+
+	std::string message = "Initialised the software rasteriser with " + std::to_string(mWorkers->threadCount() + 1) + " threads.";
+	return(FunctionResult(true, RESULT::SSUCCESS, message));
+}
+
+/** Reallocates the render targets for the current client size. */
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::onResize() {
+	if (mWorkers == nullptr) return(FunctionResult(false, RESULT::FAIL, "The software rasteriser has not been initialised."));
+
+	mStride = (mWidth + 3) & ~3;
+	mTilesX = (mWidth + TileSize - 1) / TileSize;
+	mTilesY = (mHeight + TileSize - 1) / TileSize;
+
+	const std::size_t samples = static_cast<std::size_t>(mStride) * mHeight * mSampleCount;
+	mDepth.assign(samples, 1.0f);
+	mColor.assign(samples, 0);
+	mResolved.assign(static_cast<std::size_t>(mWidth) * mHeight, 0);
+
+	mTriangles.clear();
+	mBins.assign(static_cast<std::size_t>(mTilesX) * mTilesY, std::vector<std::uint32_t>());
+
+	resetState();
+	return(FunctionResult(true, RESULT::SSUCCESS, "Resized the software render targets."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::waitForNextFrame() {
+	return(FunctionResult(true, RESULT::SSUCCESS, "Software frames are not paced."));
+}
+
+/** Replays the submitted command streams and resolves the frame.
+ *
+ * @details
+ * Submitters keep recording into a second stream while the frame is rasterised.
+ *
+ * @return FunctionResult indicating the success of the frame.
+ */
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::render() {
+	if (mWorkers == nullptr) return(FunctionResult(false, RESULT::FAIL, "The software rasteriser has not been initialised."));
+
+	{
+		std::lock_guard<std::mutex> lock(mStreamMutex);
+		std::swap(mFrameStream, mReplayStream);
+	}
+
+	resetState();
+	StreamExecutor executor = { *this };
+	replayCommandStream(mReplayStream, executor);
+	mReplayStream.reset();
+
+	flush();
+	resolve();
+
+	std::vector<std::uint32_t>* staging = nullptr;
+	FunctionResult result = mReadback.beginCopy(staging);
+	if (!result.is_successfull) return(result);
+	staging->swap(mResolved);
+	mResolved.resize(static_cast<std::size_t>(mWidth) * mHeight);
+
+	std::uint64_t fenceValue = 0;
+	mReadbackTimeline.signal(fenceValue);
+	mReadback.endCopy(fenceValue, mFrameCount, mWidth, mHeight);
+	++mFrameCount;
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Frame rendered."));
+}
+
+/** Queues a recorded command stream for the next frame. May be called from any thread. */
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::submit(const CommandStream& stream) {
+	std::lock_guard<std::mutex> lock(mStreamMutex);
+	mFrameStream.append(stream);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Command stream queued."));
+}
+
+/** Takes the oldest rendered frame from the readback ring.
+ *
+ * @details
+ * Frames are copied as soon as they are resolved, so one is always ready after render() returns.
+ *
+ * @param[out] frame: Receives the pixels of the frame.
+ * @param[in] wait: Unused, copies complete within render().
+ */
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::readback(ReadbackFrame& frame, bool wait) {
+	std::vector<std::uint32_t>* staging = nullptr;
+	FunctionResult result = mReadback.acquire(staging, frame, wait);
+	if (result.result != RESULT::SSUCCESS) return(result);
+
+	frame.pixels.swap(*staging);
+	mReadback.release();
+	return(FunctionResult(true, RESULT::SSUCCESS, "Frame read back."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::update() {
+	return(FunctionResult(true, RESULT::SSUCCESS, "Succseeful."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::destroy() {
+	mWorkers.reset();
+	return(FunctionResult(true, RESULT::SSUCCESS, "Succseeful."));
+}
+
+/** Reports the rasteriser as the only adapter. */
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::getAdapters(GraphicsAdapterList& adapters) {
+	unsigned int threads = mWorkers != nullptr ? mWorkers->threadCount() + 1 : std::thread::hardware_concurrency();
+	adapters.emplace_back(0, "Syren Software Rasteriser (" + std::to_string(threads) + " threads)");
+	return(FunctionResult(true, RESULT::SSUCCESS, "Adapters returned."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::getOutputs(int, GraphicsOutputList&) {
+	return(FunctionResult(true, RESULT::WSUCCESS, "The software rasteriser has no output devices."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::getDisplayModes(int, int, DisplayModeList&) {
+	return(FunctionResult(true, RESULT::WSUCCESS, "The software rasteriser has no display modes."));
+}
+
+/** Creates a buffer that command streams can reference.
+ *
+ * @param[in] data: Initial contents, or nullptr for a zeroed buffer.
+ * @param[in] size: Size in bytes.
+ *
+ * @retval ResourceId of the new buffer.
+ */
+SyrenEngine::ResourceId SyrenEngine::SoftwareRasteriser::createBuffer(const void* data, std::size_t size) {
+	mBuffers.emplace_back(size);
+	if (data != nullptr && size != 0) std::memcpy(mBuffers.back().data(), data, size);
+	return static_cast<ResourceId>(mBuffers.size());
+}
+
+/** Overwrites part of a buffer. Must not be called while render() is running. */
+SyrenEngine::FunctionResult SyrenEngine::SoftwareRasteriser::updateBuffer(ResourceId buffer, std::size_t offset, const void* data, std::size_t size) {
+	std::vector<unsigned char>* destination = findBuffer(buffer);
+	if (destination == nullptr) return(FunctionResult(false, RESULT::FAIL, "Unknown buffer."));
+	if (!rangeFits(offset, size, destination->size())) return(FunctionResult(false, RESULT::FAIL, "Buffer update out of range."));
+
+	std::memcpy(destination->data() + offset, data, size);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Buffer updated."));
+}
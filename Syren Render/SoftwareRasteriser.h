@@ -0,0 +1,157 @@
+/***********************************************************************************************************
+ * @file SoftwareRasteriser.h
+ *
+ * @brief Implements a multi-threaded tile-binned CPU rasteriser as a graphics API for the Syren Render Engine
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The software rasteriser lets machines without a GPU produce frames and gives a deterministic
+ * reference for correctness and performance work. Submitted command streams are replayed on the
+ * render thread, which clips and sets up triangles and bins them into screen tiles. The tiles are
+ * then rasterised in parallel on a worker pool with SIMD edge functions, a depth test and optional
+ * 4x multisampled coverage. Frames are resolved into a colour buffer and handed to the client through
+ * a readback ring, so the rasteriser is always headless.
+ *
+ * There is no shader stage: vertex buffers hold SoftwareVertex records whose positions are already in
+ * clip space, and colours are interpolated perspective correctly across each triangle.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CommandStream.h"
+#include "CpuTimeline.h"
+#include "GraphicsAPI.h"
+#include "ReadbackRing.h"
+#include "WorkerPool.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	/** Vertex layout consumed by the software rasteriser. */
+	struct SoftwareVertex {
+		float position[4];   /*!< Clip space position */
+		std::uint32_t color; /*!< RGBA8 colour, red in the lowest byte */
+	};
+
+	class SoftwareRasteriser : public GraphicsAPI {
+	public:
+		static const int TileSize = 64;
+
+	private:
+		/** Triangle after clipping and setup, in screen space. */
+		struct Triangle {
+			float edgeA[3];
+			float edgeB[3];
+			double edgeC[3];
+			bool topLeft[3];
+
+			float zA, zB;
+			double zC;
+
+			double attributeA[5]; /*!< 1/w followed by the colour channels divided by w */
+			double attributeB[5];
+			double attributeC[5];
+
+			int minX, minY, maxX, maxY; /*!< Pixel bounds, max exclusive */
+		};
+
+		struct ClipVertex {
+			float position[4];
+			float color[4];
+		};
+
+		struct Rect {
+			int left, top, right, bottom;
+		};
+
+		int mWidth = 800;
+		int mHeight = 600;
+		int mStride = 800;
+		int mSampleCount = 1;
+		int mTilesX = 0;
+		int mTilesY = 0;
+
+		std::vector<float> mDepth;
+		std::vector<std::uint32_t> mColor;
+		std::vector<std::uint32_t> mResolved;
+
+		CpuTimeline mReadbackTimeline;
+		ReadbackRing<std::vector<std::uint32_t> > mReadback;
+
+		std::vector<std::vector<unsigned char> > mBuffers; /*!< Buffer with ResourceId i is stored at i - 1 */
+
+		std::vector<Triangle> mTriangles;
+		std::vector<std::vector<std::uint32_t> > mBins;
+
+		float mViewport[6];
+		Rect mScissor;
+		ResourceId mVertexBuffer = NullResource;
+		std::uint32_t mVertexOffset = 0;
+		std::uint32_t mVertexStride = sizeof(SoftwareVertex);
+		ResourceId mIndexBuffer = NullResource;
+		std::uint32_t mIndexOffset = 0;
+		std::uint32_t mIndexSize = 2;
+
+		std::unique_ptr<WorkerPool> mWorkers;
+
+		std::mutex mStreamMutex;
+		CommandStream mFrameStream;
+		CommandStream mReplayStream;
+
+		std::uint64_t mFrameCount = 0;
+	public:
+		SoftwareRasteriser(const GraphicsConfig& pConfig);
+		~SoftwareRasteriser();
+
+		virtual FunctionResult initialise();
+		virtual FunctionResult onResize();
+		virtual FunctionResult waitForNextFrame();
+		virtual FunctionResult render();
+		virtual FunctionResult submit(const CommandStream& stream);
+		virtual FunctionResult readback(ReadbackFrame& frame, bool wait);
+		virtual FunctionResult update();
+		virtual FunctionResult destroy();
+
+		FunctionResult getAdapters(GraphicsAdapterList& adapters);
+		FunctionResult getOutputs(int index, GraphicsOutputList& outputs);
+		FunctionResult getDisplayModes(int pAdapterIndex, int pOutputIndex, DisplayModeList& pDisplayModes);
+
+		ResourceId createBuffer(const void* data, std::size_t size);
+		FunctionResult updateBuffer(ResourceId buffer, std::size_t offset, const void* data, std::size_t size);
+
+		std::uint64_t frameCount() const { return mFrameCount; }
+	private:
+		SoftwareRasteriser() = delete;
+		SoftwareRasteriser(const SoftwareRasteriser& rhs) = delete;
+		SoftwareRasteriser& operator=(const SoftwareRasteriser& rhs) = delete;
+
+		struct StreamExecutor;
+
+		void resetState();
+		std::vector<unsigned char>* findBuffer(ResourceId id);
+		const std::vector<unsigned char>* findBuffer(ResourceId id) const;
+
+		void drawPrimitives(std::uint32_t count, std::uint32_t first, bool indexed, std::int32_t baseVertex);
+		bool fetchVertex(std::uint32_t index, ClipVertex& vertex) const;
+		void clipAndBin(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2);
+		void setupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2);
+
+		void flush();
+		void rasteriseTile(std::uint32_t tileIndex);
+		void clearColor(std::uint32_t color);
+		void clearDepth(float depth);
+		void resolve();
+	};
+}
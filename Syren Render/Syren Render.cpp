@@ -1,3 +1,4 @@
+#include <cstring>
 #include <fstream>
 
 #include "pch.h"
@@ -6,9 +7,28 @@
 #include "Syren Render.h"
 
 
+namespace {
+    /** Removes the white space around a key or value of render.cfg. */
+    std::string trimConfigText(const std::string& text) {
+        const std::size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string::npos) return std::string();
+
+        const std::size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+}
+
 SyrenEngine::SyrenRender::SyrenRender() {
-    m_is_initialised = FALSE;
+    m_is_initialised = false;
     m_config.GraphicsAPI = API::NONE;
+    m_config.SwapChainBufferCount = 2;
+    m_config.MaxFrameLatency = 1;
+    m_config.SampleCount = 1;
+    m_config.Headless = false;
+    m_config.Width = 800;
+    m_config.Height = 600;
+    m_config.PipelineCachePath = "pipelines.cache";
+    m_config.ShaderArchivePath = "shaders.archive";
 }
 
 bool SyrenEngine::SyrenRender::isInitialised() const {
@@ -17,11 +37,13 @@ bool SyrenEngine::SyrenRender::isInitialised() const {
 
 SyrenEngine::FunctionResult SyrenEngine::SyrenRender::initialise(HWND phMainWnd) {
     FunctionResult initialised = loadConfig(m_config);
+    if (phMainWnd == nullptr) m_config.Headless = true;
+
     if (initialised.is_successfull) {
         if (initialised.result == RESULT::SSUCCESS) { 
             m_API = select_api(m_config.GraphicsAPI, phMainWnd);
             initialised = m_API->initialise();
-            m_is_initialised = TRUE;
+            m_is_initialised = true;
             return (initialised);
         }
     }
@@ -29,11 +51,16 @@ SyrenEngine::FunctionResult SyrenEngine::SyrenRender::initialise(HWND phMainWnd)
     m_config.GraphicsAPI = API::DIRECTX;
     m_API = select_api(API::DIRECTX, phMainWnd);
     initialised = m_API->initialise();
-    m_is_initialised = TRUE;
+    m_is_initialised = true;
 
     return (initialised);
 }
 
+/** Initialises the render engine without a window. Frames are rendered offscreen and read back. */
+SyrenEngine::FunctionResult SyrenEngine::SyrenRender::initialise() {
+    return(initialise(nullptr));
+}
+
 SyrenEngine::FunctionResult SyrenEngine::SyrenRender::onResize() {
     FunctionResult result = m_API->onResize();
     if (!result.is_successfull) return(result);
@@ -41,12 +68,51 @@ SyrenEngine::FunctionResult SyrenEngine::SyrenRender::onResize() {
     return (FunctionResult(true, RESULT::SSUCCESS, "Successfully resized window."));
 }
 
+SyrenEngine::FunctionResult SyrenEngine::SyrenRender::waitForNextFrame() {
+    return(m_API->waitForNextFrame());
+}
+
+SyrenEngine::FunctionResult SyrenEngine::SyrenRender::submit(const CommandStream& stream) {
+    return(m_API->submit(stream));
+}
+
 SyrenEngine::FunctionResult SyrenEngine::SyrenRender::draw() {
     return(m_API->render());
 }
 
-std::shared_ptr<SyrenEngine::GraphicsAPI> SyrenEngine::SyrenRender::select_api(SyrenEngine::API p_api, HWND phMainWnd) {
-    return(std::make_shared<SyrenEngine::DirectX>(phMainWnd));
+/** Takes the oldest rendered frame that has been copied back in headless mode.
+ *
+ * @param[out] frame: Receives the pixels of the frame.
+ * @param[in] wait: Block until the oldest frame has been copied instead of returning straight away.
+ *
+ * @return FunctionResult with RESULT::WSUCCESS if no frame was ready.
+ */
+SyrenEngine::FunctionResult SyrenEngine::SyrenRender::readback(ReadbackFrame& frame, bool wait) {
+    if (!m_is_initialised) return(SyrenEngine::FunctionResult(false, RESULT::FAIL, "Graphics API has not been initialised."));
+    return(m_API->readback(frame, wait));
+}
+
+std::unique_ptr<SyrenEngine::GraphicsAPI> SyrenEngine::SyrenRender::select_api(SyrenEngine::API p_api, HWND phMainWnd) {
+    switch (p_api) {
+#ifdef SYRENRENDER_VULKAN
+    case API::VULKAN:
+        return(std::make_unique<SyrenEngine::Vulkan>(phMainWnd, m_config));
+#endif
+#ifndef _WIN32
+    case API::OPENGL:
+        return(std::make_unique<SyrenEngine::OpenGL>(phMainWnd, m_config));
+#endif
+    case API::SOFTWARE:
+        return(std::make_unique<SyrenEngine::SoftwareRasteriser>(m_config));
+    default:
+#if defined(_WIN32)
+        return(std::make_unique<SyrenEngine::DirectX>(phMainWnd, m_config));
+#elif defined(SYRENRENDER_VULKAN)
+        return(std::make_unique<SyrenEngine::Vulkan>(phMainWnd, m_config));
+#else
+        return(std::make_unique<SyrenEngine::OpenGL>(phMainWnd, m_config));
+#endif
+    }
 }
 
 SyrenEngine::FunctionResult SyrenEngine::SyrenRender::getAdapters(GraphicsAdapterList& adapters) {
@@ -76,8 +142,15 @@ SyrenEngine::FunctionResult SyrenEngine::SyrenRender::loadConfig(GraphicsConfig&
     if (fconfig.is_open()) {
         std::string line;
         while (getline(fconfig, line)) {
-            std::istringstream sin(line.substr(line.find(":") + 1));
-            if (line.find("api") != std::string::npos) {
+            // Entries are "key: value" or "key = value". Keys are compared whole and paths keep their spaces
+            const std::size_t separator = line.find_first_of(":=");
+            if (separator == std::string::npos) continue;
+
+            const std::string key = trimConfigText(line.substr(0, separator));
+            const std::string value = trimConfigText(line.substr(separator + 1));
+            std::istringstream sin(value);
+
+            if (key == "api") {
 
                 std::string api_check;
                 sin >> api_check;
@@ -85,8 +158,45 @@ SyrenEngine::FunctionResult SyrenEngine::SyrenRender::loadConfig(GraphicsConfig&
                 if (api_check == std::string("directx")) config.GraphicsAPI = API::DIRECTX;
                 else if (api_check == std::string("opengl")) config.GraphicsAPI = API::OPENGL;
                 else if (api_check == std::string("vulkan")) config.GraphicsAPI = API::VULKAN;
+                else if (api_check == std::string("software")) config.GraphicsAPI = API::SOFTWARE;
                 else { fconfig.close(); return(FunctionResult(false, RESULT::FAIL, "invalid graphics API entry in render.config.")); }
             }
+            else if (key == "swap_chain_buffers") {
+                int buffers = 0;
+                if (!(sin >> buffers) || buffers < 2 || buffers > 4) { fconfig.close(); return(FunctionResult(false, RESULT::FAIL, "invalid swap_chain_buffers entry in render.config, expected 2 to 4.")); }
+                config.SwapChainBufferCount = buffers;
+            }
+            else if (key == "max_frame_latency") {
+                int latency = 0;
+                if (!(sin >> latency) || latency < 1) { fconfig.close(); return(FunctionResult(false, RESULT::FAIL, "invalid max_frame_latency entry in render.config.")); }
+                config.MaxFrameLatency = latency;
+            }
+            else if (key == "sample_count") {
+                int samples = 0;
+                if (!(sin >> samples) || (samples != 1 && samples != 4)) { fconfig.close(); return(FunctionResult(false, RESULT::FAIL, "invalid sample_count entry in render.config, expected 1 or 4.")); }
+                config.SampleCount = samples;
+            }
+            else if (key == "headless") {
+                int headless = 0;
+                if (!(sin >> headless) || (headless != 0 && headless != 1)) { fconfig.close(); return(FunctionResult(false, RESULT::FAIL, "invalid headless entry in render.config, expected 0 or 1.")); }
+                config.Headless = headless == 1;
+            }
+            else if (key == "width") {
+                int width = 0;
+                if (!(sin >> width) || width < 1 || width > 16384) { fconfig.close(); return(FunctionResult(false, RESULT::FAIL, "invalid width entry in render.config, expected 1 to 16384.")); }
+                config.Width = width;
+            }
+            else if (key == "height") {
+                int height = 0;
+                if (!(sin >> height) || height < 1 || height > 16384) { fconfig.close(); return(FunctionResult(false, RESULT::FAIL, "invalid height entry in render.config, expected 1 to 16384.")); }
+                config.Height = height;
+            }
+            else if (key == "pipeline_cache") {
+                config.PipelineCachePath = value;
+            }
+            else if (key == "shader_archive") {
+                config.ShaderArchivePath = value;
+            }
         }
 
         fconfig.close();
@@ -99,9 +209,13 @@ SyrenEngine::FunctionResult SyrenEngine::SyrenRender::loadConfig(GraphicsConfig&
     std::string message = "Error opening file: render.cfg";
     if (fconfig.bad()) message = message + '\n' + "Fatal error : badbit is set.";
     if (fconfig.fail()) {
+#ifdef _WIN32
         char buffer[1024];
         strerror_s(buffer, sizeof(buffer), errno);
         message = message + '\n' + "Error details: " + buffer;
+#else
+        message = message + '\n' + "Error details: " + std::strerror(errno);
+#endif
     }
     return(FunctionResult(false, RESULT::FAIL, message));
 }
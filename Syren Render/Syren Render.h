@@ -1,4 +1,6 @@
-#ifdef SYRENRENDER_EXPORTS
+#if !defined(_WIN32)
+#define SYRENRENDER_API
+#elif defined(SYRENRENDER_EXPORTS)
 #define SYRENRENDER_API __declspec(dllexport)
 #else
 #define SYRENRENDER_API __declspec(dllimport)
@@ -10,7 +12,15 @@
 
 #include "common.h"
 #include "GraphicsAPI.h"
+#ifdef _WIN32
 #include "DirectX.h"
+#else
+#include "OpenGL.h"
+#endif
+#include "SoftwareRasteriser.h"
+#ifdef SYRENRENDER_VULKAN
+#include "Vulkan.h"
+#endif
 
 
 namespace SyrenEngine {
@@ -19,13 +29,17 @@ namespace SyrenEngine {
 		bool m_is_initialised;
 		
 		GraphicsConfig m_config;
-		std::shared_ptr<GraphicsAPI> m_API;
+		std::unique_ptr<GraphicsAPI> m_API;
 	public:
 		SyrenRender(void);
 
 		FunctionResult initialise(HWND phMainWnd);
+		FunctionResult initialise(void);
 		FunctionResult onResize(void);
+		FunctionResult waitForNextFrame(void);
+		FunctionResult submit(const CommandStream& stream);
 		FunctionResult draw();
+		FunctionResult readback(ReadbackFrame& frame, bool wait = false);
 
 		bool isInitialised() const;
 
@@ -33,7 +47,7 @@ namespace SyrenEngine {
 		FunctionResult getOutputs(int index, GraphicsOutputList& adapters);
 		FunctionResult getDisplayModes(int adapterIndex, int OutputIndex, DisplayModeList& displayModes);
 	private:
-		std::shared_ptr<GraphicsAPI> select_api(SyrenEngine::API p_api, HWND phMainWnd);
+		std::unique_ptr<GraphicsAPI> select_api(SyrenEngine::API p_api, HWND phMainWnd);
 		FunctionResult loadConfig(GraphicsConfig& config);
 	};
 
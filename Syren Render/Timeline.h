@@ -0,0 +1,54 @@
+/***********************************************************************************************************
+ * @file Timeline.h
+ *
+ * @brief Declares the backend-neutral fence timeline used to synchronise the CPU with a queue
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * A timeline is a monotonically increasing 64 bit counter. A queue signals a new value after the work
+ * submitted before it, and the CPU can query or wait for values to complete. Backends implement this
+ * interface over their native fence object. All operations may be called from any thread.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "common.h"
+
+
+namespace SyrenEngine {
+	class Timeline {
+	public:
+		virtual ~Timeline() = default;
+
+		/** Queues a signal of the next timeline value behind all previously submitted work.
+		 *
+		 * @param[out] value: The value that will be reached once the queued work completes.
+		 */
+		virtual FunctionResult signal(std::uint64_t& value) = 0;
+
+		/** Blocks the calling thread until the timeline reaches the given value. */
+		virtual FunctionResult waitForValue(std::uint64_t value) = 0;
+
+		/** Polls the queue for the last value it has reached. */
+		virtual std::uint64_t completedValue() = 0;
+
+		/** Cheap check whether the given value has been reached.
+		 *
+		 * @details
+		 * Answers from the last polled value whenever possible and only polls the queue again when the
+		 * cached value is too old to decide.
+		 */
+		virtual bool isComplete(std::uint64_t value) = 0;
+
+		/** Returns the last value handed out by signal(). */
+		virtual std::uint64_t lastSignaledValue() const = 0;
+	};
+}
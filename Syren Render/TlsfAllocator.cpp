@@ -0,0 +1,243 @@
+/***********************************************************************************************************
+ * @file TlsfAllocator.cpp
+ *
+ * @brief Implements functions of the TlsfAllocator class found in TlsfAllocator.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "TlsfAllocator.h"
+
+#include <bit>
+
+
+/** Constructor for the TlsfAllocator class.
+ *
+ * @param[in] pSize: Size of the managed range, rounded down to the granularity.
+ */
+SyrenEngine::TlsfAllocator::TlsfAllocator(std::uint64_t pSize) {
+	reset(pSize);
+}
+
+/** Forgets every allocation and makes the whole range one free block. */
+void SyrenEngine::TlsfAllocator::reset(std::uint64_t size) {
+	mBlocks.clear();
+	mUnusedBlocks.clear();
+
+	mFirstLevelBitmap = 0;
+	for (std::uint32_t fl = 0; fl < FirstLevelCount; ++fl) {
+		mSecondLevelBitmap[fl] = 0;
+		for (std::uint32_t sl = 0; sl < SecondLevelCount; ++sl)
+			mFreeHeads[fl][sl] = InvalidBlock;
+	}
+
+	mSize = size / Granularity * Granularity;
+	mUsedSize = 0;
+	mAllocationCount = 0;
+	mFreeBlockCount = 0;
+
+	if (mSize == 0) return;
+
+	std::uint32_t block = newBlock();
+	mBlocks[block].offset = 0;
+	mBlocks[block].size = mSize;
+	insertFree(block);
+}
+
+/** Allocates an aligned range.
+ *
+ * @param[in] size: Size of the range, rounded up to the granularity.
+ * @param[in] alignment: Power of two alignment of the offset.
+ * @param[out] offset: Offset of the range.
+ * @param[out] block: Block to pass to free().
+ *
+ * @retval False if no free block is large enough.
+ */
+bool SyrenEngine::TlsfAllocator::allocate(std::uint64_t size, std::uint64_t alignment, std::uint64_t& offset, std::uint32_t& block) {
+	if (size == 0) size = 1;
+	size = (size + Granularity - 1) / Granularity * Granularity;
+	if (alignment < Granularity) alignment = Granularity;
+
+	// Searching for the worst case padding keeps the search O(1) at the cost of skipping blocks that would only just fit
+	std::uint32_t found = findFree(size + alignment - Granularity);
+	if (found == InvalidBlock) return false;
+
+	removeFree(found);
+
+	const std::uint64_t aligned = (mBlocks[found].offset + alignment - 1) & ~(alignment - 1);
+	if (aligned != mBlocks[found].offset) {
+		std::uint32_t padding = found;
+		found = split(padding, aligned - mBlocks[padding].offset);
+		insertFree(padding);
+	}
+
+	if (mBlocks[found].size > size) {
+		std::uint32_t rest = split(found, size);
+		insertFree(rest);
+	}
+
+	mBlocks[found].free = false;
+	mUsedSize += mBlocks[found].size;
+	++mAllocationCount;
+
+	offset = mBlocks[found].offset;
+	block = found;
+	return true;
+}
+
+/** Returns a block to the allocator, merging it with free neighbours. */
+void SyrenEngine::TlsfAllocator::free(std::uint32_t block) {
+	if (block >= mBlocks.size() || mBlocks[block].free) return;
+
+	mUsedSize -= mBlocks[block].size;
+	--mAllocationCount;
+	mBlocks[block].free = true;
+
+	std::uint32_t next = mBlocks[block].nextPhysical;
+	if (next != InvalidBlock && mBlocks[next].free) {
+		removeFree(next);
+		merge(block, next);
+	}
+
+	std::uint32_t prev = mBlocks[block].prevPhysical;
+	if (prev != InvalidBlock && mBlocks[prev].free) {
+		removeFree(prev);
+		merge(prev, block);
+		block = prev;
+	}
+
+	insertFree(block);
+}
+
+/** Finds the size of the largest free block by scanning the highest non-empty bucket. */
+std::uint64_t SyrenEngine::TlsfAllocator::largestFreeBlock() const {
+	if (mFirstLevelBitmap == 0) return 0;
+
+	const std::uint32_t fl = 63 - static_cast<std::uint32_t>(std::countl_zero(mFirstLevelBitmap));
+	const std::uint32_t sl = 31 - static_cast<std::uint32_t>(std::countl_zero(mSecondLevelBitmap[fl]));
+
+	std::uint64_t largest = 0;
+	for (std::uint32_t block = mFreeHeads[fl][sl]; block != InvalidBlock; block = mBlocks[block].nextFree) {
+		if (mBlocks[block].size > largest) largest = mBlocks[block].size;
+	}
+	return largest;
+}
+
+/** Maps a size onto the bucket whose range contains it. */
+void SyrenEngine::TlsfAllocator::mapping(std::uint64_t size, std::uint32_t& firstLevel, std::uint32_t& secondLevel) {
+	firstLevel = 63 - static_cast<std::uint32_t>(std::countl_zero(size));
+	secondLevel = static_cast<std::uint32_t>((size >> (firstLevel - SecondLevelBits)) ^ SecondLevelCount);
+}
+
+/** Takes a block node from the recycled nodes or grows the node vector. */
+std::uint32_t SyrenEngine::TlsfAllocator::newBlock() {
+	std::uint32_t block;
+	if (!mUnusedBlocks.empty()) {
+		block = mUnusedBlocks.back();
+		mUnusedBlocks.pop_back();
+	}
+	else {
+		block = static_cast<std::uint32_t>(mBlocks.size());
+		mBlocks.emplace_back();
+	}
+
+	mBlocks[block] = { 0, 0, InvalidBlock, InvalidBlock, InvalidBlock, InvalidBlock, true };
+	return block;
+}
+
+void SyrenEngine::TlsfAllocator::insertFree(std::uint32_t block) {
+	std::uint32_t fl, sl;
+	mapping(mBlocks[block].size, fl, sl);
+
+	Block& node = mBlocks[block];
+	node.free = true;
+	node.prevFree = InvalidBlock;
+	node.nextFree = mFreeHeads[fl][sl];
+	if (node.nextFree != InvalidBlock) mBlocks[node.nextFree].prevFree = block;
+
+	mFreeHeads[fl][sl] = block;
+	mFirstLevelBitmap |= std::uint64_t(1) << fl;
+	mSecondLevelBitmap[fl] |= 1u << sl;
+	++mFreeBlockCount;
+}
+
+void SyrenEngine::TlsfAllocator::removeFree(std::uint32_t block) {
+	std::uint32_t fl, sl;
+	mapping(mBlocks[block].size, fl, sl);
+
+	Block& node = mBlocks[block];
+	if (node.prevFree != InvalidBlock) mBlocks[node.prevFree].nextFree = node.nextFree;
+	if (node.nextFree != InvalidBlock) mBlocks[node.nextFree].prevFree = node.prevFree;
+
+	if (mFreeHeads[fl][sl] == block) {
+		mFreeHeads[fl][sl] = node.nextFree;
+		if (node.nextFree == InvalidBlock) {
+			mSecondLevelBitmap[fl] &= ~(1u << sl);
+			if (mSecondLevelBitmap[fl] == 0) mFirstLevelBitmap &= ~(std::uint64_t(1) << fl);
+		}
+	}
+
+	node.prevFree = InvalidBlock;
+	node.nextFree = InvalidBlock;
+	--mFreeBlockCount;
+}
+
+/** Finds a free block of at least the given size in the first non-empty bucket above it. */
+std::uint32_t SyrenEngine::TlsfAllocator::findFree(std::uint64_t size) const {
+	std::uint32_t fl, sl;
+	mapping(size, fl, sl);
+
+	// Round up to the next bucket so that every block in the bucket found is large enough
+	const std::uint64_t rounded = size + (std::uint64_t(1) << (fl - SecondLevelBits)) - 1;
+	if (rounded < size) return InvalidBlock;
+	mapping(rounded, fl, sl);
+
+	std::uint32_t secondLevelMap = mSecondLevelBitmap[fl] & (~0u << sl);
+	if (secondLevelMap == 0) {
+		if (fl + 1 >= FirstLevelCount) return InvalidBlock;
+
+		const std::uint64_t firstLevelMap = mFirstLevelBitmap & (~std::uint64_t(0) << (fl + 1));
+		if (firstLevelMap == 0) return InvalidBlock;
+
+		fl = static_cast<std::uint32_t>(std::countr_zero(firstLevelMap));
+		secondLevelMap = mSecondLevelBitmap[fl];
+	}
+
+	sl = static_cast<std::uint32_t>(std::countr_zero(secondLevelMap));
+	return mFreeHeads[fl][sl];
+}
+
+/** Cuts a block in two, keeping the first size bytes in the block and returning the rest as a new block. */
+std::uint32_t SyrenEngine::TlsfAllocator::split(std::uint32_t block, std::uint64_t size) {
+	std::uint32_t rest = newBlock();
+
+	Block& node = mBlocks[block];
+	Block& restNode = mBlocks[rest];
+
+	restNode.offset = node.offset + size;
+	restNode.size = node.size - size;
+	restNode.prevPhysical = block;
+	restNode.nextPhysical = node.nextPhysical;
+	if (restNode.nextPhysical != InvalidBlock) mBlocks[restNode.nextPhysical].prevPhysical = rest;
+
+	node.size = size;
+	node.nextPhysical = rest;
+	return rest;
+}
+
+/** Folds a block into the block physically before it and recycles its node. */
+void SyrenEngine::TlsfAllocator::merge(std::uint32_t block, std::uint32_t next) {
+	Block& node = mBlocks[block];
+	const Block& nextNode = mBlocks[next];
+
+	node.size += nextNode.size;
+	node.nextPhysical = nextNode.nextPhysical;
+	if (node.nextPhysical != InvalidBlock) mBlocks[node.nextPhysical].prevPhysical = block;
+
+	mUnusedBlocks.push_back(next);
+}
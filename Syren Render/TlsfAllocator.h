@@ -0,0 +1,89 @@
+/***********************************************************************************************************
+ * @file TlsfAllocator.h
+ *
+ * @brief Declares a two level segregated fit allocator for offsets within a block of memory
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The allocator never touches the memory it manages; it hands out offsets into a range, which makes it
+ * usable for GPU heaps that the CPU cannot address. Free blocks are kept in lists bucketed by the most
+ * significant bit of their size and a further SecondLevelCount linear subdivisions, and two levels of
+ * bitmaps find a large enough non-empty bucket with a couple of bit scans. Allocation and free are O(1)
+ * and adjacent free blocks are merged straight away.
+ *
+ * Block nodes live in a vector and are recycled, so the allocator itself only allocates while the
+ * number of blocks grows.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace SyrenEngine {
+	class TlsfAllocator {
+	public:
+		static const std::uint32_t InvalidBlock = 0xFFFFFFFFu;
+		static const std::uint64_t Granularity = 256; /*!< Sizes and offsets are multiples of this */
+
+	private:
+		static const std::uint32_t SecondLevelBits = 4;
+		static const std::uint32_t SecondLevelCount = 1u << SecondLevelBits;
+		static const std::uint32_t FirstLevelCount = 64;
+
+		struct Block {
+			std::uint64_t offset;
+			std::uint64_t size;
+			std::uint32_t prevPhysical; /*!< Block right before this one in the range */
+			std::uint32_t nextPhysical; /*!< Block right after this one in the range */
+			std::uint32_t prevFree;
+			std::uint32_t nextFree;
+			bool free;
+		};
+
+		std::vector<Block> mBlocks;
+		std::vector<std::uint32_t> mUnusedBlocks;
+
+		std::uint64_t mFirstLevelBitmap = 0;
+		std::uint32_t mSecondLevelBitmap[FirstLevelCount];
+		std::uint32_t mFreeHeads[FirstLevelCount][SecondLevelCount];
+
+		std::uint64_t mSize = 0;
+		std::uint64_t mUsedSize = 0;
+		std::uint32_t mAllocationCount = 0;
+		std::uint32_t mFreeBlockCount = 0;
+
+	public:
+		explicit TlsfAllocator(std::uint64_t pSize = 0);
+
+		void reset(std::uint64_t size);
+
+		bool allocate(std::uint64_t size, std::uint64_t alignment, std::uint64_t& offset, std::uint32_t& block);
+		void free(std::uint32_t block);
+
+		std::uint64_t size() const { return mSize; }
+		std::uint64_t usedSize() const { return mUsedSize; }
+		std::uint64_t freeSize() const { return mSize - mUsedSize; }
+		std::uint32_t allocationCount() const { return mAllocationCount; }
+		std::uint32_t freeBlockCount() const { return mFreeBlockCount; }
+		std::uint64_t largestFreeBlock() const;
+		std::uint64_t blockSize(std::uint32_t block) const { return mBlocks[block].size; }
+	private:
+		static void mapping(std::uint64_t size, std::uint32_t& firstLevel, std::uint32_t& secondLevel);
+
+		std::uint32_t newBlock();
+		void insertFree(std::uint32_t block);
+		void removeFree(std::uint32_t block);
+		std::uint32_t findFree(std::uint64_t size) const;
+		std::uint32_t split(std::uint32_t block, std::uint64_t size);
+		void merge(std::uint32_t block, std::uint32_t next);
+	};
+}
@@ -0,0 +1,181 @@
+/***********************************************************************************************************
+ * @file UploadBatcher.cpp
+ *
+ * @brief Implements functions of the UploadBatcher class found in UploadBatcher.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "UploadBatcher.h"
+
+#include <cstring>
+
+
+/** Binds the batcher to a copy backend and its staging memory.
+ *
+ * @param[in] pBackend: Backend recording and submitting the copies.
+ * @param[in] pBatchSize: Amount of staged data after which the open batch is submitted.
+ * @param[in] pBatchesInFlight: Number of submitted batches the staging memory is shared between.
+ */
+SyrenEngine::FunctionResult SyrenEngine::UploadBatcher::initialise(CopyBackend* pBackend, std::uint64_t pBatchSize, std::size_t pBatchesInFlight) {
+	if (pBackend == nullptr) return(FunctionResult(false, RESULT::FAIL, "Upload batcher requires a copy backend."));
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mBackend = pBackend;
+	mBatchSize = pBatchSize;
+	mPendingBytes = 0;
+	mPendingCount = 0;
+
+	return(mStaging.initialise(mBackend->timeline(), mBackend->stagingMemory(), 0, mBackend->stagingSize(), pBatchesInFlight));
+}
+
+/** Stages a buffer upload and records its copies into the open batch.
+ *
+ * @details
+ * The data is copied into the staging memory before this returns, so the caller may free it
+ * straight away. An empty upload records nothing and returns an already completed token.
+ *
+ * @param[in] upload: Data and destination of the upload.
+ * @param[out] token: Completes once the data has arrived in the destination.
+ */
+SyrenEngine::FunctionResult SyrenEngine::UploadBatcher::upload(const BufferUpload& upload, UploadToken& token) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mBackend == nullptr) return(FunctionResult(false, RESULT::FAIL, "Upload batcher has not been initialised."));
+
+	const std::uint64_t chunkSize = mStaging.capacity() / 4 / BufferStagingAlignment * BufferStagingAlignment;
+	const unsigned char* data = static_cast<const unsigned char*>(upload.data);
+
+	// An empty upload has nothing to wait for
+	token = CompletedUploadToken;
+
+	for (std::uint64_t offset = 0; offset < upload.size; offset += chunkSize) {
+		BufferUpload chunk = upload;
+		chunk.destinationOffset = upload.destinationOffset + offset;
+		chunk.data = data + offset;
+		chunk.size = upload.size - offset < chunkSize ? upload.size - offset : chunkSize;
+
+		UploadAllocation staging;
+		FunctionResult result = allocateStaging(chunk.size, BufferStagingAlignment, staging);
+		if (!result.is_successfull) return(result);
+
+		std::memcpy(staging.cpuAddress, chunk.data, static_cast<std::size_t>(chunk.size));
+		result = mBackend->copyBuffer(chunk, staging);
+		if (!result.is_successfull) return(result);
+
+		token = openBatchToken();
+		result = recorded(chunk.size);
+		if (!result.is_successfull) return(result);
+	}
+
+	++mUploadCount;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Buffer upload recorded."));
+}
+
+/** Stages a texture upload and records its copies into the open batch.
+ *
+ * @param[in] upload: Subresource data and destination of the upload.
+ * @param[out] token: Completes once the data has arrived in the destination.
+ */
+SyrenEngine::FunctionResult SyrenEngine::UploadBatcher::upload(const TextureUpload& upload, UploadToken& token) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mBackend == nullptr) return(FunctionResult(false, RESULT::FAIL, "Upload batcher has not been initialised."));
+
+	const std::uint64_t size = mBackend->textureStagingSize(upload);
+	if (size > mStaging.capacity()) return(FunctionResult(false, RESULT::FAIL, "Texture upload is larger than the staging memory."));
+
+	UploadAllocation staging;
+	FunctionResult result = allocateStaging(size, TextureStagingAlignment, staging);
+	if (!result.is_successfull) return(result);
+
+	result = mBackend->copyTexture(upload, staging);
+	if (!result.is_successfull) return(result);
+
+	token = openBatchToken();
+	result = recorded(size);
+	if (!result.is_successfull) return(result);
+
+	++mUploadCount;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Texture upload recorded."));
+}
+
+/** Submits the open batch to the copy queue.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if the batch was empty.
+ */
+SyrenEngine::FunctionResult SyrenEngine::UploadBatcher::flush() {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return(flushLocked());
+}
+
+/** Cheap check whether the batch holding an upload has completed on the GPU. */
+bool SyrenEngine::UploadBatcher::isComplete(UploadToken token) const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return(mBackend == nullptr || mBackend->timeline()->isComplete(token));
+}
+
+/** Blocks the calling thread until an upload has completed, submitting its batch first if it is still open. */
+SyrenEngine::FunctionResult SyrenEngine::UploadBatcher::wait(UploadToken token) {
+	FunctionResult result = ensureSubmitted(token);
+	if (!result.is_successfull) return(result);
+
+	return(mBackend->timeline()->waitForValue(token));
+}
+
+/** Submits the open batch if it holds the upload of the given token.
+ *
+ * @details
+ * Called before another queue waits for the token on the GPU, since waiting for a value that is
+ * never signalled would hang that queue.
+ */
+SyrenEngine::FunctionResult SyrenEngine::UploadBatcher::ensureSubmitted(UploadToken token) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mBackend == nullptr) return(FunctionResult(false, RESULT::FAIL, "Upload batcher has not been initialised."));
+	if (token < openBatchToken()) return(FunctionResult(true, RESULT::WSUCCESS, "Upload has already been submitted."));
+
+	return(flushLocked());
+}
+
+/** Allocates staging memory, submitting the open batch first if the ring is full of its data. */
+SyrenEngine::FunctionResult SyrenEngine::UploadBatcher::allocateStaging(std::uint64_t size, std::uint64_t alignment, UploadAllocation& staging) {
+	if (mStaging.allocate(size, alignment, staging))
+		return(FunctionResult(true, RESULT::SSUCCESS, "Staging memory allocated."));
+
+	FunctionResult result = flushLocked();
+	if (!result.is_successfull) return(result);
+
+	if (!mStaging.allocate(size, alignment, staging))
+		return(FunctionResult(false, RESULT::FAIL, "Failed to allocate staging memory for an upload."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Staging memory allocated."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::UploadBatcher::flushLocked() {
+	if (mPendingCount == 0) return(FunctionResult(true, RESULT::WSUCCESS, "No uploads to submit."));
+
+	std::uint64_t fenceValue = 0;
+	FunctionResult result = mBackend->submit(fenceValue);
+	if (!result.is_successfull) return(result);
+
+	result = mStaging.retire(mStaging.cursor(), fenceValue);
+	if (!result.is_successfull) return(result);
+
+	mPendingBytes = 0;
+	mPendingCount = 0;
+	++mBatchCount;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Upload batch submitted."));
+}
+
+/** Accounts for a recorded copy and submits the open batch once it is large enough. */
+SyrenEngine::FunctionResult SyrenEngine::UploadBatcher::recorded(std::uint64_t size) {
+	mPendingBytes += size;
+	++mPendingCount;
+	mUploadedBytes += size;
+
+	if (mPendingBytes < mBatchSize) return(FunctionResult(true, RESULT::SSUCCESS, "Copy recorded."));
+	return(flushLocked());
+}
@@ -0,0 +1,136 @@
+/***********************************************************************************************************
+ * @file UploadBatcher.h
+ *
+ * @brief Declares the batcher that streams buffer and texture data to the GPU over a copy queue
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Uploads are staged in an UploadRing over memory owned by a CopyBackend and recorded into the batch
+ * that is currently open. A batch is submitted to the copy queue once it holds enough data, when the
+ * staging ring runs out of room or when the caller flushes, so many small uploads share one submission
+ * and one fence signal. Buffers larger than a quarter of the staging memory are split over several
+ * copies; textures have to fit into the staging memory as a whole.
+ *
+ * Every upload returns a token, the value the copy timeline reaches once the batch holding it has
+ * completed. The graphics queue can wait for a token on the GPU, so rendering only waits for the data
+ * it actually uses. The batcher is the only code that may signal the copy timeline, which lets it
+ * predict the value of the open batch. All functions may be called from any thread.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "common.h"
+#include "Timeline.h"
+#include "UploadRing.h"
+
+
+namespace SyrenEngine {
+	typedef std::uint64_t UploadToken;
+
+	static const UploadToken CompletedUploadToken = 0;
+	static const std::uint64_t DefaultUploadBatchSize = 8ull << 20;
+	static const std::uint64_t BufferStagingAlignment = 16;
+	static const std::uint64_t TextureStagingAlignment = 512; /*!< Placement alignment of texture data in a buffer */
+
+	/** Copy of a block of memory into a buffer. */
+	struct BufferUpload {
+		void* destination = nullptr; /*!< Backend object receiving the data */
+		std::uint64_t destinationOffset = 0;
+		const void* data = nullptr;
+		std::uint64_t size = 0;
+	};
+
+	/** Memory of one subresource of a texture upload. */
+	struct TextureSubresourceData {
+		const void* data = nullptr;
+		std::int64_t rowPitch = 0;   /*!< Bytes between the starts of two rows */
+		std::int64_t slicePitch = 0; /*!< Bytes between the starts of two depth slices */
+	};
+
+	/** Copy of a range of subresources into a texture. */
+	struct TextureUpload {
+		void* destination = nullptr; /*!< Backend object receiving the data */
+		std::uint32_t firstSubresource = 0;
+		std::uint32_t subresourceCount = 0;
+		const TextureSubresourceData* subresources = nullptr;
+	};
+
+	/** Records and submits copies on a copy queue, implemented by each backend. */
+	class CopyBackend {
+	public:
+		virtual ~CopyBackend() = default;
+
+		/** Timeline signalled by the copy queue after each submitted batch. */
+		virtual Timeline* timeline() = 0;
+
+		/** Mapped memory the uploads are staged in. Stays valid for the lifetime of the backend. */
+		virtual void* stagingMemory() = 0;
+		virtual std::uint64_t stagingSize() const = 0;
+
+		/** Returns how much staging memory a texture upload needs in the layout the backend copies from. */
+		virtual std::uint64_t textureStagingSize(const TextureUpload& upload) = 0;
+
+		/** Records a copy of buffer data that has already been written to the staging memory. */
+		virtual FunctionResult copyBuffer(const BufferUpload& upload, const UploadAllocation& staging) = 0;
+
+		/** Writes texture data into the staging memory in the backend's layout and records its copy. */
+		virtual FunctionResult copyTexture(const TextureUpload& upload, const UploadAllocation& staging) = 0;
+
+		/** Submits the recorded copies and signals the timeline.
+		 *
+		 * @param[out] fenceValue: The value signalled after the copies.
+		 */
+		virtual FunctionResult submit(std::uint64_t& fenceValue) = 0;
+	};
+
+	class UploadBatcher {
+	private:
+		CopyBackend* mBackend = nullptr;
+		UploadRing mStaging;
+		std::uint64_t mBatchSize = DefaultUploadBatchSize;
+
+		std::uint64_t mPendingBytes = 0;
+		std::uint32_t mPendingCount = 0;
+
+		std::uint64_t mBatchCount = 0;
+		std::uint64_t mUploadCount = 0;
+		std::uint64_t mUploadedBytes = 0;
+
+		mutable std::mutex mMutex;
+	public:
+		UploadBatcher() = default;
+
+		FunctionResult initialise(CopyBackend* pBackend, std::uint64_t pBatchSize = DefaultUploadBatchSize, std::size_t pBatchesInFlight = 4);
+
+		FunctionResult upload(const BufferUpload& upload, UploadToken& token);
+		FunctionResult upload(const TextureUpload& upload, UploadToken& token);
+		FunctionResult flush();
+
+		bool isComplete(UploadToken token) const;
+		FunctionResult wait(UploadToken token);
+		FunctionResult ensureSubmitted(UploadToken token);
+
+		std::uint64_t batchCount() const { return mBatchCount; }
+		std::uint64_t uploadCount() const { return mUploadCount; }
+		std::uint64_t uploadedBytes() const { return mUploadedBytes; }
+		std::uint64_t stagingStallCount() const { return mStaging.stallCount(); }
+	private:
+		UploadBatcher(const UploadBatcher& rhs) = delete;
+		UploadBatcher& operator=(const UploadBatcher& rhs) = delete;
+
+		FunctionResult allocateStaging(std::uint64_t size, std::uint64_t alignment, UploadAllocation& staging);
+		FunctionResult flushLocked();
+		FunctionResult recorded(std::uint64_t size);
+		UploadToken openBatchToken() const { return mBackend->timeline()->lastSignaledValue() + 1; }
+	};
+}
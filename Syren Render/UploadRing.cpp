@@ -0,0 +1,113 @@
+/***********************************************************************************************************
+ * @file UploadRing.cpp
+ *
+ * @brief Implements functions of the UploadRing class found in UploadRing.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "UploadRing.h"
+
+
+/** Binds the ring to a mapped buffer and the timeline its frames are signalled on.
+ *
+ * @param[in] pTimeline: Timeline signalled at the end of each frame.
+ * @param[in] pCpuBase: Address the buffer is mapped at.
+ * @param[in] pGpuBase: Address of the buffer on the GPU.
+ * @param[in] pCapacity: Size of the buffer.
+ * @param[in] pFrameCount: Number of frames that may be in flight at once.
+ */
+SyrenEngine::FunctionResult SyrenEngine::UploadRing::initialise(Timeline* pTimeline, void* pCpuBase, std::uint64_t pGpuBase, std::uint64_t pCapacity, std::size_t pFrameCount) {
+	if (pTimeline == nullptr) return(FunctionResult(false, RESULT::FAIL, "Upload ring requires a timeline."));
+	if (pCpuBase == nullptr || pCapacity == 0) return(FunctionResult(false, RESULT::FAIL, "Upload ring requires a mapped buffer."));
+	if (pFrameCount == 0) return(FunctionResult(false, RESULT::FAIL, "Upload ring requires at least one frame in flight."));
+
+	mTimeline = pTimeline;
+	mCpuBase = static_cast<unsigned char*>(pCpuBase);
+	mGpuBase = pGpuBase;
+	mCapacity = pCapacity;
+
+	mHead = 0;
+	mAllocated = 0;
+	mReclaimed = 0;
+
+	// One more entry than frames in flight so that retiring never has to wait on a well paced ring
+	mRetirements.assign(pFrameCount + 1, Retirement{ 0, 0 });
+	mOldest = 0;
+	mRetirementCount = 0;
+	mStallCount = 0;
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the upload ring."));
+}
+
+/** Hands the space allocated up to a cursor over to a submitted frame.
+ *
+ * @param[in] cursor: Value of cursor() taken once the frame had consumed all of its allocations.
+ * @param[in] fenceValue: Timeline value the frame's work completes at.
+ */
+SyrenEngine::FunctionResult SyrenEngine::UploadRing::retire(std::uint64_t cursor, std::uint64_t fenceValue) {
+	const std::uint64_t lastCursor = mRetirementCount > 0
+		? mRetirements[(mOldest + mRetirementCount - 1) % mRetirements.size()].cursor
+		: mReclaimed;
+	if (cursor <= lastCursor) return(FunctionResult(true, RESULT::WSUCCESS, "The frame did not use the upload ring."));
+
+	// A full queue only stalls if its oldest frame has not completed yet
+	if (mRetirementCount == mRetirements.size() && !reclaimOldest(false)) {
+		++mStallCount;
+		if (!reclaimOldest(true)) return(FunctionResult(false, RESULT::FAIL, "Failed to wait for the oldest upload ring frame."));
+	}
+
+	mRetirements[(mOldest + mRetirementCount) % mRetirements.size()] = Retirement{ cursor, fenceValue };
+	++mRetirementCount;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Retired the upload ring frame."));
+}
+
+/** Gives back the space of every frame whose timeline value has completed, without waiting. */
+void SyrenEngine::UploadRing::reclaimCompleted() {
+	while (mRetirementCount > 0 && reclaimOldest(false));
+}
+
+/** Frees enough of the ring for an allocation, waiting for the oldest frames if nothing else helps.
+ *
+ * @retval False if the allocation can never fit, either because it is larger than the ring or
+ *         because the rest of the ring is held by allocations that have not been retired yet.
+ */
+bool SyrenEngine::UploadRing::reclaim(std::uint64_t size, std::uint64_t alignment) {
+	std::uint64_t offset, consumed;
+	if (size > mCapacity) return false;
+
+	reclaimCompleted();
+	while (!place(size, alignment, offset, consumed)) {
+		if (mRetirementCount == 0) return false;
+
+		++mStallCount;
+		if (!reclaimOldest(true)) return false;
+	}
+	return true;
+}
+
+/** Gives back the space of the oldest submitted frame.
+ *
+ * @param[in] wait: Block until the frame completes instead of failing.
+ *
+ * @retval False if the frame has not completed and waiting was not requested or failed.
+ */
+bool SyrenEngine::UploadRing::reclaimOldest(bool wait) {
+	const Retirement& oldest = mRetirements[mOldest];
+	if (!mTimeline->isComplete(oldest.fenceValue)) {
+		if (!wait || !mTimeline->waitForValue(oldest.fenceValue).is_successfull) return false;
+	}
+
+	mReclaimed = oldest.cursor;
+	mOldest = (mOldest + 1) % mRetirements.size();
+	--mRetirementCount;
+
+	// Nothing is in flight or pending, so the next allocation can start at the front again
+	if (mReclaimed == mAllocated) mHead = 0;
+	return true;
+}
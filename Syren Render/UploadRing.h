@@ -0,0 +1,140 @@
+/***********************************************************************************************************
+ * @file UploadRing.h
+ *
+ * @brief Declares the persistently mapped ring that per-frame constants and dynamic geometry are written into
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The ring sub-allocates a CPU visible buffer that stays mapped for its whole lifetime. Allocating is
+ * an align, a compare and an add; when an allocation does not fit before the end of the buffer the
+ * rest of the buffer is skipped and the allocation starts over at offset zero. The backend retires
+ * the space a frame used together with the timeline value of the frame, and that space is reclaimed
+ * once the value completes. Only when the ring is full does an allocation look at the timeline, and it
+ * waits for the oldest frame only if nothing has completed yet.
+ *
+ * The ring does not own the buffer, so it runs without a device against a CpuTimeline. It is not
+ * thread-safe; backends serialise access to it.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common.h"
+#include "Timeline.h"
+
+
+namespace SyrenEngine {
+	static const std::uint64_t DefaultUploadRingSize = 16ull << 20;
+	static const std::uint64_t ConstantBufferAlignment = 256; /*!< Placement alignment of constant buffer views */
+
+	/** A range of the upload ring, valid until the frame it was retired with completes. */
+	struct UploadAllocation {
+		unsigned char* cpuAddress = nullptr;
+		std::uint64_t gpuAddress = 0;
+		std::uint64_t offset = 0; /*!< Offset from the start of the ring buffer */
+		std::uint64_t size = 0;
+	};
+
+	class UploadRing {
+	private:
+		/** End of the space used by a submitted frame. */
+		struct Retirement {
+			std::uint64_t cursor;
+			std::uint64_t fenceValue;
+		};
+
+		Timeline* mTimeline = nullptr;
+		unsigned char* mCpuBase = nullptr;
+		std::uint64_t mGpuBase = 0;
+		std::uint64_t mCapacity = 0;
+
+		std::uint64_t mHead = 0;      /*!< Offset the next allocation starts searching from */
+		std::uint64_t mAllocated = 0; /*!< Bytes consumed since initialisation, including padding */
+		std::uint64_t mReclaimed = 0; /*!< Bytes given back since initialisation */
+
+		std::vector<Retirement> mRetirements; /*!< Circular queue of submitted frames, oldest first */
+		std::size_t mOldest = 0;
+		std::size_t mRetirementCount = 0;
+
+		std::uint64_t mStallCount = 0;
+	public:
+		UploadRing() = default;
+
+		FunctionResult initialise(Timeline* pTimeline, void* pCpuBase, std::uint64_t pGpuBase, std::uint64_t pCapacity, std::size_t pFrameCount);
+
+		/** Allocates an aligned range of the ring.
+		 *
+		 * @param[in] size: Size of the range.
+		 * @param[in] alignment: Power of two alignment of the range, at most the alignment of the buffer.
+		 * @param[out] allocation: The range handed out.
+		 *
+		 * @retval False if the range is larger than the ring or the ring is full with unsubmitted data.
+		 */
+		bool allocate(std::uint64_t size, std::uint64_t alignment, UploadAllocation& allocation) {
+			std::uint64_t offset, consumed;
+			if (!place(size, alignment, offset, consumed)) {
+				if (!reclaim(size, alignment)) return false;
+				place(size, alignment, offset, consumed);
+			}
+
+			mHead = offset + size;
+			mAllocated += consumed;
+
+			allocation.cpuAddress = mCpuBase + offset;
+			allocation.gpuAddress = mGpuBase + offset;
+			allocation.offset = offset;
+			allocation.size = size;
+			return true;
+		}
+
+		/** Allocates a constant buffer aligned range and copies a value into it. */
+		template<typename T>
+		bool upload(const T& value, UploadAllocation& allocation) {
+			if (!allocate(sizeof(T), ConstantBufferAlignment, allocation)) return false;
+
+			std::memcpy(allocation.cpuAddress, &value, sizeof(T));
+			return true;
+		}
+
+		FunctionResult retire(std::uint64_t cursor, std::uint64_t fenceValue);
+		void reclaimCompleted();
+
+		/** Position that retire() takes to hand back everything allocated so far. */
+		std::uint64_t cursor() const { return mAllocated; }
+
+		std::uint64_t gpuAddress(std::uint64_t offset) const { return mGpuBase + offset; }
+		std::uint64_t capacity() const { return mCapacity; }
+		std::uint64_t usedSize() const { return mAllocated - mReclaimed; }
+		std::uint64_t stallCount() const { return mStallCount; }
+	private:
+		UploadRing(const UploadRing& rhs) = delete;
+		UploadRing& operator=(const UploadRing& rhs) = delete;
+
+		/** Finds where an allocation would start and how many bytes it consumes, including skipped space.
+		 *
+		 * @retval False if the bytes consumed do not fit into the free part of the ring.
+		 */
+		bool place(std::uint64_t size, std::uint64_t alignment, std::uint64_t& offset, std::uint64_t& consumed) const {
+			offset = (mHead + alignment - 1) & ~(alignment - 1);
+			consumed = offset + size - mHead;
+			if (offset + size > mCapacity) {
+				offset = 0;
+				consumed = mCapacity - mHead + size;
+			}
+			return(mAllocated + consumed - mReclaimed <= mCapacity);
+		}
+
+		bool reclaim(std::uint64_t size, std::uint64_t alignment);
+		bool reclaimOldest(bool wait);
+	};
+}
@@ -0,0 +1,1048 @@
+/***********************************************************************************************************
+ * @file Vulkan.cpp
+ *
+ * @brief Implements functions of the Vulkan class found in Vulkan.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * A graphics API provides the user with the ability to
+ *  - Initialise the member variables
+ *  - Query the available graphics adapters
+ *  - Query the available output devices for a given adapter
+ *  - Query the available device descriptions for a given output device
+ *  - Run a render loop
+ *  - Update the frames of a render loop
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "Vulkan.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "ScopeGuard.h"
+
+
+namespace {
+	const float LightSteelBlue[4] = { 0.690196097f, 0.768627524f, 0.870588303f, 1.0f };
+
+	/** Records a full barrier moving an image between layouts. */
+	void transitionImage(VkCommandBuffer cmd, VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout, VkImageLayout newLayout) {
+		if (image == VK_NULL_HANDLE || oldLayout == newLayout) return;
+
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange = { aspect, 0, 1, 0, 1 };
+
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+}
+
+
+/***********************************************************************************************************
+ * Vulkan entry and exit member functions
+ *
+ **********************************************************************************************************/
+
+/** Constructor for the Vulkan class.
+ *
+ * @details
+ * Initializes member variables. This prepares the Vulkan object for further configuration and
+ * initialisation.
+ *
+ * @param[in] pWindow: Native window the swap chain presents to, nullptr to render offscreen.
+ * @param[in] pConfig: Graphics configuration providing the swap chain depth and frame latency.
+ */
+SyrenEngine::Vulkan::Vulkan(void* pWindow, const GraphicsConfig& pConfig) {
+	mWindow = pWindow;
+	mHeadless = pConfig.Headless || pWindow == nullptr;
+	mPacing = resolveFramePacing(pConfig);
+	mClientWidth = pConfig.Width > 0 ? pConfig.Width : mClientWidth;
+	mClientHeight = pConfig.Height > 0 ? pConfig.Height : mClientHeight;
+
+	mInstance = VK_NULL_HANDLE;
+	mPhysicalDevice = VK_NULL_HANDLE;
+	mDevice = VK_NULL_HANDLE;
+	mQueue = VK_NULL_HANDLE;
+	mSurface = VK_NULL_HANDLE;
+	mSwapChain = VK_NULL_HANDLE;
+	mDepthStencilBuffer = VK_NULL_HANDLE;
+	mDepthStencilMemory = VK_NULL_HANDLE;
+	mTimeline = nullptr;
+
+	mBackBufferFormat = VK_FORMAT_R8G8B8A8_UNORM;
+	mDepthStencilFormat = VK_FORMAT_D24_UNORM_S8_UINT;
+	mDepthStencilAspect = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+
+	mScreenViewport = {};
+	mScissorRect = {};
+}
+
+/** Destructor for the Vulkan class.
+ *
+ * @details
+ * Waits for the GPU to go idle and destroys the Vulkan objects in reverse order of creation.
+ */
+SyrenEngine::Vulkan::~Vulkan() {
+	if (mDevice != VK_NULL_HANDLE) {
+		vkDeviceWaitIdle(mDevice);
+
+		releaseBackBuffers();
+		releaseFrameResources();
+		for (std::size_t i = 0; i < mReadback.slotCount(); ++i)
+			releaseReadback(mReadback.slot(i).staging);
+
+		if (mSwapChain != VK_NULL_HANDLE) vkDestroySwapchainKHR(mDevice, mSwapChain, nullptr);
+		mSwapChain = VK_NULL_HANDLE;
+
+		mTimeline.reset();
+		vkDestroyDevice(mDevice, nullptr);
+		mDevice = VK_NULL_HANDLE;
+	}
+
+	if (mSurface != VK_NULL_HANDLE) vkDestroySurfaceKHR(mInstance, mSurface, nullptr);
+	if (mInstance != VK_NULL_HANDLE) vkDestroyInstance(mInstance, nullptr);
+}
+
+/***********************************************************************************************************
+ * Vulkan private member functions
+ *
+ **********************************************************************************************************/
+
+/** Creates the Vulkan instance.
+ *
+ * @details
+ * Requires Vulkan 1.2. Surface extensions are only requested when there is a window to present to.
+ * Debug builds enable the Khronos validation layer when it is installed.
+ *
+ * @retval FunctionResult containing the outcome of the instance creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::initialiseInstance() {
+	std::uint32_t apiVersion = VK_API_VERSION_1_0;
+	vkEnumerateInstanceVersion(&apiVersion);
+	if (apiVersion < VK_API_VERSION_1_2) return(FunctionResult(false, RESULT::FAIL, "The Vulkan loader does not support Vulkan 1.2."));
+
+	std::vector<const char*> extensions;
+	std::vector<const char*> layers;
+
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+	if (mWindow != nullptr) {
+		extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+		extensions.push_back(VK_KHR_WIN32_SURFACE_EXTENSION_NAME);
+	}
+#endif
+
+#ifdef _DEBUG
+	std::uint32_t layerCount = 0;
+	vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+	std::vector<VkLayerProperties> availableLayers(layerCount);
+	vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
+
+	for (const VkLayerProperties& layer : availableLayers) {
+		if (std::strcmp(layer.layerName, "VK_LAYER_KHRONOS_validation") == 0) layers.push_back("VK_LAYER_KHRONOS_validation");
+	}
+#endif
+
+	VkApplicationInfo appInfo = {};
+	appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+	appInfo.pApplicationName = "Syren Render";
+	appInfo.pEngineName = "Syren Engine";
+	appInfo.apiVersion = VK_API_VERSION_1_2;
+
+	VkInstanceCreateInfo createInfo = {};
+	createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+	createInfo.pApplicationInfo = &appInfo;
+	createInfo.enabledExtensionCount = static_cast<std::uint32_t>(extensions.size());
+	createInfo.ppEnabledExtensionNames = extensions.data();
+	createInfo.enabledLayerCount = static_cast<std::uint32_t>(layers.size());
+	createInfo.ppEnabledLayerNames = layers.data();
+
+	VkResult vr = vkCreateInstance(&createInfo, nullptr, &mInstance);
+	if (vr != VK_SUCCESS) return(vulkanResult(vr, "Could not create the Vulkan instance."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Vulkan instance created successfully."));
+}
+
+/** Creates the presentation surface for the window.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS when rendering offscreen.
+ */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::initialiseSurface() {
+	if (mHeadless) return(FunctionResult(true, RESULT::WSUCCESS, "Rendering headless into offscreen images."));
+
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+	VkWin32SurfaceCreateInfoKHR createInfo = {};
+	createInfo.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
+	createInfo.hinstance = GetModuleHandle(nullptr);
+	createInfo.hwnd = static_cast<HWND>(mWindow);
+
+	VkResult vr = vkCreateWin32SurfaceKHR(mInstance, &createInfo, nullptr, &mSurface);
+	if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to create the window surface."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created the window surface."));
+#else
+	return(FunctionResult(true, RESULT::WSUCCESS, "Window surfaces are not supported on this platform, rendering offscreen."));
+#endif
+}
+
+/** Selects a physical device and creates the logical device.
+ *
+ * @details
+ * Discrete GPUs are preferred over integrated, virtual and CPU devices, so lavapipe is only used
+ * when it is the sole Vulkan 1.2 device. The chosen device needs a graphics queue that can present
+ * to the surface, and timeline semaphore support.
+ *
+ * @retval FunctionResult indicating the success of the device creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::initialiseDevice() {
+	std::uint32_t deviceCount = 0;
+	vkEnumeratePhysicalDevices(mInstance, &deviceCount, nullptr);
+	std::vector<VkPhysicalDevice> devices(deviceCount);
+	vkEnumeratePhysicalDevices(mInstance, &deviceCount, devices.data());
+
+	int bestScore = -1;
+	for (VkPhysicalDevice device : devices) {
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(device, &properties);
+		if (properties.apiVersion < VK_API_VERSION_1_2) continue;
+
+		VkPhysicalDeviceVulkan12Features features12 = {};
+		features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		VkPhysicalDeviceFeatures2 features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &features12;
+		vkGetPhysicalDeviceFeatures2(device, &features);
+		if (!features12.timelineSemaphore) continue;
+
+		std::uint32_t familyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> families(familyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, families.data());
+
+		for (std::uint32_t family = 0; family < familyCount; ++family) {
+			if (!(families[family].queueFlags & VK_QUEUE_GRAPHICS_BIT)) continue;
+
+			if (mSurface != VK_NULL_HANDLE) {
+				VkBool32 presentSupport = VK_FALSE;
+				vkGetPhysicalDeviceSurfaceSupportKHR(device, family, mSurface, &presentSupport);
+				if (!presentSupport) continue;
+			}
+
+			int score = 0;
+			switch (properties.deviceType) {
+			case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: score = 4; break;
+			case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: score = 3; break;
+			case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: score = 2; break;
+			case VK_PHYSICAL_DEVICE_TYPE_CPU: score = 1; break;
+			default: score = 0; break;
+			}
+
+			if (score > bestScore) {
+				bestScore = score;
+				mPhysicalDevice = device;
+				mQueueFamily = family;
+			}
+			break;
+		}
+	}
+
+	if (mPhysicalDevice == VK_NULL_HANDLE) return(FunctionResult(false, RESULT::FAIL, "No Vulkan 1.2 device with a suitable graphics queue was found."));
+
+	float priority = 1.0f;
+	VkDeviceQueueCreateInfo queueInfo = {};
+	queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+	queueInfo.queueFamilyIndex = mQueueFamily;
+	queueInfo.queueCount = 1;
+	queueInfo.pQueuePriorities = &priority;
+
+	VkPhysicalDeviceVulkan12Features features12 = {};
+	features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	features12.timelineSemaphore = VK_TRUE;
+
+	std::vector<const char*> extensions;
+	if (mSurface != VK_NULL_HANDLE) extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+
+	VkDeviceCreateInfo createInfo = {};
+	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	createInfo.pNext = &features12;
+	createInfo.queueCreateInfoCount = 1;
+	createInfo.pQueueCreateInfos = &queueInfo;
+	createInfo.enabledExtensionCount = static_cast<std::uint32_t>(extensions.size());
+	createInfo.ppEnabledExtensionNames = extensions.data();
+
+	VkResult vr = vkCreateDevice(mPhysicalDevice, &createInfo, nullptr, &mDevice);
+	if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to create the Vulkan device."));
+
+	vkGetDeviceQueue(mDevice, mQueueFamily, 0, &mQueue);
+
+	const VkFormat depthFormats[] = { VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D32_SFLOAT };
+	bool depthFound = false;
+	for (VkFormat format : depthFormats) {
+		VkFormatProperties properties;
+		vkGetPhysicalDeviceFormatProperties(mPhysicalDevice, format, &properties);
+		if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+			mDepthStencilFormat = format;
+			mDepthStencilAspect = format == VK_FORMAT_D32_SFLOAT ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+			depthFound = true;
+			break;
+		}
+	}
+	if (!depthFound) return(FunctionResult(false, RESULT::FAIL, "The Vulkan device supports none of the depth stencil formats."));
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(mPhysicalDevice, &properties);
+	return(FunctionResult(true, RESULT::SSUCCESS, std::string("Successfully created the Vulkan device on ") + properties.deviceName + "."));
+}
+
+/** Creates the timeline semaphore the frames are signalled on. */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::initialiseFence() {
+	mTimeline = std::make_unique<VulkanTimeline>(mDevice, mQueue, &mQueueMutex);
+	return(mTimeline->initialise());
+}
+
+/** Creates the frame ring and a command pool, command buffer and acquire semaphore per frame.
+ *
+ * @details
+ * A frame slot is only reused once its timeline value is reached, so its command pool can be reset
+ * as a whole at the start of the frame without tracking individual command buffers.
+ *
+ * @retval FunctionResult indicating the success of the frame resource creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::initialiseFrameResources() {
+	FunctionResult result = mFrames.initialise(mTimeline.get(), mPacing.framesInFlight);
+	if (!result.is_successfull) return(result);
+
+	for (std::size_t i = 0; i < mFrames.frameCount(); ++i) {
+		VulkanFrameResources& frame = mFrames.slot(i).resources;
+
+		VkCommandPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = mQueueFamily;
+
+		VkResult vr = vkCreateCommandPool(mDevice, &poolInfo, nullptr, &frame.commandPool);
+		if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to create a command pool."));
+
+		VkCommandBufferAllocateInfo allocateInfo = {};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocateInfo.commandPool = frame.commandPool;
+		allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocateInfo.commandBufferCount = 1;
+
+		vr = vkAllocateCommandBuffers(mDevice, &allocateInfo, &frame.commandBuffer);
+		if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to allocate a command buffer."));
+
+		VkSemaphoreCreateInfo semaphoreInfo = {};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		vr = vkCreateSemaphore(mDevice, &semaphoreInfo, nullptr, &frame.imageAcquired);
+		if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to create a semaphore."));
+	}
+
+	result = mReadback.initialise(mTimeline.get(), mPacing.bufferCount);
+	if (!result.is_successfull) return(result);
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created the frame resources."));
+}
+
+/** Creates or recreates the swap chain.
+ *
+ * @details
+ * The image count comes from the graphics configuration, clamped to what the surface supports. The
+ * present mode prefers immediate, then mailbox, then FIFO, matching the DirectX backend which
+ * presents with a sync interval of zero. Frame latency is bounded by the presenter.
+ *
+ * @retval FunctionResult indicating the success of the swap chain creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::initialiseSwapChain() {
+	VkSurfaceCapabilitiesKHR capabilities;
+	VkResult vr = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(mPhysicalDevice, mSurface, &capabilities);
+	if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to query the surface capabilities."));
+
+	std::uint32_t formatCount = 0;
+	vkGetPhysicalDeviceSurfaceFormatsKHR(mPhysicalDevice, mSurface, &formatCount, nullptr);
+	std::vector<VkSurfaceFormatKHR> formats(formatCount);
+	vkGetPhysicalDeviceSurfaceFormatsKHR(mPhysicalDevice, mSurface, &formatCount, formats.data());
+	if (formats.empty()) return(FunctionResult(false, RESULT::FAIL, "The surface reports no formats."));
+
+	VkSurfaceFormatKHR surfaceFormat = formats[0];
+	for (const VkSurfaceFormatKHR& format : formats) {
+		if (format.format == VK_FORMAT_R8G8B8A8_UNORM || format.format == VK_FORMAT_B8G8R8A8_UNORM) {
+			surfaceFormat = format;
+			break;
+		}
+	}
+	mBackBufferFormat = surfaceFormat.format;
+
+	std::uint32_t modeCount = 0;
+	vkGetPhysicalDeviceSurfacePresentModesKHR(mPhysicalDevice, mSurface, &modeCount, nullptr);
+	std::vector<VkPresentModeKHR> modes(modeCount);
+	vkGetPhysicalDeviceSurfacePresentModesKHR(mPhysicalDevice, mSurface, &modeCount, modes.data());
+
+	VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+	if (std::find(modes.begin(), modes.end(), VK_PRESENT_MODE_IMMEDIATE_KHR) != modes.end()) presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+	else if (std::find(modes.begin(), modes.end(), VK_PRESENT_MODE_MAILBOX_KHR) != modes.end()) presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+
+	if (capabilities.currentExtent.width != UINT32_MAX) {
+		mClientWidth = static_cast<int>(capabilities.currentExtent.width);
+		mClientHeight = static_cast<int>(capabilities.currentExtent.height);
+	}
+
+	std::uint32_t imageCount = std::max(static_cast<std::uint32_t>(mPacing.bufferCount), capabilities.minImageCount);
+	if (capabilities.maxImageCount != 0) imageCount = std::min(imageCount, capabilities.maxImageCount);
+
+	VkSwapchainKHR oldSwapChain = mSwapChain;
+
+	VkSwapchainCreateInfoKHR createInfo = {};
+	createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+	createInfo.surface = mSurface;
+	createInfo.minImageCount = imageCount;
+	createInfo.imageFormat = surfaceFormat.format;
+	createInfo.imageColorSpace = surfaceFormat.colorSpace;
+	createInfo.imageExtent = { static_cast<std::uint32_t>(mClientWidth), static_cast<std::uint32_t>(mClientHeight) };
+	createInfo.imageArrayLayers = 1;
+	createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	createInfo.preTransform = capabilities.currentTransform;
+	createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+	createInfo.presentMode = presentMode;
+	createInfo.clipped = VK_TRUE;
+	createInfo.oldSwapchain = oldSwapChain;
+
+	vr = vkCreateSwapchainKHR(mDevice, &createInfo, nullptr, &mSwapChain);
+	if (oldSwapChain != VK_NULL_HANDLE) vkDestroySwapchainKHR(mDevice, oldSwapChain, nullptr);
+	if (vr != VK_SUCCESS) {
+		mSwapChain = VK_NULL_HANDLE;
+		return(vulkanResult(vr, "Failed to create the swap chain."));
+	}
+
+	vkGetSwapchainImagesKHR(mDevice, mSwapChain, &imageCount, nullptr);
+	mBackBuffers.resize(imageCount);
+	vkGetSwapchainImagesKHR(mDevice, mSwapChain, &imageCount, mBackBuffers.data());
+
+	VkSemaphoreCreateInfo semaphoreInfo = {};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	mRenderFinished.assign(imageCount, VK_NULL_HANDLE);
+	for (VkSemaphore& semaphore : mRenderFinished) {
+		vr = vkCreateSemaphore(mDevice, &semaphoreInfo, nullptr, &semaphore);
+		if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to create a semaphore."));
+	}
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created the swap chain."));
+}
+
+/** Creates a ring of offscreen colour images standing in for the swap chain. */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::initialiseOffscreenTargets() {
+	mBackBufferFormat = VK_FORMAT_R8G8B8A8_UNORM;
+	mBackBuffers.assign(mPacing.bufferCount, VK_NULL_HANDLE);
+	mBackBufferMemory.assign(mPacing.bufferCount, VK_NULL_HANDLE);
+
+	for (int i = 0; i < mPacing.bufferCount; ++i) {
+		FunctionResult result = createImage(mBackBufferFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+			mBackBuffers[i], mBackBufferMemory[i]);
+		if (!result.is_successfull) return(result);
+	}
+
+	mCurrBackBuffer = 0;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created the offscreen render targets."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::initialiseDepthStencil() {
+	return(createImage(mDepthStencilFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, mDepthStencilBuffer, mDepthStencilMemory));
+}
+
+/** Blocks until the queue has executed all submitted work. */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::flushCommandQueue() {
+	std::uint64_t fenceValue = 0;
+	FunctionResult result = mTimeline->signal(fenceValue);
+	if (!result.is_successfull) return(result);
+
+	return(mTimeline->waitForValue(fenceValue));
+}
+
+/** Destroys the offscreen images, the per image semaphores and the depth buffer. */
+void SyrenEngine::Vulkan::releaseBackBuffers() {
+	for (VkSemaphore semaphore : mRenderFinished)
+		vkDestroySemaphore(mDevice, semaphore, nullptr);
+	mRenderFinished.clear();
+
+	for (std::size_t i = 0; i < mBackBufferMemory.size(); ++i) {
+		vkDestroyImage(mDevice, mBackBuffers[i], nullptr);
+		vkFreeMemory(mDevice, mBackBufferMemory[i], nullptr);
+	}
+	mBackBufferMemory.clear();
+	mBackBuffers.clear();
+
+	if (mDepthStencilBuffer != VK_NULL_HANDLE) vkDestroyImage(mDevice, mDepthStencilBuffer, nullptr);
+	if (mDepthStencilMemory != VK_NULL_HANDLE) vkFreeMemory(mDevice, mDepthStencilMemory, nullptr);
+	mDepthStencilBuffer = VK_NULL_HANDLE;
+	mDepthStencilMemory = VK_NULL_HANDLE;
+}
+
+void SyrenEngine::Vulkan::releaseFrameResources() {
+	for (std::size_t i = 0; i < mFrames.frameCount(); ++i) {
+		VulkanFrameResources& frame = mFrames.slot(i).resources;
+
+		if (frame.imageAcquired != VK_NULL_HANDLE) vkDestroySemaphore(mDevice, frame.imageAcquired, nullptr);
+		if (frame.commandPool != VK_NULL_HANDLE) vkDestroyCommandPool(mDevice, frame.commandPool, nullptr);
+		frame = VulkanFrameResources();
+	}
+}
+
+/** Finds a memory type allowed by typeBits that has all of the requested properties. */
+void SyrenEngine::Vulkan::releaseReadback(VulkanReadback& staging) {
+	if (staging.memory != VK_NULL_HANDLE) {
+		vkUnmapMemory(mDevice, staging.memory);
+		vkFreeMemory(mDevice, staging.memory, nullptr);
+	}
+	if (staging.buffer != VK_NULL_HANDLE) vkDestroyBuffer(mDevice, staging.buffer, nullptr);
+	staging = VulkanReadback();
+}
+
+/** Records a copy of the current offscreen image into a readback buffer.
+ *
+ * @details
+ * The buffer is reallocated when the frame size changes and stays mapped for its lifetime. Cached
+ * host memory is preferred because the client reads every byte of it.
+ *
+ * @param[in] cmd: Command buffer of the frame, with the back buffer in the transfer source layout.
+ * @param[in] staging: Readback slot claimed for the frame.
+ */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::recordReadback(VkCommandBuffer cmd, VulkanReadback& staging) {
+	const VkDeviceSize size = static_cast<VkDeviceSize>(mClientWidth) * mClientHeight * sizeof(std::uint32_t);
+
+	if (staging.size != size) {
+		releaseReadback(staging);
+
+		VkBufferCreateInfo bufferInfo = {};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = size;
+		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VkResult vr = vkCreateBuffer(mDevice, &bufferInfo, nullptr, &staging.buffer);
+		if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to create a readback buffer."));
+
+		VkMemoryRequirements requirements;
+		vkGetBufferMemoryRequirements(mDevice, staging.buffer, &requirements);
+
+		VkMemoryAllocateInfo allocateInfo = {};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocateInfo.allocationSize = requirements.size;
+
+		const VkMemoryPropertyFlags hostVisible = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		FunctionResult result = findMemoryType(requirements.memoryTypeBits, hostVisible | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, allocateInfo.memoryTypeIndex);
+		if (!result.is_successfull) result = findMemoryType(requirements.memoryTypeBits, hostVisible, allocateInfo.memoryTypeIndex);
+		if (!result.is_successfull) return(result);
+
+		vr = vkAllocateMemory(mDevice, &allocateInfo, nullptr, &staging.memory);
+		if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to allocate readback memory."));
+
+		vr = vkBindBufferMemory(mDevice, staging.buffer, staging.memory, 0);
+		if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to bind readback memory."));
+
+		void* mapping = nullptr;
+		vr = vkMapMemory(mDevice, staging.memory, 0, size, 0, &mapping);
+		if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to map readback memory."));
+
+		staging.mapping = static_cast<const unsigned char*>(mapping);
+		staging.size = size;
+	}
+
+	VkBufferImageCopy region = {};
+	region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+	region.imageExtent = { static_cast<std::uint32_t>(mClientWidth), static_cast<std::uint32_t>(mClientHeight), 1 };
+	vkCmdCopyImageToBuffer(cmd, mBackBuffers[mCurrBackBuffer], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging.buffer, 1, &region);
+
+	VkBufferMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer = staging.buffer;
+	barrier.offset = 0;
+	barrier.size = size;
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Recorded the readback copy."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::findMemoryType(std::uint32_t typeBits, VkMemoryPropertyFlags properties, std::uint32_t& typeIndex) const {
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	vkGetPhysicalDeviceMemoryProperties(mPhysicalDevice, &memoryProperties);
+
+	for (std::uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+		if ((typeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+			typeIndex = i;
+			return(FunctionResult(true, RESULT::SSUCCESS, "Memory type found."));
+		}
+	}
+
+	return(FunctionResult(false, RESULT::FAIL, "No suitable memory type found."));
+}
+
+/** Creates a client sized 2D image in device local memory. */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::createImage(VkFormat format, VkImageUsageFlags usage, VkImage& image, VkDeviceMemory& memory) {
+	VkImageCreateInfo imageInfo = {};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = format;
+	imageInfo.extent = { static_cast<std::uint32_t>(mClientWidth), static_cast<std::uint32_t>(mClientHeight), 1 };
+	imageInfo.mipLevels = 1;
+	imageInfo.arrayLayers = 1;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = usage;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	VkResult vr = vkCreateImage(mDevice, &imageInfo, nullptr, &image);
+	if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to create an image."));
+
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements(mDevice, image, &requirements);
+
+	VkMemoryAllocateInfo allocateInfo = {};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize = requirements.size;
+
+	FunctionResult result = findMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, allocateInfo.memoryTypeIndex);
+	if (!result.is_successfull) return(result);
+
+	vr = vkAllocateMemory(mDevice, &allocateInfo, nullptr, &memory);
+	if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to allocate image memory."));
+
+	vr = vkBindImageMemory(mDevice, image, memory, 0);
+	if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to bind image memory."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Image created."));
+}
+
+VkImage SyrenEngine::Vulkan::resolveResource(ResourceId id) const {
+	if (id == BackBufferResource) return mBackBuffers.empty() ? VK_NULL_HANDLE : mBackBuffers[mCurrBackBuffer];
+	if (id == DepthStencilResource) return mDepthStencilBuffer;
+	return VK_NULL_HANDLE;
+}
+
+/** Builds a failed FunctionResult carrying the VkResult code. */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::vulkanResult(VkResult vr, const char* message) {
+	return(FunctionResult(false, RESULT::FAIL, std::string(message) + " (VkResult " + std::to_string(static_cast<int>(vr)) + ")"));
+}
+
+/** Maps a backend neutral resource state to the image layout it implies.
+ *
+ * @param[in] state: Resource state named by a command stream.
+ * @param[in] offscreen: Whether the back buffer is an offscreen image, which is presented by copying.
+ */
+VkImageLayout SyrenEngine::Vulkan::toVkLayout(ResourceState state, bool offscreen) {
+	switch (state) {
+	case ResourceState::PRESENT: return offscreen ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	case ResourceState::RENDER_TARGET: return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	case ResourceState::DEPTH_WRITE: return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	case ResourceState::DEPTH_READ: return VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+	case ResourceState::SHADER_RESOURCE: return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	case ResourceState::COPY_SOURCE: return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	case ResourceState::COPY_DEST: return VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	default: return VK_IMAGE_LAYOUT_GENERAL;
+	}
+}
+
+/***********************************************************************************************************
+ * Vulkan command stream replay
+ *
+ **********************************************************************************************************/
+
+/** Translates command stream packets into calls on a Vulkan command buffer.
+ *
+ * @details
+ * Image layouts of the back buffer and depth buffer are tracked while replaying, so clears and
+ * barriers transition from the layout the image is actually in. The backend does not create
+ * pipelines yet and Vulkan rejects draws and dispatches without one, so those packets are skipped
+ * along with packets naming resources this backend does not know.
+ */
+struct SyrenEngine::Vulkan::StreamExecutor {
+	const Vulkan& api;
+	VkCommandBuffer cmd;
+	VkImageLayout colorLayout;
+	VkImageLayout depthLayout;
+
+	void transition(ResourceId id, VkImageLayout layout) {
+		if (id == BackBufferResource) {
+			transitionImage(cmd, api.resolveResource(id), VK_IMAGE_ASPECT_COLOR_BIT, colorLayout, layout);
+			colorLayout = layout;
+		}
+		else if (id == DepthStencilResource) {
+			transitionImage(cmd, api.resolveResource(id), api.mDepthStencilAspect, depthLayout, layout);
+			depthLayout = layout;
+		}
+	}
+
+	void execute(const ClearRenderTargetCommand& command) {
+		if (command.target != BackBufferResource) return;
+		transition(BackBufferResource, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+		VkClearColorValue value;
+		std::memcpy(value.float32, command.color, sizeof(value.float32));
+		VkImageSubresourceRange range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		vkCmdClearColorImage(cmd, api.resolveResource(BackBufferResource), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &value, 1, &range);
+	}
+
+	void execute(const ClearDepthStencilCommand& command) {
+		if (command.target != DepthStencilResource) return;
+
+		VkImageAspectFlags aspect = 0;
+		if (command.clearDepth) aspect |= VK_IMAGE_ASPECT_DEPTH_BIT;
+		if (command.clearStencil) aspect |= api.mDepthStencilAspect & VK_IMAGE_ASPECT_STENCIL_BIT;
+		if (aspect == 0) return;
+
+		transition(DepthStencilResource, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+		VkClearDepthStencilValue value = { command.depth, command.stencil };
+		VkImageSubresourceRange range = { aspect, 0, 1, 0, 1 };
+		vkCmdClearDepthStencilImage(cmd, api.mDepthStencilBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &value, 1, &range);
+	}
+
+	/** Flips the viewport so clip space y points up, as it does in Direct3D. */
+	void execute(const SetViewportCommand& command) {
+		VkViewport viewport = { command.x, command.y + command.height, command.width, -command.height, command.minDepth, command.maxDepth };
+		vkCmdSetViewport(cmd, 0, 1, &viewport);
+	}
+
+	void execute(const SetScissorCommand& command) {
+		VkRect2D rect;
+		rect.offset = { std::max(command.left, 0), std::max(command.top, 0) };
+		rect.extent = { static_cast<std::uint32_t>(std::max(command.right - rect.offset.x, 0)), static_cast<std::uint32_t>(std::max(command.bottom - rect.offset.y, 0)) };
+		vkCmdSetScissor(cmd, 0, 1, &rect);
+	}
+
+	void execute(const SetRenderTargetsCommand& command) {
+		for (std::uint32_t i = 0; i < std::min(command.count, MaxCommandRenderTargets); ++i) {
+			if (command.colors[i] == BackBufferResource) transition(BackBufferResource, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+		}
+		if (command.depthStencil == DepthStencilResource) transition(DepthStencilResource, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+	}
+
+	void execute(const SetPipelineCommand&) {}
+	void execute(const SetVertexBufferCommand&) {}
+	void execute(const SetIndexBufferCommand&) {}
+	void execute(const DrawCommand&) {}
+	void execute(const DrawIndexedCommand&) {}
+	void execute(const DispatchCommand&) {}
+
+	void execute(const BarrierCommand& command) {
+		transition(command.resource, toVkLayout(command.after, api.isOffscreen()));
+	}
+
+	void execute(const CopyBufferCommand&) {}
+	void execute(const CopyTextureCommand&) {}
+};
+
+/***********************************************************************************************************
+ * Vulkan public member functions
+ *
+ **********************************************************************************************************/
+
+/** Retrieves a list of available graphics adapters.
+ *
+ * @details
+ * Enumerates the Vulkan physical devices, including CPU implementations such as lavapipe.
+ *
+ * @param[out] adapters: List of graphics adapters discovered.
+ *
+ * @retval FunctionResult indicating the success or failure of retrieving the adapters.
+ */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::getAdapters(GraphicsAdapterList& adapters) {
+	if (mInstance == VK_NULL_HANDLE) return(FunctionResult(false, RESULT::FAIL, "Vulkan has not been initialised."));
+
+	std::uint32_t deviceCount = 0;
+	vkEnumeratePhysicalDevices(mInstance, &deviceCount, nullptr);
+	std::vector<VkPhysicalDevice> devices(deviceCount);
+	vkEnumeratePhysicalDevices(mInstance, &deviceCount, devices.data());
+
+	for (std::uint32_t i = 0; i < deviceCount; ++i) {
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(devices[i], &properties);
+		adapters.emplace_back(static_cast<int>(i), std::string(properties.deviceName));
+	}
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Adapters returned."));
+}
+
+/** Vulkan only exposes displays through VK_KHR_display, which desktop drivers rarely support. */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::getOutputs(int, GraphicsOutputList&) {
+	return(FunctionResult(true, RESULT::WSUCCESS, "Vulkan does not enumerate output devices."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::getDisplayModes(int, int, DisplayModeList&) {
+	return(FunctionResult(true, RESULT::WSUCCESS, "Vulkan does not enumerate display modes."));
+}
+
+/** Initializes Vulkan.
+ *
+ * @details
+ * Calls the necessary initialization functions in sequence and checks for successful completion of
+ * each step. The render targets are created straight away, so frames can be rendered without a
+ * resize event.
+ *
+ * @return FunctionResult indicating success or failure of the initialization process.
+ */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::initialise() {
+	std::string message = "Initialising Vulkan. \n";
+
+	FunctionResult initialised = initialiseInstance();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	initialised = initialiseSurface();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	initialised = initialiseDevice();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	initialised = initialiseFence();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	initialised = initialiseFrameResources();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	initialised = mPacer.initialise(&mPresenter, mPacing);
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	initialised = onResize();
+	message += initialised.message + "\n";
+	if (!initialised.is_successfull) return initialised;
+
+	message += "Initialising Vulkan was successful.";
+
+	return(FunctionResult(true, RESULT::SSUCCESS, message));
+}
+
+/** Recreates the back buffers and the depth buffer for the current client size. */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::onResize() {
+	assert(mDevice != VK_NULL_HANDLE);
+	assert(mTimeline);
+
+	FunctionResult result = flushCommandQueue();
+	if (!result.is_successfull) return(result);
+
+	releaseBackBuffers();
+
+	result = mSurface != VK_NULL_HANDLE ? initialiseSwapChain() : initialiseOffscreenTargets();
+	if (!result.is_successfull) return(result);
+
+	result = initialiseDepthStencil();
+	if (!result.is_successfull) return(result);
+
+	result = mPresenter.initialise(mQueue, &mQueueMutex, mSwapChain, mTimeline.get(), mPacing.maxFrameLatency);
+	if (!result.is_successfull) return(result);
+
+	mScreenViewport = { 0.0f, static_cast<float>(mClientHeight), static_cast<float>(mClientWidth), -static_cast<float>(mClientHeight), 0.0f, 1.0f };
+	mScissorRect = { { 0, 0 }, { static_cast<std::uint32_t>(mClientWidth), static_cast<std::uint32_t>(mClientHeight) } };
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Succseeful."));
+}
+
+/** Blocks until the presentation queue can accept another frame.
+ *
+ * @return FunctionResult with RESULT::WSUCCESS if the wait timed out.
+ */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::waitForNextFrame() {
+	assert(mTimeline);
+	return(mPacer.waitForNextFrame());
+}
+
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::render() {
+	assert(mDevice != VK_NULL_HANDLE);
+	assert(mTimeline);
+	assert(!mBackBuffers.empty());
+
+	VulkanFrameResources* frame = nullptr;
+	FunctionResult result = mFrames.beginFrame(frame);
+	if (!result.is_successfull) return(result);
+
+	bool acquired = false;
+	bool copying = false;
+
+	// Every early return gives the readback slot back and unsignals the semaphore of an acquired image,
+	// which would otherwise still be signalled when the next acquire into it is issued
+	ScopeGuard abandonFrame([&]() {
+		if (copying) mReadback.cancelCopy();
+		if (acquired) {
+			VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+			VkSubmitInfo waitInfo = {};
+			waitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			waitInfo.waitSemaphoreCount = 1;
+			waitInfo.pWaitSemaphores = &frame->imageAcquired;
+			waitInfo.pWaitDstStageMask = &waitStage;
+
+			std::lock_guard<std::mutex> lock(mQueueMutex);
+			vkQueueSubmit(mQueue, 1, &waitInfo, VK_NULL_HANDLE);
+		}
+	});
+
+	if (mSwapChain != VK_NULL_HANDLE) {
+		VkResult vr = vkAcquireNextImageKHR(mDevice, mSwapChain, UINT64_MAX, frame->imageAcquired, VK_NULL_HANDLE, &mCurrBackBuffer);
+		if (vr == VK_ERROR_OUT_OF_DATE_KHR) {
+			result = onResize();
+			if (!result.is_successfull) return(result);
+			return(FunctionResult(true, RESULT::WSUCCESS, "The swap chain was out of date, frame skipped."));
+		}
+		if (vr != VK_SUCCESS && vr != VK_SUBOPTIMAL_KHR) return(vulkanResult(vr, "Failed to acquire a swap chain image."));
+		acquired = true;
+	}
+
+	VkResult vr = vkResetCommandPool(mDevice, frame->commandPool, 0);
+	if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to reset the command pool."));
+
+	VkCommandBuffer cmd = frame->commandBuffer;
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	vr = vkBeginCommandBuffer(cmd, &beginInfo);
+	if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to begin the command buffer."));
+
+	vkCmdSetViewport(cmd, 0, 1, &mScreenViewport);
+	vkCmdSetScissor(cmd, 0, 1, &mScissorRect);
+
+	StreamExecutor executor = { *this, cmd, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_UNDEFINED };
+
+	ClearRenderTargetCommand clearColor = {};
+	clearColor.target = BackBufferResource;
+	std::memcpy(clearColor.color, LightSteelBlue, sizeof(clearColor.color));
+	executor.execute(clearColor);
+
+	ClearDepthStencilCommand clearDepth = {};
+	clearDepth.target = DepthStencilResource;
+	clearDepth.depth = 1.0f;
+	clearDepth.clearDepth = 1;
+	clearDepth.clearStencil = 1;
+	executor.execute(clearDepth);
+
+	{
+		std::lock_guard<std::mutex> lock(mStreamMutex);
+		replayCommandStream(mFrameStream, executor);
+		mFrameStream.reset();
+	}
+
+	executor.transition(BackBufferResource, toVkLayout(ResourceState::PRESENT, isOffscreen()));
+
+	if (isOffscreen()) {
+		VulkanReadback* staging = nullptr;
+		result = mReadback.beginCopy(staging);
+		if (!result.is_successfull) return(result);
+		copying = true;
+
+		result = recordReadback(cmd, *staging);
+		if (!result.is_successfull) return(result);
+	}
+
+	vr = vkEndCommandBuffer(cmd);
+	if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to close the command buffer."));
+
+	VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+	VkSemaphore renderFinished = isOffscreen() ? VK_NULL_HANDLE : mRenderFinished[mCurrBackBuffer];
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.waitSemaphoreCount = isOffscreen() ? 0 : 1;
+	submitInfo.pWaitSemaphores = &frame->imageAcquired;
+	submitInfo.pWaitDstStageMask = &waitStage;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &cmd;
+	submitInfo.signalSemaphoreCount = isOffscreen() ? 0 : 1;
+	submitInfo.pSignalSemaphores = &renderFinished;
+
+	{
+		std::lock_guard<std::mutex> lock(mQueueMutex);
+		vr = vkQueueSubmit(mQueue, 1, &submitInfo, VK_NULL_HANDLE);
+	}
+	if (vr != VK_SUCCESS) return(vulkanResult(vr, "Failed to submit the command buffer."));
+	acquired = false;
+
+	mPresenter.setImage(mCurrBackBuffer, renderFinished);
+	result = mPacer.present();
+	if (!result.is_successfull) return(result);
+
+	std::uint64_t fenceValue = 0;
+	result = mFrames.endFrame(fenceValue);
+	if (!result.is_successfull) return(result);
+
+	mPresenter.trackFrame(fenceValue);
+
+	if (isOffscreen()) mReadback.endCopy(fenceValue, mFrameCount, mClientWidth, mClientHeight);
+	copying = false;
+	abandonFrame.dismiss();
+	++mFrameCount;
+
+	if (isOffscreen()) mCurrBackBuffer = (mCurrBackBuffer + 1) % static_cast<std::uint32_t>(mBackBuffers.size());
+	else if (mPresenter.isOutOfDate()) return(onResize());
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully rendered frame."));
+}
+
+/** Queues a recorded command stream for the next frame.
+ *
+ * @details
+ * May be called from any thread. Submitted streams are replayed in submission order by render().
+ *
+ * @param[in] stream: Stream recorded by the caller.
+ *
+ * @return FunctionResult indicating that the stream was queued.
+ */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::submit(const CommandStream& stream) {
+	std::lock_guard<std::mutex> lock(mStreamMutex);
+	mFrameStream.append(stream);
+	return(FunctionResult(true, RESULT::SSUCCESS, "Command stream queued."));
+}
+
+/** Takes the oldest offscreen frame whose copy has completed.
+ *
+ * @param[out] frame: Receives the pixels of the frame.
+ * @param[in] wait: Block until the oldest copy completes instead of returning straight away.
+ *
+ * @return FunctionResult with RESULT::WSUCCESS if no frame was ready.
+ */
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::readback(ReadbackFrame& frame, bool wait) {
+	if (!isOffscreen()) return(FunctionResult(false, RESULT::FAIL, "Frames can only be read back when rendering headless."));
+
+	VulkanReadback* staging = nullptr;
+	FunctionResult result = mReadback.acquire(staging, frame, wait);
+	if (result.result != RESULT::SSUCCESS) return(result);
+
+	frame.pixels.resize(static_cast<std::size_t>(frame.width) * frame.height);
+	std::memcpy(frame.pixels.data(), staging->mapping, frame.pixels.size() * sizeof(std::uint32_t));
+
+	mReadback.release();
+	return(FunctionResult(true, RESULT::SSUCCESS, "Frame read back."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::update() {
+	return(FunctionResult(true, RESULT::SSUCCESS, "Succseeful."));
+}
+
+SyrenEngine::FunctionResult SyrenEngine::Vulkan::destroy() {
+	return(FunctionResult(true, RESULT::SSUCCESS, "Succseeful."));
+}
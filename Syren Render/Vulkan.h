@@ -0,0 +1,158 @@
+/***********************************************************************************************************
+ * @file Vulkan.h
+ *
+ * @brief Initialises and implements Vulkan as the underlying graphics API for the Syren Render Engine
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The Vulkan backend mirrors the DirectX class: a frame ring on a timeline semaphore, a paced swap
+ * chain, a depth buffer and replay of submitted command streams. It requires Vulkan 1.2 for timeline
+ * semaphores. In headless mode, when no window is given or the platform has no surface support,
+ * frames are rendered into a ring of offscreen images instead, which lets the engine run on Linux
+ * under the lavapipe CPU driver. Each offscreen frame is copied into host visible memory and handed
+ * to the client through a readback ring.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#ifdef _WIN32
+#define VK_USE_PLATFORM_WIN32_KHR
+#endif
+
+#include <vulkan/vulkan.h>
+
+#ifdef _MSC_VER
+#pragma comment(lib, "vulkan-1.lib")
+#endif
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "GraphicsAPI.h"
+#include "CommandStream.h"
+#include "FramePacing.h"
+#include "FrameRing.h"
+#include "ReadbackRing.h"
+#include "VulkanPresenter.h"
+#include "VulkanTimeline.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	/** Resources owned by a single Vulkan frame in flight. */
+	struct VulkanFrameResources {
+		VkCommandPool commandPool = VK_NULL_HANDLE;     /*!< Reset as a whole once the frame has retired */
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		VkSemaphore imageAcquired = VK_NULL_HANDLE;     /*!< Signalled when the swap chain image is available */
+	};
+
+	/** Host visible buffer an offscreen frame is copied into. */
+	struct VulkanReadback {
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		const unsigned char* mapping = nullptr;
+		VkDeviceSize size = 0;
+	};
+
+	class Vulkan : public GraphicsAPI {
+	private:
+		void* mWindow;
+		bool mHeadless;
+
+		int mClientWidth = 800;
+		int mClientHeight = 600;
+
+		VkFormat mBackBufferFormat;
+		VkFormat mDepthStencilFormat;
+		VkImageAspectFlags mDepthStencilAspect;
+
+		FramePacing mPacing;
+		std::uint32_t mCurrBackBuffer = 0;
+
+		FramePacer mPacer;
+		VulkanPresenter mPresenter;
+		FrameRing<VulkanFrameResources> mFrames;
+		ReadbackRing<VulkanReadback> mReadback;
+		std::unique_ptr<VulkanTimeline> mTimeline;
+		std::uint64_t mFrameCount = 0;
+
+		VkInstance mInstance;
+		VkPhysicalDevice mPhysicalDevice;
+		VkDevice mDevice;
+
+		std::uint32_t mQueueFamily = 0;
+		VkQueue mQueue;
+		std::mutex mQueueMutex;
+
+		VkSurfaceKHR mSurface;
+		VkSwapchainKHR mSwapChain;
+
+		std::vector<VkImage> mBackBuffers;
+		std::vector<VkDeviceMemory> mBackBufferMemory; /*!< Only used by offscreen back buffers */
+		std::vector<VkSemaphore> mRenderFinished;     /*!< Signalled per swap chain image when its frame completes */
+
+		VkImage mDepthStencilBuffer;
+		VkDeviceMemory mDepthStencilMemory;
+
+		VkViewport mScreenViewport;
+		VkRect2D mScissorRect;
+
+		std::mutex mStreamMutex;
+		CommandStream mFrameStream; /*!< Streams submitted for the next frame */
+	public:
+		Vulkan(void* pWindow, const GraphicsConfig& pConfig);
+		~Vulkan();
+
+		virtual FunctionResult initialise();
+		virtual FunctionResult onResize();
+		virtual FunctionResult waitForNextFrame();
+		virtual FunctionResult render();
+		virtual FunctionResult submit(const CommandStream& stream);
+		virtual FunctionResult readback(ReadbackFrame& frame, bool wait);
+		virtual FunctionResult update();
+		virtual FunctionResult destroy();
+
+		FunctionResult getAdapters(GraphicsAdapterList& adapters);
+		FunctionResult getOutputs(int index, GraphicsOutputList& outputs);
+		FunctionResult getDisplayModes(int pAdapterIndex, int pOutputIndex, DisplayModeList& pDisplayModes);
+
+		bool isOffscreen() const { return mSwapChain == VK_NULL_HANDLE; }
+	private:
+		Vulkan() = delete;
+		Vulkan(const Vulkan& rhs) = delete;
+		Vulkan& operator=(const Vulkan& rhs) = delete;
+
+		struct StreamExecutor;
+
+		FunctionResult initialiseInstance();
+		FunctionResult initialiseSurface();
+		FunctionResult initialiseDevice();
+		FunctionResult initialiseFence();
+		FunctionResult initialiseFrameResources();
+		FunctionResult initialiseSwapChain();
+		FunctionResult initialiseOffscreenTargets();
+		FunctionResult initialiseDepthStencil();
+
+		FunctionResult flushCommandQueue();
+		void releaseBackBuffers();
+		void releaseFrameResources();
+		void releaseReadback(VulkanReadback& staging);
+		FunctionResult recordReadback(VkCommandBuffer cmd, VulkanReadback& staging);
+
+		FunctionResult findMemoryType(std::uint32_t typeBits, VkMemoryPropertyFlags properties, std::uint32_t& typeIndex) const;
+		FunctionResult createImage(VkFormat format, VkImageUsageFlags usage, VkImage& image, VkDeviceMemory& memory);
+		VkImage resolveResource(ResourceId id) const;
+
+		static FunctionResult vulkanResult(VkResult vr, const char* message);
+		static VkImageLayout toVkLayout(ResourceState state, bool offscreen);
+	};
+}
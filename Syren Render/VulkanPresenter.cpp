@@ -0,0 +1,107 @@
+/***********************************************************************************************************
+ * @file VulkanPresenter.cpp
+ *
+ * @brief Implements functions of the VulkanPresenter class found in VulkanPresenter.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "VulkanPresenter.h"
+
+
+/** Binds the presenter to a queue and, optionally, a swap chain.
+ *
+ * @param[in] pQueue: Queue that presents.
+ * @param[in] pQueueMutex: Mutex guarding submissions to the queue.
+ * @param[in] pSwapChain: Swap chain to present, VK_NULL_HANDLE for offscreen rendering.
+ * @param[in] pTimeline: Timeline the frames are signalled on.
+ * @param[in] pMaxFrameLatency: Number of frames that may be queued for presentation.
+ *
+ * @retval FunctionResult indicating whether the presenter could be bound.
+ */
+SyrenEngine::FunctionResult SyrenEngine::VulkanPresenter::initialise(VkQueue pQueue, std::mutex* pQueueMutex, VkSwapchainKHR pSwapChain, VulkanTimeline* pTimeline, int pMaxFrameLatency) {
+	reset();
+	if (pTimeline == nullptr) return(FunctionResult(false, RESULT::FAIL, "The presenter requires a timeline."));
+
+	mQueue = pQueue;
+	mQueueMutex = pQueueMutex;
+	mSwapChain = pSwapChain;
+	mTimeline = pTimeline;
+	mMaxFrameLatency = pMaxFrameLatency > 0 ? pMaxFrameLatency : 1;
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully initialised the presenter."));
+}
+
+/** Forgets the swap chain and the frames queued for presentation. */
+void SyrenEngine::VulkanPresenter::reset() {
+	mSwapChain = VK_NULL_HANDLE;
+	mWaitSemaphore = VK_NULL_HANDLE;
+	mImageIndex = 0;
+	mOutOfDate = false;
+	mPresentedValues.clear();
+}
+
+/** Selects the swap chain image presented next and the semaphore its rendering signals. */
+void SyrenEngine::VulkanPresenter::setImage(std::uint32_t imageIndex, VkSemaphore waitSemaphore) {
+	mImageIndex = imageIndex;
+	mWaitSemaphore = waitSemaphore;
+}
+
+/** Records the timeline value signalled after the last presented frame. */
+void SyrenEngine::VulkanPresenter::trackFrame(std::uint64_t fenceValue) {
+	mPresentedValues.push_back(fenceValue);
+	while (mPresentedValues.size() > static_cast<std::size_t>(mMaxFrameLatency))
+		mPresentedValues.pop_front();
+}
+
+/** Blocks until fewer than maxFrameLatency presented frames are still executing.
+ *
+ * @param[in] timeoutMs: Longest time to block for.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if the timeout expired.
+ */
+SyrenEngine::FunctionResult SyrenEngine::VulkanPresenter::waitForLatency(std::uint32_t timeoutMs) {
+	if (mTimeline == nullptr) return(FunctionResult(false, RESULT::FAIL, "The presenter has not been initialised."));
+	if (mPresentedValues.size() < static_cast<std::size_t>(mMaxFrameLatency)) return(FunctionResult(true, RESULT::SSUCCESS, "Presentation queue has room."));
+
+	return(mTimeline->waitForValue(mPresentedValues.front(), timeoutMs));
+}
+
+/** Presents the current swap chain image.
+ *
+ * @details
+ * An out of date or suboptimal swap chain is reported as a warning and flagged, so the backend can
+ * recreate it before the next frame.
+ *
+ * @param[in] syncInterval: Unused, the present mode is fixed when the swap chain is created.
+ */
+SyrenEngine::FunctionResult SyrenEngine::VulkanPresenter::present([[maybe_unused]] std::uint32_t syncInterval) {
+	if (mSwapChain == VK_NULL_HANDLE) return(FunctionResult(true, RESULT::SSUCCESS, "Presented."));
+
+	VkPresentInfoKHR presentInfo = {};
+	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+	presentInfo.waitSemaphoreCount = mWaitSemaphore != VK_NULL_HANDLE ? 1 : 0;
+	presentInfo.pWaitSemaphores = &mWaitSemaphore;
+	presentInfo.swapchainCount = 1;
+	presentInfo.pSwapchains = &mSwapChain;
+	presentInfo.pImageIndices = &mImageIndex;
+
+	VkResult vr = VK_SUCCESS;
+	{
+		std::lock_guard<std::mutex> lock(*mQueueMutex);
+		vr = vkQueuePresentKHR(mQueue, &presentInfo);
+	}
+
+	if (vr == VK_ERROR_OUT_OF_DATE_KHR || vr == VK_SUBOPTIMAL_KHR) {
+		mOutOfDate = true;
+		return(FunctionResult(true, RESULT::WSUCCESS, "The swap chain is out of date."));
+	}
+	if (vr != VK_SUCCESS) return(FunctionResult(false, RESULT::FAIL, "Failed to present the swap chain."));
+
+	return(FunctionResult(true, RESULT::SSUCCESS, "Presented."));
+}
@@ -0,0 +1,63 @@
+/***********************************************************************************************************
+ * @file VulkanPresenter.h
+ *
+ * @brief Implements the FramePresenter interface over a Vulkan swap chain or an offscreen image ring
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Vulkan has no equivalent of the DXGI frame latency waitable object, so the presenter bounds the
+ * latency itself. It remembers the timeline value of every presented frame and waitForLatency()
+ * blocks until the frame maxFrameLatency presents ago has finished on the GPU. Without a swap chain
+ * present() only advances that bookkeeping, which keeps offscreen frames paced the same way.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+#include "FramePacing.h"
+#include "VulkanTimeline.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	class VulkanPresenter : public FramePresenter {
+	private:
+		VkQueue mQueue = VK_NULL_HANDLE;
+		std::mutex* mQueueMutex = nullptr;
+		VkSwapchainKHR mSwapChain = VK_NULL_HANDLE;
+		VulkanTimeline* mTimeline = nullptr;
+		int mMaxFrameLatency = 1;
+
+		std::uint32_t mImageIndex = 0;
+		VkSemaphore mWaitSemaphore = VK_NULL_HANDLE;
+		bool mOutOfDate = false;
+
+		std::deque<std::uint64_t> mPresentedValues; /*!< Timeline values of the frames queued for presentation */
+	public:
+		VulkanPresenter() = default;
+
+		FunctionResult initialise(VkQueue pQueue, std::mutex* pQueueMutex, VkSwapchainKHR pSwapChain, VulkanTimeline* pTimeline, int pMaxFrameLatency);
+		void reset();
+
+		void setImage(std::uint32_t imageIndex, VkSemaphore waitSemaphore);
+		void trackFrame(std::uint64_t fenceValue);
+		bool isOutOfDate() const { return mOutOfDate; }
+
+		virtual FunctionResult waitForLatency(std::uint32_t timeoutMs);
+		virtual FunctionResult present(std::uint32_t syncInterval);
+	private:
+		VulkanPresenter(const VulkanPresenter& rhs) = delete;
+		VulkanPresenter& operator=(const VulkanPresenter& rhs) = delete;
+	};
+}
@@ -0,0 +1,158 @@
+/***********************************************************************************************************
+ * @file VulkanTimeline.cpp
+ *
+ * @brief Implements functions of the VulkanTimeline class found in VulkanTimeline.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "VulkanTimeline.h"
+
+
+/** Constructor for the VulkanTimeline class.
+ *
+ * @param[in] pDevice: Device used to create the semaphore.
+ * @param[in] pQueue: Queue that signals the semaphore.
+ * @param[in] pQueueMutex: Mutex guarding submissions to the queue.
+ */
+SyrenEngine::VulkanTimeline::VulkanTimeline(VkDevice pDevice, VkQueue pQueue, std::mutex* pQueueMutex) {
+	mDevice = pDevice;
+	mQueue = pQueue;
+	mQueueMutex = pQueueMutex;
+	mSemaphore = VK_NULL_HANDLE;
+}
+
+/** Destructor for the VulkanTimeline class. No thread may be waiting on the timeline at this point. */
+SyrenEngine::VulkanTimeline::~VulkanTimeline() {
+	if (mSemaphore != VK_NULL_HANDLE) vkDestroySemaphore(mDevice, mSemaphore, nullptr);
+}
+
+/** Creates the timeline semaphore backing the timeline.
+ *
+ * @retval FunctionResult indicating the success of the semaphore creation.
+ */
+SyrenEngine::FunctionResult SyrenEngine::VulkanTimeline::initialise() {
+	VkSemaphoreTypeCreateInfo typeInfo = {};
+	typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	typeInfo.initialValue = 0;
+
+	VkSemaphoreCreateInfo createInfo = {};
+	createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	createInfo.pNext = &typeInfo;
+
+	VkResult vr = vkCreateSemaphore(mDevice, &createInfo, nullptr, &mSemaphore);
+	if (vr != VK_SUCCESS) return(FunctionResult(false, RESULT::FAIL, "Failed to create a timeline semaphore."));
+
+	mLastSignaledValue = 0;
+	mCompletedValue = 0;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Successfully created a timeline semaphore."));
+}
+
+/** Queues a signal of the next timeline value on the queue.
+ *
+ * @details
+ * Submits an empty batch that signals the semaphore. Queue submission order guarantees that the
+ * value is reached only after all previously submitted work has completed.
+ *
+ * @param[out] value: Timeline value that is reached once all previously submitted work completes.
+ *
+ * @retval FunctionResult indicating whether the signal was queued.
+ */
+SyrenEngine::FunctionResult SyrenEngine::VulkanTimeline::signal(std::uint64_t& value) {
+	std::lock_guard<std::mutex> lock(*mQueueMutex);
+
+	std::uint64_t nextValue = mLastSignaledValue.load(std::memory_order_relaxed) + 1;
+
+	VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.signalSemaphoreValueCount = 1;
+	timelineInfo.pSignalSemaphoreValues = &nextValue;
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineInfo;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &mSemaphore;
+
+	VkResult vr = vkQueueSubmit(mQueue, 1, &submitInfo, VK_NULL_HANDLE);
+	if (vr != VK_SUCCESS) return(FunctionResult(false, RESULT::FAIL, "Failed to signal the queue."));
+
+	mLastSignaledValue.store(nextValue, std::memory_order_release);
+	value = nextValue;
+	return(FunctionResult(true, RESULT::SSUCCESS, "Signalled the queue."));
+}
+
+/** Blocks until the semaphore reaches the given value.
+ *
+ * @param[in] value: Timeline value to wait for.
+ *
+ * @retval FunctionResult indicating whether the wait succeeded.
+ */
+SyrenEngine::FunctionResult SyrenEngine::VulkanTimeline::waitForValue(std::uint64_t value) {
+	FunctionResult result = waitForValue(value, UINT32_MAX);
+	if (result.result == RESULT::WSUCCESS) return(FunctionResult(false, RESULT::FAIL, "Timed out waiting for a timeline value."));
+	return(result);
+}
+
+/** Blocks until the semaphore reaches the given value or the timeout expires.
+ *
+ * @param[in] value: Timeline value to wait for.
+ * @param[in] timeoutMs: Longest time to block for, UINT32_MAX to wait without a limit.
+ *
+ * @retval FunctionResult with RESULT::WSUCCESS if the timeout expired.
+ */
+SyrenEngine::FunctionResult SyrenEngine::VulkanTimeline::waitForValue(std::uint64_t value, std::uint32_t timeoutMs) {
+	if (isComplete(value)) return(FunctionResult(true, RESULT::SSUCCESS, "Timeline value reached."));
+
+	if (value > mLastSignaledValue.load(std::memory_order_acquire))
+		return(FunctionResult(false, RESULT::FAIL, "Cannot wait for a timeline value that has not been signalled."));
+
+	VkSemaphoreWaitInfo waitInfo = {};
+	waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores = &mSemaphore;
+	waitInfo.pValues = &value;
+
+	std::uint64_t timeoutNs = timeoutMs == UINT32_MAX ? UINT64_MAX : static_cast<std::uint64_t>(timeoutMs) * 1000000ull;
+
+	VkResult vr = vkWaitSemaphores(mDevice, &waitInfo, timeoutNs);
+	if (vr == VK_TIMEOUT) return(FunctionResult(true, RESULT::WSUCCESS, "Timed out waiting for a timeline value."));
+	if (vr != VK_SUCCESS) return(FunctionResult(false, RESULT::FAIL, "Failed to wait for the timeline semaphore."));
+
+	completedValue();
+	return(FunctionResult(true, RESULT::SSUCCESS, "Timeline value reached."));
+}
+
+/** Polls the semaphore and refreshes the cached completed value.
+ *
+ * @retval The last timeline value reached by the queue.
+ */
+std::uint64_t SyrenEngine::VulkanTimeline::completedValue() {
+	std::uint64_t value = 0;
+	if (vkGetSemaphoreCounterValue(mDevice, mSemaphore, &value) != VK_SUCCESS) return mCompletedValue.load(std::memory_order_relaxed);
+
+	std::uint64_t cached = mCompletedValue.load(std::memory_order_relaxed);
+	while (cached < value && !mCompletedValue.compare_exchange_weak(cached, value, std::memory_order_relaxed));
+
+	return value;
+}
+
+/** Checks whether a timeline value has been reached, polling only when the cache cannot decide. */
+bool SyrenEngine::VulkanTimeline::isComplete(std::uint64_t value) {
+	if (value <= mCompletedValue.load(std::memory_order_relaxed)) return true;
+	return(value <= completedValue());
+}
+
+std::uint64_t SyrenEngine::VulkanTimeline::lastSignaledValue() const {
+	return mLastSignaledValue.load(std::memory_order_acquire);
+}
+
+VkSemaphore SyrenEngine::VulkanTimeline::semaphore() const {
+	return mSemaphore;
+}
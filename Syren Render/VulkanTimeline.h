@@ -0,0 +1,61 @@
+/***********************************************************************************************************
+ * @file VulkanTimeline.h
+ *
+ * @brief Implements the Timeline interface over a Vulkan timeline semaphore signalled by a queue
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Timeline semaphores are core in Vulkan 1.2 and carry the same monotonically increasing value as
+ * an ID3D12Fence, so the frame ring and command recycling work unchanged on top of them. Waits go
+ * straight to vkWaitSemaphores and need no OS events.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "Timeline.h"
+#include "common.h"
+
+
+namespace SyrenEngine {
+	class VulkanTimeline : public Timeline {
+	private:
+		VkDevice mDevice;
+		VkQueue mQueue;
+		std::mutex* mQueueMutex;
+		VkSemaphore mSemaphore;
+
+		std::atomic<std::uint64_t> mLastSignaledValue = 0;
+		std::atomic<std::uint64_t> mCompletedValue = 0; /*!< Last value observed through vkGetSemaphoreCounterValue */
+	public:
+		VulkanTimeline(VkDevice pDevice, VkQueue pQueue, std::mutex* pQueueMutex);
+		~VulkanTimeline();
+
+		FunctionResult initialise();
+
+		virtual FunctionResult signal(std::uint64_t& value);
+		virtual FunctionResult waitForValue(std::uint64_t value);
+		virtual std::uint64_t completedValue();
+		virtual bool isComplete(std::uint64_t value);
+		virtual std::uint64_t lastSignaledValue() const;
+
+		FunctionResult waitForValue(std::uint64_t value, std::uint32_t timeoutMs);
+
+		VkSemaphore semaphore() const;
+	private:
+		VulkanTimeline() = delete;
+		VulkanTimeline(const VulkanTimeline& rhs) = delete;
+		VulkanTimeline& operator=(const VulkanTimeline& rhs) = delete;
+	};
+}
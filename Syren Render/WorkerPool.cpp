@@ -0,0 +1,124 @@
+/***********************************************************************************************************
+ * @file WorkerPool.cpp
+ *
+ * @brief Implements functions of the WorkerPool class found in WorkerPool.h
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include "pch.h"
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <memory>
+
+
+/** Constructor for the WorkerPool class.
+ *
+ * @param[in] pThreadCount: Number of worker threads, 0 for one per hardware thread minus the caller.
+ */
+SyrenEngine::WorkerPool::WorkerPool(unsigned int pThreadCount) {
+	if (pThreadCount == 0) {
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		pThreadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	mThreads.reserve(pThreadCount);
+	for (unsigned int i = 0; i < pThreadCount; ++i)
+		mThreads.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+/** Destructor for the WorkerPool class.
+ *
+ * @details
+ * Finishes the queued tasks and joins the worker threads.
+ */
+SyrenEngine::WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mCondition.notify_all();
+
+	for (std::thread& thread : mThreads)
+		thread.join();
+}
+
+/** Queues a task for the next free worker. */
+void SyrenEngine::WorkerPool::enqueue(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTasks.push_back(std::move(task));
+	}
+	mCondition.notify_one();
+}
+
+/** Runs job(i) for every i in [0, count) across the workers and the calling thread.
+ *
+ * @details
+ * Indices are handed out through a shared counter, so uneven jobs balance themselves. Returns once
+ * every index has been processed.
+ *
+ * @param[in] count: Number of indices.
+ * @param[in] job: Function called once per index.
+ */
+void SyrenEngine::WorkerPool::parallelFor(std::uint32_t count, const std::function<void(std::uint32_t)>& job) {
+	if (count == 0) return;
+	if (count == 1 || mThreads.empty()) {
+		for (std::uint32_t i = 0; i < count; ++i) job(i);
+		return;
+	}
+
+	struct Loop {
+		std::atomic<std::uint32_t> next{ 0 };
+		std::atomic<std::uint32_t> done{ 0 };
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+	std::shared_ptr<Loop> loop = std::make_shared<Loop>();
+
+	auto run = [loop, count, &job]() {
+		std::uint32_t processed = 0;
+		for (std::uint32_t i = loop->next.fetch_add(1); i < count; i = loop->next.fetch_add(1)) {
+			job(i);
+			++processed;
+		}
+
+		if (processed != 0 && loop->done.fetch_add(processed) + processed == count) {
+			std::lock_guard<std::mutex> lock(loop->mutex);
+			loop->finished.notify_all();
+		}
+	};
+
+	std::uint32_t helpers = count - 1 < mThreads.size() ? count - 1 : static_cast<std::uint32_t>(mThreads.size());
+	for (std::uint32_t i = 0; i < helpers; ++i)
+		enqueue(run);
+
+	run();
+
+	std::unique_lock<std::mutex> lock(loop->mutex);
+	loop->finished.wait(lock, [&loop, count]() { return loop->done.load() == count; });
+}
+
+unsigned int SyrenEngine::WorkerPool::threadCount() const {
+	return static_cast<unsigned int>(mThreads.size());
+}
+
+void SyrenEngine::WorkerPool::workerLoop() {
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCondition.wait(lock, [this]() { return mStopping || !mTasks.empty(); });
+			if (mTasks.empty()) return;
+
+			task = std::move(mTasks.front());
+			mTasks.pop_front();
+		}
+		task();
+	}
+}
@@ -0,0 +1,53 @@
+/***********************************************************************************************************
+ * @file WorkerPool.h
+ *
+ * @brief Declares a fixed pool of worker threads shared by the CPU side systems of the renderer
+ *
+ * @ingroup Syren Render
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The pool runs fire-and-forget tasks and fork-join loops. parallelFor() lets the calling thread take
+ * part in the loop, so it never blocks a worker on another worker and can be used from any thread.
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace SyrenEngine {
+	class WorkerPool {
+	private:
+		std::vector<std::thread> mThreads;
+
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		std::deque<std::function<void()> > mTasks;
+		bool mStopping = false;
+
+	public:
+		explicit WorkerPool(unsigned int pThreadCount = 0);
+		~WorkerPool();
+
+		void enqueue(std::function<void()> task);
+		void parallelFor(std::uint32_t count, const std::function<void(std::uint32_t)>& job);
+
+		unsigned int threadCount() const;
+	private:
+		WorkerPool(const WorkerPool& rhs) = delete;
+		WorkerPool& operator=(const WorkerPool& rhs) = delete;
+
+		void workerLoop();
+	};
+}
@@ -1,4 +1,6 @@
-#ifdef SYRENRENDER_EXPORTS
+#if !defined(_WIN32)
+#define SYRENRENDER_API
+#elif defined(SYRENRENDER_EXPORTS)
 #define SYRENRENDER_API __declspec(dllexport)
 #else
 #define SYRENRENDER_API __declspec(dllimport)
@@ -6,28 +8,89 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <fstream>
 #include <sstream>
 
 #include <vector>
+#include <memory>
+#include <utility>
 
 
 namespace SyrenEngine {
-	enum class API { DIRECTX, OPENGL, VULKAN, NONE };
+	enum class API { DIRECTX, OPENGL, VULKAN, SOFTWARE, NONE };
 	enum class RESULT { FAIL = 0, WSUCCESS = 1, SSUCCESS = 2 };
+	enum class ResourceState : unsigned char {
+		COMMON, PRESENT, RENDER_TARGET, DEPTH_WRITE, DEPTH_READ, SHADER_RESOURCE, UNORDERED_ACCESS,
+		COPY_SOURCE, COPY_DEST, VERTEX_BUFFER, INDEX_BUFFER, CONSTANT_BUFFER, INDIRECT_ARGUMENT
+	};
+
+	/** A string literal a ResultMessage can point at without copying it.
+	 *
+	 * @details
+	 * The constructor only runs at compile time, so it takes literals and other text with static storage
+	 * but refuses character buffers on the stack, which would be gone before the message is read.
+	 */
+	class ResultLiteral {
+	private:
+		const char* mText;
+	public:
+		template<std::size_t N>
+		consteval ResultLiteral(const char (&pText)[N]) : mText(pText) {};
+
+		constexpr const char* c_str() const { return mText; }
+	};
+
+	/** Text of a FunctionResult. Literals are referenced in place; any other text is owned. */
+	class SYRENRENDER_API ResultMessage {
+	private:
+		const char* mLiteral;
+		std::string mText;
+	public:
+		explicit ResultMessage(ResultLiteral pLiteral) : mLiteral(pLiteral.c_str()) {};
+		explicit ResultMessage(std::string pText) : mLiteral(nullptr), mText(std::move(pText)) {};
 
+		const char* c_str() const { return mLiteral != nullptr ? mLiteral : mText.c_str(); }
+		std::string str() const { return std::string(c_str()); }
+		operator std::string() const { return str(); }
+		operator std::string_view() const { return std::string_view(c_str()); }
+	};
+
+	inline std::string operator+(const char* lhs, const ResultMessage& rhs) { return std::string(lhs) + rhs.c_str(); }
+	inline std::string operator+(const std::string& lhs, const ResultMessage& rhs) { return lhs + rhs.c_str(); }
+	inline std::string operator+(const ResultMessage& lhs, const char* rhs) { return std::string(lhs.c_str()) + rhs; }
+
+	/** Outcome of a fallible call.
+	 *
+	 * @details
+	 * Results built from a string literal do not allocate, so they are cheap enough for every frame.
+	 * Any other text, composed strings and character pointers alike, is copied into the result. The
+	 * message still reads as a std::string, either implicitly or through str().
+	 */
 	struct SYRENRENDER_API FunctionResult {
 		bool is_successfull;
 		RESULT result;
-		std::string message;
+		ResultMessage message;
+
+		FunctionResult(bool p_is_successfull, RESULT p_result, ResultLiteral p_message) : is_successfull(p_is_successfull), result(p_result), message(p_message) {};
 
-		FunctionResult(bool p_is_successfull, RESULT p_result, const char* p_message) : is_successfull(p_is_successfull), result(p_result), message(p_message) {};
-		FunctionResult(bool p_is_successfull, RESULT p_result, const std::string p_message) : is_successfull(p_is_successfull), result(p_result), message(p_message) {};
+		template<typename Text> requires (!std::is_array_v<std::remove_reference_t<Text>> && std::is_constructible_v<std::string, Text>)
+		FunctionResult(bool p_is_successfull, RESULT p_result, Text&& p_message) : is_successfull(p_is_successfull), result(p_result), message(std::string(std::forward<Text>(p_message))) {};
 	};
 
 	struct GraphicsConfig {
 		API GraphicsAPI;
+		int SwapChainBufferCount; /*!< Number of swap chain buffers, 2 to 4 */
+		int MaxFrameLatency;      /*!< Number of frames that may be queued for presentation */
+		int SampleCount;          /*!< Coverage samples per pixel, 1 or 4 */
+		bool Headless;            /*!< Render into offscreen textures that are read back instead of presented */
+		int Width;                /*!< Width of the render targets in pixels */
+		int Height;               /*!< Height of the render targets in pixels */
+		std::string PipelineCachePath; /*!< File compiled pipelines are kept in between runs, empty to disable */
+		std::string ShaderArchivePath; /*!< Archive written by the Syren Shader Packer */
 	};
 
 	struct GraphicsAdapter {
@@ -54,7 +117,7 @@ namespace SyrenEngine {
 			: index(pIndex), resolutionWidth(pResolutionWidth), resolutionHeight(pResolutionHeight), refreshRate(pRefreshRate) {};
 	};
 
-	typedef std::vector<std::shared_ptr<GraphicsAdapter> > SYRENRENDER_API GraphicsAdapterList;
-	typedef std::vector<std::shared_ptr<GraphicsOutput> > SYRENRENDER_API GraphicsOutputList;
-	typedef std::vector<std::shared_ptr<DisplayMode> > SYRENRENDER_API DisplayModeList;
+	typedef std::vector<GraphicsAdapter> SYRENRENDER_API GraphicsAdapterList;
+	typedef std::vector<GraphicsOutput> SYRENRENDER_API GraphicsOutputList;
+	typedef std::vector<DisplayMode> SYRENRENDER_API DisplayModeList;
 }
@@ -1,5 +1,9 @@
 #pragma once
 
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 // Windows Header Files
 #include <windows.h>
+#else
+typedef void* HWND;                     // Native window handle, there are no window surfaces outside Win32
+#endif
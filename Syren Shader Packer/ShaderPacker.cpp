@@ -0,0 +1,103 @@
+/***********************************************************************************************************
+ * @file ShaderPacker.cpp
+ *
+ * @brief Command line tool that packs compiled shaders into a shader archive and inspects archives
+ *
+ * @ingroup Syren Shader Packer
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Usage:
+ *     ShaderPacker [-c] <archive> <shader>...   Packs the shaders, named after their file names. -c stores
+ *                                               the blobs that compress well LZ compressed.
+ *     ShaderPacker -l <archive>                 Lists and verifies the shaders of an archive.
+ *
+ * The tool only uses the portable parts of Syren Render, so it also builds outside Windows with the
+ * CMake build at the root of the repository.
+ *
+ **********************************************************************************************************/
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "ShaderArchive.h"
+
+
+namespace {
+	int usage() {
+		std::fprintf(stderr, "Usage: ShaderPacker [-c] <archive> <shader>...\n       ShaderPacker -l <archive>\n");
+		return 2;
+	}
+
+	int list(const std::string& path) {
+		SyrenEngine::ShaderArchive archive;
+		SyrenEngine::FunctionResult result = archive.open(path);
+		if (!result.is_successfull) {
+			std::fprintf(stderr, "%s\n", result.message.c_str());
+			return 1;
+		}
+
+		std::uint64_t size = 0;
+		std::uint64_t storedSize = 0;
+		for (std::uint32_t i = 0; i < archive.entryCount(); ++i) {
+			const SyrenEngine::ShaderArchiveEntry entry = archive.entry(i);
+			std::printf("%016" PRIx64 " %10" PRIu64 " %10" PRIu64 " %s\n", entry.key, entry.size, entry.storedSize,
+				entry.compression == SyrenEngine::ShaderCompression::LZ ? "lz" : "none");
+			size += entry.size;
+			storedSize += entry.storedSize;
+		}
+		std::printf("%u shaders, %" PRIu64 " bytes stored as %" PRIu64 " bytes\n", archive.entryCount(), size, storedSize);
+
+		result = archive.verify();
+		std::printf("%s\n", result.message.c_str());
+		return(result.is_successfull ? 0 : 1);
+	}
+
+	int pack(const std::string& path, const std::vector<std::string>& shaders, bool compress) {
+		SyrenEngine::ShaderArchiveWriter writer;
+		for (const std::string& shader : shaders) {
+			std::ifstream file(shader, std::ios::binary);
+			if (!file.is_open()) {
+				std::fprintf(stderr, "Failed to open %s.\n", shader.c_str());
+				return 1;
+			}
+			const std::vector<char> bytecode((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+			SyrenEngine::ShaderKey key = 0;
+			SyrenEngine::FunctionResult result = writer.add(std::filesystem::path(shader).filename().string(), bytecode.data(), bytecode.size(), key);
+			if (!result.is_successfull) {
+				std::fprintf(stderr, "%s\n", result.message.c_str());
+				return 1;
+			}
+			std::printf("%016" PRIx64 " %s\n", key, shader.c_str());
+		}
+
+		SyrenEngine::FunctionResult result = writer.write(path, compress);
+		if (!result.is_successfull) {
+			std::fprintf(stderr, "%s\n", result.message.c_str());
+			return 1;
+		}
+		std::printf("Packed %zu shaders into %zu blobs.\n", shaders.size(), writer.shaderCount());
+		return 0;
+	}
+}
+
+
+int main(int argc, char* argv[]) {
+	if (argc == 3 && std::strcmp(argv[1], "-l") == 0) return list(argv[2]);
+
+	int first = 1;
+	const bool compress = argc > 1 && std::strcmp(argv[1], "-c") == 0;
+	if (compress) ++first;
+	if (argc - first < 2) return usage();
+
+	return pack(argv[first], std::vector<std::string>(argv + first + 1, argv + argc), compress);
+}
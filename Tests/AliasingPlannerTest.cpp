@@ -0,0 +1,176 @@
+/***********************************************************************************************************
+ * @file AliasingPlannerTest.cpp
+ *
+ * @brief Plans hand made, 4K frame and random requests and checks the placements never collide
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "AliasingPlanner.h"
+#include "Check.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	bool livesOverlap(const AliasingRequest& a, const AliasingRequest& b) {
+		return(a.firstUse <= b.lastUse && b.firstUse <= a.lastUse);
+	}
+
+	bool memoryOverlaps(const AliasingRequest& a, const AliasingPlacement& placedA, const AliasingRequest& b, const AliasingPlacement& placedB) {
+		return(placedA.heap == placedB.heap && placedA.offset < placedB.offset + b.size && placedB.offset < placedA.offset + a.size);
+	}
+
+	/** Checks every placement against every other one and against the heaps the planner reports. */
+	int checkPlacements(const AliasingPlanner& planner, std::uint64_t maxHeapSize, const std::vector<AliasingRequest>& requests, const std::vector<AliasingPlacement>& placements) {
+		CHECK(placements.size() == requests.size());
+
+		const std::vector<std::uint64_t>& heaps = planner.heapSizes();
+		std::uint64_t requestedSize = 0;
+		std::uint64_t plannedSize = 0;
+		for (std::uint64_t heapSize : heaps) {
+			if (maxHeapSize != 0) CHECK(heapSize <= maxHeapSize);
+			plannedSize += heapSize;
+		}
+
+		for (std::size_t i = 0; i < requests.size(); ++i) {
+			const AliasingRequest& request = requests[i];
+			const AliasingPlacement& placement = placements[i];
+			requestedSize += request.size;
+
+			CHECK(placement.heap < heaps.size());
+			CHECK(placement.offset % request.alignment == 0);
+			CHECK(placement.offset + request.size <= heaps[placement.heap]);
+
+			// The aliased request is the latest earlier user of any of the memory
+			std::uint32_t latest = AliasingNone;
+			std::uint32_t earlierUsers = 0;
+			for (std::size_t j = 0; j < requests.size(); ++j) {
+				if (j == i || !memoryOverlaps(request, placement, requests[j], placements[j])) continue;
+				CHECK(!livesOverlap(request, requests[j]));
+				if (requests[j].lastUse >= request.firstUse) continue;
+
+				++earlierUsers;
+				if (latest == AliasingNone || requests[j].lastUse > requests[latest].lastUse) latest = static_cast<std::uint32_t>(j);
+			}
+
+			if (placement.aliases == AliasingNone) {
+				CHECK(earlierUsers == 0);
+			} else if (placement.aliases == AliasingMany) {
+				CHECK(earlierUsers > 1);
+			} else {
+				CHECK(earlierUsers > 0);
+				CHECK(requests[placement.aliases].lastUse == requests[latest].lastUse);
+				CHECK(memoryOverlaps(request, placement, requests[placement.aliases], placements[placement.aliases]));
+			}
+		}
+
+		CHECK(planner.requestedSize() == requestedSize);
+		CHECK(planner.plannedSize() == plannedSize);
+		return 0;
+	}
+
+	int testSharingAndHandOver() {
+		const std::vector<AliasingRequest> requests = {
+			{ 1024, 256, 0, 1 },
+			{ 1024, 256, 2, 3 }, // Takes over the first request
+			{ 512, 256, 1, 2 },  // Alive alongside both
+			{ 100, 64, 4, 4 },
+		};
+
+		AliasingPlanner planner;
+		std::vector<AliasingPlacement> placements;
+		CHECK(planner.plan(requests, placements).is_successfull);
+		CHECK(checkPlacements(planner, 0, requests, placements) == 0);
+
+		CHECK(planner.heapSizes().size() == 1);
+		CHECK(placements[0].offset == placements[1].offset);
+		CHECK(placements[0].aliases == AliasingNone);
+		CHECK(placements[1].aliases == 0);
+		CHECK(placements[2].offset == 1024);
+		CHECK(planner.plannedSize() == 1536);
+		return 0;
+	}
+
+	int testRejectedRequests() {
+		AliasingPlanner planner(4096);
+		std::vector<AliasingPlacement> placements;
+
+		CHECK(!planner.plan({ { 64, 64, 3, 2 } }, placements).is_successfull);
+		CHECK(!planner.plan({ { 64, 64, 0, 0 }, { 4097, 64, 0, 0 } }, placements).is_successfull);
+		CHECK(planner.plan({ { 4096, 64, 0, 0 }, { 4096, 64, 0, 0 } }, placements).is_successfull);
+		CHECK(planner.heapSizes().size() == 2);
+		return 0;
+	}
+
+	/** A 4K deferred frame: depth, three G-buffer targets and the post-processing chain, RGBA16F sized. */
+	int testDeferredFrame() {
+		const std::uint64_t Target = 3840ull * 2160 * 8;
+		const std::uint64_t Alignment = 65536;
+
+		// Lifetimes are the steps GBuffer, SSAO, SSAOBlur, Light, Bloom0 to Bloom2, Tonemap, FXAA and Present
+		const std::vector<AliasingRequest> requests = {
+			{ Target, Alignment, 0, 1 },      // Depth
+			{ Target, Alignment, 0, 3 },      // G-buffer A
+			{ Target, Alignment, 0, 3 },      // G-buffer B
+			{ Target, Alignment, 0, 3 },      // G-buffer C
+			{ Target, Alignment, 1, 2 },      // SSAO
+			{ Target, Alignment, 2, 3 },      // SSAO blur
+			{ Target, Alignment, 3, 7 },      // Lighting
+			{ Target >> 2, Alignment, 4, 5 }, // Bloom, quarter size
+			{ Target >> 4, Alignment, 5, 6 },
+			{ Target >> 6, Alignment, 6, 7 },
+			{ Target, Alignment, 7, 8 },      // Tonemap
+			{ Target, Alignment, 8, 9 },      // FXAA
+		};
+
+		AliasingPlanner planner;
+		std::vector<AliasingPlacement> placements;
+		CHECK(planner.plan(requests, placements).is_successfull);
+		CHECK(checkPlacements(planner, 0, requests, placements) == 0);
+
+		// Five full targets are alive during the lighting step, so nothing can do better than that
+		CHECK(planner.requestedSize() / 1048576 == 590);
+		CHECK(planner.plannedSize() >= 5 * Target);
+		CHECK(planner.plannedSize() / 1048576 == 316);
+		return 0;
+	}
+
+	int testRandomRequests(std::uint64_t maxHeapSize, int requestCount, unsigned seed) {
+		const std::uint64_t alignments[] = { 256, 4096, 65536, 4u << 20 };
+
+		std::mt19937 random(seed);
+		std::vector<AliasingRequest> requests(requestCount);
+		for (AliasingRequest& request : requests) {
+			request.alignment = alignments[random() % 4];
+			request.size = (random() % 4096 + 1) * 65536 - random() % 256;
+			request.firstUse = random() % 200;
+			request.lastUse = request.firstUse + random() % 20;
+		}
+
+		AliasingPlanner planner(maxHeapSize);
+		std::vector<AliasingPlacement> placements;
+		CHECK(planner.plan(requests, placements).is_successfull);
+		CHECK(checkPlacements(planner, maxHeapSize, requests, placements) == 0);
+		CHECK(planner.plannedSize() < planner.requestedSize());
+		if (maxHeapSize != 0) CHECK(planner.heapSizes().size() > 1);
+		return 0;
+	}
+}
+
+int main() {
+	if (testSharingAndHandOver() != 0) return 1;
+	if (testRejectedRequests() != 0) return 1;
+	if (testDeferredFrame() != 0) return 1;
+	if (testRandomRequests(0, 2000, 1) != 0) return 1;
+	if (testRandomRequests(512ull << 20, 1000, 2) != 0) return 1;
+	return 0;
+}
@@ -0,0 +1,147 @@
+/***********************************************************************************************************
+ * @file BindlessTableTest.cpp
+ *
+ * @brief Allocates and frees bindless slots against a CPU timeline and checks stale handles are caught
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <vector>
+
+#include "BindlessTable.h"
+#include "Check.h"
+#include "CpuTimeline.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	int testInitialise() {
+		CpuTimeline timeline;
+		BindlessTable table;
+		CHECK(!table.initialise(nullptr, 16).is_successfull);
+		CHECK(!table.initialise(&timeline, 0).is_successfull);
+		CHECK(!table.initialise(&timeline, MaxBindlessCount + 1).is_successfull);
+		CHECK(table.initialise(&timeline, MaxBindlessCount).is_successfull);
+		CHECK(table.capacity() == MaxBindlessCount);
+		return 0;
+	}
+
+	int testFullTable() {
+		const std::uint32_t Capacity = 64;
+
+		CpuTimeline timeline;
+		BindlessTable table;
+		CHECK(table.initialise(&timeline, Capacity).is_successfull);
+
+		std::vector<bool> seen(Capacity, false);
+		for (std::uint32_t i = 0; i < Capacity; ++i) {
+			BindlessHandle handle;
+			CHECK(table.allocate(handle).is_successfull);
+			CHECK(handle != InvalidBindlessHandle);
+			CHECK(table.isValid(handle));
+			CHECK(!seen[BindlessTable::index(handle)]);
+			seen[BindlessTable::index(handle)] = true;
+		}
+
+		BindlessHandle handle = InvalidBindlessHandle;
+		CHECK(!table.allocate(handle).is_successfull);
+		CHECK(table.liveCount() == Capacity);
+		return 0;
+	}
+
+	int testStaleHandles() {
+		CpuTimeline timeline;
+		BindlessTable table;
+		CHECK(table.initialise(&timeline, 4).is_successfull);
+
+		BindlessHandle handle;
+		CHECK(table.allocate(handle).is_successfull);
+		const BindlessHandle kept = handle;
+
+		std::uint64_t value;
+		CHECK(timeline.signal(value).is_successfull);
+		CHECK(table.free(handle, value).is_successfull);
+		CHECK(handle == InvalidBindlessHandle);
+		CHECK(table.liveCount() == 0);
+
+		// The copy kept past the free is stale, and freeing it again changes nothing
+		CHECK(!table.isValid(kept));
+		BindlessHandle stale = kept;
+		CHECK(table.free(stale, value).result == RESULT::FAIL);
+		CHECK(stale == kept);
+
+		// The slot comes back under a new generation, which the old handle does not match
+		BindlessHandle reused;
+		CHECK(table.allocate(reused).is_successfull);
+		CHECK(BindlessTable::index(reused) == BindlessTable::index(kept));
+		CHECK(BindlessTable::generation(reused) != BindlessTable::generation(kept));
+		CHECK(table.isValid(reused));
+		CHECK(!table.isValid(kept));
+
+		CHECK(!table.isValid(InvalidBindlessHandle));
+		CHECK(!table.isValid((BindlessTable::generation(reused) << BindlessIndexBits) | 4));
+		return 0;
+	}
+
+	/** Freed slots stay out of use until the frames that may still index them have completed. */
+	int testDeferredReuse() {
+		CpuTimeline timeline;
+		BindlessTable table;
+		CHECK(table.initialise(&timeline, 2).is_successfull);
+
+		BindlessHandle first, second;
+		CHECK(table.allocate(first).is_successfull);
+		CHECK(table.allocate(second).is_successfull);
+		const std::uint32_t slot = BindlessTable::index(first);
+
+		const std::uint64_t frame = timeline.reserve();
+		CHECK(table.free(first, frame).is_successfull);
+		CHECK(table.liveCount() == 1);
+
+		BindlessHandle handle;
+		CHECK(!table.allocate(handle).is_successfull);
+
+		timeline.complete(frame);
+		CHECK(table.allocate(handle).is_successfull);
+		CHECK(BindlessTable::index(handle) == slot);
+		return 0;
+	}
+
+	/** Generations wrap past the top of their bits to 1, so slot 0 never yields InvalidBindlessHandle. */
+	int testGenerationWrap() {
+		const std::uint32_t GenerationCount = 0xFFFFFFFFu >> BindlessIndexBits;
+
+		CpuTimeline timeline;
+		BindlessTable table;
+		CHECK(table.initialise(&timeline, 1).is_successfull);
+
+		for (std::uint32_t i = 0; i < 2 * GenerationCount + 2; ++i) {
+			BindlessHandle handle;
+			CHECK(table.allocate(handle).is_successfull);
+			CHECK(handle != InvalidBindlessHandle);
+			CHECK(BindlessTable::index(handle) == 0);
+			CHECK(BindlessTable::generation(handle) == i % GenerationCount + 1);
+			CHECK(table.isValid(handle));
+
+			std::uint64_t value;
+			CHECK(timeline.signal(value).is_successfull);
+			CHECK(table.free(handle, value).is_successfull);
+		}
+		return 0;
+	}
+}
+
+int main() {
+	if (testInitialise() != 0) return 1;
+	if (testFullTable() != 0) return 1;
+	if (testStaleHandles() != 0) return 1;
+	if (testDeferredReuse() != 0) return 1;
+	if (testGenerationWrap() != 0) return 1;
+	return 0;
+}
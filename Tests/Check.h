@@ -0,0 +1,26 @@
+/***********************************************************************************************************
+ * @file Check.h
+ *
+ * @brief Declares the check macro the Syren Render tests report failures with
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+
+#pragma once
+
+#include <cstdio>
+
+
+/** Fails the enclosing test function, which returns int, if the condition does not hold. */
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			return 1; \
+		} \
+	} while (0)
@@ -0,0 +1,112 @@
+/***********************************************************************************************************
+ * @file CommandStreamTest.cpp
+ *
+ * @brief Loads recorded and crafted command streams and checks which ones are accepted
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Loading used to check the packet headers only, so a stream naming more render targets than a packet
+ * holds made the executors read past the packet and write past their own arrays.
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Check.h"
+#include "CommandStream.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	/** Returns the serialised form of a stream holding one packet, changed by the caller. */
+	template<typename Command, typename Change>
+	std::vector<unsigned char> craft(Change change) {
+		CommandStream stream;
+		Command& command = stream.push<Command>();
+		change(command);
+		return std::vector<unsigned char>(stream.data(), stream.data() + stream.size());
+	}
+
+	bool loads(const std::vector<unsigned char>& data) {
+		CommandStream stream;
+		return stream.load(data.data(), data.size()).is_successfull;
+	}
+
+	int testRecordedStreamLoads() {
+		const float black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+		const ResourceId colors[MaxCommandRenderTargets + 2] = {};
+
+		CommandStream recorded;
+		recorded.clearRenderTarget(BackBufferResource, black);
+		recorded.clearDepthStencil(DepthStencilResource, 1.0f, 0, true, false);
+		recorded.setRenderTargets(MaxCommandRenderTargets + 2, colors, DepthStencilResource);
+		recorded.setVertexBuffer(MaxCommandVertexBuffers - 1, UploadRingResource, 0, 64, 16);
+		recorded.setIndexBuffer(UploadRingResource, 0, 64, 2);
+		recorded.barrier(BackBufferResource, ResourceState::RENDER_TARGET, ResourceState::INDIRECT_ARGUMENT);
+		recorded.copyBuffer(1, 0, 2, 0, 64);
+		recorded.draw(3);
+
+		CommandStream loaded;
+		CHECK(loaded.load(recorded.data(), recorded.size()).is_successfull);
+		CHECK(loaded.commandCount() == recorded.commandCount());
+		CHECK(loaded.size() == recorded.size());
+		CHECK(std::memcmp(loaded.data(), recorded.data(), recorded.size()) == 0);
+		return 0;
+	}
+
+	int testCraftedPayloadsAreRejected() {
+		CHECK(loads(craft<SetRenderTargetsCommand>([](SetRenderTargetsCommand& c) { c.count = MaxCommandRenderTargets; })));
+		CHECK(!loads(craft<SetRenderTargetsCommand>([](SetRenderTargetsCommand& c) { c.count = MaxCommandRenderTargets + 1; })));
+		CHECK(!loads(craft<SetRenderTargetsCommand>([](SetRenderTargetsCommand& c) { c.count = 0xFFFFFFFFu; })));
+
+		CHECK(!loads(craft<SetVertexBufferCommand>([](SetVertexBufferCommand& c) { c.slot = MaxCommandVertexBuffers; })));
+		CHECK(!loads(craft<SetIndexBufferCommand>([](SetIndexBufferCommand& c) { c.indexSize = 3; })));
+		CHECK(!loads(craft<ClearDepthStencilCommand>([](ClearDepthStencilCommand& c) { c.clearStencil = 2; })));
+
+		CHECK(!loads(craft<BarrierCommand>([](BarrierCommand& c) {
+			c.before = ResourceState::COMMON;
+			c.after = static_cast<ResourceState>(static_cast<unsigned char>(ResourceState::INDIRECT_ARGUMENT) + 1);
+		})));
+		return 0;
+	}
+
+	int testCraftedHeadersAreRejected() {
+		std::vector<unsigned char> data = craft<DrawCommand>([](DrawCommand&) {});
+		CHECK(loads(data));
+
+		CommandHeader header;
+		std::memcpy(&header, data.data(), sizeof(header));
+
+		CommandHeader unknown = header;
+		unknown.type = CommandType::COUNT;
+		std::vector<unsigned char> crafted = data;
+		std::memcpy(crafted.data(), &unknown, sizeof(unknown));
+		CHECK(!loads(crafted));
+
+		CommandHeader oversized = header;
+		oversized.size = static_cast<std::uint16_t>(header.size + CommandAlignment);
+		crafted = data;
+		std::memcpy(crafted.data(), &oversized, sizeof(oversized));
+		crafted.resize(crafted.size() + CommandAlignment);
+		CHECK(!loads(crafted));
+
+		crafted = data;
+		crafted.pop_back();
+		CHECK(!loads(crafted));
+		return 0;
+	}
+}
+
+int main() {
+	if (testRecordedStreamLoads() != 0) return 1;
+	if (testCraftedPayloadsAreRejected() != 0) return 1;
+	if (testCraftedHeadersAreRejected() != 0) return 1;
+	return 0;
+}
@@ -0,0 +1,130 @@
+/***********************************************************************************************************
+ * @file DeferredReleaseQueueTest.cpp
+ *
+ * @brief Retires objects from several threads into the deferred release queue and checks when they come out
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "CpuTimeline.h"
+#include "DeferredReleaseQueue.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	std::atomic<std::uint64_t> gAllocationCount(0);
+}
+
+void* operator new(std::size_t size) {
+	gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size != 0 ? size : 1)) return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+
+namespace {
+	/** Six producers retire objects stamped with the frame being recorded while a fake GPU completes frames. */
+	int testConcurrentRetire() {
+		const int ProducerCount = 6;
+		const int RetiresPerProducer = 200000;
+
+		CpuTimeline timeline;
+		DeferredReleaseQueue<std::uint64_t> queue(&timeline);
+
+		std::atomic<bool> stop(false);
+		std::vector<std::thread> producers;
+		for (int p = 0; p < ProducerCount; ++p) {
+			producers.emplace_back([&]() {
+				for (int i = 0; i < RetiresPerProducer; ++i) {
+					const std::uint64_t value = timeline.lastSignaledValue() + 1;
+					queue.retire(value, value);
+				}
+			});
+		}
+
+		std::thread gpu([&]() {
+			while (!stop.load()) {
+				const std::uint64_t value = timeline.reserve();
+				std::this_thread::sleep_for(std::chrono::microseconds(50));
+				timeline.complete(value);
+			}
+		});
+
+		const std::uint64_t total = static_cast<std::uint64_t>(ProducerCount) * RetiresPerProducer;
+		std::uint64_t released = 0;
+		std::uint64_t early = 0;
+		while (released < total) {
+			released += queue.collect([&](std::uint64_t& value) {
+				if (!timeline.isComplete(value)) ++early;
+			});
+		}
+
+		stop.store(true);
+		gpu.join();
+		for (std::thread& producer : producers)
+			producer.join();
+
+		CHECK(released == total);
+		CHECK(early == 0);
+		CHECK(queue.size() == 0);
+
+		queue.retire(1, timeline.lastSignaledValue() + 1);
+		CHECK(queue.collect([](std::uint64_t&) {}) == 0);
+		CHECK(queue.drain([](std::uint64_t&) {}) == 1);
+		CHECK(queue.size() == 0);
+		return 0;
+	}
+
+	/** Once the pool holds a few frames worth of nodes, retiring and collecting do not allocate. */
+	int testSteadyStateAllocations() {
+		const std::uint64_t FramesInFlight = 2;
+		const int RetiresPerFrame = 500;
+
+		CpuTimeline timeline;
+		DeferredReleaseQueue<std::uint64_t> queue(&timeline);
+
+		std::uint64_t released = 0;
+		std::uint64_t allocations = 0;
+		for (int frame = 0; frame < 1000; ++frame) {
+			// The first frames grow the pool; count from there on
+			if (frame == 10) allocations = gAllocationCount.load();
+
+			const std::uint64_t value = timeline.lastSignaledValue() + 1;
+			for (int i = 0; i < RetiresPerFrame; ++i)
+				queue.retire(value, value);
+
+			released += queue.collect([](std::uint64_t&) {});
+
+			// The frame goes in flight and the oldest one in flight completes
+			if (timeline.reserve() > FramesInFlight) timeline.complete(value - FramesInFlight);
+		}
+
+		CHECK(gAllocationCount.load() == allocations);
+		CHECK(released + queue.size() == 1000ull * RetiresPerFrame);
+		CHECK(queue.size() <= (FramesInFlight + 1) * RetiresPerFrame);
+		return 0;
+	}
+}
+
+int main() {
+	if (testConcurrentRetire() != 0) return 1;
+	if (testSteadyStateAllocations() != 0) return 1;
+	return 0;
+}
@@ -0,0 +1,160 @@
+/***********************************************************************************************************
+ * @file DescriptorAllocatorTest.cpp
+ *
+ * @brief Hands out descriptor indices from several threads and checks none is handed out twice
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "DescriptorAllocator.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	/** Eight threads allocate and free at random, each claiming an owner flag for every index it holds. */
+	int testConcurrentFreeList() {
+		const std::uint32_t Capacity = 1024;
+		const int ThreadCount = 8;
+		const int OperationsPerThread = 1000000;
+		const std::size_t MaxHeld = 100;
+
+		DescriptorFreeList list;
+		list.initialise(Capacity);
+
+		std::vector<std::atomic<int>> owners(Capacity);
+		std::atomic<std::uint64_t> errors(0);
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < ThreadCount; ++t) {
+			threads.emplace_back([&, t]() {
+				std::mt19937 random(t);
+				std::vector<DescriptorIndex> held;
+				for (int i = 0; i < OperationsPerThread; ++i) {
+					if (held.empty() || (held.size() < MaxHeld && (random() & 1))) {
+						DescriptorIndex index;
+						if (!list.allocate(index)) continue;
+						if (index >= Capacity || owners[index].exchange(1) != 0) ++errors;
+						held.push_back(index);
+					} else {
+						const std::size_t k = random() % held.size();
+						DescriptorIndex index = held[k];
+						held[k] = held.back();
+						held.pop_back();
+						if (owners[index].exchange(0) != 1) ++errors;
+						list.free(index);
+						if (index != InvalidDescriptor) ++errors;
+					}
+				}
+
+				for (DescriptorIndex index : held) {
+					owners[index].store(0);
+					list.free(index);
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		CHECK(errors.load() == 0);
+		CHECK(list.allocatedCount() == 0);
+
+		// Every index is back on the list exactly once
+		std::vector<bool> seen(Capacity, false);
+		DescriptorIndex index;
+		for (std::uint32_t i = 0; i < Capacity; ++i) {
+			CHECK(list.allocate(index));
+			CHECK(!seen[index]);
+			seen[index] = true;
+		}
+		CHECK(!list.allocate(index));
+		CHECK(list.allocatedCount() == Capacity);
+
+		DescriptorIndex invalid = InvalidDescriptor;
+		list.free(invalid);
+		CHECK(list.allocatedCount() == Capacity);
+		return 0;
+	}
+
+	int testEmptyFreeList() {
+		DescriptorFreeList list;
+		list.initialise(0);
+
+		DescriptorIndex index = 7;
+		CHECK(!list.allocate(index));
+		CHECK(index == 7);
+		return 0;
+	}
+
+	/** Ranges taken from several threads stay inside the segment of the frame and never overlap. */
+	int testRingSegments() {
+		const std::uint32_t Capacity = 3000;
+		const std::size_t FrameCount = 3;
+
+		DescriptorRing ring;
+		CHECK(!ring.initialise(2, FrameCount).is_successfull);
+		CHECK(ring.initialise(Capacity, FrameCount).is_successfull);
+		CHECK(ring.segmentSize() == 1000);
+
+		for (std::size_t frame = 0; frame < FrameCount * 2; ++frame) {
+			const std::uint32_t slot = static_cast<std::uint32_t>(frame % FrameCount);
+			ring.beginFrame(slot);
+			CHECK(ring.usedCount() == 0);
+
+			std::vector<std::atomic<int>> used(Capacity);
+			std::atomic<std::uint64_t> errors(0);
+			std::atomic<std::uint32_t> taken(0);
+
+			std::vector<std::thread> threads;
+			for (int t = 0; t < 4; ++t) {
+				threads.emplace_back([&]() {
+					DescriptorIndex first;
+					while (ring.allocate(7, first)) {
+						for (std::uint32_t k = 0; k < 7; ++k) {
+							const DescriptorIndex index = first + k;
+							if (index < slot * 1000 || index >= (slot + 1) * 1000 || used[index].exchange(1) != 0) ++errors;
+						}
+						taken += 7;
+					}
+				});
+			}
+			for (std::thread& thread : threads)
+				thread.join();
+
+			CHECK(errors.load() == 0);
+			CHECK(taken.load() == 994);
+
+			// An exhausted segment stays exhausted until its slot comes round again
+			DescriptorIndex first;
+			CHECK(!ring.allocate(1, first));
+			CHECK(ring.usedCount() == ring.segmentSize());
+		}
+
+		// A range larger than a segment never fits, even in a fresh one
+		ring.beginFrame(0);
+		DescriptorIndex first;
+		CHECK(!ring.allocate(1001, first));
+		ring.beginFrame(0);
+		CHECK(ring.allocate(1000, first) && first == 0);
+		return 0;
+	}
+}
+
+int main() {
+	if (testConcurrentFreeList() != 0) return 1;
+	if (testEmptyFreeList() != 0) return 1;
+	if (testRingSegments() != 0) return 1;
+	return 0;
+}
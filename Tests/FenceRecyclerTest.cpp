@@ -0,0 +1,100 @@
+/***********************************************************************************************************
+ * @file FenceRecyclerTest.cpp
+ *
+ * @brief Retires objects against a CPU timeline and checks when and in which order they are recycled
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+
+#include "Check.h"
+#include "CpuTimeline.h"
+#include "FenceRecycler.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	/** Objects come back in submission order, each only once its value has completed. */
+	int testCompletionOrder() {
+		CpuTimeline timeline;
+		FenceRecycler<int> recycler(&timeline);
+
+		int object = -1;
+		CHECK(!recycler.acquire(object));
+		CHECK(object == -1);
+
+		std::uint64_t values[4];
+		for (int i = 0; i < 4; ++i) {
+			values[i] = timeline.reserve();
+			recycler.retire(i, values[i]);
+		}
+		CHECK(recycler.size() == 4);
+		CHECK(!recycler.acquire(object));
+
+		timeline.complete(values[0]);
+		timeline.complete(values[1]);
+		CHECK(recycler.acquire(object) && object == 0);
+		CHECK(recycler.acquire(object) && object == 1);
+		CHECK(!recycler.acquire(object));
+
+		timeline.complete(values[2]);
+		timeline.complete(values[3]);
+		CHECK(recycler.acquire(object) && object == 2);
+		CHECK(recycler.acquire(object) && object == 3);
+		CHECK(!recycler.acquire(object));
+		CHECK(recycler.size() == 0);
+		return 0;
+	}
+
+	/** Objects that never reached the GPU are handed out at once, even behind a running submission. */
+	int testImmediateReuse() {
+		CpuTimeline timeline;
+		FenceRecycler<int> recycler(&timeline);
+
+		const std::uint64_t running = timeline.reserve();
+		recycler.retire(1, running);
+		recycler.retire(2, 0);
+		CHECK(recycler.size() == 2);
+
+		int object = -1;
+		CHECK(recycler.acquire(object) && object == 2);
+		CHECK(!recycler.acquire(object));
+
+		// Discarded again while the submission still runs, it is the one handed out once more
+		recycler.retire(2, 0);
+		CHECK(recycler.acquire(object) && object == 2);
+
+		timeline.complete(running);
+		CHECK(recycler.acquire(object) && object == 1);
+		CHECK(recycler.size() == 0);
+		return 0;
+	}
+
+	int testClear() {
+		CpuTimeline timeline;
+		FenceRecycler<int> recycler(&timeline);
+
+		recycler.retire(1, timeline.reserve());
+		recycler.retire(2, 0);
+		CHECK(recycler.size() == 2);
+
+		recycler.clear();
+		CHECK(recycler.size() == 0);
+		int object = -1;
+		CHECK(!recycler.acquire(object));
+		return 0;
+	}
+}
+
+int main() {
+	if (testCompletionOrder() != 0) return 1;
+	if (testImmediateReuse() != 0) return 1;
+	if (testClear() != 0) return 1;
+	return 0;
+}
@@ -0,0 +1,241 @@
+/***********************************************************************************************************
+ * @file FrameArenaTest.cpp
+ *
+ * @brief Counts general heap allocations while frame arenas and the render graph run steady state frames
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The test replaces the global operator new. The first frames may grow the arenas and vectors, after
+ * which a frame of the same shape must not allocate at all.
+ *
+ **********************************************************************************************************/
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "AliasingPlanner.h"
+#include "Check.h"
+#include "FrameArena.h"
+#include "RenderGraph.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	std::atomic<std::uint64_t> gAllocationCount(0);
+}
+
+void* operator new(std::size_t size) {
+	gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size != 0 ? size : 1)) return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+
+namespace {
+	const int WarmUpFrames = 10;
+	const int FrameCount = 100;
+
+	/** Containers, strings and objects drawn from one arena, with a frame several times its first block. */
+	int testArenaFrames() {
+		FrameArena arena(1024);
+		std::uint64_t allocations = 0;
+
+		for (int frame = 0; frame < FrameCount; ++frame) {
+			if (frame == WarmUpFrames) allocations = gAllocationCount.load();
+
+			ArenaVector<int> values{ ArenaAllocator<int>(&arena) };
+			for (int i = 0; i < 5000; ++i)
+				values.push_back(i);
+
+			ArenaString message{ ArenaAllocator<char>(&arena) };
+			message = "A message long enough not to fit into the small string buffer.";
+			const char* copied = arena.copy(message.data(), message.size());
+
+			const double* value = arena.create<double>(1.5);
+			void* aligned = arena.allocate(10, 256);
+
+			for (int i = 0; i < 5000; ++i)
+				CHECK(values[i] == i);
+			CHECK(copied[message.size()] == '\0' && message == copied);
+			CHECK(reinterpret_cast<std::uintptr_t>(value) % alignof(double) == 0 && *value == 1.5);
+			CHECK(reinterpret_cast<std::uintptr_t>(aligned) % 256 == 0);
+
+			arena.reset();
+			CHECK(arena.usedSize() == 0);
+		}
+
+		CHECK(gAllocationCount.load() == allocations);
+		CHECK(arena.capacity() >= arena.highWater());
+		return 0;
+	}
+
+	/** Every recording thread gets an arena of its own, the same one for the whole frame. */
+	int testThreadArenas() {
+		const std::uint32_t ThreadCount = 8;
+
+		ThreadArenas arenas(ThreadCount, 4096);
+		for (int frame = 0; frame < 20; ++frame) {
+			std::atomic<int> errors(0);
+			std::vector<FrameArena*> claimed(ThreadCount, nullptr);
+
+			std::vector<std::thread> threads;
+			for (std::uint32_t t = 0; t < ThreadCount; ++t) {
+				threads.emplace_back([&, t]() {
+					FrameArena* arena = arenas.local();
+					if (arena == nullptr || arenas.local() != arena) {
+						++errors;
+						return;
+					}
+					claimed[t] = arena;
+
+					int* values = arena->allocateArray<int>(1000);
+					for (int i = 0; i < 1000; ++i) values[i] = static_cast<int>(t);
+					for (int i = 0; i < 1000; ++i) {
+						if (values[i] != static_cast<int>(t)) ++errors;
+					}
+				});
+			}
+			for (std::thread& thread : threads)
+				thread.join();
+
+			CHECK(errors.load() == 0);
+			for (std::uint32_t a = 0; a < ThreadCount; ++a) {
+				for (std::uint32_t b = a + 1; b < ThreadCount; ++b)
+					CHECK(claimed[a] != claimed[b]);
+			}
+
+			// Every arena is claimed, so one more thread goes without
+			CHECK(arenas.local() == nullptr);
+			arenas.reset();
+		}
+		return 0;
+	}
+
+	struct CountingExecutor {
+		std::uint32_t barrierCount = 0;
+
+		void barriers(const RenderGraphBarrier*, std::uint32_t count) { barrierCount += count; }
+	};
+
+	/** Builds, compiles and executes a deferred frame with aliased transients, as a backend would every frame. */
+	int recordFrame(RenderGraph& graph, ResourceId backBuffer, int& passesRun) {
+		RenderGraphTextureDesc target;
+		target.width = 3840;
+		target.height = 2160;
+		target.size = 3840ull * 2160 * 8;
+		target.alignment = 65536;
+
+		RenderGraphTextureDesc bloom = target;
+		bloom.width /= 4;
+		bloom.height /= 4;
+		bloom.size /= 16;
+
+		const RenderGraphResource present = graph.importResource("BackBuffer", backBuffer, ResourceState::PRESENT, ResourceState::PRESENT);
+		const RenderGraphResource depth = graph.createTransient("Depth", 100, target, ResourceState::COMMON);
+		const RenderGraphResource albedo = graph.createTransient("Albedo", 101, target, ResourceState::COMMON);
+		const RenderGraphResource normals = graph.createTransient("Normals", 102, target, ResourceState::COMMON);
+		const RenderGraphResource occlusion = graph.createTransient("Occlusion", 103, target, ResourceState::COMMON);
+		const RenderGraphResource lighting = graph.createTransient("Lighting", 104, target, ResourceState::COMMON);
+		const RenderGraphResource glow = graph.createTransient("Bloom", 105, bloom, ResourceState::COMMON);
+		const RenderGraphResource tonemapped = graph.createTransient("Tonemapped", 106, target, ResourceState::COMMON);
+
+		// Callbacks capture more than a std::function keeps inline
+		int* counter = &passesRun;
+		const std::uint64_t padding[4] = { 1, 2, 3, 4 };
+		auto record = [counter, padding]() { *counter += static_cast<int>(padding[0]); };
+
+		RenderGraphPass pass = graph.addPass("GBuffer", record);
+		graph.write(pass, depth, ResourceState::DEPTH_WRITE);
+		graph.write(pass, albedo, ResourceState::RENDER_TARGET);
+		graph.write(pass, normals, ResourceState::RENDER_TARGET);
+
+		pass = graph.addPass("Occlusion", record);
+		graph.read(pass, depth, ResourceState::SHADER_RESOURCE);
+		graph.read(pass, normals, ResourceState::SHADER_RESOURCE);
+		graph.write(pass, occlusion, ResourceState::RENDER_TARGET);
+
+		pass = graph.addPass("Lighting", record);
+		graph.read(pass, albedo, ResourceState::SHADER_RESOURCE);
+		graph.read(pass, normals, ResourceState::SHADER_RESOURCE);
+		graph.read(pass, occlusion, ResourceState::SHADER_RESOURCE);
+		graph.write(pass, lighting, ResourceState::RENDER_TARGET);
+
+		pass = graph.addPass("Bloom", record);
+		graph.read(pass, lighting, ResourceState::SHADER_RESOURCE);
+		graph.write(pass, glow, ResourceState::RENDER_TARGET);
+
+		pass = graph.addPass("Tonemap", record);
+		graph.read(pass, lighting, ResourceState::SHADER_RESOURCE);
+		graph.read(pass, glow, ResourceState::SHADER_RESOURCE);
+		graph.write(pass, tonemapped, ResourceState::RENDER_TARGET);
+
+		pass = graph.addPass("Present", record);
+		graph.read(pass, tonemapped, ResourceState::COPY_SOURCE);
+		graph.write(pass, present, ResourceState::COPY_DEST);
+
+		// Never read, so culled
+		pass = graph.addPass("Unused", record);
+		graph.read(pass, depth, ResourceState::SHADER_RESOURCE);
+
+		CHECK(graph.compile().is_successfull);
+
+		CountingExecutor executor;
+		graph.execute(executor);
+		CHECK(executor.barrierCount > 0);
+		return 0;
+	}
+
+	int testRenderGraphFrames() {
+		AliasingPlanner planner;
+		RenderGraph graph;
+		graph.setAliasingPlanner(&planner);
+
+		std::uint64_t allocations = 0;
+		int passesRun = 0;
+		for (int frame = 0; frame < FrameCount; ++frame) {
+			if (frame == WarmUpFrames) allocations = gAllocationCount.load();
+
+			CHECK(recordFrame(graph, 1 + frame % 3, passesRun) == 0);
+			CHECK(planner.plannedSize() < planner.requestedSize());
+			graph.reset();
+		}
+
+		CHECK(gAllocationCount.load() == allocations);
+		CHECK(passesRun == 6 * FrameCount);
+		return 0;
+	}
+
+	/** Results built from string literals keep a pointer instead of copying the text. */
+	int testLiteralResults() {
+		const std::uint64_t allocations = gAllocationCount.load();
+		FunctionResult result(true, RESULT::SSUCCESS, "A result message well past the small string buffer of std::string.");
+		result = FunctionResult(false, RESULT::FAIL, "Another result message well past the small string buffer.");
+		CHECK(gAllocationCount.load() == allocations);
+
+		const std::string composed = "Composed " + result.message;
+		FunctionResult owning(false, RESULT::FAIL, composed);
+		CHECK(gAllocationCount.load() > allocations);
+		CHECK(owning.message.str() == composed);
+		return 0;
+	}
+}
+
+int main() {
+	if (testArenaFrames() != 0) return 1;
+	if (testThreadArenas() != 0) return 1;
+	if (testRenderGraphFrames() != 0) return 1;
+	if (testLiteralResults() != 0) return 1;
+	return 0;
+}
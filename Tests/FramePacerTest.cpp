@@ -0,0 +1,149 @@
+/***********************************************************************************************************
+ * @file FramePacerTest.cpp
+ *
+ * @brief Drives the frame pacer with a scripted presenter and checks latency clamping, waits and timeouts
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "Check.h"
+#include "FramePacing.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	/** Answers latency waits from a script, succeeding once it runs out, and records every call. */
+	class MockPresenter : public FramePresenter {
+	public:
+		std::deque<FunctionResult> waitResults;
+		std::deque<FunctionResult> presentResults;
+		std::vector<std::uint32_t> waitTimeouts;
+		std::vector<std::uint32_t> syncIntervals;
+
+		virtual FunctionResult waitForLatency(std::uint32_t timeoutMs) {
+			waitTimeouts.push_back(timeoutMs);
+			return(next(waitResults));
+		}
+
+		virtual FunctionResult present(std::uint32_t syncInterval) {
+			syncIntervals.push_back(syncInterval);
+			return(next(presentResults));
+		}
+	private:
+		static FunctionResult next(std::deque<FunctionResult>& results) {
+			if (results.empty()) return(FunctionResult(true, RESULT::SSUCCESS, "Done."));
+
+			FunctionResult result = results.front();
+			results.pop_front();
+			return(result);
+		}
+	};
+
+	FramePacing resolve(int bufferCount, int maxFrameLatency) {
+		GraphicsConfig config = {};
+		config.SwapChainBufferCount = bufferCount;
+		config.MaxFrameLatency = maxFrameLatency;
+		return(resolveFramePacing(config));
+	}
+
+	/** At most bufferCount - 1 frames queue behind the one scanned out, and the CPU records one more. */
+	int testLatencyClamping() {
+		for (int bufferCount = -1; bufferCount <= 8; ++bufferCount) {
+			for (int latency = -1; latency <= MaxFrameLatencyLimit + 2; ++latency) {
+				const FramePacing pacing = resolve(bufferCount, latency);
+				CHECK(pacing.bufferCount >= MinSwapChainBufferCount && pacing.bufferCount <= MaxSwapChainBufferCount);
+				CHECK(pacing.maxFrameLatency >= 1 && pacing.maxFrameLatency <= pacing.bufferCount - 1);
+				CHECK(pacing.framesInFlight == pacing.maxFrameLatency + 1);
+			}
+		}
+
+		const FramePacing lowLatency = resolve(2, 3);
+		CHECK(lowLatency.bufferCount == 2 && lowLatency.maxFrameLatency == 1 && lowLatency.framesInFlight == 2);
+		const FramePacing tripleBuffered = resolve(3, 2);
+		CHECK(tripleBuffered.bufferCount == 3 && tripleBuffered.maxFrameLatency == 2 && tripleBuffered.framesInFlight == 3);
+		const FramePacing tooMany = resolve(9, MaxFrameLatencyLimit);
+		CHECK(tooMany.bufferCount == MaxSwapChainBufferCount && tooMany.maxFrameLatency == MaxSwapChainBufferCount - 1);
+		const FramePacing noLatency = resolve(4, 0);
+		CHECK(noLatency.maxFrameLatency == 1);
+		return 0;
+	}
+
+	/** Repeated waits before present() return at once instead of consuming a second latency slot. */
+	int testSingleWaitPerFrame() {
+		MockPresenter presenter;
+		FramePacer pacer;
+		CHECK(!pacer.initialise(nullptr, resolve(3, 2)).is_successfull);
+		CHECK(pacer.initialise(&presenter, resolve(3, 2), 1).is_successfull);
+
+		for (int frame = 0; frame < 10; ++frame) {
+			CHECK(pacer.waitForNextFrame().is_successfull);
+			CHECK(pacer.waitForNextFrame().is_successfull);
+			CHECK(pacer.waitForNextFrame().is_successfull);
+			CHECK(presenter.waitTimeouts.size() == static_cast<std::size_t>(frame + 1));
+			CHECK(pacer.present().is_successfull);
+		}
+
+		CHECK(pacer.presentedFrames() == 10);
+		CHECK(presenter.syncIntervals.size() == 10);
+		for (std::uint32_t syncInterval : presenter.syncIntervals)
+			CHECK(syncInterval == 1);
+		for (std::uint32_t timeout : presenter.waitTimeouts)
+			CHECK(timeout > 0);
+		CHECK(pacer.latencyTimeouts() == 0);
+		return 0;
+	}
+
+	/** A timed out wait is a warning and the frame goes ahead; a failed wait is retried next call. */
+	int testTimeouts() {
+		MockPresenter presenter;
+		FramePacer pacer;
+		CHECK(pacer.initialise(&presenter, resolve(2, 1)).is_successfull);
+
+		presenter.waitResults.push_back(FunctionResult(true, RESULT::WSUCCESS, "Timed out."));
+		FunctionResult result = pacer.waitForNextFrame();
+		CHECK(result.is_successfull && result.result == RESULT::WSUCCESS);
+		CHECK(pacer.latencyTimeouts() == 1);
+
+		// The timed out wait still paces the frame
+		CHECK(pacer.waitForNextFrame().result == RESULT::SSUCCESS);
+		CHECK(presenter.waitTimeouts.size() == 1);
+		CHECK(pacer.present().is_successfull);
+
+		presenter.waitResults.push_back(FunctionResult(false, RESULT::FAIL, "Device removed."));
+		result = pacer.waitForNextFrame();
+		CHECK(!result.is_successfull);
+		CHECK(pacer.latencyTimeouts() == 1);
+		CHECK(pacer.waitForNextFrame().is_successfull);
+		CHECK(presenter.waitTimeouts.size() == 3);
+
+		// A failed present leaves the frame paced, so the retry does not wait again
+		presenter.presentResults.push_back(FunctionResult(false, RESULT::FAIL, "Present failed."));
+		CHECK(!pacer.present().is_successfull);
+		CHECK(pacer.presentedFrames() == 1);
+		CHECK(pacer.waitForNextFrame().is_successfull);
+		CHECK(presenter.waitTimeouts.size() == 3);
+		CHECK(pacer.present().is_successfull);
+		CHECK(pacer.presentedFrames() == 2);
+
+		// Initialising again starts the counters over
+		CHECK(pacer.initialise(&presenter, resolve(2, 1)).is_successfull);
+		CHECK(pacer.presentedFrames() == 0 && pacer.latencyTimeouts() == 0);
+		return 0;
+	}
+}
+
+int main() {
+	if (testLatencyClamping() != 0) return 1;
+	if (testSingleWaitPerFrame() != 0) return 1;
+	if (testTimeouts() != 0) return 1;
+	return 0;
+}
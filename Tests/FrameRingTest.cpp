@@ -0,0 +1,195 @@
+/***********************************************************************************************************
+ * @file FrameRingTest.cpp
+ *
+ * @brief Records frames into a frame ring against a stand-in queue and checks when beginning a frame waits
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The stand-in queue reserves a CPU timeline value for every signal and leaves it incomplete until the
+ * test completes it, the way a GPU catches up with submissions some time later. It records every wait.
+ *
+ **********************************************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "CpuTimeline.h"
+#include "FrameRing.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	class QueueTimeline : public Timeline {
+	private:
+		CpuTimeline mTimeline;
+	public:
+		std::vector<std::uint64_t> waits;
+		bool catchUpOnWait = true; /*!< Completes a waited for value at once instead of leaving it to another thread */
+
+		virtual FunctionResult signal(std::uint64_t& value) {
+			value = mTimeline.reserve();
+			return(FunctionResult(true, RESULT::SSUCCESS, "Queued a signal."));
+		}
+
+		virtual FunctionResult waitForValue(std::uint64_t value) {
+			waits.push_back(value);
+			if (catchUpOnWait) mTimeline.complete(value);
+			return(mTimeline.waitForValue(value));
+		}
+
+		virtual std::uint64_t completedValue() { return mTimeline.completedValue(); }
+		virtual bool isComplete(std::uint64_t value) { return mTimeline.isComplete(value); }
+		virtual std::uint64_t lastSignaledValue() const { return mTimeline.lastSignaledValue(); }
+
+		void complete(std::uint64_t value) { mTimeline.complete(value); }
+	};
+
+	struct Resources {
+		int recordedCount = 0;
+	};
+
+	/** Begins, records and ends one frame, checking the ring hands out the current slot's resources. */
+	int runFrame(FrameRing<Resources>& ring, std::uint64_t& fenceValue) {
+		const std::size_t index = ring.currentIndex();
+
+		Resources* resources = nullptr;
+		CHECK(ring.beginFrame(resources).is_successfull);
+		CHECK(resources == &ring.slot(index).resources);
+		++resources->recordedCount;
+
+		CHECK(ring.endFrame(fenceValue).is_successfull);
+		CHECK(ring.slot(index).fenceValue == fenceValue);
+		CHECK(ring.currentIndex() == (index + 1) % ring.frameCount());
+		return 0;
+	}
+
+	int testInitialise() {
+		QueueTimeline timeline;
+		FrameRing<Resources> ring;
+		CHECK(!ring.initialise(nullptr, 3).is_successfull);
+		CHECK(!ring.initialise(&timeline, 0).is_successfull);
+		CHECK(ring.initialise(&timeline, 3).is_successfull);
+		CHECK(ring.frameCount() == 3 && ring.currentIndex() == 0 && ring.frameNumber() == 0);
+		return 0;
+	}
+
+	/** Only a slot submitted on the previous lap and not yet completed makes beginning a frame wait. */
+	int testWaitsOnlyWhenLapping() {
+		const std::size_t FrameCount = 3;
+
+		QueueTimeline timeline;
+		FrameRing<Resources> ring;
+		CHECK(ring.initialise(&timeline, FrameCount).is_successfull);
+
+		// The first lap finds every slot unused, although no frame has completed
+		std::uint64_t fenceValue = 0;
+		for (std::size_t i = 0; i < FrameCount; ++i)
+			CHECK(runFrame(ring, fenceValue) == 0);
+		CHECK(timeline.waits.empty());
+		CHECK(timeline.completedValue() == 0);
+
+		// Slot 0 has completed, slot 1 has not
+		timeline.complete(1);
+		CHECK(runFrame(ring, fenceValue) == 0);
+		CHECK(timeline.waits.empty());
+		CHECK(runFrame(ring, fenceValue) == 0);
+		CHECK(timeline.waits.size() == 1 && timeline.waits[0] == 2);
+
+		// A GPU trailing by fewer frames than the ring holds never stalls the CPU
+		for (int frame = 0; frame < 100; ++frame) {
+			timeline.complete(fenceValue - (FrameCount - 2));
+			CHECK(runFrame(ring, fenceValue) == 0);
+		}
+		CHECK(timeline.waits.size() == 1);
+
+		// Once the GPU stops, the slot of the frame it last completed is free; every later frame stalls on
+		// the frame submitted one lap earlier
+		CHECK(runFrame(ring, fenceValue) == 0);
+		CHECK(timeline.waits.size() == 1);
+		for (int frame = 0; frame < 10; ++frame) {
+			const std::uint64_t lapped = ring.slot(ring.currentIndex()).fenceValue;
+			CHECK(!timeline.isComplete(lapped));
+			CHECK(runFrame(ring, fenceValue) == 0);
+			CHECK(timeline.waits.back() == lapped);
+			CHECK(lapped == fenceValue - FrameCount);
+		}
+		CHECK(timeline.waits.size() == 11);
+
+		const std::uint64_t Frames = 5 + 100 + 1 + 10;
+		CHECK(ring.frameNumber() == Frames);
+		for (std::size_t i = 0; i < FrameCount; ++i)
+			CHECK(ring.slot(i).resources.recordedCount == static_cast<int>(Frames / FrameCount + (i < Frames % FrameCount ? 1 : 0)));
+		return 0;
+	}
+
+	/** A lapped slot is handed out only once the queue has actually reached its value. */
+	int testBlockingWait() {
+		QueueTimeline timeline;
+		timeline.catchUpOnWait = false;
+		FrameRing<Resources> ring;
+		CHECK(ring.initialise(&timeline, 2).is_successfull);
+
+		std::uint64_t fenceValue = 0;
+		CHECK(runFrame(ring, fenceValue) == 0);
+		CHECK(runFrame(ring, fenceValue) == 0);
+
+		std::thread gpu([&timeline]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			timeline.complete(1);
+		});
+
+		Resources* resources = nullptr;
+		const FunctionResult result = ring.beginFrame(resources);
+		const bool reached = timeline.isComplete(1);
+		gpu.join();
+
+		CHECK(result.is_successfull);
+		CHECK(reached);
+		CHECK(resources == &ring.slot(0).resources);
+		return 0;
+	}
+
+	/** waitForIdle waits for the last submitted frame, and for nothing before the first one. */
+	int testWaitForIdle() {
+		QueueTimeline timeline;
+		FrameRing<Resources> ring;
+		CHECK(ring.initialise(&timeline, 3).is_successfull);
+
+		CHECK(ring.waitForIdle().is_successfull);
+		CHECK(timeline.waits.empty());
+
+		std::uint64_t fenceValue = 0;
+		for (int frame = 0; frame < 5; ++frame) {
+			timeline.complete(fenceValue);
+			CHECK(runFrame(ring, fenceValue) == 0);
+		}
+		CHECK(!timeline.isComplete(fenceValue));
+
+		CHECK(ring.waitForIdle().is_successfull);
+		CHECK(timeline.waits.size() == 1 && timeline.waits[0] == fenceValue);
+		CHECK(timeline.isComplete(fenceValue));
+
+		// Every slot can be begun again without waiting
+		const std::size_t waits = timeline.waits.size();
+		for (int frame = 0; frame < 3; ++frame)
+			CHECK(runFrame(ring, fenceValue) == 0);
+		CHECK(timeline.waits.size() == waits);
+		return 0;
+	}
+}
+
+int main() {
+	if (testInitialise() != 0) return 1;
+	if (testWaitsOnlyWhenLapping() != 0) return 1;
+	if (testBlockingWait() != 0) return 1;
+	if (testWaitForIdle() != 0) return 1;
+	return 0;
+}
@@ -0,0 +1,117 @@
+/***********************************************************************************************************
+ * @file HandlePoolTest.cpp
+ *
+ * @brief Checks the handle pool against a reference list over a long run of random creates and destroys
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Check.h"
+#include "HandlePool.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	const int OperationCount = 2000000;
+	const std::size_t TargetSize = 4096;
+	const int CheckInterval = 1000;
+
+	struct PooledObject {
+		std::uint64_t id;
+		std::string name; /*!< Owns memory, so a bad move in destroy() shows up under a sanitiser */
+	};
+
+	typedef std::pair<std::uint64_t, Handle<PooledObject>> LiveObject;
+
+	/** Every live handle finds its own object, and the dense array and its owners agree. */
+	int checkPool(const HandlePool<PooledObject>& pool, const std::vector<LiveObject>& live, const std::vector<Handle<PooledObject>>& destroyed) {
+		CHECK(pool.size() == live.size());
+		for (const auto& [id, handle] : live) {
+			const PooledObject* object = pool.get(handle);
+			CHECK(object != nullptr);
+			CHECK(object->id == id);
+			CHECK(object->name == std::to_string(id));
+		}
+
+		for (const Handle<PooledObject>& handle : destroyed)
+			CHECK(pool.get(handle) == nullptr);
+
+		for (std::size_t dense = 0; dense < pool.size(); ++dense)
+			CHECK(pool.get(pool.handle(dense)) == pool.data() + dense);
+		return 0;
+	}
+
+	int testRandomOperations() {
+		HandlePool<PooledObject> pool;
+		std::vector<LiveObject> live;
+		std::vector<Handle<PooledObject>> destroyed;
+		std::mt19937_64 random(3);
+		std::uint64_t nextId = 0;
+
+		for (int operation = 0; operation < OperationCount; ++operation) {
+			// Creating gets less likely as the pool grows, so its size settles around the target
+			if (live.empty() || random() % (2 * TargetSize) >= live.size()) {
+				live.emplace_back(nextId, pool.create(PooledObject{ nextId, std::to_string(nextId) }));
+				++nextId;
+			}
+			else {
+				const std::size_t entry = random() % live.size();
+				Handle<PooledObject> handle = live[entry].second;
+				Handle<PooledObject> stale = handle;
+				CHECK(pool.destroy(handle));
+				CHECK(!handle.valid());
+				CHECK(!pool.destroy(stale));
+				CHECK(stale == live[entry].second);
+
+				destroyed.push_back(stale);
+				live[entry] = live.back();
+				live.pop_back();
+			}
+
+			if (operation % CheckInterval == 0) {
+				CHECK(checkPool(pool, live, destroyed) == 0);
+				if (destroyed.size() > 1000) destroyed.clear();
+			}
+		}
+
+		CHECK(checkPool(pool, live, destroyed) == 0);
+
+		pool.clear();
+		CHECK(pool.empty());
+		for (const auto& [id, handle] : live)
+			CHECK(pool.get(handle) == nullptr);
+		return 0;
+	}
+
+	/** Slots are reused after a destroy, and the new object is not reachable through the old handle. */
+	int testSlotReuse() {
+		HandlePool<PooledObject> pool;
+		Handle<PooledObject> first = pool.create(PooledObject{ 1, "1" });
+		const Handle<PooledObject> stale = first;
+		CHECK(pool.destroy(first));
+
+		const Handle<PooledObject> second = pool.create(PooledObject{ 2, "2" });
+		CHECK(second.index == stale.index);
+		CHECK(second.generation != stale.generation);
+		CHECK(pool.get(stale) == nullptr);
+		CHECK(pool.get(second) != nullptr && pool.get(second)->id == 2);
+		return 0;
+	}
+}
+
+int main() {
+	if (testRandomOperations() != 0) return 1;
+	if (testSlotReuse() != 0) return 1;
+	return 0;
+}
@@ -0,0 +1,139 @@
+/***********************************************************************************************************
+ * @file HeapAllocatorTest.cpp
+ *
+ * @brief Checks how the heap allocator places page sized and larger requests
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Requests of a page or more used to get a page of exactly their size managed by a TLSF, which could
+ * not hold them because of its alignment padding and size class rounding, and the heap created for
+ * that page was leaked.
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <map>
+#include <utility>
+
+#include "Check.h"
+#include "HeapAllocator.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	const std::uint64_t PageSize = 64ull << 20;
+
+	/** Keeps track of the heaps that exist, optionally refusing to create any. */
+	class TestHeapSource : public HeapSource {
+	public:
+		std::map<std::pair<HeapClass, std::uint32_t>, std::uint64_t> heaps;
+		bool fail = false;
+
+		FunctionResult createHeap(HeapClass heapClass, std::uint32_t page, std::uint64_t size) override {
+			if (fail) return(FunctionResult(false, RESULT::FAIL, "Out of memory."));
+			if (!heaps.emplace(std::make_pair(heapClass, page), size).second) return(FunctionResult(false, RESULT::FAIL, "The page already has a heap."));
+			return(FunctionResult(true, RESULT::SSUCCESS, "Created a heap."));
+		}
+
+		void destroyHeap(HeapClass heapClass, std::uint32_t page) override {
+			heaps.erase(std::make_pair(heapClass, page));
+		}
+
+		std::uint64_t heapSize(const HeapAllocation& allocation) const {
+			auto heap = heaps.find(std::make_pair(allocation.heapClass, allocation.page));
+			return heap != heaps.end() ? heap->second : 0;
+		}
+	};
+
+	int testPageSizedAndLarger() {
+		TestHeapSource source;
+		HeapAllocator allocator(&source, PageSize);
+
+		const std::uint64_t sizes[] = { PageSize, 100ull << 20, PageSize - (64ull << 10), PageSize + 1 };
+		HeapAllocation allocations[4];
+
+		for (int i = 0; i < 4; ++i) {
+			CHECK(allocator.allocate(HeapClass::TEXTURE, sizes[i], 0, allocations[i]).is_successfull);
+			CHECK(allocations[i].valid());
+			CHECK(allocations[i].size >= sizes[i]);
+			CHECK(allocations[i].offset % HeapAllocator::classAlignment(HeapClass::TEXTURE) == 0);
+			CHECK(allocations[i].offset + allocations[i].size <= source.heapSize(allocations[i]));
+		}
+
+		// Every request got a page of its own, sized to fit it rather than rounded up to a whole page
+		CHECK(source.heaps.size() == 4);
+		CHECK(source.heapSize(allocations[1]) == sizes[1]);
+
+		HeapStatistics statistics = allocator.statistics(HeapClass::TEXTURE);
+		CHECK(statistics.pageCount == 4);
+		CHECK(statistics.allocationCount == 4);
+
+		for (HeapAllocation& allocation : allocations)
+			allocator.free(allocation);
+
+		// Dedicated pages go with their resource; only the last shared page is kept
+		statistics = allocator.statistics(HeapClass::TEXTURE);
+		CHECK(statistics.allocationCount == 0);
+		CHECK(statistics.pageCount == source.heaps.size());
+		CHECK(source.heaps.size() <= 1);
+		return 0;
+	}
+
+	int testSmallRequestsSharePages() {
+		TestHeapSource source;
+		HeapAllocator allocator(&source, PageSize);
+
+		HeapAllocation allocations[16];
+		for (HeapAllocation& allocation : allocations)
+			CHECK(allocator.allocate(HeapClass::BUFFER, 1 << 20, 0, allocation).is_successfull);
+
+		CHECK(source.heaps.size() == 1);
+		CHECK(source.heapSize(allocations[0]) == PageSize);
+
+		// A large request next to them does not disturb the shared page
+		HeapAllocation large;
+		CHECK(allocator.allocate(HeapClass::BUFFER, PageSize, 0, large).is_successfull);
+		CHECK(large.page != allocations[0].page);
+		CHECK(source.heaps.size() == 2);
+
+		allocator.free(large);
+		CHECK(source.heaps.size() == 1);
+
+		for (HeapAllocation& allocation : allocations)
+			allocator.free(allocation);
+		CHECK(source.heaps.size() == 1);
+		return 0;
+	}
+
+	int testFailedHeapCreation() {
+		TestHeapSource source;
+		HeapAllocator allocator(&source, PageSize);
+		source.fail = true;
+
+		HeapAllocation allocation;
+		CHECK(!allocator.allocate(HeapClass::TEXTURE, 100ull << 20, 0, allocation).is_successfull);
+		CHECK(!allocator.allocate(HeapClass::TEXTURE, 1 << 20, 0, allocation).is_successfull);
+		CHECK(!allocation.valid());
+		CHECK(allocator.statistics(HeapClass::TEXTURE).pageCount == 0);
+
+		// The pages that could not be created are reused once heaps can be created again
+		source.fail = false;
+		CHECK(allocator.allocate(HeapClass::TEXTURE, 100ull << 20, 0, allocation).is_successfull);
+		CHECK(allocation.page == 0);
+		allocator.free(allocation);
+		CHECK(source.heaps.empty());
+		return 0;
+	}
+}
+
+int main() {
+	if (testPageSizedAndLarger() != 0) return 1;
+	if (testSmallRequestsSharePages() != 0) return 1;
+	if (testFailedHeapCreation() != 0) return 1;
+	return 0;
+}
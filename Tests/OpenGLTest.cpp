@@ -0,0 +1,143 @@
+/***********************************************************************************************************
+ * @file OpenGLTest.cpp
+ *
+ * @brief Renders one scene with the OpenGL backend and the software rasteriser and compares the frames
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The OpenGL backend runs on surfaceless EGL, which Mesa provides through llvmpipe without a GPU or a
+ * display server. Where no such context can be created the test reports itself as skipped.
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Check.h"
+#include "CommandStream.h"
+#include "OpenGL.h"
+#include "SoftwareRasteriser.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	const int SkipReturnCode = 77;
+	const int Width = 320;
+	const int Height = 240;
+	const int Tolerance = 8; /*!< Per channel, out of 255 */
+
+	GraphicsConfig makeConfig(API api, int sampleCount) {
+		GraphicsConfig config = {};
+		config.GraphicsAPI = api;
+		config.SwapChainBufferCount = 2;
+		config.MaxFrameLatency = 1;
+		config.SampleCount = sampleCount;
+		config.Headless = true;
+		config.Width = Width;
+		config.Height = Height;
+		return config;
+	}
+
+	/** Overlapping triangles at different depths, drawn both indexed and non-indexed. */
+	const SoftwareVertex SceneVertices[9] = {
+		{ { -0.9f, -0.8f, 0.6f, 1.0f }, 0xFF2040E0u },
+		{ { 0.7f, -0.6f, 0.6f, 1.0f }, 0xFF20E040u },
+		{ { -0.2f, 0.9f, 0.6f, 1.0f }, 0xFFE04020u },
+		{ { -0.5f, 0.5f, 0.3f, 2.0f }, 0xFFFFFFFFu },
+		{ { 1.2f, 0.2f, 0.9f, 2.0f }, 0xFF808080u },
+		{ { 0.1f, -1.5f, 0.3f, 2.0f }, 0xFF000000u },
+		{ { -1.0f, -1.0f, 0.8f, 1.0f }, 0xFFFF00FFu },
+		{ { 1.0f, -1.0f, 0.8f, 1.0f }, 0xFF00FFFFu },
+		{ { 1.0f, 1.0f, 0.8f, 1.0f }, 0xFFFFFF00u },
+	};
+	const std::uint16_t SceneIndices[3] = { 6, 7, 8 };
+
+	template<typename Backend>
+	int renderScene(Backend& backend, ReadbackFrame& frame) {
+		const ResourceId vertices = backend.createBuffer(SceneVertices, sizeof(SceneVertices));
+		const ResourceId indices = backend.createBuffer(SceneIndices, sizeof(SceneIndices));
+		const float clearColor[4] = { 0.1f, 0.2f, 0.3f, 1.0f };
+
+		CommandStream stream;
+		stream.clearRenderTarget(BackBufferResource, clearColor);
+		stream.clearDepthStencil(DepthStencilResource, 1.0f, 0);
+		stream.setViewport(0.0f, 0.0f, static_cast<float>(Width), static_cast<float>(Height));
+		stream.setScissor(0, 0, Width, Height);
+		stream.setVertexBuffer(0, vertices, 0, sizeof(SceneVertices), sizeof(SoftwareVertex));
+		stream.draw(6);
+		stream.setIndexBuffer(indices, 0, sizeof(SceneIndices), 2);
+		stream.drawIndexed(3);
+
+		CHECK(backend.submit(stream).is_successfull);
+		CHECK(backend.render().is_successfull);
+		CHECK(backend.readback(frame, true).result == RESULT::SSUCCESS);
+		CHECK(frame.width == Width && frame.height == Height);
+		return 0;
+	}
+
+	/** Largest difference of any channel of any pixel. */
+	int largestDifference(const ReadbackFrame& a, const ReadbackFrame& b) {
+		int largest = 0;
+		for (std::size_t i = 0; i < a.pixels.size(); ++i) {
+			for (int channel = 0; channel < 4; ++channel) {
+				const int difference = std::abs(static_cast<int>((a.pixels[i] >> (8 * channel)) & 0xFF) - static_cast<int>((b.pixels[i] >> (8 * channel)) & 0xFF));
+				if (difference > largest) largest = difference;
+			}
+		}
+		return largest;
+	}
+
+	/** Renders with both backends at one sample count; returns SkipReturnCode without an EGL context. */
+	int testMatchesSoftwareRasteriser(int sampleCount) {
+		OpenGL opengl(nullptr, makeConfig(API::OPENGL, sampleCount));
+		FunctionResult initialised = opengl.initialise();
+		if (!initialised.is_successfull) {
+			std::fprintf(stderr, "Skipping, no surfaceless EGL context: %s\n", initialised.message.c_str());
+			return SkipReturnCode;
+		}
+
+		ReadbackFrame hardware;
+		CHECK(renderScene(opengl, hardware) == 0);
+		CHECK(opengl.destroy().is_successfull);
+
+		SoftwareRasteriser rasteriser(makeConfig(API::SOFTWARE, sampleCount));
+		CHECK(rasteriser.initialise().is_successfull);
+		ReadbackFrame software;
+		CHECK(renderScene(rasteriser, software) == 0);
+		CHECK(rasteriser.destroy().is_successfull);
+
+		CHECK(hardware.pixels.size() == software.pixels.size());
+		const int difference = largestDifference(hardware, software);
+		if (difference > Tolerance) std::fprintf(stderr, "%dx frames differ by up to %d\n", sampleCount, difference);
+		CHECK(difference <= Tolerance);
+		return 0;
+	}
+
+	/** Updates whose end wraps past the end of the address space must not reach the mapping. */
+	int testWrappingUpdate() {
+		OpenGL opengl(nullptr, makeConfig(API::OPENGL, 1));
+		if (!opengl.initialise().is_successfull) return SkipReturnCode;
+
+		const ResourceId buffer = opengl.createBuffer(SceneVertices, sizeof(SceneVertices));
+		const std::size_t wrapping = ~static_cast<std::size_t>(0) - 7;
+		CHECK(!opengl.updateBuffer(buffer, wrapping, SceneVertices, 16).is_successfull);
+		CHECK(!opengl.updateBuffer(buffer, sizeof(SceneVertices) + 1, SceneVertices, 0).is_successfull);
+		CHECK(opengl.updateBuffer(buffer, sizeof(SceneVertices) - 16, SceneVertices, 16).is_successfull);
+		CHECK(opengl.destroy().is_successfull);
+		return 0;
+	}
+}
+
+int main() {
+	const int single = testMatchesSoftwareRasteriser(1);
+	if (single != 0) return single;
+	if (testMatchesSoftwareRasteriser(4) != 0) return 1;
+	if (testWrappingUpdate() != 0) return 1;
+	return 0;
+}
@@ -0,0 +1,194 @@
+/***********************************************************************************************************
+ * @file PipelineCacheTest.cpp
+ *
+ * @brief Checks the stable hash and round trips pipeline blobs through the pipeline cache file
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "Hash.h"
+#include "PipelineCache.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	const PipelineCacheIdentity Identity = { 0x10DE, 0x2684, 0x1, 0xA1, 0x0020000000001234ull };
+
+	std::string tempPath(const char* name) {
+		return((std::filesystem::temp_directory_path() / name).string());
+	}
+
+	std::vector<unsigned char> makeBlob(std::uint64_t key, std::size_t size) {
+		std::vector<unsigned char> blob(size);
+		for (std::size_t i = 0; i < size; ++i)
+			blob[i] = static_cast<unsigned char>(key * 31 + i);
+		return blob;
+	}
+
+	/** Whether the cache returns exactly the expected blob for a key. */
+	bool holds(PipelineCache& cache, std::uint64_t key, const std::vector<unsigned char>& expected) {
+		const void* blob = nullptr;
+		std::size_t size = 0;
+		return(cache.find(key, blob, size) && size == expected.size() && std::memcmp(blob, expected.data(), size) == 0);
+	}
+
+	/** Writes a cache holding keys 1 to 3, the last blob being the last bytes of the file. */
+	int writeCache(const std::string& path) {
+		std::filesystem::remove(path);
+
+		PipelineCache cache;
+		CHECK(cache.load(path, Identity).result == RESULT::WSUCCESS);
+		for (std::uint64_t key = 3; key >= 1; --key) {
+			const std::vector<unsigned char> blob = makeBlob(key, 100 * key);
+			cache.store(key, blob.data(), blob.size());
+		}
+		CHECK(cache.save().is_successfull);
+		return 0;
+	}
+
+	std::vector<unsigned char> readFile(const std::string& path) {
+		std::ifstream file(path, std::ios::binary);
+		return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void writeFile(const std::string& path, const std::vector<unsigned char>& bytes) {
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	}
+
+	int testFnvReferenceVectors() {
+		CHECK(fnv1a("", 0) == 0xCBF29CE484222325ull);
+		CHECK(fnv1a("a", 1) == 0xAF63DC4C8601EC8Cull);
+		CHECK(fnv1a("foobar", 6) == 0x85944171F73967E8ull);
+
+		// Sizes prefix every block, so moving bytes from one block to the next changes the hash
+		Hasher first;
+		first.addString("ab");
+		first.addString("c");
+		Hasher second;
+		second.addString("a");
+		second.addString("bc");
+		CHECK(first.value() != second.value());
+
+		Hasher empty;
+		empty.addString(nullptr);
+		Hasher emptyString;
+		emptyString.addString("");
+		CHECK(empty.value() == emptyString.value());
+		return 0;
+	}
+
+	int testRoundTripAndMerge() {
+		const std::string path = tempPath("SyrenPipelineCacheTest.cache");
+		CHECK(writeCache(path) == 0);
+
+		PipelineCache cache;
+		CHECK(cache.load(path, Identity).result == RESULT::SSUCCESS);
+		CHECK(cache.statistics().loadedCount == 3);
+		for (std::uint64_t key = 1; key <= 3; ++key)
+			CHECK(holds(cache, key, makeBlob(key, 100 * key)));
+
+		const void* blob = nullptr;
+		std::size_t size = 0;
+		CHECK(!cache.find(4, blob, size));
+		CHECK(cache.statistics().hitCount == 3 && cache.statistics().missCount == 1);
+
+		// A new key and a replaced key are merged with the blobs already in the file
+		const std::vector<unsigned char> added = makeBlob(4, 50);
+		const std::vector<unsigned char> replaced = makeBlob(9, 70);
+		cache.store(4, added.data(), added.size());
+		cache.store(2, replaced.data(), replaced.size());
+		CHECK(holds(cache, 2, replaced));
+		CHECK(cache.save().is_successfull);
+		CHECK(cache.statistics().storedCount == 0);
+
+		PipelineCache reloaded;
+		CHECK(reloaded.load(path, Identity).result == RESULT::SSUCCESS);
+		CHECK(reloaded.statistics().loadedCount == 4);
+		CHECK(holds(reloaded, 1, makeBlob(1, 100)));
+		CHECK(holds(reloaded, 2, replaced));
+		CHECK(holds(reloaded, 3, makeBlob(3, 300)));
+		CHECK(holds(reloaded, 4, added));
+
+		std::filesystem::remove(path);
+		return 0;
+	}
+
+	int testIdentityMismatch() {
+		const std::string path = tempPath("SyrenPipelineCacheTest.cache");
+		CHECK(writeCache(path) == 0);
+
+		PipelineCacheIdentity otherDriver = Identity;
+		otherDriver.driverVersion += 1;
+
+		PipelineCache cache;
+		CHECK(cache.load(path, otherDriver).result == RESULT::WSUCCESS);
+		CHECK(cache.statistics().loadedCount == 0);
+		CHECK(!holds(cache, 1, makeBlob(1, 100)));
+
+		std::filesystem::remove(path);
+		return 0;
+	}
+
+	/** A damaged blob is a miss for its own key only. */
+	int testCorruption() {
+		const std::string path = tempPath("SyrenPipelineCacheTest.cache");
+		CHECK(writeCache(path) == 0);
+
+		std::vector<unsigned char> bytes = readFile(path);
+		bytes.back() ^= 0x40;
+		writeFile(path, bytes);
+
+		PipelineCache cache;
+		CHECK(cache.load(path, Identity).result == RESULT::SSUCCESS);
+		CHECK(holds(cache, 1, makeBlob(1, 100)));
+		CHECK(holds(cache, 2, makeBlob(2, 200)));
+		CHECK(!holds(cache, 3, makeBlob(3, 300)));
+		CHECK(cache.statistics().corruptCount == 1);
+
+		std::filesystem::remove(path);
+		return 0;
+	}
+
+	/** Files cut short anywhere are ignored as a whole instead of being read past their end. */
+	int testTruncation() {
+		const std::string path = tempPath("SyrenPipelineCacheTest.cache");
+		CHECK(writeCache(path) == 0);
+		const std::vector<unsigned char> bytes = readFile(path);
+
+		const std::size_t lengths[] = { 0, 20, 40 + 32 + 16, bytes.size() - 1 };
+		for (std::size_t length : lengths) {
+			writeFile(path, std::vector<unsigned char>(bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(length)));
+
+			PipelineCache cache;
+			CHECK(cache.load(path, Identity).result == RESULT::WSUCCESS);
+			CHECK(cache.statistics().loadedCount == 0);
+		}
+
+		std::filesystem::remove(path);
+		return 0;
+	}
+}
+
+int main() {
+	if (testFnvReferenceVectors() != 0) return 1;
+	if (testRoundTripAndMerge() != 0) return 1;
+	if (testIdentityMismatch() != 0) return 1;
+	if (testCorruption() != 0) return 1;
+	if (testTruncation() != 0) return 1;
+	return 0;
+}
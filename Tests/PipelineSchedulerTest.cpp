@@ -0,0 +1,230 @@
+/***********************************************************************************************************
+ * @file PipelineSchedulerTest.cpp
+ *
+ * @brief Compiles stand-in pipelines on a worker pool and checks fallbacks, callbacks and shutdown
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Pipelines are heap allocated ints holding an id. Compile jobs can be held back on a gate, so the test
+ * decides which pipelines are still pending when it resolves them.
+ *
+ **********************************************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "PipelineScheduler.h"
+#include "WorkerPool.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	std::atomic<int> gLiveCount(0);
+	std::atomic<int> gStartCount(0);
+	std::atomic<int> gCompileCount(0);
+
+	void releasePipeline(void* pipeline) {
+		delete static_cast<int*>(pipeline);
+		--gLiveCount;
+	}
+
+	/** A job that waits for the gate to open, then compiles a pipeline holding the id or fails. */
+	PipelineCompileJob makeJob(int id, std::shared_future<void> gate = std::shared_future<void>(), bool fail = false) {
+		return PipelineCompileJob([id, gate, fail](void*& pipeline) {
+			++gStartCount;
+			if (gate.valid()) gate.wait();
+			++gCompileCount;
+			if (fail) return(FunctionResult(false, RESULT::FAIL, "Shader did not compile."));
+
+			pipeline = new int(id);
+			++gLiveCount;
+			return(FunctionResult(true, RESULT::SSUCCESS, "Pipeline compiled."));
+		});
+	}
+
+	int idOf(void* pipeline) {
+		return(pipeline != nullptr ? *static_cast<int*>(pipeline) : -1);
+	}
+
+	/** Pumps once per millisecond until a pipeline is finished, for at most five seconds. */
+	bool pumpUntilFinished(PipelineScheduler& scheduler, PipelineHandle handle) {
+		for (int i = 0; i < 5000; ++i) {
+			scheduler.pump();
+			if (scheduler.status(handle) != PipelineStatus::PENDING) return true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return false;
+	}
+
+	int testFallbackResolution() {
+		WorkerPool workers(2);
+		PipelineScheduler scheduler;
+		CHECK(scheduler.initialise(&workers, releasePipeline).is_successfull);
+
+		const PipelineHandle cheap = scheduler.request(1, makeJob(1));
+		CHECK(pumpUntilFinished(scheduler, cheap));
+		CHECK(idOf(scheduler.resolve(cheap)) == 1);
+
+		std::promise<void> open;
+		const std::shared_future<void> gate = open.get_future().share();
+		const PipelineHandle expensive = scheduler.request(2, makeJob(2, gate), cheap);
+		const PipelineHandle chained = scheduler.request(3, makeJob(3, gate), expensive);
+		const PipelineHandle lone = scheduler.request(4, makeJob(4, gate));
+
+		// Pending pipelines draw with the first ready pipeline along their fallbacks, or not at all
+		CHECK(idOf(scheduler.resolve(expensive)) == 1);
+		CHECK(idOf(scheduler.resolve(chained)) == 1);
+		CHECK(scheduler.resolve(lone) == nullptr);
+		CHECK(scheduler.statistics().fallbackCount == 2);
+		CHECK(scheduler.statistics().skippedCount == 1);
+
+		// Requesting a key again compiles nothing new, and fills in a missing fallback
+		CHECK(scheduler.request(4, makeJob(40), cheap) == lone);
+		CHECK(scheduler.request(2, makeJob(20), lone) == expensive);
+		CHECK(idOf(scheduler.resolve(lone)) == 1);
+		CHECK(scheduler.statistics().requestedCount == 4);
+
+		open.set_value();
+		CHECK(pumpUntilFinished(scheduler, expensive));
+		CHECK(idOf(scheduler.resolve(expensive)) == 2);
+		CHECK(pumpUntilFinished(scheduler, chained));
+		CHECK(idOf(scheduler.resolve(chained)) == 3);
+		CHECK(pumpUntilFinished(scheduler, lone));
+		CHECK(idOf(scheduler.resolve(lone)) == 4);
+
+		const PipelineSchedulerStatistics statistics = scheduler.statistics();
+		CHECK(statistics.readyCount == 4 && statistics.pendingCount == 0 && statistics.failedCount == 0);
+
+		scheduler.shutdown();
+		CHECK(gLiveCount.load() == 0);
+		return 0;
+	}
+
+	int testCycleRejection() {
+		WorkerPool workers(1);
+		PipelineScheduler scheduler;
+		CHECK(scheduler.initialise(&workers, releasePipeline).is_successfull);
+
+		const PipelineHandle a = scheduler.request(1, makeJob(1));
+		const PipelineHandle b = scheduler.request(2, makeJob(2), a);
+		const PipelineHandle c = scheduler.request(3, makeJob(3), b);
+		const PipelineHandle d = scheduler.request(4, makeJob(4));
+
+		CHECK(!scheduler.setFallback(a, a));
+		CHECK(!scheduler.setFallback(a, b));
+		CHECK(!scheduler.setFallback(a, c));
+		CHECK(!scheduler.setFallback(PipelineHandle(), a));
+		CHECK(scheduler.setFallback(a, d));
+		CHECK(!scheduler.setFallback(d, c));
+		CHECK(scheduler.setFallback(c, d));
+
+		scheduler.shutdown();
+		CHECK(gLiveCount.load() == 0);
+		return 0;
+	}
+
+	int testFailedPipelineCallbacks() {
+		WorkerPool workers(1);
+		PipelineScheduler scheduler;
+		CHECK(scheduler.initialise(&workers, releasePipeline).is_successfull);
+
+		const PipelineHandle cheap = scheduler.request(1, makeJob(1));
+		CHECK(pumpUntilFinished(scheduler, cheap));
+
+		std::promise<void> open;
+		const PipelineHandle broken = scheduler.request(2, makeJob(2, open.get_future().share(), true), cheap);
+
+		int fired = 0;
+		void* published = &fired;
+		PipelineHandle finished;
+		scheduler.onReady(broken, [&](PipelineHandle handle, void* pipeline) {
+			++fired;
+			published = pipeline;
+			finished = handle;
+		});
+		CHECK(fired == 0);
+
+		open.set_value();
+		FunctionResult result = FunctionResult(true, RESULT::SSUCCESS, "Not pumped.");
+		for (int i = 0; i < 5000 && scheduler.status(broken) == PipelineStatus::PENDING; ++i) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			result = scheduler.pump();
+		}
+
+		CHECK(result.result == RESULT::WSUCCESS);
+		CHECK(result.message.str().find("Shader did not compile.") != std::string::npos);
+		CHECK(scheduler.status(broken) == PipelineStatus::FAILED);
+		CHECK(fired == 1 && published == nullptr && finished == broken);
+		CHECK(idOf(scheduler.resolve(broken)) == 1);
+
+		// Callbacks registered once the pipeline has finished fire at once
+		scheduler.onReady(broken, [&](PipelineHandle, void* pipeline) { ++fired; published = pipeline; });
+		CHECK(fired == 2 && published == nullptr);
+		scheduler.onReady(cheap, [&](PipelineHandle, void* pipeline) { published = pipeline; });
+		CHECK(idOf(published) == 1);
+
+		CHECK(scheduler.statistics().failedCount == 1);
+		scheduler.shutdown();
+		CHECK(gLiveCount.load() == 0);
+		return 0;
+	}
+
+	/** Queued jobs are cancelled without compiling, the running one is waited for and nothing leaks. */
+	int testShutdownWithQueuedJobs() {
+		const int QueuedCount = 50;
+
+		WorkerPool workers(1);
+		PipelineScheduler scheduler;
+		CHECK(scheduler.initialise(&workers, releasePipeline).is_successfull);
+
+		const PipelineHandle ready = scheduler.request(1, makeJob(1));
+		CHECK(pumpUntilFinished(scheduler, ready));
+
+		std::promise<void> open;
+		int fired = 0;
+		const int started = gStartCount.load();
+		const PipelineHandle running = scheduler.request(2, makeJob(2, open.get_future().share()));
+		scheduler.onReady(running, [&](PipelineHandle, void*) { ++fired; });
+		for (int i = 0; i < QueuedCount; ++i)
+			scheduler.request(100 + i, makeJob(100 + i));
+
+		// The only worker is held by the running job, so the others stay queued
+		for (int i = 0; i < 5000 && gStartCount.load() == started; ++i)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		CHECK(gStartCount.load() == started + 1);
+
+		const int compiled = gCompileCount.load();
+		std::thread stopping([&]() { scheduler.shutdown(); });
+
+		// The running job finishes only after shutdown() has begun waiting for it
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		open.set_value();
+		stopping.join();
+
+		CHECK(gCompileCount.load() == compiled + 1);
+		CHECK(gLiveCount.load() == 0);
+		CHECK(fired == 0);
+		CHECK(scheduler.resolve(ready) == nullptr);
+		CHECK(!scheduler.request(3, makeJob(3)).valid());
+		return 0;
+	}
+}
+
+int main() {
+	if (testFallbackResolution() != 0) return 1;
+	if (testCycleRejection() != 0) return 1;
+	if (testFailedPipelineCallbacks() != 0) return 1;
+	if (testShutdownWithQueuedJobs() != 0) return 1;
+	return 0;
+}
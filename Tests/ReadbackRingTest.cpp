@@ -0,0 +1,237 @@
+/***********************************************************************************************************
+ * @file ReadbackRingTest.cpp
+ *
+ * @brief Copies frames into a readback ring and checks the order they are read in, drops and cancels
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * The ring is driven directly against a CPU timeline whose values the test completes, standing in for
+ * GPU copies, and through the software rasteriser, whose copies complete within render().
+ *
+ **********************************************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "CommandStream.h"
+#include "CpuTimeline.h"
+#include "ReadbackRing.h"
+#include "SoftwareRasteriser.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	typedef ReadbackRing<int> IntRing;
+
+	/** Copies a frame whose staging holds its index, leaving the copy incomplete. */
+	int copyFrame(IntRing& ring, CpuTimeline& timeline, std::uint64_t frameIndex, std::uint64_t& fenceValue) {
+		int* staging = nullptr;
+		CHECK(ring.beginCopy(staging).is_successfull);
+		*staging = static_cast<int>(frameIndex);
+		fenceValue = timeline.reserve();
+		ring.endCopy(fenceValue, frameIndex, 64, 32);
+		return 0;
+	}
+
+	/** Reads the oldest frame, which must be the given one, and hands its slot back. */
+	int readFrame(IntRing& ring, std::uint64_t frameIndex) {
+		int* staging = nullptr;
+		ReadbackFrame frame;
+		CHECK(ring.acquire(staging, frame, false).result == RESULT::SSUCCESS);
+		CHECK(frame.frameIndex == frameIndex && *staging == static_cast<int>(frameIndex));
+		CHECK(frame.width == 64 && frame.height == 32);
+		ring.release();
+		return 0;
+	}
+
+	int testInitialise() {
+		CpuTimeline timeline;
+		IntRing ring;
+		CHECK(!ring.initialise(nullptr, 3).is_successfull);
+		CHECK(!ring.initialise(&timeline, 0).is_successfull);
+		CHECK(ring.initialise(&timeline, 3).is_successfull);
+		CHECK(ring.slotCount() == 3 && ring.pendingCount() == 0 && ring.droppedFrames() == 0);
+
+		int* staging = nullptr;
+		ReadbackFrame frame;
+		CHECK(ring.acquire(staging, frame, true).result == RESULT::WSUCCESS);
+		return 0;
+	}
+
+	/** Frames are read oldest first, each only once its copy has completed. */
+	int testOrdering() {
+		CpuTimeline timeline;
+		IntRing ring;
+		CHECK(ring.initialise(&timeline, 3).is_successfull);
+
+		std::uint64_t fenceValues[3];
+		for (std::uint64_t i = 0; i < 3; ++i)
+			CHECK(copyFrame(ring, timeline, i, fenceValues[i]) == 0);
+		CHECK(ring.pendingCount() == 3);
+
+		int* staging = nullptr;
+		ReadbackFrame frame;
+		CHECK(ring.acquire(staging, frame, false).result == RESULT::WSUCCESS);
+
+		// A later copy completing first still leaves the oldest frame to be read first
+		timeline.complete(fenceValues[1]);
+		CHECK(readFrame(ring, 0) == 0);
+		CHECK(readFrame(ring, 1) == 0);
+		CHECK(ring.acquire(staging, frame, false).result == RESULT::WSUCCESS);
+
+		// Waiting blocks until another thread completes the copy
+		std::thread gpu([&timeline, &fenceValues]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			timeline.complete(fenceValues[2]);
+		});
+		const FunctionResult result = ring.acquire(staging, frame, true);
+		const bool reached = timeline.isComplete(fenceValues[2]);
+		gpu.join();
+		CHECK(result.result == RESULT::SSUCCESS && reached);
+		CHECK(frame.frameIndex == 2 && *staging == 2);
+		ring.release();
+
+		// The ring keeps its order across many laps
+		for (std::uint64_t i = 3; i <= 100; ++i) {
+			std::uint64_t fenceValue = 0;
+			CHECK(copyFrame(ring, timeline, i, fenceValue) == 0);
+			if (i % 2 == 1) continue;
+
+			timeline.complete(fenceValue);
+			CHECK(readFrame(ring, i - 1) == 0);
+			CHECK(readFrame(ring, i) == 0);
+		}
+		CHECK(ring.pendingCount() == 0 && ring.droppedFrames() == 0);
+		return 0;
+	}
+
+	/** A client a whole ring behind loses its oldest unread frame, after that frame's copy has completed. */
+	int testDropOldest() {
+		CpuTimeline timeline;
+		IntRing ring;
+		CHECK(ring.initialise(&timeline, 3).is_successfull);
+
+		std::uint64_t fenceValue = 0;
+		for (std::uint64_t i = 0; i < 3; ++i)
+			CHECK(copyFrame(ring, timeline, i, fenceValue) == 0);
+
+		// The copy into the oldest slot is still running, so the drop waits for it
+		std::thread gpu([&timeline]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			timeline.complete(1);
+		});
+		int* staging = nullptr;
+		const FunctionResult result = ring.beginCopy(staging);
+		const bool reached = timeline.isComplete(1);
+		gpu.join();
+		CHECK(result.is_successfull && reached);
+		CHECK(ring.droppedFrames() == 1 && ring.pendingCount() == 2);
+		*staging = 3;
+		fenceValue = timeline.reserve();
+		ring.endCopy(fenceValue, 3, 64, 32);
+
+		// Copies that have completed are dropped without waiting
+		for (std::uint64_t i = 4; i < 8; ++i) {
+			timeline.complete(fenceValue);
+			CHECK(copyFrame(ring, timeline, i, fenceValue) == 0);
+		}
+		CHECK(ring.droppedFrames() == 5 && ring.pendingCount() == 3);
+
+		timeline.complete(fenceValue);
+		for (std::uint64_t i = 5; i < 8; ++i)
+			CHECK(readFrame(ring, i) == 0);
+		CHECK(ring.pendingCount() == 0);
+
+		// Initialising again starts the count over
+		CHECK(ring.initialise(&timeline, 3).is_successfull);
+		CHECK(ring.droppedFrames() == 0);
+		return 0;
+	}
+
+	/** A cancelled copy publishes nothing and leaves its slot to the next frame. */
+	int testCancelCopy() {
+		CpuTimeline timeline;
+		IntRing ring;
+		CHECK(ring.initialise(&timeline, 2).is_successfull);
+
+		std::uint64_t fenceValue = 0;
+		CHECK(copyFrame(ring, timeline, 0, fenceValue) == 0);
+
+		int* cancelled = nullptr;
+		CHECK(ring.beginCopy(cancelled).is_successfull);
+		*cancelled = -1;
+		ring.cancelCopy();
+		CHECK(ring.pendingCount() == 1);
+
+		int* staging = nullptr;
+		CHECK(ring.beginCopy(staging).is_successfull);
+		CHECK(staging == cancelled);
+		*staging = 1;
+		fenceValue = timeline.reserve();
+		ring.endCopy(fenceValue, 1, 64, 32);
+
+		timeline.complete(fenceValue);
+		CHECK(readFrame(ring, 0) == 0);
+		CHECK(readFrame(ring, 1) == 0);
+		CHECK(ring.droppedFrames() == 0);
+		return 0;
+	}
+
+	/** The software rasteriser keeps the newest frames of a client that stopped reading, in order. */
+	int testSoftwareRasteriser() {
+		const int Width = 64;
+		const int Height = 32;
+
+		GraphicsConfig config = {};
+		config.GraphicsAPI = API::SOFTWARE;
+		config.SwapChainBufferCount = 3;
+		config.MaxFrameLatency = 2;
+		config.SampleCount = 1;
+		config.Headless = true;
+		config.Width = Width;
+		config.Height = Height;
+
+		SoftwareRasteriser rasteriser(config);
+		CHECK(rasteriser.initialise().is_successfull);
+
+		// Every frame is cleared to a red level equal to its index
+		for (int i = 0; i < 5; ++i) {
+			const float clear[4] = { i / 255.0f, 0.0f, 0.0f, 1.0f };
+			CommandStream stream;
+			stream.clearRenderTarget(BackBufferResource, clear);
+			CHECK(rasteriser.submit(stream).is_successfull);
+			CHECK(rasteriser.render().is_successfull);
+		}
+
+		for (int i = 2; i < 5; ++i) {
+			ReadbackFrame frame;
+			CHECK(rasteriser.readback(frame, false).result == RESULT::SSUCCESS);
+			CHECK(frame.frameIndex == static_cast<std::uint64_t>(i));
+			CHECK(frame.width == Width && frame.height == Height);
+			CHECK(frame.pixels.size() == static_cast<std::size_t>(Width) * Height);
+			CHECK((frame.pixels[0] & 0xFFu) == static_cast<std::uint32_t>(i));
+		}
+
+		ReadbackFrame frame;
+		CHECK(rasteriser.readback(frame, false).result == RESULT::WSUCCESS);
+		CHECK(rasteriser.destroy().is_successfull);
+		return 0;
+	}
+}
+
+int main() {
+	if (testInitialise() != 0) return 1;
+	if (testOrdering() != 0) return 1;
+	if (testDropOldest() != 0) return 1;
+	if (testCancelCopy() != 0) return 1;
+	if (testSoftwareRasteriser() != 0) return 1;
+	return 0;
+}
@@ -0,0 +1,92 @@
+/***********************************************************************************************************
+ * @file RenderGraphTest.cpp
+ *
+ * @brief Checks the barriers the render graph emits between passes using the same UAV
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+
+#include "Check.h"
+#include "RenderGraph.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	/** Returns the number of UAV barriers on a resource issued right before a pass. */
+	std::uint32_t uavBarriersBefore(const RenderGraph& graph, RenderGraphPass pass, RenderGraphResource resource) {
+		std::uint32_t count = 0;
+		for (const RenderGraphStep& step : graph.steps()) {
+			if (step.pass != pass) continue;
+
+			const RenderGraphBarrier* barriers = graph.barriers(step);
+			for (std::uint32_t i = 0; i < step.barrierCount; ++i) {
+				if (barriers[i].resource == resource && barriers[i].type == RenderGraphBarrierType::UAV) ++count;
+			}
+		}
+		return count;
+	}
+
+	int testUnorderedAccessBarriers() {
+		RenderGraph graph;
+		const RenderGraphResource buffer = graph.importResource("Buffer", 1, ResourceState::UNORDERED_ACCESS, ResourceState::UNORDERED_ACCESS);
+
+		const RenderGraphPass write = graph.addPass("Write", []() {});
+		graph.write(write, buffer, ResourceState::UNORDERED_ACCESS);
+
+		const RenderGraphPass readAfterWrite = graph.addPass("ReadAfterWrite", []() {});
+		graph.read(readAfterWrite, buffer, ResourceState::UNORDERED_ACCESS);
+		graph.setSideEffect(readAfterWrite);
+
+		const RenderGraphPass readAfterRead = graph.addPass("ReadAfterRead", []() {});
+		graph.read(readAfterRead, buffer, ResourceState::UNORDERED_ACCESS);
+		graph.setSideEffect(readAfterRead);
+
+		const RenderGraphPass writeAfterRead = graph.addPass("WriteAfterRead", []() {});
+		graph.write(writeAfterRead, buffer, ResourceState::UNORDERED_ACCESS);
+
+		const RenderGraphPass writeAfterWrite = graph.addPass("WriteAfterWrite", []() {});
+		graph.write(writeAfterWrite, buffer, ResourceState::UNORDERED_ACCESS);
+
+		CHECK(graph.compile().is_successfull);
+		CHECK(graph.passOrder().size() == 5);
+
+		CHECK(uavBarriersBefore(graph, write, buffer) == 0);
+		CHECK(uavBarriersBefore(graph, readAfterWrite, buffer) + uavBarriersBefore(graph, readAfterRead, buffer) == 1);
+		CHECK(uavBarriersBefore(graph, writeAfterRead, buffer) == 1);
+		CHECK(uavBarriersBefore(graph, writeAfterWrite, buffer) == 1);
+
+		// The buffer never leaves the unordered access state, so there is nothing else to synchronise
+		CHECK(graph.barrierCount() == 3);
+		return 0;
+	}
+
+	/** Passes that only read a UAV need no barriers between each other. */
+	int testReadsOnlyNeedNoBarriers() {
+		RenderGraph graph;
+		const RenderGraphResource buffer = graph.importResource("Buffer", 1, ResourceState::UNORDERED_ACCESS, ResourceState::UNORDERED_ACCESS);
+
+		for (int i = 0; i < 3; ++i) {
+			const RenderGraphPass read = graph.addPass("Read", []() {});
+			graph.read(read, buffer, ResourceState::UNORDERED_ACCESS);
+			graph.setSideEffect(read);
+		}
+
+		CHECK(graph.compile().is_successfull);
+		CHECK(graph.passOrder().size() == 3);
+		CHECK(graph.barrierCount() == 0);
+		return 0;
+	}
+}
+
+int main() {
+	if (testUnorderedAccessBarriers() != 0) return 1;
+	if (testReadsOnlyNeedNoBarriers() != 0) return 1;
+	return 0;
+}
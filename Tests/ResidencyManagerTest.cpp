@@ -0,0 +1,157 @@
+/***********************************************************************************************************
+ * @file ResidencyManagerTest.cpp
+ *
+ * @brief Runs the residency manager against a simulated video memory budget with frames in flight
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * 4000 objects of 1 to 32 MB share a 1 GB budget over 20000 frames, each frame using 12 objects out of a
+ * working set that drifts through them. Two frames are kept in flight on a CPU timeline, so eviction has
+ * to tell apart the objects the GPU may still read from those it is done with.
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "Check.h"
+#include "CpuTimeline.h"
+#include "ResidencyManager.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	const int ObjectCount = 4000;
+	const int FrameCount = 20000;
+	const int UsesPerFrame = 12;
+	const std::size_t FramesInFlight = 2;
+	const std::uint64_t Budget = 1000ull << 20;
+
+	struct SimulatedObject {
+		std::uint64_t size = 0;
+		std::uint64_t lastUse = 0; /*!< Timeline value of the last frame using the object */
+		bool resident = true;
+	};
+
+	/** Pages simulated objects in and out, counting every request the manager should never make. */
+	class SimulatedSource : public ResidencySource {
+	public:
+		CpuTimeline* timeline = nullptr;
+		std::uint64_t usage = 0;
+		std::uint64_t errors = 0;
+
+		FunctionResult queryBudget(ResidencyBudget& budget) override {
+			budget.budget = Budget;
+			budget.usage = usage;
+			return(FunctionResult(true, RESULT::SSUCCESS, "Budget queried."));
+		}
+
+		FunctionResult makeResident(void* const* objects, std::uint32_t count) override {
+			for (std::uint32_t i = 0; i < count; ++i) {
+				SimulatedObject* object = static_cast<SimulatedObject*>(objects[i]);
+				if (object->resident) ++errors;
+				object->resident = true;
+				usage += object->size;
+			}
+			return(FunctionResult(true, RESULT::SSUCCESS, "Objects made resident."));
+		}
+
+		FunctionResult evict(void* const* objects, std::uint32_t count) override {
+			for (std::uint32_t i = 0; i < count; ++i) {
+				SimulatedObject* object = static_cast<SimulatedObject*>(objects[i]);
+				if (!object->resident || !timeline->isComplete(object->lastUse)) ++errors;
+				object->resident = false;
+				usage -= object->size;
+			}
+			return(FunctionResult(true, RESULT::SSUCCESS, "Objects evicted."));
+		}
+	};
+
+	int testDriftingWorkingSet() {
+		CpuTimeline timeline;
+		SimulatedSource source;
+		source.timeline = &timeline;
+
+		ResidencyManager manager;
+		CHECK(manager.initialise(&source, &timeline, 0.1f).is_successfull);
+
+		std::mt19937_64 random(7);
+		std::vector<SimulatedObject> objects(ObjectCount);
+		std::vector<ResidencyHandle> handles(ObjectCount);
+		for (int i = 0; i < ObjectCount; ++i) {
+			objects[i].size = ((random() % 32) + 1) << 20;
+			source.usage += objects[i].size;
+			CHECK(manager.track(&objects[i], objects[i].size, handles[i]).is_successfull);
+		}
+
+		std::deque<std::uint64_t> inFlight;
+		std::vector<int> used;
+		for (int frame = 0; frame < FrameCount; ++frame) {
+			const int base = (frame / 50) * 37 % ObjectCount;
+			used.clear();
+			for (int k = 0; k < UsesPerFrame; ++k) {
+				const int i = (base + static_cast<int>(random() % 200)) % ObjectCount;
+				used.push_back(i);
+				manager.use(handles[i]);
+				objects[i].lastUse = timeline.lastSignaledValue() + 1;
+			}
+
+			// Now and then an object is streamed out and back in, coming back resident
+			if (frame % 997 == 0) {
+				const int i = frame % ObjectCount;
+				manager.untrack(handles[i]);
+				CHECK(!manager.isResident(handles[i]));
+				if (!objects[i].resident) {
+					objects[i].resident = true;
+					source.usage += objects[i].size;
+				}
+				CHECK(manager.track(&objects[i], objects[i].size, handles[i]).is_successfull);
+			}
+
+			CHECK(manager.update().is_successfull);
+			for (int i : used)
+				CHECK(objects[i].resident);
+
+			// Objects count as used by the frame recording when they are tracked, so the budget can only be
+			// met once the frames in flight at the start have completed
+			if (frame > static_cast<int>(FramesInFlight)) CHECK(source.usage <= Budget);
+
+			// Reserving rather than signalling leaves the frame incomplete until it leaves the flight window
+			inFlight.push_back(timeline.reserve());
+			if (inFlight.size() > FramesInFlight) {
+				timeline.complete(inFlight.front());
+				inFlight.pop_front();
+			}
+		}
+
+		CHECK(source.errors == 0);
+
+		std::uint64_t residentSize = 0;
+		std::uint32_t residentCount = 0;
+		for (const SimulatedObject& object : objects) {
+			if (!object.resident) continue;
+			residentSize += object.size;
+			++residentCount;
+		}
+
+		const ResidencyStatistics statistics = manager.statistics();
+		CHECK(statistics.trackedCount == ObjectCount);
+		CHECK(statistics.residentCount == residentCount);
+		CHECK(statistics.residentSize == residentSize);
+		CHECK(statistics.evictionCount > 0);
+		CHECK(statistics.makeResidentCount > 0);
+		return 0;
+	}
+}
+
+int main() {
+	if (testDriftingWorkingSet() != 0) return 1;
+	return 0;
+}
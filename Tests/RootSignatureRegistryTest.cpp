@@ -0,0 +1,199 @@
+/***********************************************************************************************************
+ * @file RootSignatureRegistryTest.cpp
+ *
+ * @brief Registers stand-in root signature layouts and checks sharing, sort indices and switch counting
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "Hash.h"
+#include "RootSignatureRegistry.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	int gLiveCount = 0;
+	int gCreateCount = 0;
+
+	void releaseRootSignature(void* rootSignature) {
+		delete static_cast<std::string*>(rootSignature);
+		--gLiveCount;
+	}
+
+	/** A stand-in layout: its canonical description is the text, hashed the way backends hash theirs. */
+	struct Layout {
+		std::vector<unsigned char> canonical;
+		std::uint64_t key;
+
+		explicit Layout(const char* text) {
+			Hasher hasher(&canonical);
+			hasher.addString(text);
+			key = hasher.value();
+		}
+	};
+
+	FunctionResult acquire(RootSignatureRegistry& registry, const Layout& layout, std::uint64_t key, RootSignatureHandle& handle) {
+		return registry.acquire(key, layout.canonical.data(), layout.canonical.size(), [&layout](void*& rootSignature) {
+			++gCreateCount;
+			++gLiveCount;
+			rootSignature = new std::string(layout.canonical.begin(), layout.canonical.end());
+			return(FunctionResult(true, RESULT::SSUCCESS, "Root signature created."));
+		}, handle);
+	}
+
+	FunctionResult acquire(RootSignatureRegistry& registry, const Layout& layout, RootSignatureHandle& handle) {
+		return acquire(registry, layout, layout.key, handle);
+	}
+
+	/** The recorded bytes hash to the same value as the values fed in, so recording leaves keys unchanged. */
+	int testCanonicalDescription() {
+		const Layout layout("CBV b0, table t0-t3, static sampler s0");
+
+		Hasher plain;
+		plain.addString("CBV b0, table t0-t3, static sampler s0");
+		CHECK(layout.key == plain.value());
+		CHECK(layout.key == fnv1a(layout.canonical.data(), layout.canonical.size()));
+		return 0;
+	}
+
+	int testSharingAndSortIndices() {
+		gCreateCount = 0;
+		RootSignatureRegistry registry;
+		RootSignatureHandle handle;
+		CHECK(!acquire(registry, Layout("Opaque"), handle).is_successfull);
+		CHECK(registry.initialise(releaseRootSignature).is_successfull);
+
+		const Layout layouts[3] = { Layout("Opaque"), Layout("Skinned"), Layout("Transparent") };
+		RootSignatureHandle handles[3];
+		for (int i = 0; i < 3; ++i) {
+			CHECK(acquire(registry, layouts[i], handles[i]).is_successfull);
+			CHECK(registry.sortIndex(handles[i]) == static_cast<std::uint32_t>(i));
+			CHECK(registry.key(handles[i]) == layouts[i].key);
+		}
+
+		// Materials describing a layout separately share the root signature created first
+		for (int repeat = 0; repeat < 4; ++repeat) {
+			for (int i = 0; i < 3; ++i) {
+				const Layout again(i == 0 ? "Opaque" : i == 1 ? "Skinned" : "Transparent");
+				RootSignatureHandle shared;
+				CHECK(acquire(registry, again, shared).is_successfull);
+				CHECK(shared == handles[i]);
+				CHECK(registry.get(shared) == registry.get(handles[i]));
+			}
+		}
+
+		CHECK(gCreateCount == 3);
+		const RootSignatureStatistics statistics = registry.statistics();
+		CHECK(statistics.layoutCount == 3);
+		CHECK(statistics.requestCount == 15);
+		CHECK(statistics.sharedCount == 12);
+
+		CHECK(registry.get(RootSignatureHandle()) == nullptr);
+		registry.shutdown();
+		CHECK(gLiveCount == 0);
+		return 0;
+	}
+
+	/** A layout whose key collides with a registered one is refused instead of sharing its root signature. */
+	int testKeyCollision() {
+		gCreateCount = 0;
+		RootSignatureRegistry registry;
+		CHECK(registry.initialise(releaseRootSignature).is_successfull);
+
+		const Layout first("Opaque");
+		const Layout second("Skinned");
+		RootSignatureHandle handle;
+		CHECK(acquire(registry, first, handle).is_successfull);
+
+		RootSignatureHandle colliding = handle;
+		const FunctionResult result = acquire(registry, second, first.key, colliding);
+		CHECK(result.result == RESULT::FAIL);
+		CHECK(!colliding.valid());
+		CHECK(gCreateCount == 1);
+		CHECK(registry.statistics().layoutCount == 1);
+		CHECK(registry.statistics().sharedCount == 0);
+
+		// A description that is a prefix of the registered one differs as well
+		Layout truncated("Opaque");
+		truncated.canonical.pop_back();
+		CHECK(!acquire(registry, truncated, first.key, colliding).is_successfull);
+
+		registry.shutdown();
+		CHECK(gLiveCount == 0);
+		return 0;
+	}
+
+	int testFailedCreation() {
+		RootSignatureRegistry registry;
+		CHECK(registry.initialise(releaseRootSignature).is_successfull);
+
+		const Layout layout("Broken");
+		RootSignatureHandle handle;
+		CHECK(!registry.acquire(layout.key, layout.canonical.data(), layout.canonical.size(), [](void*&) {
+			return(FunctionResult(false, RESULT::FAIL, "Serialization failed."));
+		}, handle).is_successfull);
+		CHECK(!handle.valid());
+
+		// Nothing was registered, so the next request tries again
+		CHECK(acquire(registry, layout, handle).is_successfull);
+		CHECK(registry.sortIndex(handle) == 0);
+
+		registry.shutdown();
+		CHECK(gLiveCount == 0);
+		return 0;
+	}
+
+	int testSwitchCounting() {
+		RootSignatureRegistry registry;
+		CHECK(registry.initialise(releaseRootSignature).is_successfull);
+
+		RootSignatureHandle a, b;
+		CHECK(acquire(registry, Layout("A"), a).is_successfull);
+		CHECK(acquire(registry, Layout("B"), b).is_successfull);
+
+		// Sorted draws set each root signature once per run
+		RootSignatureBinding sorted;
+		const RootSignatureHandle sortedDraws[6] = { a, a, a, b, b, b };
+		std::uint32_t sets = 0;
+		for (RootSignatureHandle handle : sortedDraws)
+			sets += registry.bindGraphics(sorted, handle) ? 1 : 0;
+		CHECK(sets == 2);
+
+		// Interleaved draws switch on every draw; compute bindings are tracked apart from graphics ones
+		RootSignatureBinding interleaved;
+		const RootSignatureHandle interleavedDraws[6] = { a, b, a, b, a, b };
+		for (RootSignatureHandle handle : interleavedDraws)
+			sets += registry.bindGraphics(interleaved, handle) ? 1 : 0;
+		CHECK(sets == 8);
+		CHECK(registry.bindCompute(interleaved, b));
+		CHECK(!registry.bindCompute(interleaved, b));
+
+		const RootSignatureStatistics statistics = registry.statistics();
+		CHECK(statistics.bindCount == 14);
+		CHECK(statistics.switchCount == 9);
+
+		registry.shutdown();
+		CHECK(registry.statistics().bindCount == 0);
+		CHECK(gLiveCount == 0);
+		return 0;
+	}
+}
+
+int main() {
+	if (testCanonicalDescription() != 0) return 1;
+	if (testSharingAndSortIndices() != 0) return 1;
+	if (testKeyCollision() != 0) return 1;
+	if (testFailedCreation() != 0) return 1;
+	if (testSwitchCounting() != 0) return 1;
+	return 0;
+}
@@ -0,0 +1,155 @@
+/***********************************************************************************************************
+ * @file ShaderArchiveTest.cpp
+ *
+ * @brief Round trips shaders through the shader archive writer and reader
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "ShaderArchive.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	const int ShaderCount = 50;
+
+	std::string tempPath(const char* name) {
+		return((std::filesystem::temp_directory_path() / name).string());
+	}
+
+	/** Every third blob is noise that does not compress, the others are repetitive like real bytecode. */
+	std::vector<std::vector<unsigned char> > makeShaders() {
+		std::mt19937 rng(1);
+		std::vector<std::vector<unsigned char> > shaders;
+		for (int i = 0; i < ShaderCount; ++i) {
+			std::vector<unsigned char> bytecode(100 + rng() % 20000);
+			const bool noise = i % 3 == 0;
+			for (std::size_t j = 0; j < bytecode.size(); ++j)
+				bytecode[j] = static_cast<unsigned char>(noise ? rng() : (j / 7) % 13 + (j % 5 == 0 ? rng() % 3 : 0));
+			shaders.push_back(std::move(bytecode));
+		}
+		return shaders;
+	}
+
+	int testRoundTrip() {
+		const std::vector<std::vector<unsigned char> > shaders = makeShaders();
+		const std::string path = tempPath("SyrenShaderArchiveTest.archive");
+
+		ShaderArchiveWriter writer;
+		std::vector<ShaderKey> keys(ShaderCount);
+		for (int i = 0; i < ShaderCount; ++i)
+			CHECK(writer.add("shader" + std::to_string(i), shaders[i].data(), shaders[i].size(), keys[i]).is_successfull);
+
+		// The same bytecode under a second name is stored once; a name can not be reused for other bytecode
+		ShaderKey alias = 0;
+		CHECK(writer.add("alias", shaders[4].data(), shaders[4].size(), alias).is_successfull);
+		CHECK(alias == keys[4]);
+		CHECK(!writer.add("alias", shaders[5].data(), shaders[5].size(), alias).is_successfull);
+		CHECK(writer.shaderCount() == ShaderCount);
+
+		for (int compress = 0; compress < 2; ++compress) {
+			CHECK(writer.write(path, compress != 0).is_successfull);
+
+			ShaderArchive archive;
+			CHECK(archive.open(path).is_successfull);
+			CHECK(archive.entryCount() == ShaderCount);
+
+			int compressed = 0;
+			for (std::uint32_t i = 0; i < archive.entryCount(); ++i) {
+				const ShaderArchiveEntry entry = archive.entry(i);
+				if (entry.compression == ShaderCompression::LZ) {
+					CHECK(entry.storedSize < entry.size);
+					++compressed;
+				}
+			}
+			CHECK(compress ? compressed > 0 : compressed == 0);
+
+			for (int i = 0; i < ShaderCount; ++i) {
+				ShaderBytecode byKey;
+				CHECK(archive.find(keys[i], byKey).is_successfull);
+				CHECK(byKey.size == shaders[i].size());
+				CHECK(std::memcmp(byKey.data, shaders[i].data(), byKey.size) == 0);
+
+				ShaderBytecode byName;
+				CHECK(archive.find(("shader" + std::to_string(i)).c_str(), byName).is_successfull);
+				CHECK(byName.data == byKey.data);
+
+				if (!compress) CHECK(reinterpret_cast<std::uintptr_t>(byKey.data) % ShaderArchiveAlignment == 0);
+			}
+
+			ShaderBytecode bytecode;
+			CHECK(archive.find("alias", bytecode).is_successfull);
+			CHECK(std::memcmp(bytecode.data, shaders[4].data(), bytecode.size) == 0);
+			CHECK(!archive.find("missing", bytecode).is_successfull);
+			CHECK(!archive.find(ShaderKey(12345), bytecode).is_successfull);
+			CHECK(archive.verify().is_successfull);
+		}
+
+		// A flipped byte in the last blob is caught by verify()
+		{
+			std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+			file.seekg(0, std::ios::end);
+			file.seekp(static_cast<std::streamoff>(file.tellg()) - 10);
+			const char corrupt = 0x5a;
+			file.write(&corrupt, 1);
+		}
+		ShaderArchive archive;
+		CHECK(archive.open(path).is_successfull);
+		CHECK(!archive.verify().is_successfull);
+		archive.close();
+
+		std::filesystem::remove(path);
+		return 0;
+	}
+
+	int testInvalidFiles() {
+		const std::string path = tempPath("SyrenShaderArchiveTest.truncated");
+		std::ofstream(path, std::ios::binary) << "SYSAxxxx";
+
+		ShaderArchive archive;
+		CHECK(!archive.open(path).is_successfull);
+		CHECK(!archive.open(tempPath("SyrenShaderArchiveTest.missing")).is_successfull);
+
+		std::filesystem::remove(path);
+		return 0;
+	}
+
+	int testEmptyArchive() {
+		const std::string path = tempPath("SyrenShaderArchiveTest.empty");
+
+		ShaderArchiveWriter writer;
+		CHECK(writer.write(path, true).is_successfull);
+
+		ShaderArchive archive;
+		CHECK(archive.open(path).is_successfull);
+		CHECK(archive.entryCount() == 0);
+
+		ShaderBytecode bytecode;
+		CHECK(!archive.find("shader", bytecode).is_successfull);
+		archive.close();
+
+		std::filesystem::remove(path);
+		return 0;
+	}
+}
+
+int main() {
+	if (testRoundTrip() != 0) return 1;
+	if (testInvalidFiles() != 0) return 1;
+	if (testEmptyArchive() != 0) return 1;
+	return 0;
+}
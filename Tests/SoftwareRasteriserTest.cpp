@@ -0,0 +1,151 @@
+/***********************************************************************************************************
+ * @file SoftwareRasteriserTest.cpp
+ *
+ * @brief Renders triangles reaching far outside the viewport with the software rasteriser
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ * @details
+ * Vertices this far out overflowed the integer bounds of a triangle before triangles were clipped
+ * to the guard band, which left the screen covering triangle unrasterised.
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <vector>
+
+#include "Check.h"
+#include "CommandStream.h"
+#include "SoftwareRasteriser.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	const int Width = 800;
+	const int Height = 600;
+	const float Far = 1.0e8f;
+	const std::uint32_t Red = 0xFF0000FFu;
+	const std::uint32_t Black = 0xFF000000u;
+
+	GraphicsConfig makeConfig() {
+		GraphicsConfig config = {};
+		config.GraphicsAPI = API::SOFTWARE;
+		config.SwapChainBufferCount = 2;
+		config.MaxFrameLatency = 1;
+		config.SampleCount = 1;
+		config.Headless = true;
+		config.Width = Width;
+		config.Height = Height;
+		return config;
+	}
+
+	/** Returns the pixel at a point given in normalised device coordinates. */
+	std::uint32_t pixelAt(const ReadbackFrame& frame, float ndcX, float ndcY) {
+		const int x = static_cast<int>((ndcX * 0.5f + 0.5f) * Width);
+		const int y = static_cast<int>((0.5f - ndcY * 0.5f) * Height);
+		return frame.pixels[static_cast<std::size_t>(y) * Width + x];
+	}
+
+	int renderTriangle(const SoftwareVertex (&vertices)[3], ReadbackFrame& frame) {
+		SoftwareRasteriser rasteriser(makeConfig());
+		CHECK(rasteriser.initialise().is_successfull);
+
+		const ResourceId vertexBuffer = rasteriser.createBuffer(vertices, sizeof(vertices));
+		const float black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+		CommandStream stream;
+		stream.clearRenderTarget(BackBufferResource, black);
+		stream.clearDepthStencil(DepthStencilResource, 1.0f, 0);
+		stream.setVertexBuffer(0, vertexBuffer, 0, sizeof(vertices), sizeof(SoftwareVertex));
+		stream.draw(3, 1, 0, 0);
+
+		CHECK(rasteriser.submit(stream).is_successfull);
+		CHECK(rasteriser.render().is_successfull);
+		CHECK(rasteriser.readback(frame, true).result == RESULT::SSUCCESS);
+		CHECK(frame.width == Width && frame.height == Height);
+		CHECK(rasteriser.destroy().is_successfull);
+		return 0;
+	}
+
+	int testScreenCoveringTriangle() {
+		const SoftwareVertex vertices[3] = {
+			{ { -Far, -Far, 0.5f, 1.0f }, Red },
+			{ { Far, -Far, 0.5f, 1.0f }, Red },
+			{ { 0.0f, Far, 0.5f, 1.0f }, Red },
+		};
+
+		ReadbackFrame frame;
+		CHECK(renderTriangle(vertices, frame) == 0);
+		for (std::uint32_t pixel : frame.pixels)
+			CHECK(pixel == Red);
+		return 0;
+	}
+
+	/** One far vertex: the clipped triangle has to keep the shape of its on screen part. */
+	int testPartlyClippedTriangle() {
+		const SoftwareVertex vertices[3] = {
+			{ { -0.5f, -0.5f, 0.5f, 1.0f }, Red },
+			{ { Far, -0.5f, 0.5f, 1.0f }, Red },
+			{ { -0.5f, 0.5f, 0.5f, 1.0f }, Red },
+		};
+
+		ReadbackFrame frame;
+		CHECK(renderTriangle(vertices, frame) == 0);
+		CHECK(pixelAt(frame, 0.0f, 0.0f) == Red);
+		CHECK(pixelAt(frame, 0.95f, 0.0f) == Red);
+		CHECK(pixelAt(frame, -0.4f, 0.45f) == Red);
+		CHECK(pixelAt(frame, 0.0f, 0.6f) == Black);
+		CHECK(pixelAt(frame, 0.0f, -0.6f) == Black);
+		CHECK(pixelAt(frame, -0.6f, 0.0f) == Black);
+		return 0;
+	}
+
+	/** Ranges whose end wraps past 2^64 used to pass the bounds checks of copies and updates. */
+	int testWrappingRanges() {
+		const SoftwareVertex vertices[3] = {
+			{ { -Far, -Far, 0.5f, 1.0f }, Red },
+			{ { Far, -Far, 0.5f, 1.0f }, Red },
+			{ { 0.0f, Far, 0.5f, 1.0f }, Red },
+		};
+
+		SoftwareRasteriser rasteriser(makeConfig());
+		CHECK(rasteriser.initialise().is_successfull);
+
+		const ResourceId vertexBuffer = rasteriser.createBuffer(vertices, sizeof(vertices));
+		const ResourceId scratch = rasteriser.createBuffer(nullptr, sizeof(vertices));
+		const std::uint64_t wrapping = ~0ull - 7;
+
+		CHECK(!rasteriser.updateBuffer(vertexBuffer, static_cast<std::size_t>(wrapping), vertices, 16).is_successfull);
+		CHECK(!rasteriser.updateBuffer(vertexBuffer, sizeof(vertices) + 1, vertices, 0).is_successfull);
+		CHECK(rasteriser.updateBuffer(vertexBuffer, sizeof(vertices), vertices, 0).is_successfull);
+
+		const float black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+		CommandStream stream;
+		stream.copyBuffer(vertexBuffer, 0, scratch, wrapping, 16);
+		stream.copyBuffer(vertexBuffer, wrapping, scratch, 0, 16);
+		stream.clearRenderTarget(BackBufferResource, black);
+		stream.clearDepthStencil(DepthStencilResource, 1.0f, 0);
+		stream.setVertexBuffer(0, vertexBuffer, 0, sizeof(vertices), sizeof(SoftwareVertex));
+		stream.draw(3, 1, 0, 0);
+
+		// Both copies are dropped, so the triangle is drawn from untouched vertices
+		ReadbackFrame frame;
+		CHECK(rasteriser.submit(stream).is_successfull);
+		CHECK(rasteriser.render().is_successfull);
+		CHECK(rasteriser.readback(frame, true).result == RESULT::SSUCCESS);
+		CHECK(pixelAt(frame, 0.0f, 0.0f) == Red);
+		CHECK(rasteriser.destroy().is_successfull);
+		return 0;
+	}
+}
+
+int main() {
+	if (testScreenCoveringTriangle() != 0) return 1;
+	if (testPartlyClippedTriangle() != 0) return 1;
+	if (testWrappingRanges() != 0) return 1;
+	return 0;
+}
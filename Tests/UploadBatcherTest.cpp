@@ -0,0 +1,74 @@
+/***********************************************************************************************************
+ * @file UploadBatcherTest.cpp
+ *
+ * @brief Uploads buffers through the upload batcher on the CPU copy backend
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Check.h"
+#include "CpuCopyBackend.h"
+#include "UploadBatcher.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	/** An empty upload used to leave the token untouched, so callers waited on whatever it held. */
+	int testEmptyUpload() {
+		CpuCopyBackend backend(1 << 20);
+		UploadBatcher batcher;
+		CHECK(batcher.initialise(&backend, 64 << 10, 2).is_successfull);
+
+		std::vector<unsigned char> destination(16);
+		BufferUpload upload;
+		upload.destination = destination.data();
+
+		UploadToken token = 12345;
+		CHECK(batcher.upload(upload, token).is_successfull);
+		CHECK(token == CompletedUploadToken);
+		CHECK(batcher.isComplete(token));
+		CHECK(batcher.wait(token).is_successfull);
+		return 0;
+	}
+
+	/** Uploads larger than the staging memory are split into chunks that all land in place. */
+	int testChunkedUpload() {
+		CpuCopyBackend backend(1 << 20);
+		UploadBatcher batcher;
+		CHECK(batcher.initialise(&backend, 64 << 10, 2).is_successfull);
+
+		std::vector<unsigned char> source(3 << 20);
+		for (std::size_t i = 0; i < source.size(); ++i)
+			source[i] = static_cast<unsigned char>(i * 7 + i / 4096);
+
+		std::vector<unsigned char> destination(source.size() + 64, 0);
+		BufferUpload upload;
+		upload.destination = destination.data();
+		upload.destinationOffset = 64;
+		upload.data = source.data();
+		upload.size = source.size();
+
+		UploadToken token = CompletedUploadToken;
+		CHECK(batcher.upload(upload, token).is_successfull);
+		CHECK(token != CompletedUploadToken);
+		CHECK(batcher.wait(token).is_successfull);
+		CHECK(batcher.isComplete(token));
+		CHECK(std::memcmp(destination.data() + 64, source.data(), source.size()) == 0);
+		return 0;
+	}
+}
+
+int main() {
+	if (testEmptyUpload() != 0) return 1;
+	if (testChunkedUpload() != 0) return 1;
+	return 0;
+}
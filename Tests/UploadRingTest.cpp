@@ -0,0 +1,236 @@
+/***********************************************************************************************************
+ * @file UploadRingTest.cpp
+ *
+ * @brief Runs the upload ring against frames kept in flight on a CPU timeline
+ *
+ * @ingroup Syren Render Tests
+ *
+ * @author Ashvin Perera
+ * Contact: ashvin.perera.97@gmail.com
+ *
+ **********************************************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "CpuTimeline.h"
+#include "UploadRing.h"
+
+using namespace SyrenEngine;
+
+
+namespace {
+	const std::uint64_t GpuBase = 0x10000;
+
+	struct Range {
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	struct Frame {
+		std::uint64_t fenceValue;
+		std::vector<Range> ranges;
+	};
+
+	bool rangesOverlap(const Range& a, const Range& b) {
+		return(a.offset < b.offset + b.size && b.offset < a.offset + a.size);
+	}
+
+	/** Completes a timeline value from another thread after a delay, standing in for a slow GPU. */
+	std::thread completeLater(CpuTimeline& timeline, std::uint64_t value) {
+		return std::thread([&timeline, value]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			timeline.complete(value);
+		});
+	}
+
+	/** Two frames stay in flight while random allocations are checked against every range still in use. */
+	int testFramesInFlight() {
+		const std::size_t FramesInFlight = 2;
+		const std::uint64_t AllocationCount = 2000000;
+
+		CpuTimeline timeline;
+		std::vector<unsigned char> buffer(1 << 20);
+		UploadRing ring;
+		CHECK(ring.initialise(&timeline, buffer.data(), GpuBase, buffer.size(), FramesInFlight).is_successfull);
+
+		std::mt19937 random(1);
+		std::deque<Frame> inFlight;
+		std::uint64_t allocations = 0;
+		std::uint64_t wraps = 0;
+		std::uint64_t lastOffset = 0;
+
+		while (allocations < AllocationCount) {
+			Frame frame;
+			const int count = static_cast<int>(random() % 64);
+			for (int i = 0; i < count; ++i) {
+				const std::uint64_t size = 1 + random() % 3000;
+				const std::uint64_t alignment = 1ull << (random() % 9);
+
+				UploadAllocation allocation;
+				CHECK(ring.allocate(size, alignment, allocation));
+				CHECK(allocation.size == size);
+				CHECK(allocation.offset % alignment == 0);
+				CHECK(allocation.offset + size <= buffer.size());
+				CHECK(allocation.cpuAddress == buffer.data() + allocation.offset);
+				CHECK(allocation.gpuAddress == GpuBase + allocation.offset);
+
+				const Range range = { allocation.offset, size };
+				for (const Range& other : frame.ranges)
+					CHECK(!rangesOverlap(range, other));
+				for (const Frame& other : inFlight) {
+					for (const Range& otherRange : other.ranges)
+						CHECK(!rangesOverlap(range, otherRange));
+				}
+
+				if (allocation.offset < lastOffset) ++wraps;
+				lastOffset = allocation.offset;
+				frame.ranges.push_back(range);
+				++allocations;
+			}
+
+			// The frame is submitted and the oldest frame in flight completes
+			frame.fenceValue = timeline.reserve();
+			CHECK(ring.retire(ring.cursor(), frame.fenceValue).is_successfull);
+			inFlight.push_back(frame);
+			if (inFlight.size() > FramesInFlight) {
+				timeline.complete(inFlight.front().fenceValue);
+				inFlight.pop_front();
+			}
+		}
+
+		// Three frames of at most 64 allocations fit, so a well paced ring never waits
+		CHECK(wraps > 0);
+		CHECK(ring.stallCount() == 0);
+
+		timeline.complete(timeline.lastSignaledValue());
+		ring.reclaimCompleted();
+		CHECK(ring.usedSize() == 0);
+		return 0;
+	}
+
+	/** An allocation that does not fit before the end starts over at the front once that space is free. */
+	int testWrapAndReclaim() {
+		CpuTimeline timeline;
+		std::vector<unsigned char> buffer(1024);
+		UploadRing ring;
+		CHECK(ring.initialise(&timeline, buffer.data(), GpuBase, buffer.size(), 2).is_successfull);
+
+		UploadAllocation first, second, third;
+		CHECK(ring.allocate(400, 16, first) && first.offset == 0);
+		const std::uint64_t firstFrame = timeline.reserve();
+		CHECK(ring.retire(ring.cursor(), firstFrame).is_successfull);
+
+		CHECK(ring.allocate(400, 16, second) && second.offset == 400);
+		const std::uint64_t secondFrame = timeline.reserve();
+		CHECK(ring.retire(ring.cursor(), secondFrame).is_successfull);
+
+		// The third allocation skips the end of the ring and reuses the space of the completed first frame
+		timeline.complete(firstFrame);
+		CHECK(ring.allocate(400, 16, third));
+		CHECK(third.offset == 0);
+		CHECK(ring.usedSize() == buffer.size());
+		CHECK(ring.stallCount() == 0);
+
+		const std::uint64_t thirdFrame = timeline.reserve();
+		CHECK(ring.retire(ring.cursor(), thirdFrame).is_successfull);
+
+		// A frame that allocated nothing has nothing to retire
+		CHECK(ring.retire(ring.cursor(), timeline.reserve()).result == RESULT::WSUCCESS);
+
+		timeline.complete(secondFrame);
+		ring.reclaimCompleted();
+		CHECK(ring.usedSize() == 400 + 224); // The third allocation holds the end it skipped as well
+		timeline.complete(thirdFrame);
+		ring.reclaimCompleted();
+		CHECK(ring.usedSize() == 0);
+
+		// An empty ring starts over at the front
+		UploadAllocation fourth;
+		CHECK(ring.allocate(16, 16, fourth) && fourth.offset == 0);
+		return 0;
+	}
+
+	/** A full ring waits for the oldest frame, and only when nothing has completed. */
+	int testStall() {
+		CpuTimeline timeline;
+		std::vector<unsigned char> buffer(1024);
+		UploadRing ring;
+		CHECK(ring.initialise(&timeline, buffer.data(), GpuBase, buffer.size(), 2).is_successfull);
+
+		UploadAllocation allocation;
+		CHECK(ring.allocate(1000, 8, allocation));
+		const std::uint64_t frame = timeline.reserve();
+		CHECK(ring.retire(ring.cursor(), frame).is_successfull);
+
+		std::thread gpu = completeLater(timeline, frame);
+		CHECK(ring.allocate(100, 8, allocation));
+		const bool completed = timeline.isComplete(frame);
+		gpu.join();
+
+		CHECK(completed);
+		CHECK(ring.stallCount() == 1);
+		CHECK(allocation.offset == 0);
+		return 0;
+	}
+
+	/** Retiring more frames than the ring tracks waits for the oldest one. */
+	int testRetirementStall() {
+		CpuTimeline timeline;
+		std::vector<unsigned char> buffer(1024);
+		UploadRing ring;
+		CHECK(ring.initialise(&timeline, buffer.data(), GpuBase, buffer.size(), 1).is_successfull);
+
+		UploadAllocation allocation;
+		std::uint64_t frames[2];
+		for (std::uint64_t& frame : frames) {
+			CHECK(ring.allocate(16, 16, allocation));
+			frame = timeline.reserve();
+			CHECK(ring.retire(ring.cursor(), frame).is_successfull);
+		}
+
+		CHECK(ring.allocate(16, 16, allocation));
+		std::thread gpu = completeLater(timeline, frames[0]);
+		CHECK(ring.retire(ring.cursor(), timeline.reserve()).is_successfull);
+		const bool completed = timeline.isComplete(frames[0]);
+		gpu.join();
+
+		CHECK(completed);
+		CHECK(ring.stallCount() == 1);
+		CHECK(ring.usedSize() == 32);
+		return 0;
+	}
+
+	/** Allocations that can never fit fail instead of waiting forever. */
+	int testAllocationLargerThanRing() {
+		CpuTimeline timeline;
+		std::vector<unsigned char> buffer(1024);
+		UploadRing ring;
+		CHECK(ring.initialise(&timeline, buffer.data(), GpuBase, buffer.size(), 2).is_successfull);
+
+		UploadAllocation allocation;
+		CHECK(!ring.allocate(buffer.size() + 1, 1, allocation));
+		CHECK(ring.usedSize() == 0);
+
+		CHECK(ring.allocate(buffer.size(), 256, allocation) && allocation.offset == 0);
+
+		// The ring is full of data no frame has retired yet, so there is nothing to wait for
+		CHECK(!ring.allocate(1, 1, allocation));
+		CHECK(ring.stallCount() == 0);
+		return 0;
+	}
+}
+
+int main() {
+	if (testFramesInFlight() != 0) return 1;
+	if (testWrapAndReclaim() != 0) return 1;
+	if (testStall() != 0) return 1;
+	if (testRetirementStall() != 0) return 1;
+	if (testAllocationLargerThanRing() != 0) return 1;
+	return 0;
+}